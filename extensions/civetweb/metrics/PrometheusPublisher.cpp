@@ -0,0 +1,78 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "PrometheusPublisher.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/state/OpenMetricsSerializer.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace state {
+
+constexpr const char *PrometheusPublisher::PORT;
+constexpr const char *PrometheusPublisher::PATH;
+constexpr const char *PrometheusPublisher::DEFAULT_PATH;
+
+void PrometheusPublisher::initialize(const std::shared_ptr<Configure> &configuration, const std::shared_ptr<response::NodeReporter> &reporter) {
+  std::string port;
+  if (!configuration->get(PORT, port) || port.empty()) {
+    logger_->log_error("%s must be set to publish metrics", PORT);
+    return;
+  }
+  std::string path;
+  if (!configuration->get(PATH, path) || path.empty()) {
+    path = DEFAULT_PATH;
+  }
+
+  std::vector<std::string> options = { "listening_ports", port, "num_threads", "1" };
+  try {
+    server_ = std::unique_ptr<CivetServer>(new CivetServer(options));
+  } catch (const CivetException &exception) {
+    // e.g. the port is taken, which must not keep the flow from starting
+    logger_->log_error("Metrics are not published, failed to listen on port %s: %s", port, exception.what());
+    return;
+  }
+  handler_ = std::unique_ptr<MetricsHandler>(new MetricsHandler(reporter));
+  server_->addHandler(path, handler_.get());
+  logger_->log_info("Publishing metrics on port %s at %s", port, path);
+}
+
+bool PrometheusPublisher::MetricsHandler::handleGet(CivetServer*, struct mg_connection *conn) {
+  auto reporter = reporter_.lock();
+  if (reporter == nullptr) {
+    mg_printf(conn, "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+    return true;
+  }
+
+  const std::string body = OpenMetricsSerializer::serialize(reporter->getPublishedMetricsNodes());
+  mg_printf(conn, "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Length: %lu\r\nConnection: close\r\n\r\n", OpenMetricsSerializer::CONTENT_TYPE,
+            static_cast<unsigned long>(body.size()));  // NOLINT
+  mg_write(conn, body.data(), body.size());
+  return true;
+}
+
+}  // namespace state
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
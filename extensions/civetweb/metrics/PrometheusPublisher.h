@@ -0,0 +1,85 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXTENSIONS_CIVETWEB_METRICS_PROMETHEUSPUBLISHER_H_
+#define EXTENSIONS_CIVETWEB_METRICS_PROMETHEUSPUBLISHER_H_
+
+#include <memory>
+#include <string>
+
+#include <CivetServer.h>
+
+#include "core/Resource.h"
+#include "core/logging/LoggerConfiguration.h"
+#include "core/state/MetricsPublisher.h"
+#include "properties/Configure.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace state {
+
+/**
+ * Purpose: Serves the metrics of the agent in the OpenMetrics text format, so that Prometheus
+ * or any other local tooling can scrape them as often as it likes. The metrics are read when
+ * they are requested, independently of C2 heartbeats.
+ *
+ * Configured with nifi.metrics.publisher.port and, optionally, nifi.metrics.publisher.path
+ * (/metrics by default).
+ */
+class PrometheusPublisher : public MetricsPublisher {
+ public:
+  static constexpr const char *PORT = "nifi.metrics.publisher.port";
+  static constexpr const char *PATH = "nifi.metrics.publisher.path";
+  static constexpr const char *DEFAULT_PATH = "/metrics";
+
+  explicit PrometheusPublisher(std::string name, utils::Identifier uuid = utils::Identifier())
+      : MetricsPublisher(name, uuid),
+        logger_(logging::LoggerFactory<PrometheusPublisher>::getLogger()) {
+  }
+
+  void initialize(const std::shared_ptr<Configure> &configuration, const std::shared_ptr<response::NodeReporter> &reporter) override;
+
+ private:
+  class MetricsHandler : public CivetHandler {
+   public:
+    explicit MetricsHandler(const std::shared_ptr<response::NodeReporter> &reporter)
+        : reporter_(reporter) {
+    }
+
+    bool handleGet(CivetServer *server, struct mg_connection *conn) override;
+
+   private:
+    // the flow controller owns the publisher
+    std::weak_ptr<response::NodeReporter> reporter_;
+  };
+
+  std::unique_ptr<MetricsHandler> handler_;
+  std::unique_ptr<CivetServer> server_;
+  std::shared_ptr<logging::Logger> logger_;
+};
+
+REGISTER_RESOURCE(PrometheusPublisher, "Serves agent, queue, repository and processor metrics in the OpenMetrics format for Prometheus to scrape");
+
+}  // namespace state
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
+
+#endif  // EXTENSIONS_CIVETWEB_METRICS_PROMETHEUSPUBLISHER_H_
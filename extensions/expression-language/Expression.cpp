@@ -20,6 +20,7 @@
 #include <iomanip>
 #include <random>
 #include <algorithm>
+#include <set>
 
 #include "rapidjson/reader.h"
 #include "rapidjson/writer.h"
@@ -83,11 +84,11 @@ Expression make_dynamic_attr(const std::string &attribute_id) {
     std::string result;
     const auto cur_flow_file = params.flow_file.lock();
     if (cur_flow_file && cur_flow_file->getAttribute(attribute_id, result)) {
-      return Value(result);
+      return Value(std::move(result));
     } else {
       auto registry = params.registry_.lock();
       if ( registry && registry->getConfigurationProperty( attribute_id , result) ) {
-        return Value(result);
+        return Value(std::move(result));
       }
     }
     return Value();
@@ -734,18 +735,22 @@ Value expr_replace(const std::vector<Value> &args) {
   return Value(result);
 }
 
+Value expr_replaceFirst(const std::vector<Value> &args, const std::regex &find) {
+  const std::string &replace = args[2].asString();
+  return Value(std::regex_replace(args[0].asString(), find, replace, std::regex_constants::format_first_only));
+}
+
 Value expr_replaceFirst(const std::vector<Value> &args) {
-  std::string result = args[0].asString();
-  const std::regex find(args[1].asString());
+  return expr_replaceFirst(args, std::regex(args[1].asString()));
+}
+
+Value expr_replaceAll(const std::vector<Value> &args, const std::regex &find) {
   const std::string &replace = args[2].asString();
-  return Value(std::regex_replace(result, find, replace, std::regex_constants::format_first_only));
+  return Value(std::regex_replace(args[0].asString(), find, replace));
 }
 
 Value expr_replaceAll(const std::vector<Value> &args) {
-  std::string result = args[0].asString();
-  const std::regex find(args[1].asString());
-  const std::string &replace = args[2].asString();
-  return Value(std::regex_replace(result, find, replace));
+  return expr_replaceAll(args, std::regex(args[1].asString()));
 }
 
 Value expr_replaceNull(const std::vector<Value> &args) {
@@ -758,25 +763,29 @@ Value expr_replaceNull(const std::vector<Value> &args) {
 
 Value expr_replaceEmpty(const std::vector<Value> &args) {
   std::string result = args[0].asString();
-  const std::regex find("^[ \n\r\t]*$");
+  static const std::regex find("^[ \n\r\t]*$");
   const std::string &replace = args[1].asString();
   return Value(std::regex_replace(result, find, replace));
 }
 
-Value expr_matches(const std::vector<Value> &args) {
+Value expr_matches(const std::vector<Value> &args, const std::regex &expr) {
   const auto &subject = args[0].asString();
-  const std::regex expr = std::regex(args[1].asString());
-
   return Value(std::regex_match(subject.begin(), subject.end(), expr));
 }
 
-Value expr_find(const std::vector<Value> &args) {
-  const auto &subject = args[0].asString();
-  const std::regex expr = std::regex(args[1].asString());
+Value expr_matches(const std::vector<Value> &args) {
+  return expr_matches(args, std::regex(args[1].asString()));
+}
 
+Value expr_find(const std::vector<Value> &args, const std::regex &expr) {
+  const auto &subject = args[0].asString();
   return Value(std::regex_search(subject.begin(), subject.end(), expr));
 }
 
+Value expr_find(const std::vector<Value> &args) {
+  return expr_find(args, std::regex(args[1].asString()));
+}
+
 #endif  // EXPRESSION_LANGUAGE_USE_REGEX
 
 Value expr_trim(const std::vector<Value> &args) {
@@ -889,6 +898,14 @@ Value expr_random(const std::vector<Value> &args) {
   return Value(distribution(generator));
 }
 
+/**
+ * Functions which depend on something other than their arguments, so their results must not be computed at compile time.
+ */
+bool is_constant_foldable(const std::string &function_name) {
+  static const std::set<std::string> non_deterministic_functions = { "hostname", "ip", "UUID", "random", "now", "resolve_user_id" };
+  return non_deterministic_functions.find(function_name) == non_deterministic_functions.end();
+}
+
 template<Value T(const std::vector<Value> &)>
 Expression make_dynamic_function_incomplete(const std::string &function_name, const std::vector<Expression> &args, std::size_t num_args) {
 
@@ -909,19 +926,72 @@ Expression make_dynamic_function_incomplete(const std::string &function_name, co
       return T(args);
     },
                                  multi_args);
-  } else {
-    return make_dynamic([=](const Parameters &params, const std::vector<Expression> &sub_exprs) -> Value {
-      std::vector<Value> evaluated_args;
+  }
 
-      for (const auto &arg : args) {
-        evaluated_args.emplace_back(arg(params));
-      }
+  const bool static_args = std::none_of(args.begin(), args.end(), [](const Expression &arg) {
+    return arg.is_dynamic() || arg.is_multi();
+  });
+  if (static_args && is_constant_foldable(function_name)) {
+    std::vector<Value> evaluated_args;
+    evaluated_args.reserve(args.size());
+    for (const auto &arg : args) {
+      evaluated_args.emplace_back(arg(Parameters()));
+    }
+    try {
+      return Expression(T(evaluated_args));
+    } catch (const std::exception &) {
+      // leave it to evaluation time, so that the error surfaces where it would without folding
+    }
+  }
 
-      return T(evaluated_args);
-    });
+  return make_dynamic([=](const Parameters &params, const std::vector<Expression> &sub_exprs) -> Value {
+    std::vector<Value> evaluated_args;
+    evaluated_args.reserve(args.size());
+
+    for (const auto &arg : args) {
+      evaluated_args.emplace_back(arg(params));
+    }
+
+    return T(evaluated_args);
+  });
+}
+
+#ifdef EXPRESSION_LANGUAGE_USE_REGEX
+
+/**
+ * Regex functions whose pattern (the second argument) is constant get the pattern compiled once here,
+ * instead of on every evaluation.
+ */
+template<Value T(const std::vector<Value> &), Value R(const std::vector<Value> &, const std::regex &)>
+Expression make_dynamic_regex_function(const std::string &function_name, const std::vector<Expression> &args, std::size_t num_args) {
+  const bool precompile = args.size() >= num_args && args.size() > 1 && !args[0].is_multi() && !args[1].is_dynamic() && !args[1].is_multi()
+      && std::any_of(args.begin(), args.end(), [](const Expression &arg) {return arg.is_dynamic();});
+  if (!precompile) {
+    return make_dynamic_function_incomplete<T>(function_name, args, num_args);
   }
+
+  std::shared_ptr<const std::regex> regex;
+  try {
+    regex = std::make_shared<const std::regex>(args[1](Parameters()).asString());
+  } catch (const std::regex_error &) {
+    // an invalid pattern is reported when the expression is evaluated, as before
+    return make_dynamic_function_incomplete<T>(function_name, args, num_args);
+  }
+
+  return make_dynamic([=](const Parameters &params, const std::vector<Expression> &sub_exprs) -> Value {
+    std::vector<Value> evaluated_args;
+    evaluated_args.reserve(args.size());
+
+    for (const auto &arg : args) {
+      evaluated_args.emplace_back(arg(params));
+    }
+
+    return R(evaluated_args, *regex);
+  });
 }
 
+#endif  // EXPRESSION_LANGUAGE_USE_REGEX
+
 Value expr_literal(const std::vector<Value> &args) {
   return args[0];
 }
@@ -1133,7 +1203,7 @@ Expression make_allMatchingAttributes(const std::string &function_name, const st
     for (const auto &arg : args) {
       const std::regex attr_regex = std::regex(arg(params).asString());
       const auto cur_flow_file = params.flow_file.lock();
-      std::map<std::string, std::string> attrs;
+      core::FlowFileAttributes attrs;
 
       if (cur_flow_file) {
         attrs = cur_flow_file->getAttributes();
@@ -1141,11 +1211,12 @@ Expression make_allMatchingAttributes(const std::string &function_name, const st
 
       for (const auto &attr : attrs) {
         if (std::regex_match(attr.first.begin(), attr.first.end(), attr_regex)) {
+          const std::string attr_name = attr.first;
           out_exprs.emplace_back(make_dynamic([=](const Parameters &params,
                       const std::vector<Expression> &sub_exprs) -> Value {
                     std::string attr_val;
 
-                    if (cur_flow_file && cur_flow_file->getAttribute(attr.first, attr_val)) {
+                    if (cur_flow_file && cur_flow_file->getAttribute(attr_name, attr_val)) {
                       return Value(attr_val);
                     } else {
                       return Value();
@@ -1186,7 +1257,7 @@ Expression make_anyMatchingAttribute(const std::string &function_name, const std
     for (const auto &arg : args) {
       const std::regex attr_regex = std::regex(arg(params).asString());
       const auto cur_flow_file = params.flow_file.lock();
-      std::map<std::string, std::string> attrs;
+      core::FlowFileAttributes attrs;
 
       if (cur_flow_file) {
         attrs = cur_flow_file->getAttributes();
@@ -1194,11 +1265,12 @@ Expression make_anyMatchingAttribute(const std::string &function_name, const std
 
       for (const auto &attr : attrs) {
         if (std::regex_match(attr.first.begin(), attr.first.end(), attr_regex)) {
+          const std::string attr_name = attr.first;
           out_exprs.emplace_back(make_dynamic([=](const Parameters &params,
                       const std::vector<Expression> &sub_exprs) -> Value {
                     std::string attr_val;
 
-                    if (cur_flow_file && cur_flow_file->getAttribute(attr.first, attr_val)) {
+                    if (cur_flow_file && cur_flow_file->getAttribute(attr_name, attr_val)) {
                       return Value(attr_val);
                     } else {
                       return Value();
@@ -1407,17 +1479,17 @@ Expression make_dynamic_function(const std::string &function_name, const std::ve
   } else if (function_name == "replace") {
     return make_dynamic_function_incomplete<expr_replace>(function_name, args, 2);
   } else if (function_name == "replaceFirst") {
-    return make_dynamic_function_incomplete<expr_replaceFirst>(function_name, args, 2);
+    return make_dynamic_regex_function<expr_replaceFirst, expr_replaceFirst>(function_name, args, 2);
   } else if (function_name == "replaceAll") {
-    return make_dynamic_function_incomplete<expr_replaceAll>(function_name, args, 2);
+    return make_dynamic_regex_function<expr_replaceAll, expr_replaceAll>(function_name, args, 2);
   } else if (function_name == "replaceNull") {
     return make_dynamic_function_incomplete<expr_replaceNull>(function_name, args, 1);
   } else if (function_name == "replaceEmpty") {
     return make_dynamic_function_incomplete<expr_replaceEmpty>(function_name, args, 1);
   } else if (function_name == "matches") {
-    return make_dynamic_function_incomplete<expr_matches>(function_name, args, 1);
+    return make_dynamic_regex_function<expr_matches, expr_matches>(function_name, args, 1);
   } else if (function_name == "find") {
-    return make_dynamic_function_incomplete<expr_find>(function_name, args, 1);
+    return make_dynamic_regex_function<expr_find, expr_find>(function_name, args, 1);
   } else if (function_name == "allMatchingAttributes") {
     return make_allMatchingAttributes(function_name, args);
   } else if (function_name == "anyMatchingAttribute") {
@@ -1570,7 +1642,8 @@ Expression Expression::operator+(const Expression &other_expr) const {
 
 Value Expression::operator()(const Parameters &params) const {
   if (is_dynamic()) {
-    return val_fn_(params, sub_expr_generator_(params));
+    // only multi-expressions generate sub-expressions, spare the call for everything else
+    return is_multi_ ? val_fn_(params, sub_expr_generator_(params)) : val_fn_(params, {});
   } else {
     return val_;
   }
@@ -17,44 +17,132 @@
 
 #include "ProcessContextExpr.h"
 #include <memory>
+#include <string>
+#include <utility>
 namespace org {
 namespace apache {
 namespace nifi {
 namespace minifi {
 namespace core {
 
+void ProcessContextExpr::onSchedule() {
+  auto compiled = std::make_shared<CompiledExpressions>();
+
+  auto compile = [&](const std::string &name, const std::string &expression_str, std::unordered_map<std::string, int> &index) {
+    logger_->log_debug("Compiling expression for %s/%s: %s", getProcessorNode()->getName(), name, expression_str);
+    try {
+      compiled->expressions.push_back(expression::compile(expression_str));
+    } catch (const std::exception &e) {
+      // leave it to evaluation time, where the error surfaced before expressions were compiled eagerly
+      logger_->log_error("Failed to compile expression for %s/%s: %s", getProcessorNode()->getName(), name, e.what());
+      return;
+    }
+    compiled->names.push_back(name);
+    index.emplace(name, static_cast<int>(compiled->expressions.size() - 1));
+  };
+
+  const auto component = std::dynamic_pointer_cast<ConfigurableComponent>(getProcessorNode()->getProcessor());
+  if (component) {
+    for (const auto &property : component->getProperties()) {
+      if (property.second.supportsExpressionLangauge()) {
+        std::string expression_str;
+        ProcessContext::getProperty(property.first, expression_str);
+        compile(property.first, expression_str, compiled->property_index);
+      }
+    }
+  }
+  for (const auto &name : getDynamicPropertyKeys()) {
+    std::string expression_str;
+    ProcessContext::getDynamicProperty(name, expression_str);
+    compile(name, expression_str, compiled->dynamic_property_index);
+  }
+
+  std::atomic_store(&compiled_expressions_, std::shared_ptr<const CompiledExpressions>(std::move(compiled)));
+}
+
+PropertyHandle ProcessContextExpr::getPropertyHandle(const Property &property) {
+  const auto compiled = getCompiledExpressions();
+  if (compiled && property.supportsExpressionLangauge()) {
+    const auto it = compiled->property_index.find(property.getName());
+    if (it != compiled->property_index.end()) {
+      return PropertyHandle(property, false, it->second);
+    }
+  }
+  return PropertyHandle(property, false);
+}
+
+PropertyHandle ProcessContextExpr::getDynamicPropertyHandle(const Property &property) {
+  const auto compiled = getCompiledExpressions();
+  if (compiled && property.supportsExpressionLangauge()) {
+    const auto it = compiled->dynamic_property_index.find(property.getName());
+    if (it != compiled->dynamic_property_index.end()) {
+      return PropertyHandle(property, true, it->second);
+    }
+  }
+  return PropertyHandle(property, true);
+}
+
+bool ProcessContextExpr::getProperty(const PropertyHandle &handle, std::string &value, const std::shared_ptr<FlowFile> &flow_file) {
+  const int index = handle.getIndex();
+  if (index >= 0) {
+    const auto compiled = getCompiledExpressions();
+    // the handle may stem from a previous schedule, in which case the slot can belong to another property
+    if (compiled && static_cast<size_t>(index) < compiled->expressions.size() && compiled->names[index] == handle.getName()) {
+      value = evaluate(compiled->expressions[index], flow_file);
+      return true;
+    }
+  }
+  return ProcessContext::getProperty(handle, value, flow_file);
+}
+
 bool ProcessContextExpr::getProperty(const Property &property, std::string &value, const std::shared_ptr<FlowFile> &flow_file) {
   if (!property.supportsExpressionLangauge()) {
     return ProcessContext::getProperty(property.getName(), value);
   }
-  auto name = property.getName();
-  if (expressions_.find(name) == expressions_.end()) {
-    std::string expression_str;
-    ProcessContext::getProperty(name, expression_str);
-    logger_->log_debug("Compiling expression for %s/%s: %s", getProcessorNode()->getName(), name, expression_str);
-    expressions_.emplace(name, expression::compile(expression_str));
+  const auto name = property.getName();
+  const auto compiled = getCompiledExpressions();
+  if (compiled) {
+    const auto it = compiled->property_index.find(name);
+    if (it != compiled->property_index.end()) {
+      value = evaluate(compiled->expressions[it->second], flow_file);
+      return true;
+    }
   }
-
-  minifi::expression::Parameters p(shared_from_this(), flow_file);
-  value = expressions_[name](p).asString();
+  value = evaluate(compileProperty(name, false), flow_file);
   return true;
 }
 
 bool ProcessContextExpr::getDynamicProperty(const Property &property, std::string &value, const std::shared_ptr<FlowFile> &flow_file) {
-
   if (!property.supportsExpressionLangauge()) {
     return ProcessContext::getDynamicProperty(property.getName(), value);
   }
-  auto name = property.getName();
-  if (dynamic_property_expressions_.find(name) == dynamic_property_expressions_.end()) {
-    std::string expression_str;
+  const auto name = property.getName();
+  const auto compiled = getCompiledExpressions();
+  if (compiled) {
+    const auto it = compiled->dynamic_property_index.find(name);
+    if (it != compiled->dynamic_property_index.end()) {
+      value = evaluate(compiled->expressions[it->second], flow_file);
+      return true;
+    }
+  }
+  value = evaluate(compileProperty(name, true), flow_file);
+  return true;
+}
+
+expression::Expression ProcessContextExpr::compileProperty(const std::string &name, bool dynamic) {
+  std::string expression_str;
+  if (dynamic) {
     ProcessContext::getDynamicProperty(name, expression_str);
-    logger_->log_debug("Compiling expression for %s/%s: %s", getProcessorNode()->getName(), name, expression_str);
-    dynamic_property_expressions_.emplace(name, expression::compile(expression_str));
+  } else {
+    ProcessContext::getProperty(name, expression_str);
   }
+  logger_->log_debug("Compiling expression for %s/%s: %s", getProcessorNode()->getName(), name, expression_str);
+  return expression::compile(expression_str);
+}
+
+std::string ProcessContextExpr::evaluate(const expression::Expression &expression, const std::shared_ptr<FlowFile> &flow_file) {
   minifi::expression::Parameters p(shared_from_this(), flow_file);
-  value = dynamic_property_expressions_[name](p).asString();
-  return true;
+  return expression(p).asString();
 }
 
 } /* namespace core */
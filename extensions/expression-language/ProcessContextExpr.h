@@ -17,6 +17,9 @@
 
 #include <ProcessContext.h>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include <impl/expression/Expression.h>
 
 namespace org {
@@ -61,10 +64,44 @@ class ProcessContextExpr : public core::ProcessContext {
   virtual bool getProperty(const Property &property, std::string &value, const std::shared_ptr<FlowFile> &flow_file) override;
 
   virtual bool getDynamicProperty(const Property &property, std::string &value, const std::shared_ptr<FlowFile> &flow_file) override;
+
+  /**
+   * Compiles the expressions of all properties supporting expression language and of all dynamic properties.
+   */
+  virtual void onSchedule() override;
+
+  virtual PropertyHandle getPropertyHandle(const Property &property) override;
+
+  virtual PropertyHandle getDynamicPropertyHandle(const Property &property) override;
+
+  virtual bool getProperty(const PropertyHandle &handle, std::string &value, const std::shared_ptr<FlowFile> &flow_file) override;
+
  protected:
 
-  std::map<std::string, org::apache::nifi::minifi::expression::Expression> expressions_;
-  std::map<std::string, org::apache::nifi::minifi::expression::Expression> dynamic_property_expressions_;
+  /**
+   * Expressions compiled for one schedule, addressed by index. The table is never modified
+   * once published, so concurrent tasks evaluate it without locking.
+   */
+  struct CompiledExpressions {
+    std::vector<std::string> names;
+    std::vector<org::apache::nifi::minifi::expression::Expression> expressions;
+    std::unordered_map<std::string, int> property_index;
+    std::unordered_map<std::string, int> dynamic_property_index;
+  };
+
+  std::shared_ptr<const CompiledExpressions> getCompiledExpressions() const {
+    return std::atomic_load(&compiled_expressions_);
+  }
+
+  /**
+   * Compiles the expression of a property the table does not know about, e.g. when the context
+   * was not scheduled through onSchedule. The result is not cached.
+   */
+  org::apache::nifi::minifi::expression::Expression compileProperty(const std::string &name, bool dynamic);
+
+  std::string evaluate(const org::apache::nifi::minifi::expression::Expression &expression, const std::shared_ptr<FlowFile> &flow_file);
+
+  std::shared_ptr<const CompiledExpressions> compiled_expressions_;
 
  private:
   std::shared_ptr<logging::Logger> logger_;
@@ -70,8 +70,10 @@ static const std::function<Value(const Parameters &params, const std::vector<Exp
 class Expression {
  public:
 
-  Expression() {
-    val_fn_ = NOOP_FN;
+  Expression()
+      : val_fn_(NOOP_FN),
+        is_multi_(false) {
+    sub_expr_generator_ = [](const Parameters &params) -> std::vector<Expression> {return {};};
   }
 
   explicit Expression(Value val, std::function<Value(const Parameters &, const std::vector<Expression> &)> val_fn = NOOP_FN)
@@ -0,0 +1,102 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <time.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include "impl/expression/Expression.h"
+#include "core/FlowFile.h"
+#include "TestBase.h"
+
+namespace expression = org::apache::nifi::minifi::expression;
+
+class MockFlowFile : public core::FlowFile {
+  void releaseClaim(const std::shared_ptr<minifi::ResourceClaim> claim) override {
+  }
+};
+
+namespace {
+
+std::shared_ptr<MockFlowFile> createFlowFile() {
+  auto flow_file = std::make_shared<MockFlowFile>();
+  flow_file->addAttribute("filename", "data-2019-01-01.csv");
+  flow_file->addAttribute("status", "ok");
+  flow_file->addAttribute("size", "4096");
+  return flow_file;
+}
+
+/**
+ * Evaluates expr_str repeatedly and prints the throughput. Run the same cases on a
+ * previous revision to obtain the baseline.
+ */
+void benchmark(const std::string &expr_str, const std::string &expected) {
+  auto expr = expression::compile(expr_str);
+  auto flow_file = createFlowFile();
+  const expression::Parameters params(flow_file);
+  REQUIRE(expected == expr(params).asString());
+
+  const int iterations = 200000;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    expr(params);
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+  std::cout << expr_str << ": " << (iterations * 1000000.0 / std::max<int64_t>(elapsed, 1)) << " evaluations/s" << std::endl;
+}
+
+}  // namespace
+
+TEST_CASE("Constant sub-expressions are folded at compile time", "[expressionLanguageConstantFolding]") {  // NOLINT
+  auto flow_file = createFlowFile();
+  REQUIRE("ABCDEF" == expression::compile("${literal('abc'):append('def'):toUpper()}")( { flow_file }).asString());
+  REQUIRE("data-2019-01-01.csv.BAK" == expression::compile("${filename:append(${literal('.bak'):toUpper()})}")( { flow_file }).asString());
+  REQUIRE("true" == expression::compile("${literal(3):plus(4):equals(7)}")( { flow_file }).asString());
+}
+
+TEST_CASE("Non-deterministic functions are not folded", "[expressionLanguageNoFolding]") {  // NOLINT
+  auto expr = expression::compile("${UUID()}");
+  REQUIRE(expr( { }).asString() != expr( { }).asString());
+}
+
+#ifdef EXPRESSION_LANGUAGE_USE_REGEX
+
+TEST_CASE("Constant patterns are compiled once", "[expressionLanguagePrecompiledRegex]") {  // NOLINT
+  auto flow_file = createFlowFile();
+  REQUIRE("data_2019_01_01.csv" == expression::compile("${filename:replaceAll('-', '_')}")( { flow_file }).asString());
+  REQUIRE("data_2019-01-01.csv" == expression::compile("${filename:replaceFirst('-', '_')}")( { flow_file }).asString());
+  REQUIRE("true" == expression::compile("${filename:matches('data-[0-9-]+\\.csv')}")( { flow_file }).asString());
+  REQUIRE("true" == expression::compile("${filename:find('[0-9]{4}')}")( { flow_file }).asString());
+  REQUIRE("false" == expression::compile("${filename:find('[a-z]{5}')}")( { flow_file }).asString());
+}
+
+#endif  // EXPRESSION_LANGUAGE_USE_REGEX
+
+TEST_CASE("UpdateAttribute style expression throughput", "[.benchmark]") {  // NOLINT
+  benchmark("${filename:toUpper():append('.bak')}", "DATA-2019-01-01.CSV.bak");
+  benchmark("${filename:substringBeforeLast('.'):append(${literal('.json')})}", "data-2019-01-01.json");
+#ifdef EXPRESSION_LANGUAGE_USE_REGEX
+  benchmark("${filename:replaceAll('[0-9]', 'x')}", "data-xxxx-xx-xx.csv");
+#endif
+}
+
+TEST_CASE("RouteOnAttribute style predicate throughput", "[.benchmark]") {  // NOLINT
+  benchmark("${status:equals('ok'):and(${size:gt(1024)})}", "true");
+  benchmark("${filename:endsWith('.csv'):or(${filename:endsWith('.tsv')})}", "true");
+}
@@ -0,0 +1,93 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "TestBase.h"
+#include "core/FlowFile.h"
+#include "processors/UpdateAttribute.h"
+
+class MockFlowFile : public core::FlowFile {
+  void releaseClaim(const std::shared_ptr<minifi::ResourceClaim> claim) override {
+  }
+};
+
+TEST_CASE("Expressions are compiled at schedule and shared by concurrent tasks", "[processContextExprConcurrent]") {  // NOLINT
+  TestController testController;
+  std::shared_ptr<TestPlan> plan = testController.createPlan();
+
+  const auto &update_proc = plan->addProcessor("UpdateAttribute", "update");
+  plan->setProperty(update_proc, "greeting", "hello ${name:toUpper()}", true);
+
+  const auto property = core::PropertyBuilder::createProperty("greeting")->supportsExpressionLanguage(true)->build();
+
+  plan->runNextProcessor([&](const std::shared_ptr<core::ProcessContext> context, const std::shared_ptr<core::ProcessSession> session) {
+    const auto handle = context->getDynamicPropertyHandle(property);
+    REQUIRE(handle.getIndex() >= 0);
+
+    std::vector<std::thread> threads;
+    std::vector<int> failures(8, 0);
+    for (size_t t = 0; t < failures.size(); t++) {
+      threads.emplace_back([&, t]() {
+        for (int i = 0; i < 1000; i++) {
+          auto flow_file = std::make_shared<MockFlowFile>();
+          const auto name = "task" + std::to_string(t) + "_" + std::to_string(i);
+          flow_file->addAttribute("name", name);
+          std::string by_handle;
+          std::string by_property;
+          context->getProperty(handle, by_handle, flow_file);
+          context->getDynamicProperty(property, by_property, flow_file);
+          std::string upper_name = name;
+          std::transform(upper_name.begin(), upper_name.end(), upper_name.begin(), ::toupper);
+          const std::string expected = "hello " + upper_name;
+          if (by_handle != expected || by_property != expected) {
+            failures[t]++;
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    for (const auto failure_count : failures) {
+      REQUIRE(0 == failure_count);
+    }
+  });
+}
+
+TEST_CASE("Properties missing from the compiled table are still evaluated", "[processContextExprUncompiled]") {  // NOLINT
+  TestController testController;
+  std::shared_ptr<TestPlan> plan = testController.createPlan();
+
+  const auto &update_proc = plan->addProcessor("UpdateAttribute", "update");
+
+  const auto property = core::PropertyBuilder::createProperty("late")->supportsExpressionLanguage(true)->build();
+
+  plan->runNextProcessor([&](const std::shared_ptr<core::ProcessContext> context, const std::shared_ptr<core::ProcessSession> session) {
+    update_proc->setDynamicProperty("late", "${literal(1):plus(1)}");
+    const auto handle = context->getDynamicPropertyHandle(property);
+    REQUIRE(handle.getIndex() == -1);
+
+    std::string value;
+    REQUIRE(context->getProperty(handle, value, nullptr));
+    REQUIRE("2" == value);
+  });
+}
@@ -90,3 +90,61 @@ TEST_CASE("RouteOnAttributeUnmatchedTest", "[routeOnAttributeUnmatchedTest]") {
 
   LogTestController::getInstance().reset();
 }
+
+TEST_CASE("RouteOnAttributeEqualityDispatchTest", "[routeOnAttributeEqualityDispatchTest]") {
+  TestController testController;
+
+  LogTestController::getInstance().setDebug<minifi::processors::UpdateAttribute>();
+  LogTestController::getInstance().setDebug<minifi::processors::RouteOnAttribute>();
+  LogTestController::getInstance().setDebug<TestPlan>();
+  LogTestController::getInstance().setDebug<minifi::processors::LogAttribute>();
+
+  std::string matched_route;
+
+  SECTION("Equality route") {
+    matched_route = "route_b";
+  }
+  SECTION("Evaluated route") {
+    matched_route = "route_prefix";
+  }
+  SECTION("Equality route on a missing attribute") {
+    matched_route = "route_missing";
+  }
+
+  std::shared_ptr<TestPlan> plan = testController.createPlan();
+
+  plan->addProcessor("GenerateFlowFile", "generate");
+
+  const auto &update_proc = plan->addProcessor("UpdateAttribute", "update", core::Relationship("success", "description"), true);
+  plan->setProperty(update_proc, "status", "b", true);
+
+  const auto &route_proc = plan->addProcessor("RouteOnAttribute", "route", core::Relationship("success", "description"), true);
+  plan->setProperty(route_proc, "route_a", "${status:equals('a')}", true);
+  plan->setProperty(route_proc, "route_b", "${status:equals('b')}", true);
+  plan->setProperty(route_proc, "route_c", "${status:equals(\"c\")}", true);
+  plan->setProperty(route_proc, "route_prefix", "${status:startsWith('b')}", true);
+  plan->setProperty(route_proc, "route_missing", "${missing:equals('')}", true);
+  std::set<core::Relationship> terminated { core::Relationship("unmatched", "description") };
+  for (const auto &route : { "route_a", "route_b", "route_c", "route_prefix", "route_missing" }) {
+    if (route != matched_route) {
+      terminated.insert(core::Relationship(route, "description"));
+    }
+  }
+  route_proc->setAutoTerminatedRelationships(terminated);
+
+  const auto &update_matched_proc = plan->addProcessor("UpdateAttribute", "update_matched", core::Relationship(matched_route, "description"), true);
+  plan->setProperty(update_matched_proc, "route_check_attr", "matched_" + matched_route, true);
+
+  plan->addProcessor("LogAttribute", "log", core::Relationship("success", "description"), true);
+
+  testController.runSession(plan, false);  // generate
+  testController.runSession(plan, false);  // update
+  testController.runSession(plan, false);  // route
+  testController.runSession(plan, false);  // update_matched
+  testController.runSession(plan, false);  // log
+
+  REQUIRE(LogTestController::getInstance().contains("key:route_check_attr value:matched_" + matched_route));
+  REQUIRE(LogTestController::getInstance().contains("RouteOnAttribute dispatches 4 route(s) on 2 attribute(s), evaluates 1 route(s)"));
+
+  LogTestController::getInstance().reset();
+}
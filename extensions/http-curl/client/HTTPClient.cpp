@@ -190,7 +190,7 @@ void HTTPClient::setUploadCallback(HTTPUploadCallback *callbackObj) {
   curl_easy_setopt(http_session_, CURLOPT_READDATA, static_cast<void*>(callbackObj));
 }
 
-struct curl_slist *HTTPClient::build_header_list(std::string regex, const std::map<std::string, std::string> &attributes) {
+struct curl_slist *HTTPClient::build_header_list(std::string regex, const core::FlowFileAttributes &attributes) {
   if (http_session_) {
     for (auto attribute : attributes) {
       if (matches(attribute.first, regex)) {
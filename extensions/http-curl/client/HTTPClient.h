@@ -44,6 +44,7 @@
 
 #include "utils/ByteArrayCallback.h"
 #include "controllers/SSLContextService.h"
+#include "core/FlowFileAttributes.h"
 #include "core/logging/Logger.h"
 #include "core/logging/LoggerConfiguration.h"
 #include "properties/Configure.h"
@@ -99,7 +100,7 @@ class HTTPClient : public BaseHTTPClient, public core::Connectable {
 
   virtual void setReadCallback(HTTPReadCallback *callbackObj);
 
-  struct curl_slist *build_header_list(std::string regex, const std::map<std::string, std::string> &attributes);
+  struct curl_slist *build_header_list(std::string regex, const core::FlowFileAttributes &attributes);
 
   void setContentType(std::string content_type) override;
 
@@ -29,6 +29,9 @@
 #include "utils/StringUtils.h"
 #include "utils/file/FileManager.h"
 #include "utils/FileOutputCallback.h"
+#include "io/ZlibStream.h"
+#include "core/Property.h"
+#include "utils/GeneralUtils.h"
 
 namespace org {
 namespace apache {
@@ -36,8 +39,21 @@ namespace nifi {
 namespace minifi {
 namespace c2 {
 
+namespace {
+
+std::string gzip(const std::string &data) {
+  io::ZlibCompressStream compressStream;
+  compressStream.write(reinterpret_cast<uint8_t*>(const_cast<char*>(data.data())), data.size());
+  compressStream.closeStream();
+  return std::string(reinterpret_cast<const char*>(compressStream.getBuffer()), compressStream.getSize());
+}
+
+}  // namespace
+
 RESTSender::RESTSender(const std::string &name, const utils::Identifier &uuid)
     : C2Protocol(name, uuid),
+      gzip_heartbeats_(false),
+      last_response_code_(0),
       logger_(logging::LoggerFactory<Connectable>::getLogger()) {
 }
 
@@ -56,11 +72,30 @@ void RESTSender::initialize(const std::shared_ptr<core::controller::ControllerSe
     }
     configure->get("nifi.c2.rest.heartbeat.minimize.updates", "c2.rest.heartbeat.minimize.updates", update_str);
     utils::StringUtils::StringToBool(update_str, minimize_updates_);
+
+    std::string delta_str, full_interval_str, gzip_str;
+    bool delta_heartbeats = false;
+    if (configure->get("nifi.c2.rest.heartbeat.delta", "c2.rest.heartbeat.delta", delta_str) && utils::StringUtils::StringToBool(delta_str, delta_heartbeats) && delta_heartbeats) {
+      uint32_t full_interval = 20;
+      if (configure->get("nifi.c2.rest.heartbeat.full.interval", "c2.rest.heartbeat.full.interval", full_interval_str)) {
+        core::Property::StringToInt(full_interval_str, full_interval);
+      }
+      delta_encoder_ = utils::make_unique<HeartbeatDeltaEncoder>(full_interval);
+      logger_->log_debug("Sending delta heartbeats with a full one every %u heartbeats", full_interval);
+    }
+    bool gzip_heartbeats = false;
+    if (configure->get("nifi.c2.rest.heartbeat.gzip", "c2.rest.heartbeat.gzip", gzip_str)) {
+      utils::StringUtils::StringToBool(gzip_str, gzip_heartbeats);
+    }
+    gzip_heartbeats_ = gzip_heartbeats;
   }
   logger_->log_debug("Submitting to %s", rest_uri_);
 }
 
 C2Payload RESTSender::consumePayload(const std::string &url, const C2Payload &payload, Direction direction, bool async) {
+  if (direction == Direction::TRANSMIT && payload.getOperation() == HEARTBEAT && (delta_encoder_ != nullptr || gzip_heartbeats_)) {
+    return sendHeartbeat(url, payload);
+  }
   std::string outputConfig;
 
   if (direction == Direction::TRANSMIT) {
@@ -76,6 +111,39 @@ C2Payload RESTSender::consumePayload(const C2Payload &payload, Direction directi
   return consumePayload(rest_uri_, payload, direction, async);
 }
 
+C2Payload RESTSender::sendHeartbeat(const std::string &url, const C2Payload &payload) {
+  std::lock_guard<std::mutex> lock(update_mutex_);
+  std::string outputConfig;
+  if (delta_encoder_ != nullptr) {
+    rapidjson::Document json_payload;
+    buildJsonRootPayload(payload, json_payload);
+    outputConfig = delta_encoder_->encode(std::move(json_payload));
+  } else {
+    outputConfig = serializeJsonRootPayload(payload);
+  }
+
+  C2Payload response(payload.getOperation(), state::UpdateState::READ_ERROR, true);
+  if (gzip_heartbeats_) {
+    response = sendPayload(url, Direction::TRANSMIT, payload, gzip(outputConfig), true);
+    if (last_response_code_ == 415) {
+      logger_->log_warn("%s does not accept gzip compressed heartbeats, sending them uncompressed", url);
+      gzip_heartbeats_ = false;
+    }
+  }
+  if (!gzip_heartbeats_) {
+    response = sendPayload(url, Direction::TRANSMIT, payload, outputConfig);
+  }
+
+  if (delta_encoder_ != nullptr) {
+    if (last_response_code_ >= 200 && last_response_code_ < 300) {
+      delta_encoder_->acknowledge();
+    } else {
+      delta_encoder_->reject();
+    }
+  }
+  return response;
+}
+
 void RESTSender::update(const std::shared_ptr<Configure> &configure) {
   std::string url;
   configure->get("nifi.c2.rest.url", "c2.rest.url", url);
@@ -89,7 +157,8 @@ void RESTSender::setSecurityContext(utils::HTTPClient &client, const std::string
   client.initialize(type, url, generatedService);
 }
 
-const C2Payload RESTSender::sendPayload(const std::string url, const Direction direction, const C2Payload &payload, const std::string outputConfig) {
+const C2Payload RESTSender::sendPayload(const std::string url, const Direction direction, const C2Payload &payload, const std::string outputConfig, bool gzipped) {
+  last_response_code_ = 0;
   if (url.empty()) {
     return C2Payload(payload.getOperation(), state::UpdateState::READ_ERROR, true);
   }
@@ -119,6 +188,9 @@ const C2Payload RESTSender::sendPayload(const std::string url, const Direction d
     }
     client.setUploadCallback(callback.get());
     client.setPostSize(outputConfig.size());
+    if (gzipped) {
+      client.appendHeader("Content-Encoding: gzip");
+    }
   } else {
     // we do not need to set the upload callback
     // since we are not uploading anything on a get
@@ -141,6 +213,7 @@ const C2Payload RESTSender::sendPayload(const std::string url, const Direction d
   }
   bool isOkay = client.submit();
   int64_t respCode = client.getResponseCode();
+  last_response_code_ = respCode;
   auto rs = client.getResponseBody();
   if (isOkay && respCode) {
     if (payload.isRaw()) {
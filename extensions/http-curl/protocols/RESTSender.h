@@ -19,11 +19,14 @@
 #define LIBMINIFI_INCLUDE_C2_RESTSENDER_H_
 
 #include <string>
+#include <atomic>
+#include <memory>
 #include <mutex>
 
 #include "utils/ByteArrayCallback.h"
 #include "c2/C2Protocol.h"
 #include "c2/protocols/RESTProtocol.h"
+#include "c2/protocols/HeartbeatDeltaEncoder.h"
 #include "c2/HeartBeatReporter.h"
 #include "controllers/SSLContextService.h"
 #include "../client/HTTPClient.h"
@@ -60,7 +63,10 @@ class RESTSender : public RESTProtocol, public C2Protocol {
 
  protected:
 
-  virtual const C2Payload sendPayload(const std::string url, const Direction direction, const C2Payload &payload, const std::string outputConfig);
+  virtual const C2Payload sendPayload(const std::string url, const Direction direction, const C2Payload &payload, const std::string outputConfig, bool gzipped = false);
+
+  // serializes, encodes and sends a heartbeat
+  C2Payload sendHeartbeat(const std::string &url, const C2Payload &payload);
 
   /**
    * Initializes the SSLContextService onto the HTTP client if one is needed
@@ -75,6 +81,13 @@ class RESTSender : public RESTProtocol, public C2Protocol {
   std::string rest_uri_;
   std::string ack_uri_;
 
+  // set when heartbeats are sent as deltas
+  std::unique_ptr<HeartbeatDeltaEncoder> delta_encoder_;
+  // whether heartbeats are gzip compressed, cleared if the server does not support it
+  std::atomic<bool> gzip_heartbeats_;
+  // HTTP status of the last request, 0 if it got none
+  int64_t last_response_code_;
+
  private:
   std::shared_ptr<logging::Logger> logger_;
 };
@@ -0,0 +1,373 @@
+/**
+ * @file ConsumeKafka.cpp
+ * ConsumeKafka class implementation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ConsumeKafka.h"
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utils/StringUtils.h"
+#include "utils/GeneralUtils.h"
+#include "core/ProcessContext.h"
+#include "core/ProcessSession.h"
+#include "core/TypedValues.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace processors {
+
+const core::Property ConsumeKafka::SeedBrokers(
+    core::PropertyBuilder::createProperty("Known Brokers")->withDescription("A comma-separated list of known Kafka Brokers in the format <host>:<port>")
+        ->isRequired(true)->supportsExpressionLanguage(true)->build());
+
+const core::Property ConsumeKafka::TopicNames(
+    core::PropertyBuilder::createProperty("Topic Names")->withDescription("A comma-separated list of the Kafka Topics to consume from")
+        ->isRequired(true)->supportsExpressionLanguage(true)->build());
+
+const core::Property ConsumeKafka::GroupID(
+    core::PropertyBuilder::createProperty("Group ID")->withDescription("The Kafka consumer group the processor joins. Offsets are committed for this group.")
+        ->isRequired(true)->supportsExpressionLanguage(true)->build());
+
+const core::Property ConsumeKafka::ClientName(
+    core::PropertyBuilder::createProperty("Client Name")->withDescription("Client Name to use when communicating with Kafka")
+        ->isRequired(false)->supportsExpressionLanguage(true)->build());
+
+const core::Property ConsumeKafka::OffsetReset(
+    core::PropertyBuilder::createProperty("Offset Reset")->withDescription("Where to start consuming when the group has no committed offset for a partition, "
+                                                                           "or the committed offset no longer exists")
+        ->isRequired(false)->withDefaultValue<std::string>(OFFSET_RESET_LATEST)
+        ->withAllowableValues<std::string>({OFFSET_RESET_EARLIEST, OFFSET_RESET_LATEST, OFFSET_RESET_NONE})->build());
+
+const core::Property ConsumeKafka::MessageDemarcator(
+    core::PropertyBuilder::createProperty("Message Demarcator")->withDescription("If set, all the messages of a topic partition received in one poll are written "
+                                                                                 "to a single FlowFile, separated by this string. Otherwise each message becomes a FlowFile.")
+        ->isRequired(false)->build());
+
+const core::Property ConsumeKafka::MaxPollRecords(
+    core::PropertyBuilder::createProperty("Max Poll Records")->withDescription("The maximum number of messages consumed in a single trigger")
+        ->isRequired(false)->withDefaultValue<uint32_t>(10000)->build());
+
+const core::Property ConsumeKafka::MaxPollTime(
+    core::PropertyBuilder::createProperty("Max Poll Time")->withDescription("The maximum time a trigger waits for <Max Poll Records> messages to arrive")
+        ->isRequired(false)->withDefaultValue<core::TimePeriodValue>("1 sec")->build());
+
+const core::Property ConsumeKafka::DebugContexts("Debug contexts", "A comma-separated list of debug contexts to enable."
+                                                 "Including: generic, broker, topic, metadata, feature, queue, msg, protocol, cgrp, security, fetch, interceptor, plugin, consumer, admin, eos, all", "");
+
+const core::Relationship ConsumeKafka::Success("success", "FlowFiles received from Kafka are routed to this Relationship");
+
+namespace {
+struct rd_kafka_conf_deleter {
+  void operator()(rd_kafka_conf_t* p) const noexcept { rd_kafka_conf_destroy(p); }
+};
+struct rd_kafka_topic_partition_list_deleter {
+  void operator()(rd_kafka_topic_partition_list_t* p) const noexcept { rd_kafka_topic_partition_list_destroy(p); }
+};
+using rd_kafka_topic_partition_list_unique_ptr = std::unique_ptr<rd_kafka_topic_partition_list_t, rd_kafka_topic_partition_list_deleter>;
+
+const std::string PREFIX_ERROR_MSG = "ConsumeKafka: configure error result: ";
+
+void setConf(rd_kafka_conf_t* conf, const std::string& name, const std::string& value) {
+  std::array<char, 512U> errstr{};
+  if (rd_kafka_conf_set(conf, name.c_str(), value.c_str(), errstr.data(), errstr.size()) != RD_KAFKA_CONF_OK) {
+    throw Exception(PROCESS_SCHEDULE_EXCEPTION, utils::StringUtils::join_pack(PREFIX_ERROR_MSG, errstr.data()));
+  }
+}
+}  // namespace
+
+void ConsumeKafka::initialize() {
+  // Set the supported properties
+  std::set<core::Property> properties;
+  properties.insert(SeedBrokers);
+  properties.insert(TopicNames);
+  properties.insert(GroupID);
+  properties.insert(ClientName);
+  properties.insert(OffsetReset);
+  properties.insert(MessageDemarcator);
+  properties.insert(MaxPollRecords);
+  properties.insert(MaxPollTime);
+  properties.insert(DebugContexts);
+  setSupportedProperties(properties);
+  // Set the supported relationships
+  std::set<core::Relationship> relationships;
+  relationships.insert(Success);
+  setSupportedRelationships(relationships);
+}
+
+void ConsumeKafka::onSchedule(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory) {
+  std::lock_guard<std::mutex> lock_connection(connection_mutex_);
+  stop();
+
+  std::string value;
+  std::vector<std::string> topics;
+  if (context->getProperty(TopicNames.getName(), value)) {
+    for (const auto& topic : utils::StringUtils::split(value, ",")) {
+      const std::string trimmed = utils::StringUtils::trim(topic);
+      if (!trimmed.empty()) {
+        topics.push_back(trimmed);
+      }
+    }
+  }
+  if (topics.empty()) {
+    throw Exception(PROCESS_SCHEDULE_EXCEPTION, "Topic Names property missing or invalid");
+  }
+
+  context->getProperty(MaxPollRecords.getName(), max_poll_records_);
+  max_poll_records_ = std::max<uint32_t>(max_poll_records_, 1);
+  logger_->log_debug("ConsumeKafka: Max Poll Records [%lu]", max_poll_records_);
+
+  value = "";
+  if (context->getProperty(MaxPollTime.getName(), value) && !value.empty()) {
+    core::TimeUnit unit;
+    int64_t valInt;
+    if (core::Property::StringToTime(value, valInt, unit) && core::Property::ConvertTimeUnitToMS(valInt, unit, valInt)) {
+      max_poll_time_ms_ = valInt;
+    }
+  }
+  logger_->log_debug("ConsumeKafka: Max Poll Time [%lld ms]", max_poll_time_ms_);
+
+  demarcator_ = "";
+  use_demarcator_ = context->getProperty(MessageDemarcator.getName(), demarcator_) && !demarcator_.empty();
+
+  configureNewConnection(context, topics);
+  poll_buffer_.resize(max_poll_records_);
+
+  logger_->log_debug("Successfully configured ConsumeKafka");
+}
+
+void ConsumeKafka::configureNewConnection(const std::shared_ptr<core::ProcessContext> &context, const std::vector<std::string>& topics) {
+  std::string value;
+  KafkaConnectionKey key;
+  if (!context->getProperty(SeedBrokers.getName(), key.brokers_) || key.brokers_.empty()) {
+    throw Exception(PROCESS_SCHEDULE_EXCEPTION, "Known Brokers property missing or invalid");
+  }
+  std::string group_id;
+  if (!context->getProperty(GroupID.getName(), group_id) || group_id.empty()) {
+    throw Exception(PROCESS_SCHEDULE_EXCEPTION, "Group ID property missing or invalid");
+  }
+  if (!context->getProperty(ClientName.getName(), key.client_id_) || key.client_id_.empty()) {
+    key.client_id_ = getUUIDStr();
+  }
+
+  std::unique_ptr<rd_kafka_conf_t, rd_kafka_conf_deleter> conf{ rd_kafka_conf_new() };
+  if (conf == nullptr) {
+    throw Exception(PROCESS_SCHEDULE_EXCEPTION, "Failed to create rd_kafka_conf_t object");
+  }
+
+  setConf(conf.get(), "bootstrap.servers", key.brokers_);
+  logger_->log_debug("ConsumeKafka: bootstrap.servers [%s]", key.brokers_);
+  setConf(conf.get(), "client.id", key.client_id_);
+  logger_->log_debug("ConsumeKafka: client.id [%s]", key.client_id_);
+  setConf(conf.get(), "group.id", group_id);
+  logger_->log_debug("ConsumeKafka: group.id [%s]", group_id);
+
+  // offsets are committed explicitly, once the FlowFiles made of the messages are committed
+  setConf(conf.get(), "enable.auto.commit", "false");
+  setConf(conf.get(), "enable.auto.offset.store", "false");
+  setConf(conf.get(), "enable.partition.eof", "false");
+
+  value = "";
+  if (context->getProperty(OffsetReset.getName(), value) && !value.empty()) {
+    setConf(conf.get(), "auto.offset.reset", value == OFFSET_RESET_NONE ? "error" : value);
+    logger_->log_debug("ConsumeKafka: auto.offset.reset [%s]", value);
+  }
+  value = "";
+  if (context->getProperty(DebugContexts.getName(), value) && !value.empty()) {
+    setConf(conf.get(), "debug", value);
+    logger_->log_debug("ConsumeKafka: debug [%s]", value);
+  }
+
+  // Add all of the dynamic properties as librdkafka configurations
+  const auto &dynamic_prop_keys = context->getDynamicPropertyKeys();
+  logger_->log_info("ConsumeKafka registering %d librdkafka dynamic properties", dynamic_prop_keys.size());
+  for (const auto &prop_key : dynamic_prop_keys) {
+    value = "";
+    if (context->getDynamicProperty(prop_key, value) && !value.empty()) {
+      logger_->log_debug("ConsumeKafka: DynamicProperty: [%s] -> [%s]", prop_key, value);
+      setConf(conf.get(), prop_key, value);
+    } else {
+      logger_->log_warn("ConsumeKafka Dynamic Property '%s' is empty and therefore will not be configured", prop_key);
+    }
+  }
+
+  rd_kafka_conf_set_log_cb(conf.get(), &KafkaConnection::logCallback);
+
+  std::array<char, 512U> errstr{};
+  // The consumer takes ownership of the configuration, we must not free it
+  gsl::owner<rd_kafka_t*> consumer = rd_kafka_new(RD_KAFKA_CONSUMER, conf.release(), errstr.data(), errstr.size());
+  if (consumer == nullptr) {
+    auto error_msg = utils::StringUtils::join_pack("Failed to create Kafka consumer ", errstr.data());
+    throw Exception(PROCESS_SCHEDULE_EXCEPTION, error_msg);
+  }
+  conn_ = utils::make_unique<KafkaConnection>(key);
+  conn_->setConsumerConnection(consumer);
+
+  rd_kafka_topic_partition_list_unique_ptr subscription{ rd_kafka_topic_partition_list_new(static_cast<int>(topics.size())) };
+  for (const auto& topic : topics) {
+    rd_kafka_topic_partition_list_add(subscription.get(), topic.c_str(), RD_KAFKA_PARTITION_UA);
+  }
+  const rd_kafka_resp_err_t err = rd_kafka_subscribe(consumer, subscription.get());
+  if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+    conn_.reset();
+    throw Exception(PROCESS_SCHEDULE_EXCEPTION, utils::StringUtils::join_pack("ConsumeKafka: failed to subscribe: ", rd_kafka_err2str(err)));
+  }
+
+  // messages, rebalance events and errors all arrive on the consumer queue, which onTrigger drains in batches
+  queue_ = rd_kafka_queue_get_consumer(consumer);
+}
+
+void ConsumeKafka::notifyStop() {
+  logger_->log_debug("notifyStop called");
+  std::lock_guard<std::mutex> lock_connection(connection_mutex_);
+  stop();
+}
+
+void ConsumeKafka::stop() {
+  if (queue_ != nullptr) {
+    rd_kafka_queue_destroy(queue_);
+    queue_ = nullptr;
+  }
+  conn_.reset();
+}
+
+void ConsumeKafka::onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) {
+  std::lock_guard<std::mutex> lock_connection(connection_mutex_);
+  if (queue_ == nullptr) {
+    context->yield();
+    return;
+  }
+
+  const ssize_t count = rd_kafka_consume_batch_queue(queue_, static_cast<int>(max_poll_time_ms_), poll_buffer_.data(), poll_buffer_.size());
+  if (count <= 0) {
+    if (count < 0) {
+      logger_->log_error("ConsumeKafka: failed to consume, error: %s", rd_kafka_err2str(rd_kafka_last_error()));
+    }
+    context->yield();
+    return;
+  }
+  logger_->log_debug("ConsumeKafka consumed %zd messages", count);
+
+  // the payloads are referenced until the content is written, the messages are destroyed however we leave
+  const auto destroyMessages = gsl::finally([&]() {
+    for (ssize_t i = 0; i < count; i++) {
+      rd_kafka_message_destroy(poll_buffer_[i]);
+    }
+  });
+
+  const Partitions partitions = groupByPartition(poll_buffer_.data(), static_cast<size_t>(count));
+  if (partitions.empty()) {
+    return;
+  }
+
+  rd_kafka_topic_partition_list_unique_ptr offsets{ rd_kafka_topic_partition_list_new(static_cast<int>(partitions.size())) };
+  for (const auto& partition : partitions) {
+    transferMessages(*session, partition.second);
+    // the committed offset is the one of the next message to consume
+    rd_kafka_topic_partition_list_add(offsets.get(), partition.first.first.c_str(), partition.first.second)->offset = partition.second.back()->offset + 1;
+  }
+
+  // at least once: offsets are only committed once the FlowFiles are persisted
+  commitSession(*session, partitions);
+  const rd_kafka_resp_err_t err = rd_kafka_commit(conn_->getConnection(), offsets.get(), 1 /*async*/);
+  if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+    logger_->log_warn("ConsumeKafka: failed to commit offsets, messages may be consumed again, error: %s", rd_kafka_err2str(err));
+  }
+}
+
+ConsumeKafka::Partitions ConsumeKafka::groupByPartition(rd_kafka_message_t* const* messages, size_t count) const {
+  // keeps the order of the messages within each partition
+  Partitions partitions;
+  for (size_t i = 0; i < count; i++) {
+    rd_kafka_message_t* message = messages[i];
+    if (message->err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+      if (message->err != RD_KAFKA_RESP_ERR__PARTITION_EOF) {
+        logger_->log_error("ConsumeKafka: consumer error: %s", rd_kafka_err2str(message->err));
+      }
+      continue;
+    }
+    partitions[std::make_pair(std::string(rd_kafka_topic_name(message->rkt)), message->partition)].push_back(message);
+  }
+  return partitions;
+}
+
+void ConsumeKafka::commitSession(core::ProcessSession& session, const Partitions& partitions) {
+  try {
+    session.commit();
+  } catch (...) {
+    // rewind, so that the messages of the failed session are consumed again
+    for (const auto& partition : partitions) {
+      rewind(*partition.second.front());
+    }
+    throw;
+  }
+}
+
+void ConsumeKafka::rewind(const rd_kafka_message_t& message) {
+  const rd_kafka_resp_err_t err = rd_kafka_seek(message.rkt, message.partition, message.offset, static_cast<int>(max_poll_time_ms_));
+  if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+    logger_->log_error("ConsumeKafka: failed to rewind partition %d of %s, error: %s", message.partition, rd_kafka_topic_name(message.rkt), rd_kafka_err2str(err));
+  }
+}
+
+void ConsumeKafka::transferMessages(core::ProcessSession& session, const std::vector<rd_kafka_message_t*>& messages) {
+  const rd_kafka_message_t* first = messages.front();
+  const std::string topic = rd_kafka_topic_name(first->rkt);
+  const std::string partition = std::to_string(first->partition);
+
+  if (use_demarcator_) {
+    std::shared_ptr<core::FlowFile> flowFile = session.create();
+    ConsumeKafka::WriteCallback callback(messages, demarcator_);
+    session.write(flowFile, &callback);
+    session.putAttribute(flowFile, "kafka.topic", topic);
+    session.putAttribute(flowFile, "kafka.partition", partition);
+    session.putAttribute(flowFile, "kafka.offset", std::to_string(first->offset));
+    session.putAttribute(flowFile, "kafka.count", std::to_string(messages.size()));
+    session.transfer(flowFile, Success);
+    return;
+  }
+
+  std::vector<rd_kafka_message_t*> single(1);
+  for (rd_kafka_message_t* message : messages) {
+    single[0] = message;
+    std::shared_ptr<core::FlowFile> flowFile = session.create();
+    ConsumeKafka::WriteCallback callback(single, demarcator_);
+    session.write(flowFile, &callback);
+    session.putAttribute(flowFile, "kafka.topic", topic);
+    session.putAttribute(flowFile, "kafka.partition", partition);
+    session.putAttribute(flowFile, "kafka.offset", std::to_string(message->offset));
+    if (message->key != nullptr && message->key_len > 0) {
+      session.putAttribute(flowFile, "kafka.key", std::string(static_cast<const char*>(message->key), message->key_len));
+    }
+    session.transfer(flowFile, Success);
+  }
+}
+
+}  // namespace processors
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
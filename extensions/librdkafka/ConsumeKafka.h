@@ -0,0 +1,175 @@
+/**
+ * @file ConsumeKafka.h
+ * ConsumeKafka class declaration
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXTENSIONS_LIBRDKAFKA_CONSUMEKAFKA_H_
+#define EXTENSIONS_LIBRDKAFKA_CONSUMEKAFKA_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/Processor.h"
+#include "core/ProcessSession.h"
+#include "core/Core.h"
+#include "core/Resource.h"
+#include "core/Property.h"
+#include "core/logging/LoggerConfiguration.h"
+#include "core/logging/Logger.h"
+#include "rdkafka.h"
+#include "KafkaConnection.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace processors {
+
+#define OFFSET_RESET_EARLIEST "earliest"
+#define OFFSET_RESET_LATEST "latest"
+#define OFFSET_RESET_NONE "none"
+
+// ConsumeKafka Class
+class ConsumeKafka : public core::Processor {
+ public:
+  // Constructor
+  /*!
+   * Create a new processor
+   */
+  explicit ConsumeKafka(std::string name, utils::Identifier uuid = utils::Identifier())
+      : core::Processor(std::move(name), uuid),
+        logger_(logging::LoggerFactory<ConsumeKafka>::getLogger()),
+        max_poll_records_(10000),
+        max_poll_time_ms_(1000),
+        use_demarcator_(false),
+        queue_(nullptr) {
+  }
+
+  virtual ~ConsumeKafka() {
+    stop();
+  }
+
+  static constexpr char const* ProcessorName = "ConsumeKafka";
+
+  // Supported Properties
+  static const core::Property SeedBrokers;
+  static const core::Property TopicNames;
+  static const core::Property GroupID;
+  static const core::Property ClientName;
+  static const core::Property OffsetReset;
+  static const core::Property MessageDemarcator;
+  static const core::Property MaxPollRecords;
+  static const core::Property MaxPollTime;
+  static const core::Property DebugContexts;
+
+  // Supported Relationships
+  static const core::Relationship Success;
+
+  /**
+   * Writes the payloads of consumed messages straight from the librdkafka buffers,
+   * separated by the demarcator.
+   */
+  class WriteCallback : public OutputStreamCallback {
+   public:
+    WriteCallback(const std::vector<rd_kafka_message_t*>& messages, const std::string& demarcator)
+        : messages_(messages),
+          demarcator_(demarcator) {
+    }
+
+    int64_t process(std::shared_ptr<io::BaseStream> stream) {
+      int64_t written = 0;
+      for (size_t i = 0; i < messages_.size(); i++) {
+        if (i > 0 && !demarcator_.empty()) {
+          if (stream->write(reinterpret_cast<uint8_t*>(const_cast<char*>(demarcator_.data())), demarcator_.size()) < 0) {
+            return -1;
+          }
+          written += demarcator_.size();
+        }
+        if (messages_[i]->len > 0) {
+          if (stream->write(reinterpret_cast<uint8_t*>(messages_[i]->payload), messages_[i]->len) < 0) {
+            return -1;
+          }
+          written += messages_[i]->len;
+        }
+      }
+      return written;
+    }
+
+   private:
+    const std::vector<rd_kafka_message_t*>& messages_;
+    const std::string& demarcator_;
+  };
+
+ public:
+  bool supportsDynamicProperties() override {
+    return true;
+  }
+
+  void onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) override;
+  void initialize() override;
+  void onSchedule(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory) override;
+  void notifyStop() override;
+
+ protected:
+  // messages of a poll by topic and partition, in the order they were consumed
+  using Partitions = std::map<std::pair<std::string, int32_t>, std::vector<rd_kafka_message_t*>>;
+
+  void configureNewConnection(const std::shared_ptr<core::ProcessContext> &context, const std::vector<std::string>& topics);
+  // Groups the messages by topic partition, skipping the ones that only report an error
+  Partitions groupByPartition(rd_kafka_message_t* const* messages, size_t count) const;
+  // Transfers the messages of one topic partition, one FlowFile per message or a single demarcated FlowFile
+  void transferMessages(core::ProcessSession& session, const std::vector<rd_kafka_message_t*>& messages);
+  // Commits the session, rewinding every partition to its first message if that fails
+  void commitSession(core::ProcessSession& session, const Partitions& partitions);
+  // Seeks the partition of the message back to it, so that it is consumed again
+  virtual void rewind(const rd_kafka_message_t& message);
+
+ private:
+  void stop();
+
+  std::shared_ptr<logging::Logger> logger_;
+
+  std::unique_ptr<KafkaConnection> conn_;
+  std::mutex connection_mutex_;
+
+  uint32_t max_poll_records_;
+  int64_t max_poll_time_ms_;
+  bool use_demarcator_;
+  std::string demarcator_;
+
+  // consumer queue of the connection, destroyed before the connection
+  rd_kafka_queue_t* queue_;
+  // receives the messages of a poll, reused across triggers
+  std::vector<rd_kafka_message_t*> poll_buffer_;
+};
+
+REGISTER_RESOURCE(ConsumeKafka, "Consumes messages from Apache Kafka topics. Many messages are polled at once, and each becomes a FlowFile, "
+                  "or, if a <Message Demarcator> is set, the messages of a topic partition are bundled into a single FlowFile. "
+                  "Offsets are committed to Kafka only after the FlowFiles have been committed to the session.");
+
+}  // namespace processors
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
+
+#endif  // EXTENSIONS_LIBRDKAFKA_CONSUMEKAFKA_H_
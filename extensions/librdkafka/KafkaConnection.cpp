@@ -27,6 +27,7 @@ namespace processors {
 
 KafkaConnection::KafkaConnection(const KafkaConnectionKey &key)
     : logger_(logging::LoggerFactory<KafkaConnection>::getLogger()),
+      consumer_(false),
       kafka_connection_(nullptr),
       poll_(false) {
   initialized_ = false;
@@ -46,7 +47,11 @@ void KafkaConnection::removeConnection() {
   logger_->log_trace("KafkaConnection::removeConnection START: Client = %s -- Broker = %s", key_.client_id_, key_.brokers_);
   stopPoll();
   if (kafka_connection_) {
-    rd_kafka_flush(kafka_connection_, 10 * 1000); /* wait for max 10 seconds */
+    if (consumer_) {
+      rd_kafka_consumer_close(kafka_connection_);
+    } else {
+      rd_kafka_flush(kafka_connection_, 10 * 1000); /* wait for max 10 seconds */
+    }
     rd_kafka_destroy(kafka_connection_);
     modifyLoggers([&](std::unordered_map<const rd_kafka_t*, std::weak_ptr<logging::Logger>>& loggers) {
       loggers.erase(kafka_connection_);
@@ -54,6 +59,7 @@ void KafkaConnection::removeConnection() {
     kafka_connection_ = nullptr;
   }
   initialized_ = false;
+  consumer_ = false;
   logger_->log_trace("KafkaConnection::removeConnection FINISH: Client = %s -- Broker = %s", key_.client_id_, key_.brokers_);
 }
 
@@ -71,6 +77,16 @@ void KafkaConnection::setConnection(gsl::owner<rd_kafka_t*> producer) {
   startPoll();
 }
 
+void KafkaConnection::setConsumerConnection(gsl::owner<rd_kafka_t*> consumer) {
+  removeConnection();
+  kafka_connection_ = consumer;  // kafka_connection_ takes ownership from consumer
+  initialized_ = true;
+  consumer_ = true;
+  modifyLoggers([&](std::unordered_map<const rd_kafka_t*, std::weak_ptr<logging::Logger>>& loggers) {
+    loggers[consumer] = logger_;
+  });
+}
+
 rd_kafka_t *KafkaConnection::getConnection() const {
   return kafka_connection_;
 }
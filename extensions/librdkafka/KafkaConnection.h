@@ -64,6 +64,12 @@ class KafkaConnection {
 
   void setConnection(gsl::owner<rd_kafka_t*> producer);
 
+  /**
+   * Takes ownership of a consumer. Unlike producers, consumers are not polled in the background,
+   * their owner serves the consumer queue itself.
+   */
+  void setConsumerConnection(gsl::owner<rd_kafka_t*> consumer);
+
   rd_kafka_t *getConnection() const;
 
   bool hasTopic(const std::string &topic) const;
@@ -81,6 +87,8 @@ class KafkaConnection {
 
   bool initialized_;
 
+  bool consumer_;
+
   KafkaConnectionKey key_;
 
   std::map<std::string, std::shared_ptr<KafkaTopic>> topics_;
@@ -133,6 +133,14 @@ const core::Property PublishKafka::FailEmptyFlowFiles(
         ->isRequired(false)
         ->withDefaultValue<bool>(true)
         ->build());
+const core::Property PublishKafka::MaxPendingBatches(
+    core::PropertyBuilder::createProperty("Max Pending Batches")
+        ->withDescription("The maximum number of batches whose delivery reports are awaited asynchronously while the next batch is produced. "
+                          "Their FlowFiles are transferred in a later session once all of their messages are acknowledged. "
+                          "0 means that every trigger waits for the delivery of its batch.")
+        ->isRequired(false)
+        ->withDefaultValue<uint32_t>(0)
+        ->build());
 
 const core::Relationship PublishKafka::Success("success", "Any FlowFile that is successfully sent to Kafka will be routed to this Relationship");
 const core::Relationship PublishKafka::Failure("failure", "Any FlowFile that cannot be sent to Kafka will be routed to this Relationship");
@@ -176,6 +184,7 @@ void PublishKafka::initialize() {
   properties.insert(MessageKeyField);
   properties.insert(DebugContexts);
   properties.insert(FailEmptyFlowFiles);
+  properties.insert(MaxPendingBatches);
   setSupportedProperties(properties);
   // Set the supported relationships
   std::set<core::Relationship> relationships;
@@ -210,6 +219,12 @@ void PublishKafka::onSchedule(const std::shared_ptr<core::ProcessContext> &conte
   context->getProperty(MaxFlowSegSize.getName(), max_flow_seg_size_);
   logger_->log_debug("PublishKafka: Max Flow Segment Size [%llu]", max_flow_seg_size_);
 
+  // Max Pending Batches
+  max_pending_batches_ = 0;
+  context->getProperty(MaxPendingBatches.getName(), max_pending_batches_);
+  logger_->log_debug("PublishKafka: Max Pending Batches [%lu]", max_pending_batches_);
+  session_factory_ = sessionFactory;
+
   // Attributes to Send as Headers
   std::string value;
   if (context->getProperty(AttributeNameRegex.getName(), value) && !value.empty()) {
@@ -229,11 +244,20 @@ void PublishKafka::onSchedule(const std::shared_ptr<core::ProcessContext> &conte
 void PublishKafka::notifyStop() {
   logger_->log_debug("notifyStop called");
   interrupted_ = true;
-  std::lock_guard<std::mutex> lock(messages_mutex_);
-  for (auto& messages : messages_set_) {
-    messages->interrupt();
+  {
+    std::lock_guard<std::mutex> lock(messages_mutex_);
+    for (auto& messages : messages_set_) {
+      messages->interrupt();
+    }
   }
+  std::lock_guard<std::mutex> lock_connection(connection_mutex_);
+  // destroying the producer flushes it, so the delivery reports of the pending batches arrive before they are completed
   conn_.reset();
+  completePendingBatches(true);
+}
+
+bool PublishKafka::isWorkAvailable() {
+  return pending_batch_count_ > 0 || Processor::isWorkAvailable();
 }
 
 /**
@@ -560,11 +584,30 @@ void PublishKafka::onTrigger(const std::shared_ptr<core::ProcessContext> &contex
   std::lock_guard<std::mutex> lock_connection(connection_mutex_);
   logger_->log_debug("PublishKafka onTrigger");
 
+  const bool asynchronous = max_pending_batches_ > 0 && session_factory_ != nullptr;
+  if (asynchronous) {
+    completePendingBatches(false);
+  }
+  // the FlowFiles of an asynchronous batch are transferred by a later trigger, so they need a session of their own
+  const std::shared_ptr<core::ProcessSession> batch_session = asynchronous ? session_factory_->createSession() : session;
+  // set once the batch is queued, until then its FlowFiles have to go back to their queues if anything fails
+  bool pending = false;
+  const auto batchSessionGuard = gsl::finally([&]() {
+    if (!asynchronous || pending) {
+      return;
+    }
+    try {
+      batch_session->rollback();
+    } catch (const std::exception& exception) {
+      logger_->log_error("Failed to roll back the batch session: %s", exception.what());
+    }
+  });
+
   // Collect FlowFiles to process
   uint64_t actual_bytes = 0U;
   std::vector<std::shared_ptr<core::FlowFile>> flowFiles;
   for (uint32_t i = 0; i < batch_size_; i++) {
-    std::shared_ptr<core::FlowFile> flowFile = session->get();
+    std::shared_ptr<core::FlowFile> flowFile = batch_session->get();
     if (flowFile == nullptr) {
       break;
     }
@@ -575,7 +618,13 @@ void PublishKafka::onTrigger(const std::shared_ptr<core::ProcessContext> &contex
     }
   }
   if (flowFiles.empty()) {
-    context->yield();
+    if (pending_batches_.empty()) {
+      context->yield();
+    } else {
+      // nothing new to produce, so waiting for the oldest batch does not hold anything back
+      pending_batches_.front().messages->waitForCompletion();
+      completePendingBatches(false);
+    }
     return;
   }
   logger_->log_debug("Processing %lu flow files with a total size of %llu B", flowFiles.size(), actual_bytes);
@@ -585,9 +634,15 @@ void PublishKafka::onTrigger(const std::shared_ptr<core::ProcessContext> &contex
   {
     std::lock_guard<std::mutex> lock(messages_mutex_);
     messages_set_.emplace(messages);
+    if (interrupted_) {
+      messages->interrupt();
+    }
   }
-  // We also have to insure that it will be removed once we are done with it
+  // We also have to insure that it will be removed, unless it is left pending
   const auto messagesSetGuard = gsl::finally([&]() {
+    if (pending) {
+      return;
+    }
     std::lock_guard<std::mutex> lock(messages_mutex_);
     messages_set_.erase(messages);
   });
@@ -638,8 +693,8 @@ void PublishKafka::onTrigger(const std::shared_ptr<core::ProcessContext> &contex
     context->getProperty(FailEmptyFlowFiles.getName(), failEmptyFlowFiles);
 
     PublishKafka::ReadCallback callback(max_flow_seg_size_, kafkaKey, thisTopic->getTopic(), conn_->getConnection(), *flowFile,
-                                        attributeNameRegex_, messages, flow_file_index, failEmptyFlowFiles);
-    session->read(flowFile, &callback);
+                                        attributeNameRegex_, messages, flow_file_index, failEmptyFlowFiles, &buffer_pool_);
+    batch_session->read(flowFile, &callback);
 
     if (!callback.called_) {
       // workaround: call callback since ProcessSession doesn't do so for empty flow files without resource claims
@@ -662,12 +717,51 @@ void PublishKafka::onTrigger(const std::shared_ptr<core::ProcessContext> &contex
     }
   }
 
+  if (asynchronous) {
+    // ownership of the batch moves to the pending queue, it leaves the messages set once completed
+    pending_batches_.push_back(PendingBatch{batch_session, std::move(flowFiles), messages});
+    pending = true;
+    pending_batch_count_ = pending_batches_.size();
+    while (pending_batches_.size() > max_pending_batches_) {
+      logger_->log_trace("PublishKafka::onTrigger waiting for the oldest pending batch");
+      pending_batches_.front().messages->waitForCompletion();
+      completePendingBatches(false);
+    }
+    return;
+  }
+
   logger_->log_trace("PublishKafka::onTrigger waitForCompletion start");
   messages->waitForCompletion();
+  logger_->log_trace("PublishKafka::onTrigger waitForCompletion finish");
+  finishBatch(*session, flowFiles, std::move(messages));
+}
+
+void PublishKafka::completePendingBatches(bool wait) {
+  auto it = pending_batches_.begin();
+  while (it != pending_batches_.end()) {
+    if (wait) {
+      it->messages->waitForCompletion();
+    } else if (!it->messages->isComplete()) {
+      ++it;
+      continue;
+    }
+    PendingBatch batch = std::move(*it);
+    it = pending_batches_.erase(it);
+    finishBatch(*batch.session, batch.flow_files, std::move(batch.messages));
+    try {
+      batch.session->commit();
+    } catch (const std::exception& exception) {
+      logger_->log_error("Failed to commit the session of a delivered batch: %s", exception.what());
+      batch.session->rollback();
+    }
+  }
+  pending_batch_count_ = pending_batches_.size();
+}
+
+void PublishKafka::finishBatch(core::ProcessSession& session, const std::vector<std::shared_ptr<core::FlowFile>>& flowFiles, std::shared_ptr<Messages> messages) {
   if (messages->wasInterrupted()) {
     logger_->log_warn("Waiting for delivery confirmation was interrupted, some flow files might be routed to Failure, even if they were successfully delivered.");
   }
-  logger_->log_trace("PublishKafka::onTrigger waitForCompletion finish");
 
   messages->iterateFlowFiles([&](size_t index, const FlowFileResult& flow_file) {
     bool success;
@@ -700,11 +794,25 @@ void PublishKafka::onTrigger(const std::shared_ptr<core::ProcessContext> &contex
       }
     }
     if (success) {
-      session->transfer(flowFiles[index], Success);
+      session.transfer(flowFiles[index], Success);
     } else {
-      session->transfer(flowFiles[index], Failure);
+      session.transfer(flowFiles[index], Failure);
     }
   });
+
+  // the buffers can only be reused once no delivery callback refers to the batch any more
+  {
+    std::lock_guard<std::mutex> lock(messages_mutex_);
+    messages_set_.erase(messages);
+  }
+  if (messages.use_count() == 1 && !messages->wasInterrupted()) {
+    for (auto& buffer : messages->buffers) {
+      if (buffer_pool_.size() >= batch_size_) {
+        break;
+      }
+      buffer_pool_.push_back(std::move(buffer));
+    }
+  }
 }
 
 }  // namespace processors
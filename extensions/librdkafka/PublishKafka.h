@@ -28,6 +28,7 @@
 #include <set>
 #include <string>
 #include <condition_variable>
+#include <deque>
 #include <utility>
 #include <vector>
 
@@ -75,7 +76,8 @@ class PublishKafka : public core::Processor {
   explicit PublishKafka(std::string name, utils::Identifier uuid = utils::Identifier())
       : core::Processor(std::move(name), uuid),
         logger_(logging::LoggerFactory<PublishKafka>::getLogger()),
-        interrupted_(false) {
+        interrupted_(false),
+        pending_batch_count_(0) {
   }
 
   virtual ~PublishKafka() = default;
@@ -109,6 +111,7 @@ class PublishKafka : public core::Processor {
   static const core::Property MessageKeyField;
   static const core::Property DebugContexts;
   static const core::Property FailEmptyFlowFiles;
+  static const core::Property MaxPendingBatches;
 
   // Supported Relationships
   static const core::Relationship Failure;
@@ -135,27 +138,22 @@ class PublishKafka : public core::Processor {
     std::mutex mutex;
     std::condition_variable cv;
     std::vector<FlowFileResult> flow_files;
+    // payloads produced without copying, librdkafka references them until their delivery report arrives
+    std::vector<std::vector<unsigned char>> buffers;
     bool interrupted = false;
 
     void waitForCompletion() {
       std::unique_lock<std::mutex> lock(mutex);
       cv.wait(lock, [this]() -> bool {
-        if (interrupted) {
-          return true;
-        }
-        size_t index = 0U;
-        return std::all_of(this->flow_files.begin(), this->flow_files.end(), [&](const FlowFileResult& flow_file) {
-          index++;
-          if (flow_file.flow_file_error) {
-            return true;
-          }
-          return std::all_of(flow_file.messages.begin(), flow_file.messages.end(), [](const MessageResult& message) {
-            return message.status != MessageStatus::MESSAGESTATUS_UNCOMPLETE;
-          });
-        });
+        return interrupted || allDelivered();
       });
     }
 
+    bool isComplete() {
+      std::lock_guard<std::mutex> lock(mutex);
+      return interrupted || allDelivered();
+    }
+
     void modifyResult(size_t index, const std::function<void(FlowFileResult&)>& fun) {
       std::unique_lock<std::mutex> lock(mutex);
       fun(flow_files.at(index));
@@ -185,8 +183,29 @@ class PublishKafka : public core::Processor {
       std::lock_guard<std::mutex> lock(mutex);
       return interrupted;
     }
+
+    unsigned char* addBuffer(std::vector<unsigned char> buffer) {
+      std::lock_guard<std::mutex> lock(mutex);
+      buffers.push_back(std::move(buffer));
+      return buffers.back().data();
+    }
+
+   private:
+    bool allDelivered() const {
+      return std::all_of(flow_files.begin(), flow_files.end(), [](const FlowFileResult& flow_file) {
+        if (flow_file.flow_file_error) {
+          return true;
+        }
+        return std::all_of(flow_file.messages.begin(), flow_file.messages.end(), [](const MessageResult& message) {
+          return message.status != MessageStatus::MESSAGESTATUS_UNCOMPLETE;
+        });
+      });
+    }
   };
 
+  // Largest FlowFile produced without librdkafka copying its content
+  static constexpr uint64_t MAX_ZERO_COPY_MESSAGE_SIZE = 1024 * 1024;
+
   // Nest Callback Class for read stream
   class ReadCallback : public InputStreamCallback {
    public:
@@ -220,7 +239,7 @@ class PublishKafka : public core::Processor {
       return rd_kafka_headers_unique_ptr{ result };
     }
 
-    rd_kafka_resp_err_t produce(const size_t segment_num, std::vector<unsigned char>& buffer, const size_t buflen) const {
+    rd_kafka_resp_err_t produce(const size_t segment_num, unsigned char* buffer, const size_t buflen, const int msgflags) const {
       const std::shared_ptr<Messages> messages_ptr_copy = this->messages_;
       const auto flow_file_index_copy = this->flow_file_index_;
       const auto produce_callback = [messages_ptr_copy, flow_file_index_copy, segment_num](rd_kafka_t * /*rk*/, const rd_kafka_message_t *rkmessage) {
@@ -236,7 +255,7 @@ class PublishKafka : public core::Processor {
       allocate_message_object(segment_num);
 
       const gsl::owner<rd_kafka_headers_t*> hdrs_copy = rd_kafka_headers_copy(hdrs.get());
-      const auto err = rd_kafka_producev(rk_, RD_KAFKA_V_RKT(rkt_), RD_KAFKA_V_PARTITION(RD_KAFKA_PARTITION_UA), RD_KAFKA_V_MSGFLAGS(RD_KAFKA_MSG_F_COPY), RD_KAFKA_V_VALUE(buffer.data(), buflen),
+      const auto err = rd_kafka_producev(rk_, RD_KAFKA_V_RKT(rkt_), RD_KAFKA_V_PARTITION(RD_KAFKA_PARTITION_UA), RD_KAFKA_V_MSGFLAGS(msgflags), RD_KAFKA_V_VALUE(buffer, buflen),
                                          RD_KAFKA_V_HEADERS(hdrs_copy), RD_KAFKA_V_KEY(key_.c_str(), key_.size()), RD_KAFKA_V_OPAQUE(callback_ptr.get()), RD_KAFKA_V_END);
       if (err == RD_KAFKA_RESP_ERR_NO_ERROR) {
         // in case of failure, messageDeliveryCallback is not called and callback_ptr will delete the callback
@@ -258,7 +277,8 @@ class PublishKafka : public core::Processor {
                  utils::Regex &attributeNameRegex,
                  std::shared_ptr<Messages> messages,
                  const size_t flow_file_index,
-                 const bool fail_empty_flow_files)
+                 const bool fail_empty_flow_files,
+                 std::vector<std::vector<unsigned char>>* buffer_pool = nullptr)
         : flow_size_(flowFile.getSize()),
           max_seg_size_(max_seg_size == 0 || flow_size_ < max_seg_size ? flow_size_ : max_seg_size),
           key_(std::move(key)),
@@ -267,7 +287,8 @@ class PublishKafka : public core::Processor {
           hdrs(make_headers(flowFile, attributeNameRegex)),
           messages_(std::move(messages)),
           flow_file_index_(flow_file_index),
-          fail_empty_flow_files_(fail_empty_flow_files)
+          fail_empty_flow_files_(fail_empty_flow_files),
+          buffer_pool_(buffer_pool)
     { }
 
     int64_t process(const std::shared_ptr<io::BaseStream> stream) {
@@ -287,10 +308,14 @@ class PublishKafka : public core::Processor {
 
       // If the flow file is empty, we still want to send the message, unless the user wants to fail_empty_flow_files_
       if (flow_size_ == 0 && !fail_empty_flow_files_) {
-        produce(0, buffer, 0);
+        produce(0, buffer.data(), 0, RD_KAFKA_MSG_F_COPY);
         return 0;
       }
 
+      if (buffer_pool_ != nullptr && max_seg_size_ == flow_size_ && flow_size_ <= MAX_ZERO_COPY_MESSAGE_SIZE) {
+        return produceZeroCopy(stream);
+      }
+
       for (size_t segment_num = 0; read_size_ < flow_size_; ++segment_num) {
         const int readRet = stream->read(buffer.data(), buffer.size());
         if (readRet < 0) {
@@ -301,7 +326,7 @@ class PublishKafka : public core::Processor {
 
         if (readRet <= 0) { break; }
 
-        const auto err = produce(segment_num, buffer, readRet);
+        const auto err = produce(segment_num, buffer.data(), readRet, RD_KAFKA_MSG_F_COPY);
         if (err) {
           messages_->modifyResult(flow_file_index_, [segment_num, err](FlowFileResult& flow_file) {
             auto& message = flow_file.messages.at(segment_num);
@@ -317,6 +342,43 @@ class PublishKafka : public core::Processor {
       return read_size_;
     }
 
+    /**
+     * Produces the whole FlowFile as a single message from a pooled buffer that is handed over to
+     * the batch instead of being copied by librdkafka.
+     */
+    int64_t produceZeroCopy(const std::shared_ptr<io::BaseStream>& stream) {
+      std::vector<unsigned char> buffer;
+      if (!buffer_pool_->empty()) {
+        buffer = std::move(buffer_pool_->back());
+        buffer_pool_->pop_back();
+      }
+      buffer.resize(flow_size_);
+      while (static_cast<uint64_t>(read_size_) < flow_size_) {
+        const int readRet = stream->read(buffer.data() + read_size_, static_cast<int>(flow_size_ - read_size_));
+        if (readRet < 0) {
+          status_ = -1;
+          error_ = "Failed to read from stream";
+          buffer_pool_->push_back(std::move(buffer));
+          return read_size_;
+        }
+        if (readRet == 0) { break; }
+        read_size_ += readRet;
+      }
+
+      unsigned char* const data = messages_->addBuffer(std::move(buffer));
+      const auto err = produce(0, data, read_size_, 0);
+      if (err) {
+        messages_->modifyResult(flow_file_index_, [err](FlowFileResult& flow_file) {
+          auto& message = flow_file.messages.at(0);
+          message.status = MessageStatus::MESSAGESTATUS_ERROR;
+          message.err_code = err;
+        });
+        status_ = -1;
+        error_ = rd_kafka_err2str(err);
+      }
+      return read_size_;
+    }
+
     const uint64_t flow_size_ = 0;
     const uint64_t max_seg_size_ = 0;
     const std::string key_;
@@ -330,6 +392,7 @@ class PublishKafka : public core::Processor {
     int read_size_ = 0;
     bool called_ = false;
     const bool fail_empty_flow_files_ = true;
+    std::vector<std::vector<unsigned char>>* const buffer_pool_;
   };
 
  public:
@@ -347,12 +410,26 @@ class PublishKafka : public core::Processor {
   void initialize() override;
   void onSchedule(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory) override;
   void notifyStop() override;
+  // Also true while delivery reports of earlier batches are outstanding, so that they get completed
+  bool isWorkAvailable() override;
 
  protected:
   bool configureNewConnection(const std::shared_ptr<core::ProcessContext> &context);
   bool createNewTopic(const std::shared_ptr<core::ProcessContext> &context, const std::string& topic_name);
 
  private:
+  // Batch whose FlowFiles are transferred once all of its delivery reports have arrived
+  struct PendingBatch {
+    std::shared_ptr<core::ProcessSession> session;
+    std::vector<std::shared_ptr<core::FlowFile>> flow_files;
+    std::shared_ptr<Messages> messages;
+  };
+
+  // Routes the FlowFiles of a batch according to its delivery reports and recycles its buffers
+  void finishBatch(core::ProcessSession& session, const std::vector<std::shared_ptr<core::FlowFile>>& flowFiles, std::shared_ptr<Messages> messages);
+  // Commits the pending batches that are complete, or all of them if wait is set
+  void completePendingBatches(bool wait);
+
   static void messageDeliveryCallback(rd_kafka_t* rk, const rd_kafka_message_t* rkmessage, void* opaque);
 
   std::shared_ptr<logging::Logger> logger_;
@@ -369,6 +446,14 @@ class PublishKafka : public core::Processor {
   std::atomic<bool> interrupted_;
   std::mutex messages_mutex_;
   std::set<std::shared_ptr<Messages>> messages_set_;
+
+  uint32_t max_pending_batches_;
+  std::shared_ptr<core::ProcessSessionFactory> session_factory_;
+  // guarded by connection_mutex_
+  std::deque<PendingBatch> pending_batches_;
+  std::atomic<size_t> pending_batch_count_;
+  // guarded by connection_mutex_
+  std::vector<std::vector<unsigned char>> buffer_pool_;
 };
 
 REGISTER_RESOURCE(PublishKafka, "This Processor puts the contents of a FlowFile to a Topic in Apache Kafka. The content of a FlowFile becomes the contents of a Kafka message. "
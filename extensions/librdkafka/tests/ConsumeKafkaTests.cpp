@@ -0,0 +1,313 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "../../../libminifi/test/TestBase.h"
+#include "../../../libminifi/test/unit/ProvenanceTestHelper.h"
+#include "../ConsumeKafka.h"
+#include "Connection.h"
+#include "core/ProcessContext.h"
+#include "core/ProcessSession.h"
+#include "core/ProcessSessionFactory.h"
+#include "core/ProcessorNode.h"
+#include "core/repository/VolatileContentRepository.h"
+#include "io/BaseStream.h"
+#include "io/DataStream.h"
+#include "properties/Configure.h"
+
+namespace {
+
+using minifi::processors::ConsumeKafka;
+
+// nothing listens on this port, consumers can subscribe but never receive anything
+const char* const UNREACHABLE_BROKER = "127.0.0.1:1";
+
+// records the rewinds instead of seeking, as there is no broker to seek on
+class TestConsumeKafka : public ConsumeKafka {
+ public:
+  explicit TestConsumeKafka(std::string name)
+      : ConsumeKafka(std::move(name)) {
+  }
+
+  using ConsumeKafka::Partitions;
+  using ConsumeKafka::groupByPartition;
+  using ConsumeKafka::transferMessages;
+  using ConsumeKafka::commitSession;
+
+  void rewind(const rd_kafka_message_t& message) override {
+    rewound.emplace_back(rd_kafka_topic_name(message.rkt), message.partition, message.offset);
+  }
+
+  std::vector<std::tuple<std::string, int32_t, int64_t>> rewound;
+};
+
+// messages as librdkafka hands them over, owned by the test instead of librdkafka
+class Messages {
+ public:
+  Messages() {
+    std::array<char, 512U> errstr{};
+    rk_ = rd_kafka_new(RD_KAFKA_PRODUCER, rd_kafka_conf_new(), errstr.data(), errstr.size());
+    REQUIRE(rk_ != nullptr);
+  }
+
+  ~Messages() {
+    for (const auto& topic : topics_) {
+      rd_kafka_topic_destroy(topic.second);
+    }
+    rd_kafka_destroy(rk_);
+  }
+
+  rd_kafka_message_t* add(const std::string& topic, int32_t partition, int64_t offset, const std::string& payload,
+                          rd_kafka_resp_err_t err = RD_KAFKA_RESP_ERR_NO_ERROR) {
+    payloads_.emplace_back(new std::string(payload));
+    messages_.emplace_back(new rd_kafka_message_t);
+    rd_kafka_message_t* message = messages_.back().get();
+    std::memset(message, 0, sizeof(rd_kafka_message_t));
+    message->err = err;
+    message->rkt = getTopic(topic);
+    message->partition = partition;
+    message->offset = offset;
+    message->payload = &(*payloads_.back())[0];
+    message->len = payloads_.back()->size();
+    polled.push_back(message);
+    return message;
+  }
+
+  std::vector<rd_kafka_message_t*> polled;
+
+ private:
+  rd_kafka_topic_t* getTopic(const std::string& name) {
+    auto& topic = topics_[name];
+    if (topic == nullptr) {
+      topic = rd_kafka_topic_new(rk_, name.c_str(), nullptr);
+    }
+    return topic;
+  }
+
+  rd_kafka_t* rk_;
+  std::map<std::string, rd_kafka_topic_t*> topics_;
+  std::vector<std::unique_ptr<std::string>> payloads_;
+  std::vector<std::unique_ptr<rd_kafka_message_t>> messages_;
+};
+
+// a ConsumeKafka whose Success relationship may or may not have a connection
+class ConsumeKafkaFixture {
+ public:
+  ConsumeKafkaFixture()
+      : repo_(std::make_shared<TestRepository>()),
+        content_repo_(std::make_shared<core::repository::VolatileContentRepository>()),
+        processor_(std::make_shared<TestConsumeKafka>("consume")) {
+    content_repo_->initialize(std::make_shared<minifi::Configure>());
+    processor_->initialize();
+    processor_->setProperty(ConsumeKafka::SeedBrokers.getName(), UNREACHABLE_BROKER);
+    processor_->setProperty(ConsumeKafka::TopicNames.getName(), "test");
+    processor_->setProperty(ConsumeKafka::GroupID.getName(), "group");
+
+    auto node = std::make_shared<core::ProcessorNode>(processor_);
+    std::shared_ptr<core::controller::ControllerServiceProvider> controller_services_provider = nullptr;
+    context_ = std::make_shared<core::ProcessContext>(node, controller_services_provider, repo_, repo_, content_repo_);
+    session_factory_ = std::make_shared<core::ProcessSessionFactory>(context_);
+  }
+
+  ~ConsumeKafkaFixture() {
+    processor_->setScheduledState(core::ScheduledState::STOPPED);
+  }
+
+  void connectOutput() {
+    utils::Identifier uuid;
+    processor_->getUUID(uuid);
+    output_ = std::make_shared<minifi::Connection>(repo_, content_repo_, "output");
+    output_->addRelationship(ConsumeKafka::Success);
+    output_->setSource(processor_);
+    output_->setSourceUUID(uuid);
+    processor_->addConnection(output_);
+  }
+
+  void schedule() {
+    processor_->onSchedule(context_, session_factory_);
+  }
+
+  // the FlowFiles of the output queue, in the order they were queued
+  std::vector<std::shared_ptr<core::FlowFile>> output() {
+    std::vector<std::shared_ptr<core::FlowFile>> flow_files;
+    std::set<std::shared_ptr<core::FlowFile>> expired;
+    while (auto flow_file = output_->poll(expired)) {
+      flow_files.push_back(flow_file);
+    }
+    return flow_files;
+  }
+
+  std::string content(const std::shared_ptr<core::FlowFile>& flow_file) {
+    auto stream = content_repo_->read(flow_file->getResourceClaim());
+    std::vector<uint8_t> buffer;
+    stream->readData(buffer, static_cast<int>(flow_file->getSize()));
+    return std::string(buffer.begin(), buffer.end());
+  }
+
+  std::string attribute(const std::shared_ptr<core::FlowFile>& flow_file, const std::string& name) {
+    std::string value;
+    flow_file->getAttribute(name, value);
+    return value;
+  }
+
+  std::shared_ptr<TestRepository> repo_;
+  std::shared_ptr<core::repository::VolatileContentRepository> content_repo_;
+  std::shared_ptr<TestConsumeKafka> processor_;
+  std::shared_ptr<minifi::Connection> output_;
+  std::shared_ptr<core::ProcessContext> context_;
+  std::shared_ptr<core::ProcessSessionFactory> session_factory_;
+};
+
+}  // namespace
+
+TEST_CASE("ConsumeKafka validates its properties when scheduled", "[consumeKafka]") {
+  ConsumeKafkaFixture fixture;
+
+  SECTION("Valid properties") {
+    REQUIRE_NOTHROW(fixture.schedule());
+  }
+  SECTION("Missing Known Brokers") {
+    fixture.processor_->setProperty(ConsumeKafka::SeedBrokers.getName(), "");
+    REQUIRE_THROWS_WITH(fixture.schedule(), Catch::Contains("Known Brokers"));
+  }
+  SECTION("Topic Names without any topic") {
+    fixture.processor_->setProperty(ConsumeKafka::TopicNames.getName(), " , ,");
+    REQUIRE_THROWS_WITH(fixture.schedule(), Catch::Contains("Topic Names"));
+  }
+  SECTION("Missing Group ID") {
+    fixture.processor_->setProperty(ConsumeKafka::GroupID.getName(), "");
+    REQUIRE_THROWS_WITH(fixture.schedule(), Catch::Contains("Group ID"));
+  }
+  SECTION("Dynamic property unknown to librdkafka") {
+    fixture.processor_->setDynamicProperty("no.such.setting", "1");
+    REQUIRE_THROWS_WITH(fixture.schedule(), Catch::Contains("configure error"));
+  }
+}
+
+TEST_CASE("ConsumeKafka groups the messages of a poll by topic partition", "[consumeKafka]") {
+  ConsumeKafkaFixture fixture;
+  Messages messages;
+  rd_kafka_message_t* a0 = messages.add("a", 0, 10, "a0");
+  rd_kafka_message_t* b0 = messages.add("b", 0, 20, "b0");
+  rd_kafka_message_t* a1 = messages.add("a", 1, 30, "a1");
+  messages.add("a", 0, 0, "", RD_KAFKA_RESP_ERR__PARTITION_EOF);
+  messages.add("b", 0, 0, "", RD_KAFKA_RESP_ERR__TRANSPORT);
+  rd_kafka_message_t* a0_next = messages.add("a", 0, 11, "a0 next");
+
+  const TestConsumeKafka::Partitions partitions = fixture.processor_->groupByPartition(messages.polled.data(), messages.polled.size());
+  REQUIRE(3 == partitions.size());
+  REQUIRE((std::vector<rd_kafka_message_t*>{ a0, a0_next }) == partitions.at(std::make_pair(std::string("a"), 0)));
+  REQUIRE((std::vector<rd_kafka_message_t*>{ a1 }) == partitions.at(std::make_pair(std::string("a"), 1)));
+  REQUIRE((std::vector<rd_kafka_message_t*>{ b0 }) == partitions.at(std::make_pair(std::string("b"), 0)));
+}
+
+TEST_CASE("ConsumeKafka writes messages separated by the demarcator", "[consumeKafka]") {
+  Messages messages;
+  messages.add("a", 0, 0, "first");
+  messages.add("a", 0, 1, "");
+  messages.add("a", 0, 2, "third");
+
+  std::string demarcator;
+  std::string expected;
+  SECTION("With a demarcator") {
+    demarcator = "||";
+    expected = "first||||third";
+  }
+  SECTION("Without a demarcator") {
+    expected = "firstthird";
+  }
+
+  minifi::io::DataStream data;
+  ConsumeKafka::WriteCallback callback(messages.polled, demarcator);
+  REQUIRE(static_cast<int64_t>(expected.size()) == callback.process(std::make_shared<minifi::io::BaseStream>(&data)));
+  REQUIRE(expected == std::string(reinterpret_cast<const char*>(data.getBuffer()), data.getSize()));
+}
+
+TEST_CASE("ConsumeKafka transfers a FlowFile per message without a demarcator", "[consumeKafka]") {
+  ConsumeKafkaFixture fixture;
+  fixture.connectOutput();
+  fixture.schedule();
+  Messages messages;
+  messages.add("a", 2, 40, "first");
+  messages.add("a", 2, 41, "second");
+
+  auto session = fixture.session_factory_->createSession();
+  fixture.processor_->transferMessages(*session, messages.polled);
+  session->commit();
+
+  const auto flow_files = fixture.output();
+  REQUIRE(2 == flow_files.size());
+  REQUIRE("first" == fixture.content(flow_files[0]));
+  REQUIRE("second" == fixture.content(flow_files[1]));
+  REQUIRE("a" == fixture.attribute(flow_files[1], "kafka.topic"));
+  REQUIRE("2" == fixture.attribute(flow_files[1], "kafka.partition"));
+  REQUIRE("41" == fixture.attribute(flow_files[1], "kafka.offset"));
+}
+
+TEST_CASE("ConsumeKafka bundles the messages of a partition with a demarcator", "[consumeKafka]") {
+  ConsumeKafkaFixture fixture;
+  fixture.processor_->setProperty(ConsumeKafka::MessageDemarcator.getName(), "\n");
+  fixture.connectOutput();
+  fixture.schedule();
+  Messages messages;
+  messages.add("a", 2, 40, "first");
+  messages.add("a", 2, 41, "second");
+
+  auto session = fixture.session_factory_->createSession();
+  fixture.processor_->transferMessages(*session, messages.polled);
+  session->commit();
+
+  const auto flow_files = fixture.output();
+  REQUIRE(1 == flow_files.size());
+  REQUIRE("first\nsecond" == fixture.content(flow_files[0]));
+  REQUIRE("40" == fixture.attribute(flow_files[0], "kafka.offset"));
+  REQUIRE("2" == fixture.attribute(flow_files[0], "kafka.count"));
+}
+
+TEST_CASE("ConsumeKafka rewinds every partition when the session fails to commit", "[consumeKafka]") {
+  ConsumeKafkaFixture fixture;
+  fixture.schedule();
+  Messages messages;
+  messages.add("a", 0, 10, "a0");
+  messages.add("a", 0, 11, "a0 next");
+  messages.add("b", 3, 20, "b3");
+
+  const TestConsumeKafka::Partitions partitions = fixture.processor_->groupByPartition(messages.polled.data(), messages.polled.size());
+  auto session = fixture.session_factory_->createSession();
+  for (const auto& partition : partitions) {
+    fixture.processor_->transferMessages(*session, partition.second);
+  }
+
+  SECTION("Committed session") {
+    fixture.connectOutput();
+    fixture.processor_->commitSession(*session, partitions);
+    REQUIRE(fixture.processor_->rewound.empty());
+  }
+  SECTION("Failed session") {
+    // without a connection for Success the commit fails
+    REQUIRE_THROWS(fixture.processor_->commitSession(*session, partitions));
+    using Rewind = std::tuple<std::string, int32_t, int64_t>;
+    REQUIRE((std::vector<Rewind>{ Rewind("a", 0, 10), Rewind("b", 3, 20) }) == fixture.processor_->rewound);
+  }
+}
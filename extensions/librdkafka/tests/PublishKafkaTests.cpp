@@ -0,0 +1,232 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../../../libminifi/test/TestBase.h"
+#include "../../../libminifi/test/unit/ProvenanceTestHelper.h"
+#include "../PublishKafka.h"
+#include "Connection.h"
+#include "FlowFileRecord.h"
+#include "core/ProcessContext.h"
+#include "core/ProcessSessionFactory.h"
+#include "core/ProcessorNode.h"
+#include "core/repository/VolatileContentRepository.h"
+#include "io/BaseStream.h"
+#include "io/DataStream.h"
+#include "properties/Configure.h"
+
+namespace {
+
+using minifi::processors::PublishKafka;
+
+// nothing listens on this port, so every message fails once its Message Timeout is over
+const char* const UNREACHABLE_BROKER = "127.0.0.1:1";
+
+// a PublishKafka publishing one FlowFile per batch between an input queue and a queue collecting both of its relationships
+class PublishKafkaFixture {
+ public:
+  PublishKafkaFixture()
+      : repo_(std::make_shared<TestRepository>()),
+        content_repo_(std::make_shared<core::repository::VolatileContentRepository>()),
+        processor_(std::make_shared<PublishKafka>("publish")) {
+    content_repo_->initialize(std::make_shared<minifi::Configure>());
+    processor_->initialize();
+    processor_->setProperty(PublishKafka::SeedBrokers.getName(), UNREACHABLE_BROKER);
+    processor_->setProperty(PublishKafka::Topic.getName(), "test");
+    processor_->setProperty(PublishKafka::BatchSize.getName(), "1");
+    processor_->setProperty(PublishKafka::QueueBufferMaxTime.getName(), "10 ms");
+    processor_->setProperty(PublishKafka::MessageTimeOut.getName(), "2 sec");
+    processor_->setProperty(PublishKafka::FailEmptyFlowFiles.getName(), "false");
+
+    utils::Identifier uuid;
+    processor_->getUUID(uuid);
+    input_ = std::make_shared<minifi::Connection>(repo_, content_repo_, "input");
+    input_->setDestination(processor_);
+    input_->setDestinationUUID(uuid);
+    processor_->addConnection(input_);
+    output_ = std::make_shared<minifi::Connection>(repo_, content_repo_, "output");
+    output_->addRelationship(PublishKafka::Success);
+    output_->addRelationship(PublishKafka::Failure);
+    output_->setSource(processor_);
+    output_->setSourceUUID(uuid);
+    processor_->addConnection(output_);
+
+    auto node = std::make_shared<core::ProcessorNode>(processor_);
+    std::shared_ptr<core::controller::ControllerServiceProvider> controller_services_provider = nullptr;
+    context_ = std::make_shared<core::ProcessContext>(node, controller_services_provider, repo_, repo_, content_repo_);
+    session_factory_ = std::make_shared<core::ProcessSessionFactory>(context_);
+  }
+
+  ~PublishKafkaFixture() {
+    processor_->setScheduledState(core::ScheduledState::STOPPED);
+  }
+
+  void enqueue(size_t flow_files) {
+    for (size_t i = 0; i < flow_files; i++) {
+      std::shared_ptr<core::FlowFile> flow_file = std::make_shared<minifi::FlowFileRecord>(repo_, content_repo_, std::map<std::string, std::string>());
+      input_->put(flow_file);
+    }
+  }
+
+  void schedule() {
+    processor_->onSchedule(context_, session_factory_);
+    processor_->setScheduledState(core::ScheduledState::RUNNING);
+  }
+
+  void trigger() {
+    auto session = session_factory_->createSession();
+    processor_->onTrigger(context_, session);
+    session->commit();
+  }
+
+  std::shared_ptr<TestRepository> repo_;
+  std::shared_ptr<core::repository::VolatileContentRepository> content_repo_;
+  std::shared_ptr<PublishKafka> processor_;
+  std::shared_ptr<minifi::Connection> input_;
+  std::shared_ptr<minifi::Connection> output_;
+  std::shared_ptr<core::ProcessContext> context_;
+  std::shared_ptr<core::ProcessSessionFactory> session_factory_;
+};
+
+// deletes the delivery callbacks ReadCallback hands to librdkafka, like PublishKafka::messageDeliveryCallback does
+void deliveryCallback(rd_kafka_t* rk, const rd_kafka_message_t* rkmessage, void* /*opaque*/) {
+  auto* func = reinterpret_cast<std::function<void(rd_kafka_t*, const rd_kafka_message_t*)>*>(rkmessage->_private);
+  if (func != nullptr) {
+    (*func)(rk, rkmessage);
+    delete func;
+  }
+}
+
+// a producer of its own for driving ReadCallback directly
+class Producer {
+ public:
+  Producer() {
+    std::array<char, 512U> errstr{};
+    rd_kafka_conf_t* conf = rd_kafka_conf_new();
+    rd_kafka_conf_set(conf, "bootstrap.servers", UNREACHABLE_BROKER, errstr.data(), errstr.size());
+    rd_kafka_conf_set(conf, "message.timeout.ms", "1000", errstr.data(), errstr.size());
+    rd_kafka_conf_set(conf, "linger.ms", "10", errstr.data(), errstr.size());
+    rd_kafka_conf_set_dr_msg_cb(conf, &deliveryCallback);
+    rk_ = rd_kafka_new(RD_KAFKA_PRODUCER, conf, errstr.data(), errstr.size());
+    REQUIRE(rk_ != nullptr);
+    rkt_ = rd_kafka_topic_new(rk_, "test", nullptr);
+    REQUIRE(rkt_ != nullptr);
+  }
+
+  ~Producer() {
+    rd_kafka_flush(rk_, 10 * 1000);
+    rd_kafka_topic_destroy(rkt_);
+    rd_kafka_destroy(rk_);
+  }
+
+  // reads content through a ReadCallback, with or without a buffer pool
+  int64_t produce(const std::string& content, uint64_t max_seg_size, std::shared_ptr<PublishKafka::Messages> messages, std::vector<std::vector<unsigned char>>* buffer_pool) {
+    auto repo = std::make_shared<TestRepository>();
+    auto content_repo = std::make_shared<core::repository::VolatileContentRepository>();
+    minifi::FlowFileRecord flow_file(repo, content_repo, std::map<std::string, std::string>());
+    flow_file.setSize(content.size());
+    utils::Regex attribute_name_regex;
+    const size_t index = messages->addFlowFile();
+    PublishKafka::ReadCallback callback(max_seg_size, "key", rkt_, rk_, flow_file, attribute_name_regex, messages, index, true, buffer_pool);
+    minifi::io::DataStream data(reinterpret_cast<const uint8_t*>(content.data()), static_cast<uint32_t>(content.size()));
+    const int64_t read = callback.process(std::make_shared<minifi::io::BaseStream>(&data));
+    REQUIRE(0 == callback.status_);
+    return read;
+  }
+
+ private:
+  rd_kafka_t* rk_;
+  rd_kafka_topic_t* rkt_;
+};
+
+}  // namespace
+
+TEST_CASE("PublishKafka waits for each batch without Max Pending Batches", "[publishKafka]") {
+  PublishKafkaFixture fixture;
+  fixture.enqueue(2);
+  fixture.schedule();
+
+  fixture.trigger();
+  REQUIRE(1 == fixture.input_->getQueueSize());
+  REQUIRE(1 == fixture.output_->getQueueSize());
+}
+
+TEST_CASE("PublishKafka keeps at most Max Pending Batches batches in flight", "[publishKafka]") {
+  PublishKafkaFixture fixture;
+  fixture.processor_->setProperty(PublishKafka::MaxPendingBatches.getName(), "2");
+  fixture.enqueue(3);
+  fixture.schedule();
+
+  // the first two batches are left pending, their FlowFiles are neither queued nor routed yet
+  fixture.trigger();
+  fixture.trigger();
+  REQUIRE(1 == fixture.input_->getQueueSize());
+  REQUIRE(0 == fixture.output_->getQueueSize());
+  REQUIRE(fixture.processor_->isWorkAvailable());
+
+  // a third batch has to wait for the oldest one to be delivered
+  fixture.trigger();
+  REQUIRE(fixture.input_->isEmpty());
+  REQUIRE(1 <= fixture.output_->getQueueSize());
+
+  // stopping completes the batches that are still pending
+  fixture.processor_->notifyStop();
+  REQUIRE(3 == fixture.output_->getQueueSize());
+  REQUIRE_FALSE(fixture.processor_->isWorkAvailable());
+}
+
+TEST_CASE("PublishKafka produces small FlowFiles from pooled buffers", "[publishKafka]") {
+  Producer producer;
+  const std::string content = "zero copy payload";
+
+  std::vector<unsigned char> pooled(content.size());
+  const unsigned char* const pooled_data = pooled.data();
+  std::vector<std::vector<unsigned char>> buffer_pool;
+  buffer_pool.push_back(std::move(pooled));
+
+  auto messages = std::make_shared<PublishKafka::Messages>();
+  REQUIRE(static_cast<int64_t>(content.size()) == producer.produce(content, 0, messages, &buffer_pool));
+
+  // the pooled buffer was filled and handed over to the batch instead of being copied
+  REQUIRE(buffer_pool.empty());
+  REQUIRE(1 == messages->buffers.size());
+  REQUIRE(pooled_data == messages->buffers.front().data());
+  REQUIRE(content == std::string(messages->buffers.front().begin(), messages->buffers.front().end()));
+}
+
+TEST_CASE("PublishKafka copies segmented FlowFiles", "[publishKafka]") {
+  Producer producer;
+  const std::string content = "segmented payload";
+  std::vector<std::vector<unsigned char>> buffer_pool(1);
+
+  SECTION("Segmented FlowFiles") {
+    auto messages = std::make_shared<PublishKafka::Messages>();
+    REQUIRE(static_cast<int64_t>(content.size()) == producer.produce(content, 4, messages, &buffer_pool));
+    REQUIRE(1 == buffer_pool.size());
+    REQUIRE(messages->buffers.empty());
+  }
+  SECTION("Without a buffer pool") {
+    auto messages = std::make_shared<PublishKafka::Messages>();
+    REQUIRE(static_cast<int64_t>(content.size()) == producer.produce(content, 0, messages, nullptr));
+    REQUIRE(messages->buffers.empty());
+  }
+}
@@ -17,16 +17,152 @@
  */
 
 #include "ProvenanceRepository.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
 #include <string>
+#include <vector>
 namespace org {
 namespace apache {
 namespace nifi {
 namespace minifi {
 namespace provenance {
 
+const char *ProvenanceRepository::EVENTS_FAMILY = "events";
+const char *ProvenanceRepository::EVENT_IDS_FAMILY = "event_ids";
+const char *ProvenanceRepository::FLOW_FILE_IDS_FAMILY = "flow_file_ids";
+const char *ProvenanceRepository::COMPONENT_IDS_FAMILY = "component_ids";
+const char *ProvenanceRepository::CURSORS_FAMILY = "cursors";
+constexpr int ProvenanceRepository::SEQUENCE_BITS;
+
+bool ProvenanceRepository::openDatabase(const rocksdb::Options &options) {
+  // every existing column family has to be opened, the ones we need are created when missing
+  std::vector<std::string> families;
+  rocksdb::DB::ListColumnFamilies(options, directory_, &families);
+  for (const auto &required : { rocksdb::kDefaultColumnFamilyName, std::string(EVENTS_FAMILY), std::string(EVENT_IDS_FAMILY), std::string(FLOW_FILE_IDS_FAMILY),
+      std::string(COMPONENT_IDS_FAMILY), std::string(CURSORS_FAMILY) }) {
+    if (std::find(families.begin(), families.end(), required) == families.end()) {
+      families.push_back(required);
+    }
+  }
+
+  std::vector<rocksdb::ColumnFamilyDescriptor> descriptors;
+  for (const auto &family : families) {
+    if (family == CURSORS_FAMILY) {
+      // cursors must survive the size and age limits applied to events
+      descriptors.emplace_back(family, rocksdb::ColumnFamilyOptions());
+    } else {
+      descriptors.emplace_back(family, rocksdb::ColumnFamilyOptions(options));
+    }
+  }
+
+  rocksdb::DBOptions db_options(options);
+  db_options.create_missing_column_families = true;
+
+  rocksdb::DB* db;
+  rocksdb::Status status = rocksdb::DB::Open(db_options, directory_, descriptors, &handles_, &db);
+  if (!status.ok()) {
+    logger_->log_error("MiNiFi Provenance Repository database open %s failed: %s", directory_, status.ToString());
+    return false;
+  }
+  logger_->log_debug("MiNiFi Provenance Repository database open %s success", directory_);
+  db_.reset(db);
+
+  for (size_t i = 0; i < families.size(); i++) {
+    if (families[i] == rocksdb::kDefaultColumnFamilyName) {
+      default_handle_ = handles_[i];
+    } else if (families[i] == EVENTS_FAMILY) {
+      events_handle_ = handles_[i];
+    } else if (families[i] == EVENT_IDS_FAMILY) {
+      event_ids_handle_ = handles_[i];
+    } else if (families[i] == FLOW_FILE_IDS_FAMILY) {
+      flow_file_ids_handle_ = handles_[i];
+    } else if (families[i] == COMPONENT_IDS_FAMILY) {
+      component_ids_handle_ = handles_[i];
+    } else if (families[i] == CURSORS_FAMILY) {
+      cursors_handle_ = handles_[i];
+    }
+  }
+
+  // continue the key sequence after the newest stored event
+  std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(rocksdb::ReadOptions(), events_handle_));
+  it->SeekToLast();
+  if (it->Valid()) {
+    last_sequence_ = std::stoull(it->key().ToString(), nullptr, 16);
+  }
+  return true;
+}
+
+void ProvenanceRepository::closeDatabase() {
+  if (db_ != nullptr) {
+    for (auto handle : handles_) {
+      db_->DestroyColumnFamilyHandle(handle);
+    }
+  }
+  handles_.clear();
+  default_handle_ = events_handle_ = event_ids_handle_ = flow_file_ids_handle_ = component_ids_handle_ = cursors_handle_ = nullptr;
+  db_.reset();
+}
+
+std::string ProvenanceRepository::nextKey() {
+  const uint64_t now = getTimeMillis() << SEQUENCE_BITS;
+  uint64_t previous = last_sequence_.load();
+  uint64_t next;
+  do {
+    next = std::max(previous + 1, now);
+  } while (!last_sequence_.compare_exchange_weak(previous, next));
+
+  // fixed width, so that the lexicographic order of keys is their numeric order
+  char key[17];
+  std::snprintf(key, sizeof(key), "%016" PRIx64, next);
+  return std::string(key, 16);
+}
+
+bool ProvenanceRepository::addEvent(rocksdb::WriteBatch &batch, const std::string &uuid, const rocksdb::Slice &value) {
+  const std::string key = nextKey();
+  if (!batch.Put(events_handle_, key, value).ok() || !batch.Put(event_ids_handle_, uuid, key).ok()) {
+    return false;
+  }
+  if (secondary_indexes_) {
+    std::string event_uuid;
+    std::string component_id;
+    std::string flow_file_uuid;
+    if (ProvenanceEventRecord::getIdentifiers(reinterpret_cast<const uint8_t*>(value.data()), value.size(), event_uuid, component_id, flow_file_uuid)) {
+      if (!batch.Put(flow_file_ids_handle_, flow_file_uuid + "/" + key, rocksdb::Slice()).ok() || !batch.Put(component_ids_handle_, component_id + "/" + key, rocksdb::Slice()).ok()) {
+        return false;
+      }
+    } else {
+      logger_->log_debug("Provenance event %s could not be indexed", uuid);
+    }
+  }
+  return true;
+}
+
+bool ProvenanceRepository::getIndexedEvents(rocksdb::ColumnFamilyHandle *index, const std::string &id, std::vector<std::shared_ptr<ProvenanceEventRecord>> &records, size_t max_size) {
+  if (!secondary_indexes_) {
+    return false;
+  }
+  const std::string prefix = id + "/";
+  std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(rocksdb::ReadOptions(), index));
+  std::string value;
+  for (it->Seek(prefix); it->Valid() && it->key().starts_with(prefix) && records.size() < max_size; it->Next()) {
+    rocksdb::Slice key = it->key();
+    key.remove_prefix(prefix.size());
+    // events removed by the size and age limits or by deletes leave dangling index entries behind
+    if (!db_->Get(rocksdb::ReadOptions(), events_handle_, key, &value).ok()) {
+      continue;
+    }
+    auto eventRead = std::make_shared<ProvenanceEventRecord>();
+    if (eventRead->DeSerialize(reinterpret_cast<const uint8_t*>(value.data()), value.size())) {
+      records.push_back(eventRead);
+    }
+  }
+  return true;
+}
+
 void ProvenanceRepository::printStats() {
   std::string key_count;
-  db_->GetProperty("rocksdb.estimate-num-keys", &key_count);
+  db_->GetProperty(events_handle_, "rocksdb.estimate-num-keys", &key_count);
 
   std::string table_readers;
   db_->GetProperty("rocksdb.estimate-table-readers-mem", &table_readers);
@@ -20,6 +20,10 @@
 #include "rocksdb/db.h"
 #include "rocksdb/options.h"
 #include "rocksdb/slice.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
 #include "core/Repository.h"
 #include "core/Core.h"
 #include "provenance/Provenance.h"
@@ -35,6 +39,18 @@ namespace provenance {
 #define MAX_PROVENANCE_ENTRY_LIFE_TIME (60000) // 1 minute
 #define PROVENANCE_PURGE_PERIOD (2500) // 2500 msec
 
+/**
+ * Events are stored in the events column family under keys which sort by the time they were committed:
+ * the commit time in milliseconds shifted left by SEQUENCE_BITS, plus a counter which keeps keys committed
+ * within the same millisecond unique and ordered. Readers can therefore resume after the last key they consumed
+ * and whole ranges of consumed events can be deleted at once.
+ *
+ * The event_ids column family maps event UUIDs onto event keys. When secondary indexes are enabled, the
+ * flow_file_ids and component_ids column families hold "<id>/<event key>" entries for prefix scans.
+ * Reader positions are persisted in the cursors column family, which is not subject to the storage limits.
+ * Events stored by earlier versions under their UUID remain readable from the default column family until they expire.
+ */
+
 class ProvenanceRepository : public core::Repository, public std::enable_shared_from_this<ProvenanceRepository> {
  public:
   ProvenanceRepository(std::string name, utils::Identifier uuid)
@@ -50,10 +66,29 @@ class ProvenanceRepository : public core::Repository, public std::enable_shared_
                        uint64_t purgePeriod = PROVENANCE_PURGE_PERIOD)
       : core::SerializableComponent(repo_name),
         Repository(repo_name.length() > 0 ? repo_name : core::getClassName<ProvenanceRepository>(), directory, maxPartitionMillis, maxPartitionBytes, purgePeriod),
+        secondary_indexes_(false),
+        last_sequence_(0),
+        default_handle_(nullptr),
+        events_handle_(nullptr),
+        event_ids_handle_(nullptr),
+        flow_file_ids_handle_(nullptr),
+        component_ids_handle_(nullptr),
+        cursors_handle_(nullptr),
         logger_(logging::LoggerFactory<ProvenanceRepository>::getLogger()) {
     db_ = NULL;
   }
 
+  virtual ~ProvenanceRepository() {
+    closeDatabase();
+  }
+
+  static const char *EVENTS_FAMILY;
+  static const char *EVENT_IDS_FAMILY;
+  static const char *FLOW_FILE_IDS_FAMILY;
+  static const char *COMPONENT_IDS_FAMILY;
+  static const char *CURSORS_FAMILY;
+  static constexpr int SEQUENCE_BITS = 20;
+
   void printStats();
 
   virtual bool isNoop() {
@@ -85,6 +120,10 @@ class ProvenanceRepository : public core::Repository, public std::enable_shared_
       }
     }
     logger_->log_debug("MiNiFi Provenance Max Storage Time: [%d] ms", max_partition_millis_);
+    if (config->get(Configure::nifi_provenance_repository_secondary_indexes, value)) {
+      utils::StringUtils::StringToBool(value, secondary_indexes_);
+    }
+    logger_->log_debug("MiNiFi Provenance Secondary Indexes: %s", secondary_indexes_ ? "enabled" : "disabled");
     rocksdb::Options options;
     options.create_if_missing = true;
     options.use_direct_io_for_flush_and_compaction = true;
@@ -106,30 +145,24 @@ class ProvenanceRepository : public core::Repository, public std::enable_shared_
     logger_->log_info("Max partition bytes: %llu", max_partition_bytes_);
     logger_->log_info("Ttl: %llu", options.compaction_options_fifo.ttl);
 
-    rocksdb::DB* db;
-    rocksdb::Status status = rocksdb::DB::Open(options, directory_, &db);
-    if (status.ok()) {
-      logger_->log_debug("MiNiFi Provenance Repository database open %s success", directory_);
-      db_.reset(db);
-    } else {
-      logger_->log_error("MiNiFi Provenance Repository database open %s failed: %s", directory_, status.ToString());
-      return false;
-    }
-
-    return true;
+    return openDatabase(options);
   }
   // Put
   virtual bool Put(std::string key, const uint8_t *buf, size_t bufLen) {
     // persist to the DB
+    rocksdb::WriteBatch batch;
     rocksdb::Slice value((const char *) buf, bufLen);
-    return db_->Put(rocksdb::WriteOptions(), key, value).ok();
+    if (!addEvent(batch, key, value)) {
+      return false;
+    }
+    return db_->Write(rocksdb::WriteOptions(), &batch).ok();
   }
 
   virtual bool MultiPut(const std::vector<std::pair<std::string, std::unique_ptr<minifi::io::DataStream>>>& data) {
     rocksdb::WriteBatch batch;
     for (const auto &item: data) {
       rocksdb::Slice value((const char *) item.second->getBuffer(), item.second->getSize());
-      if (!batch.Put(item.first, value).ok()) {
+      if (!addEvent(batch, item.first, value)) {
         return false;
       }
     }
@@ -143,7 +176,11 @@ class ProvenanceRepository : public core::Repository, public std::enable_shared_
   }
   // Get
   virtual bool Get(const std::string &key, std::string &value) {
-    return db_->Get(rocksdb::ReadOptions(), key, &value).ok();
+    std::string event_key;
+    if (db_->Get(rocksdb::ReadOptions(), event_ids_handle_, key, &event_key).ok()) {
+      return db_->Get(rocksdb::ReadOptions(), events_handle_, event_key, &value).ok();
+    }
+    return db_->Get(rocksdb::ReadOptions(), default_handle_, key, &value).ok();
   }
 
   virtual bool Serialize(const std::string &key, const uint8_t *buffer, const size_t bufferSize) {
@@ -151,7 +188,7 @@ class ProvenanceRepository : public core::Repository, public std::enable_shared_
   }
 
   virtual bool get(std::vector<std::shared_ptr<core::CoreComponent>> &store, size_t max_size) {
-    std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(rocksdb::ReadOptions()));
+    std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(rocksdb::ReadOptions(), events_handle_));
     for (it->SeekToFirst(); it->Valid(); it->Next()) {
       std::shared_ptr<ProvenanceEventRecord> eventRead = std::make_shared<ProvenanceEventRecord>();
       std::string key = it->key().ToString();
@@ -165,15 +202,28 @@ class ProvenanceRepository : public core::Repository, public std::enable_shared_
   }
 
   virtual bool DeSerialize(std::vector<std::shared_ptr<core::SerializableComponent>> &records, size_t &max_size, std::function<std::shared_ptr<core::SerializableComponent>()> lambda) {
-    std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(rocksdb::ReadOptions()));
+    std::string position;
+    return DeSerialize(records, max_size, lambda, position);
+  }
+
+  virtual bool DeSerialize(std::vector<std::shared_ptr<core::SerializableComponent>> &records, size_t &max_size, std::function<std::shared_ptr<core::SerializableComponent>()> lambda,
+                           std::string &position) {
+    std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(rocksdb::ReadOptions(), events_handle_));
     size_t requested_batch = max_size;
     max_size = 0;
-    for (it->SeekToFirst(); it->Valid(); it->Next()) {
-
+    if (position.empty()) {
+      it->SeekToFirst();
+    } else {
+      it->Seek(position);
+      if (it->Valid() && it->key() == position) {
+        it->Next();
+      }
+    }
+    for (; it->Valid(); it->Next()) {
       if (max_size >= requested_batch)
         break;
       std::shared_ptr<core::SerializableComponent> eventRead = lambda();
-      std::string key = it->key().ToString();
+      position = it->key().ToString();
       if (eventRead->DeSerialize((uint8_t *) it->value().data(), (int) it->value().size())) {
         max_size++;
         records.push_back(eventRead);
@@ -182,9 +232,43 @@ class ProvenanceRepository : public core::Repository, public std::enable_shared_
     return max_size > 0;
   }
 
+  virtual bool getCursor(const std::string &name, std::string &position) {
+    return db_->Get(rocksdb::ReadOptions(), cursors_handle_, name, &position).ok();
+  }
+
+  virtual bool setCursor(const std::string &name, const std::string &position) {
+    return db_->Put(rocksdb::WriteOptions(), cursors_handle_, name, position).ok();
+  }
+
+  virtual bool DeleteRange(const std::string &from, const std::string &to) {
+    // the range deleted by rocksdb excludes its end, hence the successor of the last key
+    const std::string begin = from.empty() ? from : from + '\0';
+    const std::string end = to + '\0';
+    if (begin >= end) {
+      return true;
+    }
+    return db_->DeleteRange(rocksdb::WriteOptions(), events_handle_, begin, end).ok();
+  }
+
+  /**
+   * Retrieves the events of a FlowFile in the order they were committed.
+   * @return false if secondary indexes are disabled
+   */
+  bool getEventsByFlowFile(const std::string &flow_file_uuid, std::vector<std::shared_ptr<ProvenanceEventRecord>> &records, size_t max_size) {
+    return getIndexedEvents(flow_file_ids_handle_, flow_file_uuid, records, max_size);
+  }
+
+  /**
+   * Retrieves the events reported by a component in the order they were committed.
+   * @return false if secondary indexes are disabled
+   */
+  bool getEventsByComponent(const std::string &component_id, std::vector<std::shared_ptr<ProvenanceEventRecord>> &records, size_t max_size) {
+    return getIndexedEvents(component_ids_handle_, component_id, records, max_size);
+  }
+
   //! get record
   void getProvenanceRecord(std::vector<std::shared_ptr<ProvenanceEventRecord>> &records, int maxSize) {
-    std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(rocksdb::ReadOptions()));
+    std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(rocksdb::ReadOptions(), events_handle_));
     for (it->SeekToFirst(); it->Valid(); it->Next()) {
       std::shared_ptr<ProvenanceEventRecord> eventRead = std::make_shared<ProvenanceEventRecord>();
       std::string key = it->key().ToString();
@@ -197,7 +281,7 @@ class ProvenanceRepository : public core::Repository, public std::enable_shared_
   }
 
   virtual bool DeSerialize(std::vector<std::shared_ptr<core::SerializableComponent>> &store, size_t &max_size) {
-    std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(rocksdb::ReadOptions()));
+    std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(rocksdb::ReadOptions(), events_handle_));
     max_size = 0;
     for (it->SeekToFirst(); it->Valid(); it->Next()) {
       std::shared_ptr<ProvenanceEventRecord> eventRead = std::make_shared<ProvenanceEventRecord>();
@@ -214,14 +298,14 @@ class ProvenanceRepository : public core::Repository, public std::enable_shared_
 
   // destroy
   void destroy() {
-    db_.reset();
+    closeDatabase();
   }
   // Run function for the thread
   void run();
 
   uint64_t getKeyCount() const {
     std::string key_count;
-    db_->GetProperty("rocksdb.estimate-num-keys", &key_count);
+    db_->GetProperty(events_handle_, "rocksdb.estimate-num-keys", &key_count);
 
     return std::stoull(key_count);
   }
@@ -232,7 +316,29 @@ class ProvenanceRepository : public core::Repository, public std::enable_shared_
   ProvenanceRepository &operator=(const ProvenanceRepository &parent) = delete;
 
  private:
+  bool openDatabase(const rocksdb::Options &options);
+
+  void closeDatabase();
+
+  /**
+   * Stages an event under the next event key, along with its index entries.
+   */
+  bool addEvent(rocksdb::WriteBatch &batch, const std::string &uuid, const rocksdb::Slice &value);
+
+  std::string nextKey();
+
+  bool getIndexedEvents(rocksdb::ColumnFamilyHandle *index, const std::string &id, std::vector<std::shared_ptr<ProvenanceEventRecord>> &records, size_t max_size);
+
+  bool secondary_indexes_;
+  std::atomic<uint64_t> last_sequence_;
   std::unique_ptr<rocksdb::DB> db_;
+  std::vector<rocksdb::ColumnFamilyHandle*> handles_;
+  rocksdb::ColumnFamilyHandle *default_handle_;
+  rocksdb::ColumnFamilyHandle *events_handle_;
+  rocksdb::ColumnFamilyHandle *event_ids_handle_;
+  rocksdb::ColumnFamilyHandle *flow_file_ids_handle_;
+  rocksdb::ColumnFamilyHandle *component_ids_handle_;
+  rocksdb::ColumnFamilyHandle *cursors_handle_;
   std::shared_ptr<logging::Logger> logger_;
 };
 
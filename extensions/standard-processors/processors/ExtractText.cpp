@@ -19,13 +19,12 @@
  */
 #include <algorithm>
 #include <iterator>
+#include <limits>
 #include <string>
 #include <memory>
 #include <map>
 #include <set>
-#include <regex>
 #include <iostream>
-#include <sstream>
 #include <utility>
 
 #include "ExtractText.h"
@@ -33,15 +32,12 @@
 #include "core/ProcessSession.h"
 #include "core/FlowFile.h"
 
-#include "utils/RegexUtils.h"
-
 namespace org {
 namespace apache {
 namespace nifi {
 namespace minifi {
 namespace processors {
 
-#define MAX_BUFFER_SIZE 4096
 #define MAX_CAPTURE_GROUP_SIZE 1024
 
 core::Property ExtractText::Attribute(core::PropertyBuilder::createProperty("Attribute")->withDescription("Attribute to set from content")->build());
@@ -100,6 +96,47 @@ void ExtractText::initialize() {
   setSupportedRelationships(relationships);
 }
 
+void ExtractText::onSchedule(core::ProcessContext *context, core::ProcessSessionFactory* /*sessionFactory*/) {
+  attrKey_.clear();
+  context->getProperty(Attribute.getName(), attrKey_);
+
+  std::string sizeLimitStr;
+  context->getProperty(SizeLimit.getName(), sizeLimitStr);
+  if (sizeLimitStr.empty())
+    sizeLimit_ = DEFAULT_SIZE_LIMIT;
+  else
+    sizeLimit_ = std::stoull(sizeLimitStr);
+
+  regexMode_ = false;
+  context->getProperty(RegexMode.getName(), regexMode_);
+
+  regexes_.clear();
+  if (!regexMode_) {
+    return;
+  }
+
+  std::vector<utils::Regex::Mode> rgx_mode;
+  bool insensitive;
+  if (context->getProperty(InsensitiveMatch.getName(), insensitive) && insensitive) {
+    rgx_mode.push_back(utils::Regex::Mode::ICASE);
+  }
+
+  context->getProperty(IgnoreCaptureGroupZero.getName(), ignoreGroupZero_);
+  context->getProperty(EnableRepeatingCaptureGroup.getName(), repeatingCapture_);
+  context->getProperty(MaxCaptureGroupLen.getName(), maxCaptureSize_);
+
+  for (const auto& k : context->getDynamicPropertyKeys()) {
+    std::string value;
+    context->getDynamicProperty(k, value);
+    try {
+      regexes_.emplace_back(k, utils::Regex(value, rgx_mode));
+    } catch (const Exception &e) {
+      logger_->log_error("%s error encountered when trying to construct regular expression from property (key: %s) value: %s",
+                         e.what(), k, value);
+    }
+  }
+}
+
 void ExtractText::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
   std::shared_ptr<core::FlowFile> flowFile = session->get();
 
@@ -107,117 +144,82 @@ void ExtractText::onTrigger(core::ProcessContext *context, core::ProcessSession
     return;
   }
 
-  ReadCallback cb(flowFile, context, logger_);
+  ReadCallback cb(flowFile, *this);
   session->read(flowFile, &cb);
   session->transfer(flowFile, Success);
 }
 
 int64_t ExtractText::ReadCallback::process(std::shared_ptr<io::BaseStream> stream) {
-  int64_t ret = 0;
-  uint64_t read_size = 0;
-  bool regex_mode;
   uint64_t size_limit = flowFile_->getSize();
+  if (parent_.sizeLimit_ != 0) {
+    size_limit = std::min(size_limit, parent_.sizeLimit_);
+  }
 
-  std::string attrKey, sizeLimitStr;
-  ctx_->getProperty(Attribute.getName(), attrKey);
-  ctx_->getProperty(SizeLimit.getName(), sizeLimitStr);
-  ctx_->getProperty(RegexMode.getName(), regex_mode);
-
-  if (sizeLimitStr.empty())
-    size_limit = DEFAULT_SIZE_LIMIT;
-  else if (sizeLimitStr != "0")
-    size_limit = std::stoi(sizeLimitStr);
-
-  std::ostringstream contentStream;
-
+  // read straight into the string the attributes are extracted from, instead of buffering it in a separate stream
+  std::string content;
+  content.resize(size_limit);
+  uint64_t read_size = 0;
   while (read_size < size_limit) {
-    // Don't read more than config limit or the size of the buffer
-    ret = stream->readData(buffer_, std::min<uint64_t>(size_limit - read_size, buffer_.size()));
-
+    const int ret = stream->readData(reinterpret_cast<uint8_t*>(&content[read_size]),
+                                     std::min<uint64_t>(size_limit - read_size, std::numeric_limits<int>::max()));
     if (ret < 0) {
       return -1;  // Stream error
     } else if (ret == 0) {
       break;  // End of stream, no more data
     }
-
-    contentStream.write(reinterpret_cast<const char*>(buffer_.data()), ret);
     read_size += ret;
-    if (contentStream.fail()) {
-      return -1;
-    }
   }
+  content.resize(read_size);
 
-  if (regex_mode) {
-    std::vector<utils::Regex::Mode> rgx_mode;
-
-    bool insensitive;
-    if (ctx_->getProperty(InsensitiveMatch.getName(), insensitive) && insensitive) {
-      rgx_mode.push_back(utils::Regex::Mode::ICASE);
-    }
-
-    bool ignoregroupzero;
-    ctx_->getProperty(IgnoreCaptureGroupZero.getName(), ignoregroupzero);
-
-    bool repeatingcapture;
-    ctx_->getProperty(EnableRepeatingCaptureGroup.getName(), repeatingcapture);
-
-    int maxCaptureSize;
-    ctx_->getProperty(MaxCaptureGroupLen.getName(), maxCaptureSize);
-
-    std::string contentStr = contentStream.str();
-
-    std::map<std::string, std::string> regexAttributes;
+  if (parent_.regexMode_) {
+    extractRegexAttributes(content);
+  } else {
+    flowFile_->setAttribute(parent_.attrKey_, content);
+  }
+  return read_size;
+}
 
-    for (const auto& k : ctx_->getDynamicPropertyKeys()) {
-      std::string value;
-      ctx_->getDynamicProperty(k, value);
+void ExtractText::ReadCallback::extractRegexAttributes(const std::string& content) {
+  std::map<std::string, std::string> regexAttributes;
+  std::vector<std::string> matches;
 
-      std::string workStr = contentStr;
+  for (const auto& kv : parent_.regexes_) {
+    const std::string& k = kv.first;
+    const utils::Regex& rgx = kv.second;
 
-      int matchcount = 0;
+    int matchcount = 0;
+    size_t offset = 0;
+    size_t match_end = 0;
 
-      try {
-        utils::Regex rgx(value, rgx_mode);
-        while (rgx.match(workStr)) {
-          const std::vector<std::string> &matches = rgx.getResult();
-          size_t i = ignoregroupzero ? 1 : 0;
+    while (rgx.search(content, offset, matches, match_end)) {
+      size_t i = parent_.ignoreGroupZero_ ? 1 : 0;
 
-          for (; i < matches.size(); ++i, ++matchcount) {
-            std::string attributeValue = matches[i];
-            if (attributeValue.length() > maxCaptureSize) {
-              attributeValue = attributeValue.substr(0, maxCaptureSize);
-            }
-            if (matchcount == 0) {
-              regexAttributes[k] = attributeValue;
-            }
-            regexAttributes[k + '.' + std::to_string(matchcount)] = attributeValue;
-          }
-          if (!repeatingcapture) {
-            break;
-          }
-          workStr = rgx.getSuffix();
+      for (; i < matches.size(); ++i, ++matchcount) {
+        std::string attributeValue = matches[i];
+        if (parent_.maxCaptureSize_ >= 0 && attributeValue.length() > static_cast<size_t>(parent_.maxCaptureSize_)) {
+          attributeValue = attributeValue.substr(0, parent_.maxCaptureSize_);
+        }
+        if (matchcount == 0) {
+          regexAttributes[k] = attributeValue;
         }
-      } catch (const Exception &e) {
-        logger_->log_error("%s error encountered when trying to construct regular expression from property (key: %s) value: %s",
-                           e.what(), k, value);
-        continue;
+        regexAttributes[k + '.' + std::to_string(matchcount)] = attributeValue;
       }
+      if (!parent_.repeatingCapture_) {
+        break;
+      }
+      // step over empty matches, otherwise the same position would match forever
+      offset = match_end > offset ? match_end : offset + 1;
     }
+  }
 
-    for (const auto& kv : regexAttributes) {
-      flowFile_->setAttribute(kv.first, kv.second);
-    }
-  } else {
-    flowFile_->setAttribute(attrKey, contentStream.str());
+  for (const auto& kv : regexAttributes) {
+    flowFile_->setAttribute(kv.first, kv.second);
   }
-  return read_size;
 }
 
-ExtractText::ReadCallback::ReadCallback(std::shared_ptr<core::FlowFile> flowFile, core::ProcessContext *ctx,  std::shared_ptr<logging::Logger> lgr)
+ExtractText::ReadCallback::ReadCallback(std::shared_ptr<core::FlowFile> flowFile, const ExtractText& parent)
     : flowFile_(std::move(flowFile)),
-      ctx_(ctx),
-      logger_(std::move(lgr)) {
-  buffer_.resize(std::min<uint64_t>(flowFile_->getSize(), MAX_BUFFER_SIZE));
+      parent_(parent) {
 }
 
 }  // namespace processors
@@ -22,12 +22,14 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "core/Processor.h"
 #include "core/ProcessSession.h"
 #include "core/Resource.h"
 #include "FlowFileRecord.h"
+#include "utils/RegexUtils.h"
 
 namespace org {
 namespace apache {
@@ -63,6 +65,7 @@ class ExtractText : public core::Processor {
     //! Default maximum bytes to read into an attribute
     static constexpr int DEFAULT_SIZE_LIMIT = 2 * 1024 * 1024;
 
+    void onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory);
     //! OnTrigger method, implemented by NiFi ExtractText
     void onTrigger(core::ProcessContext *context, core::ProcessSession *session);
     //! Initialize, over write by NiFi ExtractText
@@ -74,20 +77,29 @@ class ExtractText : public core::Processor {
 
     class ReadCallback : public InputStreamCallback {
      public:
-        ReadCallback(std::shared_ptr<core::FlowFile> flowFile, core::ProcessContext *ct, std::shared_ptr<logging::Logger> lgr);
+        ReadCallback(std::shared_ptr<core::FlowFile> flowFile, const ExtractText& parent);
         ~ReadCallback() = default;
         int64_t process(std::shared_ptr<io::BaseStream> stream);
 
      private:
+        void extractRegexAttributes(const std::string& content);
+
         std::shared_ptr<core::FlowFile> flowFile_;
-        core::ProcessContext *ctx_;
-        std::vector<uint8_t> buffer_;
-        std::shared_ptr<logging::Logger> logger_;
+        const ExtractText& parent_;
     };
 
  private:
     //! Logger
     std::shared_ptr<logging::Logger> logger_;
+    std::string attrKey_;
+    //! Maximum number of bytes to read, 0 means the whole content
+    uint64_t sizeLimit_ = DEFAULT_SIZE_LIMIT;
+    bool regexMode_ = false;
+    bool ignoreGroupZero_ = false;
+    bool repeatingCapture_ = false;
+    int maxCaptureSize_ = 0;
+    //! Dynamic property names and their regexes, compiled once per schedule and shared by all concurrent tasks
+    std::vector<std::pair<std::string, utils::Regex>> regexes_;
 };
 
 REGISTER_RESOURCE(ExtractText, "Extracts the content of a FlowFile and places it into an attribute.");
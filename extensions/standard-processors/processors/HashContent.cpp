@@ -25,11 +25,15 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "HashContent.h"
 #include "core/ProcessContext.h"
 #include "core/ProcessSession.h"
 #include "core/FlowFile.h"
+#include "io/HashingStream.h"
+#include "utils/HashUtils.h"
 
 namespace org {
 namespace apache {
@@ -37,9 +41,14 @@ namespace nifi {
 namespace minifi {
 namespace processors {
 
-core::Property HashContent::HashAttribute("Hash Attribute", "Attribute to store checksum to", "Checksum");
-core::Property HashContent::HashAlgorithm("Hash Algorithm", "Name of the algorithm used to generate checksum", "SHA256");
+core::Property HashContent::HashAttribute("Hash Attribute", "Attribute to store checksum to. When multiple algorithms are selected, "
+    "each checksum is stored in <Hash Attribute>.<algorithm>, e.g. Checksum.SHA256", "Checksum");
+core::Property HashContent::HashAlgorithm("Hash Algorithm", "Comma separated list of the algorithms used to generate checksums. "
+    "Supported algorithms: MD5, SHA1, SHA224, SHA256, SHA384, SHA512, XXH64", "SHA256");
 core::Property HashContent::FailOnEmpty("Fail on empty", "Route to failure relationship in case of empty content", "false");
+core::Property HashContent::ReadBufferSize(
+    core::PropertyBuilder::createProperty("Read Buffer Size")->withDescription("Size of the buffer used to read the content, capped at the size of the content")
+        ->withDefaultValue<core::DataSizeValue>("1 MB")->build());
 core::Relationship HashContent::Success("success", "success operational on the flow record");
 core::Relationship HashContent::Failure("failure", "failure operational on the flow record");
 
@@ -48,6 +57,8 @@ void HashContent::initialize() {
   std::set<core::Property> properties;
   properties.insert(HashAttribute);
   properties.insert(HashAlgorithm);
+  properties.insert(FailOnEmpty);
+  properties.insert(ReadBufferSize);
   setSupportedProperties(properties);
   //! Set the supported relationships
   std::set<core::Relationship> relationships;
@@ -60,19 +71,36 @@ void HashContent::onSchedule(core::ProcessContext *context, core::ProcessSession
   std::string value;
 
   attrKey_ = (context->getProperty(HashAttribute.getName(), value)) ? value : "Checksum";
-  algoName_ = (context->getProperty(HashAlgorithm.getName(), value)) ? value : "SHA256";
 
-  if (context->getProperty(HashAlgorithm.getName(), value)) {
+  algoNames_.clear();
+  const std::string algorithms = (context->getProperty(HashAlgorithm.getName(), value)) ? value : "SHA256";
+  for (const auto& algorithm : utils::StringUtils::split(algorithms, ",")) {
+    const std::string algoName = utils::HashUtils::normalizeAlgorithmName(algorithm);
+    if (algoName.empty()) {
+      continue;
+    }
+    if (!utils::HashUtils::createHasher(algoName)) {
+      throw Exception(PROCESS_SCHEDULE_EXCEPTION, "Unsupported hash algorithm: " + algorithm);
+    }
+    if (std::find(algoNames_.begin(), algoNames_.end(), algoName) == algoNames_.end()) {
+      algoNames_.push_back(algoName);
+    }
+  }
+  if (algoNames_.empty()) {
+    throw Exception(PROCESS_SCHEDULE_EXCEPTION, "At least one hash algorithm must be specified");
+  }
+
+  if (context->getProperty(FailOnEmpty.getName(), value)) {
     bool bool_value;
     failOnEmpty_ = utils::StringUtils::StringToBool(value, bool_value) && bool_value;  // Only true in case of valid true string
   } else {
     failOnEmpty_ = false;
   }
 
-  std::transform(algoName_.begin(), algoName_.end(), algoName_.begin(), ::toupper);
-
-  // Erase '-' to make sha-256 and sha-1 work, too
-  algoName_.erase(std::remove(algoName_.begin(), algoName_.end(), '-'), algoName_.end());
+  readBufferSize_ = io::HashingStream::DEFAULT_BUFFER_SIZE;
+  if (context->getProperty(ReadBufferSize.getName(), value)) {
+    core::Property::StringToInt(value, readBufferSize_);
+  }
 }
 
 void HashContent::onTrigger(core::ProcessContext *, core::ProcessSession *session) {
@@ -85,6 +113,7 @@ void HashContent::onTrigger(core::ProcessContext *, core::ProcessSession *sessio
 
   if (failOnEmpty_ && flowFile->getSize() == 0) {
     session->transfer(flowFile, Failure);
+    return;
   }
 
   logger_->log_trace("attempting read");
@@ -94,15 +123,27 @@ void HashContent::onTrigger(core::ProcessContext *, core::ProcessSession *sessio
 }
 
 int64_t HashContent::ReadCallback::process(std::shared_ptr<io::BaseStream> stream) {
-  // This throws in case algo is not found, but that's fine
-  parent_.logger_->log_trace("Searching for %s", parent_.algoName_);
-  auto algo = HashAlgos.at(parent_.algoName_);
+  std::vector<std::unique_ptr<utils::Hasher>> hashers;
+  hashers.reserve(parent_.algoNames_.size());
+  for (const auto& algoName : parent_.algoNames_) {
+    hashers.push_back(utils::HashUtils::createHasher(algoName));
+  }
 
-  const auto& ret_val = algo(stream);
+  io::HashingStream hashingStream(stream.get(), std::move(hashers));
+  const int64_t ret = hashingStream.consume(parent_.readBufferSize_);
+  if (ret < 0) {
+    parent_.logger_->log_error("Failed to read content of flow file %s", flowFile_->getUUIDStr());
+    return ret;
+  }
 
-  flowFile_->setAttribute(parent_.attrKey_, ret_val.first);
+  const bool singleAlgo = parent_.algoNames_.size() == 1;
+  for (const auto& digest : hashingStream.getDigests()) {
+    // an empty content has no checksum
+    const std::string checksum = ret > 0 ? digest.second : "";
+    flowFile_->setAttribute(singleAlgo ? parent_.attrKey_ : parent_.attrKey_ + "." + digest.first, checksum);
+  }
 
-  return ret_val.second;
+  return ret;
 }
 
 HashContent::ReadCallback::ReadCallback(std::shared_ptr<core::FlowFile> flowFile, const HashContent& parent)
@@ -22,17 +22,11 @@
 
 #ifdef OPENSSL_SUPPORT
 
-#include <openssl/md5.h>
-#include <openssl/sha.h>
-
 #include <stdint.h>
 
-#include <iomanip>
-#include <map>
 #include <memory>
 #include <string>
-#include <sstream>
-#include <utility>
+#include <vector>
 
 #include "FlowFileRecord.h"
 #include "core/Processor.h"
@@ -41,95 +35,12 @@
 #include "io/BaseStream.h"
 #include "utils/StringUtils.h"
 
-using HashReturnType = std::pair<std::string, int64_t>;
-
-// Without puttng this into its own namespace, the code would export already defined symbols.
-namespace { // NOLINT
-#define HASH_BUFFER_SIZE 16384
-
-  HashReturnType MD5Hash(const std::shared_ptr<org::apache::nifi::minifi::io::BaseStream>& stream) {
-    HashReturnType ret_val;
-    ret_val.second = 0;
-    uint8_t buffer[HASH_BUFFER_SIZE];
-    MD5_CTX context;
-    MD5_Init(&context);
-
-    size_t ret = 0;
-    do {
-      ret = stream->readData(buffer, HASH_BUFFER_SIZE);
-      if (ret > 0) {
-        MD5_Update(&context, buffer, ret);
-        ret_val.second += ret;
-      }
-    } while (ret > 0);
-
-    if (ret_val.second > 0) {
-      unsigned char digest[MD5_DIGEST_LENGTH];
-      MD5_Final(digest, &context);
-      ret_val.first = utils::StringUtils::to_hex(digest, MD5_DIGEST_LENGTH, true /*uppercase*/);
-    }
-    return ret_val;
-  }
-
-  HashReturnType SHA1Hash(const std::shared_ptr<org::apache::nifi::minifi::io::BaseStream>& stream) {
-    HashReturnType ret_val;
-    ret_val.second = 0;
-    uint8_t buffer[HASH_BUFFER_SIZE];
-    SHA_CTX context;
-    SHA1_Init(&context);
-
-    size_t ret = 0;
-    do {
-      ret = stream->readData(buffer, HASH_BUFFER_SIZE);
-      if (ret > 0) {
-        SHA1_Update(&context, buffer, ret);
-        ret_val.second += ret;
-      }
-    } while (ret > 0);
-
-    if (ret_val.second > 0) {
-      unsigned char digest[SHA_DIGEST_LENGTH];
-      SHA1_Final(digest, &context);
-      ret_val.first = utils::StringUtils::to_hex(digest, SHA_DIGEST_LENGTH, true /*uppercase*/);
-    }
-    return ret_val;
-  }
-
-  HashReturnType SHA256Hash(const std::shared_ptr<org::apache::nifi::minifi::io::BaseStream>& stream) {
-    HashReturnType ret_val;
-    ret_val.second = 0;
-    uint8_t buffer[HASH_BUFFER_SIZE];
-    SHA256_CTX context;
-    SHA256_Init(&context);
-
-    size_t ret;
-    do {
-      ret = stream->readData(buffer, HASH_BUFFER_SIZE);
-      if (ret > 0) {
-        SHA256_Update(&context, buffer, ret);
-        ret_val.second += ret;
-      }
-    } while (ret > 0);
-
-    if (ret_val.second > 0) {
-      unsigned char digest[SHA256_DIGEST_LENGTH];
-      SHA256_Final(digest, &context);
-      ret_val.first = utils::StringUtils::to_hex(digest, SHA256_DIGEST_LENGTH, true /*uppercase*/);
-    }
-    return ret_val;
-  }
-}  // namespace
-
-
 namespace org {
 namespace apache {
 namespace nifi {
 namespace minifi {
 namespace processors {
 
-static const std::map<std::string, const std::function<HashReturnType(const std::shared_ptr<io::BaseStream>&)>> HashAlgos =
-  { {"MD5",  MD5Hash}, {"SHA1", SHA1Hash}, {"SHA256", SHA256Hash} };
-
 //! HashContent Class
 class HashContent : public core::Processor {
  public:
@@ -147,6 +58,7 @@ class HashContent : public core::Processor {
   static core::Property HashAttribute;
   static core::Property HashAlgorithm;
   static core::Property FailOnEmpty;
+  static core::Property ReadBufferSize;
   //! Supported Relationships
   static core::Relationship Success;
   static core::Relationship Failure;
@@ -172,12 +84,13 @@ class HashContent : public core::Processor {
  private:
   //! Logger
   std::shared_ptr<logging::Logger> logger_;
-  std::string algoName_;
+  std::vector<std::string> algoNames_;
   std::string attrKey_;
   bool failOnEmpty_;
+  uint64_t readBufferSize_;
 };
 
-REGISTER_RESOURCE(HashContent,"HashContent calculates the checksum of the content of the flowfile and adds it as an attribute. Configuration options exist to select hashing algorithm and set the name of the attribute."); // NOLINT
+REGISTER_RESOURCE(HashContent,"HashContent calculates the checksums of the content of the flowfile and adds them as attributes. Multiple hashing algorithms can be selected, all of them are computed in a single pass over the content."); // NOLINT
 
 }  // namespace processors
 }  // namespace minifi
@@ -18,12 +18,19 @@
  * limitations under the License.
  */
 #include "ListenSyslog.h"
+#include <fcntl.h>
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cinttypes>
+#include <limits>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include <set>
-#include <queue>
 #include "utils/TimeUtil.h"
 #include "utils/StringUtils.h"
 #include "core/ProcessContext.h"
@@ -37,7 +44,8 @@ namespace minifi {
 namespace processors {
 #ifndef WIN32
 core::Property ListenSyslog::RecvBufSize(
-    core::PropertyBuilder::createProperty("Receive Buffer Size")->withDescription("The size of each buffer used to receive Syslog messages.")->
+    core::PropertyBuilder::createProperty("Receive Buffer Size")->withDescription("The size of each buffer used to receive Syslog messages. "
+                                                                                  "UDP datagrams and TCP messages without a delimiter larger than this are cut.")->
     withDefaultValue<core::DataSizeValue>("65507 B")->build());
 
 core::Property ListenSyslog::MaxSocketBufSize(
@@ -51,12 +59,19 @@ core::Property ListenSyslog::MaxConnections(
 core::Property ListenSyslog::MaxBatchSize(
     core::PropertyBuilder::createProperty("Max Batch Size")->withDescription("The maximum number of Syslog events to add to a single FlowFile.")->withDefaultValue<int>(1)->build());
 
+core::Property ListenSyslog::MaxQueueSize(
+    core::PropertyBuilder::createProperty("Max Size of Message Queue")->withDescription("The maximum number of received Syslog messages waiting to be written to FlowFiles. "
+                                                                                        "Messages received while the queue is full are dropped.")
+        ->withDefaultValue<int>(10000)->build());
+
 core::Property ListenSyslog::MessageDelimiter(
     core::PropertyBuilder::createProperty("Message Delimiter")->withDescription("Specifies the delimiter to place between Syslog messages when multiple "
                                                                                 "messages are bundled together (see <Max Batch Size> core::Property).")->withDefaultValue("\n")->build());
 
 core::Property ListenSyslog::ParseMessages(
-    core::PropertyBuilder::createProperty("Parse Messages")->withDescription("Indicates if the processor should parse the Syslog messages. If set to false, each outgoing FlowFile will only.")
+    core::PropertyBuilder::createProperty("Parse Messages")->withDescription("Indicates if the processor should parse the Syslog messages. If set to false, each outgoing FlowFile will only "
+                                                                             "contain the raw messages of a batch. If set to true, each message is written to its own FlowFile "
+                                                                             "with the parsed fields as attributes, ignoring <Max Batch Size>.")
         ->withDefaultValue<bool>(false)->build());
 
 core::Property ListenSyslog::Protocol(
@@ -69,6 +84,31 @@ core::Property ListenSyslog::Port(
 core::Relationship ListenSyslog::Success("success", "All files are routed to success");
 core::Relationship ListenSyslog::Invalid("invalid", "SysLog message format invalid");
 
+namespace {
+
+// upper limit of the memory used by the buffers of a single recvmmsg call
+constexpr size_t MAX_DATAGRAM_BUFFER_SIZE = 1024 * 1024;
+constexpr size_t MAX_DATAGRAMS_PER_READ = 64;
+constexpr int POLL_TIMEOUT_MS = 100;
+// batches kept for reuse
+constexpr size_t MAX_POOLED_BATCHES = 16;
+// longest length prefix accepted by octet counting framing
+constexpr size_t MAX_OCTET_COUNT_DIGITS = 9;
+
+/*
+ * Patterns of the NiFi syslog parser, restricted to capture groups that always participate in the match
+ * so that they work with every regular expression engine: priority, version, timestamp, hostname and body.
+ */
+const char * const RFC5424_PATTERN = "^<([0-9]{1,3})>([0-9]?) ?([0-9]{4}-[0-9]{2}-[0-9]{2}T[0-9:.]+[0-9Z:+-]*|-) ([A-Za-z0-9][A-Za-z0-9.@_-]*|-) (.*)$";
+const char * const RFC3164_PATTERN = "^<([0-9]{1,3})>([0-9]?) ?([A-Z][a-z][a-z]  ?[0-9]{1,2} [0-9]{2}:[0-9]{2}:[0-9]{2}) ([A-Za-z0-9][A-Za-z0-9.@_-]*) (.*)$";
+
+bool setNonBlocking(int fd) {
+  const int flags = fcntl(fd, F_GETFL, 0);
+  return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+}  // namespace
+
 void ListenSyslog::initialize() {
   // Set the supported properties
   std::set<core::Property> properties;
@@ -76,6 +116,7 @@ void ListenSyslog::initialize() {
   properties.insert(MaxSocketBufSize);
   properties.insert(MaxConnections);
   properties.insert(MaxBatchSize);
+  properties.insert(MaxQueueSize);
   properties.insert(MessageDelimiter);
   properties.insert(ParseMessages);
   properties.insert(Protocol);
@@ -88,234 +129,475 @@ void ListenSyslog::initialize() {
   setSupportedRelationships(relationships);
 }
 
-void ListenSyslog::startSocketThread() {
-  if (_thread != NULL)
-    return;
+void ListenSyslog::onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory) {
+  stopServer();
+
+  std::string value;
+  if (context->getProperty(Protocol.getName(), value)) {
+    protocol_ = value;
+  }
+  if (context->getProperty(RecvBufSize.getName(), value)) {
+    core::Property::StringToInt(value, recv_buf_size_);
+  }
+  if (context->getProperty(MaxSocketBufSize.getName(), value)) {
+    core::Property::StringToInt(value, max_socket_buf_size_);
+  }
+  if (context->getProperty(MaxConnections.getName(), value)) {
+    core::Property::StringToInt(value, max_connections_);
+  }
+  if (context->getProperty(MaxQueueSize.getName(), value)) {
+    core::Property::StringToInt(value, max_queue_size_);
+  }
+  if (context->getProperty(MessageDelimiter.getName(), value)) {
+    message_delimiter_ = value;
+  }
+  if (context->getProperty(ParseMessages.getName(), value)) {
+    org::apache::nifi::minifi::utils::StringUtils::StringToBool(value, parse_messages_);
+  }
+  if (context->getProperty(Port.getName(), value)) {
+    core::Property::StringToInt(value, port_);
+  }
+  if (context->getProperty(MaxBatchSize.getName(), value)) {
+    core::Property::StringToInt(value, max_batch_size_);
+  }
+  if (recv_buf_size_ <= 0) {
+    throw Exception(PROCESS_SCHEDULE_EXCEPTION, "Receive Buffer Size must be positive");
+  }
+  max_batch_size_ = std::max<int64_t>(max_batch_size_, 1);
+
+  if (parse_messages_) {
+    rfc5424_ = utils::Regex(RFC5424_PATTERN);
+    rfc3164_ = utils::Regex(RFC3164_PATTERN);
+  }
+
+  startServer();
+}
+
+void ListenSyslog::startServer() {
+  server_socket_ = openServerSocket();
+  if (server_socket_ < 0) {
+    throw Exception(PROCESS_SCHEDULE_EXCEPTION, "ListenSysLog failed to listen on port " + std::to_string(port_));
+  }
+#ifdef __linux__
+  poll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (poll_fd_ < 0) {
+    close(server_socket_);
+    server_socket_ = -1;
+    throw Exception(PROCESS_SCHEDULE_EXCEPTION, "ListenSysLog failed to create epoll instance");
+  }
+#endif
+  addToPoll(server_socket_);
+
+  size_t buffer_size = static_cast<size_t>(recv_buf_size_);
+  if (protocol_ != "TCP") {
+    const size_t datagrams = std::min(MAX_DATAGRAMS_PER_READ, std::max<size_t>(1, MAX_DATAGRAM_BUFFER_SIZE / buffer_size));
+    buffer_size *= datagrams;
+  }
+  recv_buffer_.resize(buffer_size);
 
   logger_->log_trace("ListenSysLog Socket Thread Start");
-  _serverTheadRunning = true;
-  _thread = new std::thread(run, this);
-  _thread->detach();
+  running_ = true;
+  server_thread_ = std::thread(&ListenSyslog::runServer, this);
 }
 
-void ListenSyslog::run(ListenSyslog *process) {
-  process->runThread();
+void ListenSyslog::stopServer() {
+  running_ = false;
+  if (server_thread_.joinable()) {
+    server_thread_.join();
+  }
+  for (const auto &connection : connections_) {
+    close(connection.first);
+  }
+  connections_.clear();
+  if (server_socket_ >= 0) {
+    logger_->log_debug("ListenSysLog Server socket %d close", server_socket_);
+    close(server_socket_);
+    server_socket_ = -1;
+  }
+  if (poll_fd_ >= 0) {
+    close(poll_fd_);
+    poll_fd_ = -1;
+  }
+#ifndef __linux__
+  poll_fds_.clear();
+#endif
 }
 
-void ListenSyslog::runThread() {
-  while (_serverTheadRunning) {
-    if (_resetServerSocket) {
-      _resetServerSocket = false;
-      // need to reset the socket
-      std::vector<int>::iterator it;
-      for (it = _clientSockets.begin(); it != _clientSockets.end(); ++it) {
-        int clientSocket = *it;
-        close(clientSocket);
-      }
-      _clientSockets.clear();
-      if (_serverSocket > 0) {
-        close(_serverSocket);
-        _serverSocket = 0;
-      }
+int ListenSyslog::openServerSocket() {
+  const bool tcp = protocol_ == "TCP";
+  int sockfd = socket(AF_INET, tcp ? SOCK_STREAM : SOCK_DGRAM, 0);
+  if (sockfd < 0) {
+    logger_->log_error("ListenSysLog Server socket creation failed");
+    return -1;
+  }
+  int opt = 1;
+  setsockopt(sockfd, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<char *>(&opt), sizeof(opt));
+  if (max_socket_buf_size_ > 0) {
+    int buf_size = static_cast<int>(std::min<int64_t>(max_socket_buf_size_, std::numeric_limits<int>::max()));
+    if (setsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<char *>(&buf_size), sizeof(buf_size)) < 0) {
+      logger_->log_warn("ListenSysLog failed to set the socket buffer size to %d", buf_size);
     }
+  }
+  struct sockaddr_in serv_addr;
+  memset(&serv_addr, 0, sizeof(serv_addr));
+  serv_addr.sin_family = AF_INET;
+  serv_addr.sin_addr.s_addr = INADDR_ANY;
+  serv_addr.sin_port = htons(static_cast<uint16_t>(port_));
+  if (bind(sockfd, reinterpret_cast<struct sockaddr *>(&serv_addr), sizeof(serv_addr)) < 0) {
+    logger_->log_error("ListenSysLog Server socket bind failed: %s", strerror(errno));
+    close(sockfd);
+    return -1;
+  }
+  if (tcp && listen(sockfd, 128) < 0) {
+    logger_->log_error("ListenSysLog Server socket listen failed: %s", strerror(errno));
+    close(sockfd);
+    return -1;
+  }
+  setNonBlocking(sockfd);
+  logger_->log_info("ListenSysLog Server socket %d bind OK to port %d", sockfd, port_);
+  return sockfd;
+}
 
-    if (_serverSocket <= 0) {
-      uint16_t portno = _port;
-      struct sockaddr_in serv_addr;
-      int sockfd;
-      if (_protocol == "TCP")
-        sockfd = socket(AF_INET, SOCK_STREAM, 0);
-      else
-        sockfd = socket(AF_INET, SOCK_DGRAM, 0);
-      if (sockfd < 0) {
-        logger_->log_error("ListenSysLog Server socket creation failed");
-        break;
-      }
-      bzero(reinterpret_cast<char *>(&serv_addr), sizeof(serv_addr));
-      serv_addr.sin_family = AF_INET;
-      serv_addr.sin_addr.s_addr = INADDR_ANY;
-      serv_addr.sin_port = htons(portno);
-      if (bind(sockfd, (struct sockaddr *) &serv_addr, sizeof(serv_addr)) < 0) {
-        logger_->log_error("ListenSysLog Server socket bind failed");
-        break;
-      }
-      if (_protocol == "TCP")
-        listen(sockfd, 5);
-      _serverSocket = sockfd;
-      logger_->log_info("ListenSysLog Server socket %d bind OK to port %d", _serverSocket, portno);
-    }
-    FD_ZERO(&_readfds);
-    FD_SET(_serverSocket, &_readfds);
-    _maxFds = _serverSocket;
-    std::vector<int>::iterator it;
-    for (it = _clientSockets.begin(); it != _clientSockets.end(); ++it) {
-      int clientSocket = *it;
-      if (clientSocket >= _maxFds)
-        _maxFds = clientSocket;
-      FD_SET(clientSocket, &_readfds);
+bool ListenSyslog::addToPoll(int fd) {
+#ifdef __linux__
+  struct epoll_event event;
+  memset(&event, 0, sizeof(event));
+  event.events = EPOLLIN;
+  event.data.fd = fd;
+  return epoll_ctl(poll_fd_, EPOLL_CTL_ADD, fd, &event) == 0;
+#else
+  struct pollfd entry;
+  entry.fd = fd;
+  entry.events = POLLIN;
+  entry.revents = 0;
+  poll_fds_.push_back(entry);
+  return true;
+#endif
+}
+
+void ListenSyslog::removeFromPoll(int fd) {
+#ifdef __linux__
+  struct epoll_event event;
+  epoll_ctl(poll_fd_, EPOLL_CTL_DEL, fd, &event);
+#else
+  poll_fds_.erase(std::remove_if(poll_fds_.begin(), poll_fds_.end(), [fd](const struct pollfd &entry) {
+    return entry.fd == fd;
+  }), poll_fds_.end());
+#endif
+}
+
+bool ListenSyslog::waitForEvents(std::vector<int> &ready, int timeout_ms) {
+  ready.clear();
+#ifdef __linux__
+  struct epoll_event events[64];
+  const int count = epoll_wait(poll_fd_, events, 64, timeout_ms);
+  if (count < 0) {
+    return errno == EINTR;
+  }
+  for (int i = 0; i < count; i++) {
+    ready.push_back(events[i].data.fd);
+  }
+#else
+  const int count = poll(poll_fds_.data(), poll_fds_.size(), timeout_ms);
+  if (count < 0) {
+    return errno == EINTR;
+  }
+  for (const auto &entry : poll_fds_) {
+    if (entry.revents != 0) {
+      ready.push_back(entry.fd);
     }
-    fd_set fds;
-    struct timeval tv;
-    int retval;
-    fds = _readfds;
-    tv.tv_sec = 0;
-    // 100 msec
-    tv.tv_usec = 100000;
-    retval = select(_maxFds + 1, &fds, NULL, NULL, &tv);
-    if (retval < 0)
+  }
+#endif
+  return true;
+}
+
+void ListenSyslog::runServer() {
+  std::vector<int> ready;
+  while (running_) {
+    if (!waitForEvents(ready, POLL_TIMEOUT_MS)) {
+      logger_->log_error("ListenSysLog failed to wait for socket events: %s", strerror(errno));
       break;
-    if (retval == 0)
-      continue;
-    if (FD_ISSET(_serverSocket, &fds)) {
-      // server socket, either we have UDP datagram or TCP connection request
-      if (_protocol == "TCP") {
-        socklen_t clilen;
-        struct sockaddr_in cli_addr;
-        clilen = sizeof(cli_addr);
-        int newsockfd = accept(_serverSocket, reinterpret_cast<struct sockaddr *>(&cli_addr), &clilen);
-        if (newsockfd > 0) {
-          if (_clientSockets.size() < (uint64_t) _maxConnections) {
-            _clientSockets.push_back(newsockfd);
-            logger_->log_info("ListenSysLog new client socket %d connection", newsockfd);
-            continue;
-          } else {
-            close(newsockfd);
-          }
-        }
-      } else {
-        socklen_t clilen;
-        struct sockaddr_in cli_addr;
-        clilen = sizeof(cli_addr);
-        int recvlen = recvfrom(_serverSocket, _buffer, sizeof(_buffer), 0, (struct sockaddr *) &cli_addr, &clilen);
-        if (recvlen > 0 && (uint64_t) (recvlen + getEventQueueByteSize()) <= _recvBufSize) {
-          uint8_t *payload = new uint8_t[recvlen];
-          memcpy(payload, _buffer, recvlen);
-          putEvent(payload, recvlen);
-        }
-      }
     }
-    it = _clientSockets.begin();
-    while (it != _clientSockets.end()) {
-      int clientSocket = *it;
-      if (FD_ISSET(clientSocket, &fds)) {
-        int recvlen = readline(clientSocket, _buffer, sizeof(_buffer));
-        if (recvlen <= 0) {
-          close(clientSocket);
-          logger_->log_debug("ListenSysLog client socket %d close", clientSocket);
-          it = _clientSockets.erase(it);
+    for (int fd : ready) {
+      if (fd == server_socket_) {
+        if (protocol_ == "TCP") {
+          acceptConnections();
         } else {
-          if ((uint64_t) (recvlen + getEventQueueByteSize()) <= _recvBufSize) {
-            uint8_t *payload = new uint8_t[recvlen];
-            memcpy(payload, _buffer, recvlen);
-            putEvent(payload, recvlen);
-          }
-          ++it;
+          receiveDatagrams();
         }
+        continue;
+      }
+      auto it = connections_.find(fd);
+      if (it != connections_.end() && !receiveStream(it->second)) {
+        logger_->log_debug("ListenSysLog client socket %d close", fd);
+        removeFromPoll(fd);
+        close(fd);
+        connections_.erase(it);
       }
     }
   }
-  return;
 }
 
-int ListenSyslog::readline(int fd, char *bufptr, size_t len) {
-  char *bufx = bufptr;
-  static char *bp;
-  static int cnt = 0;
-  static char b[2048];
-  char c;
-
-  while (--len > 0) {
-    if (--cnt <= 0) {
-      cnt = recv(fd, b, sizeof(b), 0);
-      if (cnt < 0) {
-        if (errno == EINTR) {
-          len++; /* the while will decrement */
-          continue;
+void ListenSyslog::acceptConnections() {
+  while (true) {
+    struct sockaddr_in cli_addr;
+    socklen_t clilen = sizeof(cli_addr);
+    int newsockfd = accept(server_socket_, reinterpret_cast<struct sockaddr *>(&cli_addr), &clilen);
+    if (newsockfd < 0) {
+      return;
+    }
+    if (connections_.size() >= static_cast<uint64_t>(max_connections_) || !setNonBlocking(newsockfd) || !addToPoll(newsockfd)) {
+      logger_->log_debug("ListenSysLog rejected client socket %d", newsockfd);
+      close(newsockfd);
+      continue;
+    }
+    connections_[newsockfd].fd = newsockfd;
+    logger_->log_info("ListenSysLog new client socket %d connection", newsockfd);
+  }
+}
+
+bool ListenSyslog::receiveStream(Connection &connection) {
+  const int recvlen = recv(connection.fd, recv_buffer_.data(), recv_buffer_.size(), 0);
+  if (recvlen < 0) {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+  }
+  if (recvlen == 0) {
+    // a final message without delimiter is still a message
+    if (!connection.pending.empty()) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      addMessage(connection.pending.data(), connection.pending.size());
+    }
+    return false;
+  }
+
+  const char *data = recv_buffer_.data();
+  size_t length = recvlen;
+  // frames are parsed in place unless the previous read ended in the middle of one
+  if (!connection.pending.empty()) {
+    connection.pending.append(data, length);
+    data = connection.pending.data();
+    length = connection.pending.size();
+  }
+
+  size_t consumed;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    consumed = frameMessages(data, length);
+    // an incomplete frame never exceeds the length prefix plus the receive buffer size, anything longer is cut
+    if (length - consumed > static_cast<size_t>(recv_buf_size_) + MAX_OCTET_COUNT_DIGITS + 1) {
+      addMessage(data + consumed, length - consumed);
+      consumed = length;
+    }
+  }
+
+  if (data == recv_buffer_.data()) {
+    connection.pending.assign(data + consumed, length - consumed);
+  } else {
+    connection.pending.erase(0, consumed);
+  }
+  return true;
+}
+
+void ListenSyslog::receiveDatagrams() {
+  const size_t slot_size = static_cast<size_t>(recv_buf_size_);
+  const size_t slots = recv_buffer_.size() / slot_size;
+#ifdef __linux__
+  struct mmsghdr messages[MAX_DATAGRAMS_PER_READ];
+  struct iovec iovecs[MAX_DATAGRAMS_PER_READ];
+  memset(messages, 0, sizeof(messages));
+  for (size_t i = 0; i < slots; i++) {
+    iovecs[i].iov_base = recv_buffer_.data() + i * slot_size;
+    iovecs[i].iov_len = slot_size;
+    messages[i].msg_hdr.msg_iov = &iovecs[i];
+    messages[i].msg_hdr.msg_iovlen = 1;
+  }
+  const int count = recvmmsg(server_socket_, messages, slots, MSG_DONTWAIT, nullptr);
+  if (count <= 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (int i = 0; i < count; i++) {
+    size_t length = messages[i].msg_len;
+    const char *data = recv_buffer_.data() + i * slot_size;
+    while (length > 0 && (data[length - 1] == '\n' || data[length - 1] == '\r')) {
+      --length;
+    }
+    if (length > 0) {
+      addMessage(data, length);
+    }
+  }
+#else
+  for (size_t i = 0; i < slots; i++) {
+    char *data = recv_buffer_.data() + i * slot_size;
+    const int recvlen = recv(server_socket_, data, slot_size, MSG_DONTWAIT);
+    if (recvlen <= 0) {
+      return;
+    }
+    size_t length = recvlen;
+    while (length > 0 && (data[length - 1] == '\n' || data[length - 1] == '\r')) {
+      --length;
+    }
+    if (length > 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      addMessage(data, length);
+    }
+  }
+#endif
+}
+
+size_t ListenSyslog::frameMessages(const char *data, size_t length) {
+  size_t pos = 0;
+  while (pos < length) {
+    if (data[pos] >= '1' && data[pos] <= '9') {
+      // octet counting: MSG-LEN SP SYSLOG-MSG
+      size_t digits_end = pos;
+      uint64_t message_length = 0;
+      while (digits_end < length && isdigit(static_cast<unsigned char>(data[digits_end])) && digits_end - pos < MAX_OCTET_COUNT_DIGITS) {
+        message_length = message_length * 10 + (data[digits_end] - '0');
+        ++digits_end;
+      }
+      if (digits_end == length) {
+        break;
+      }
+      if (data[digits_end] == ' ' && message_length <= static_cast<uint64_t>(recv_buf_size_)) {
+        const size_t message_start = digits_end + 1;
+        if (length - message_start < message_length) {
+          break;
         }
-        return -1;
+        addMessage(data + message_start, message_length);
+        pos = message_start + message_length;
+        continue;
       }
-      if (cnt == 0)
-        return 0;
-      bp = b;
+      // not a length prefix, fall back to the newline delimiter
     }
-    c = *bp++;
-    *bufptr++ = c;
-    if (c == '\n') {
-      *bufptr = '\n';
-      return bufptr - bufx + 1;
+    const char *newline = static_cast<const char *>(memchr(data + pos, '\n', length - pos));
+    if (newline == nullptr) {
+      break;
     }
+    size_t end = newline - data;
+    const size_t next = end + 1;
+    if (end > pos && data[end - 1] == '\r') {
+      --end;
+    }
+    if (end > pos) {
+      addMessage(data + pos, end - pos);
+    }
+    pos = next;
   }
-  return -1;
+  return pos;
 }
 
-void ListenSyslog::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
-  std::string value;
-  bool needResetServerSocket = false;
-  if (context->getProperty(Protocol.getName(), value)) {
-    if (_protocol != value)
-      needResetServerSocket = true;
-    _protocol = value;
-  }
-  if (context->getProperty(RecvBufSize.getName(), value)) {
-    core::Property::StringToInt(value, _recvBufSize);
+void ListenSyslog::addMessage(const char *data, size_t length) {
+  if (queued_messages_ >= max_queue_size_) {
+    if (dropped_messages_++ % 10000 == 0) {
+      logger_->log_warn("ListenSysLog message queue is full, %" PRIu64 " messages dropped so far", dropped_messages_);
+    }
+    return;
   }
-  if (context->getProperty(MaxSocketBufSize.getName(), value)) {
-    core::Property::StringToInt(value, _maxSocketBufSize);
+  if (!open_batch_) {
+    open_batch_ = newBatch();
   }
-  if (context->getProperty(MaxConnections.getName(), value)) {
-    core::Property::StringToInt(value, _maxConnections);
+  std::string &buffer = open_batch_->data;
+  if (!open_batch_->messages.empty()) {
+    buffer.append(message_delimiter_);
   }
-  if (context->getProperty(MessageDelimiter.getName(), value)) {
-    _messageDelimiter = value;
+  open_batch_->messages.emplace_back(buffer.size(), length);
+  buffer.append(data, length);
+  ++queued_messages_;
+  if (open_batch_->messages.size() >= static_cast<uint64_t>(max_batch_size_)) {
+    ready_batches_.push_back(std::move(open_batch_));
   }
-  if (context->getProperty(ParseMessages.getName(), value)) {
-    org::apache::nifi::minifi::utils::StringUtils::StringToBool(value, _parseMessages);
+}
+
+std::unique_ptr<ListenSyslog::MessageBatch> ListenSyslog::newBatch() {
+  if (batch_pool_.empty()) {
+    return std::unique_ptr<MessageBatch>(new MessageBatch());
   }
-  if (context->getProperty(Port.getName(), value)) {
-    int64_t oldPort = _port;
-    core::Property::StringToInt(value, _port);
-    if (_port != oldPort)
-      needResetServerSocket = true;
+  std::unique_ptr<MessageBatch> batch = std::move(batch_pool_.back());
+  batch_pool_.pop_back();
+  return batch;
+}
+
+std::unique_ptr<ListenSyslog::MessageBatch> ListenSyslog::takeBatch() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::unique_ptr<MessageBatch> batch;
+  if (!ready_batches_.empty()) {
+    batch = std::move(ready_batches_.front());
+    ready_batches_.pop_front();
+  } else if (open_batch_) {
+    // do not hold back messages waiting for the batch to fill up
+    batch = std::move(open_batch_);
+  } else {
+    return nullptr;
   }
-  if (context->getProperty(MaxBatchSize.getName(), value)) {
-    core::Property::StringToInt(value, _maxBatchSize);
+  queued_messages_ -= batch->messages.size();
+  return batch;
+}
+
+void ListenSyslog::releaseBatch(std::unique_ptr<MessageBatch> batch) {
+  batch->clear();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (batch_pool_.size() < MAX_POOLED_BATCHES) {
+    batch_pool_.push_back(std::move(batch));
   }
+}
 
-  if (needResetServerSocket)
-    _resetServerSocket = true;
+void ListenSyslog::transferParsed(core::ProcessSession *session, const std::string &message) {
+  std::shared_ptr<core::FlowFile> flowFile = session->create();
+  if (!flowFile) {
+    return;
+  }
+  ListenSyslog::WriteCallback callback(message.data(), message.size());
+  session->write(flowFile, &callback);
+  session->putAttribute(flowFile, "syslog.protocol", protocol_);
+  session->putAttribute(flowFile, "syslog.port", std::to_string(port_));
 
-  startSocketThread();
+  std::vector<std::string> groups;
+  size_t match_end;
+  if ((rfc5424_.search(message, 0, groups, match_end) || rfc3164_.search(message, 0, groups, match_end)) && groups.size() == 6) {
+    int priority = std::stoi(groups[1]);
+    session->putAttribute(flowFile, "syslog.priority", groups[1]);
+    session->putAttribute(flowFile, "syslog.severity", std::to_string(priority % 8));
+    session->putAttribute(flowFile, "syslog.facility", std::to_string(priority / 8));
+    if (!groups[2].empty()) {
+      session->putAttribute(flowFile, "syslog.version", groups[2]);
+    }
+    session->putAttribute(flowFile, "syslog.timestamp", groups[3]);
+    session->putAttribute(flowFile, "syslog.hostname", groups[4]);
+    session->putAttribute(flowFile, "syslog.body", groups[5]);
+    session->putAttribute(flowFile, "syslog.valid", "true");
+    session->transfer(flowFile, Success);
+  } else {
+    session->putAttribute(flowFile, "syslog.valid", "false");
+    session->transfer(flowFile, Invalid);
+  }
+}
 
-  // read from the event queue
-  if (isEventQueueEmpty()) {
+void ListenSyslog::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
+  std::unique_ptr<MessageBatch> batch = takeBatch();
+  if (!batch) {
     context->yield();
     return;
   }
 
-  std::queue<SysLogEvent> eventQueue;
-  pollEvent(eventQueue, _maxBatchSize);
-  bool firstEvent = true;
-  std::shared_ptr<FlowFileRecord> flowFile = NULL;
-  while (!eventQueue.empty()) {
-    SysLogEvent event = eventQueue.front();
-    eventQueue.pop();
-    if (firstEvent) {
-      flowFile = std::static_pointer_cast<FlowFileRecord>(session->create());
-      if (!flowFile)
-        return;
-      ListenSyslog::WriteCallback callback(event.payload, event.len);
+  if (parse_messages_) {
+    // parsing runs here, on the scheduler's threads, to keep the receiving thread free
+    std::string message;
+    for (const auto &location : batch->messages) {
+      message.assign(batch->data, location.first, location.second);
+      transferParsed(session, message);
+    }
+  } else {
+    std::shared_ptr<core::FlowFile> flowFile = session->create();
+    if (flowFile) {
+      ListenSyslog::WriteCallback callback(batch->data.data(), batch->data.size());
       session->write(flowFile, &callback);
-      delete[] event.payload;
-      firstEvent = false;
-    } else {
-      ListenSyslog::WriteCallback callback(event.payload, event.len);
-      session->append(flowFile, &callback);
-      delete[] event.payload;
+      session->putAttribute(flowFile, "syslog.protocol", protocol_);
+      session->putAttribute(flowFile, "syslog.port", std::to_string(port_));
+      session->transfer(flowFile, Success);
     }
   }
-  flowFile->addAttribute("syslog.protocol", _protocol);
-  flowFile->addAttribute("syslog.port", std::to_string(_port));
-  session->transfer(flowFile, Success);
+  releaseBatch(std::move(batch));
 }
 #endif
 } /* namespace processors */
@@ -23,17 +23,26 @@
 #include <stdio.h>
 #include <sys/types.h>
 
+#include <atomic>
+#include <deque>
 #include <memory>
-#include <queue>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #ifndef WIN32
 #include <arpa/inet.h>
 #include <netinet/in.h>
-#include <sys/select.h>
 #include <sys/socket.h>
 #include <sys/time.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
 
 #else
 #include <WinSock2.h>
@@ -41,15 +50,13 @@
 #endif
 #include <errno.h>
 
-#include <chrono>
-#include <thread>
-
 #include "core/Core.h"
 #include "core/logging/LoggerConfiguration.h"
 #include "core/Processor.h"
 #include "core/ProcessSession.h"
 #include "core/Resource.h"
 #include "FlowFileRecord.h"
+#include "utils/RegexUtils.h"
 
 #ifndef WIN32
 
@@ -59,13 +66,6 @@ namespace nifi {
 namespace minifi {
 namespace processors {
 
-
-// SyslogEvent
-typedef struct {
-  char *payload;
-  uint64_t len;
-} SysLogEvent;
-
 // ListenSyslog Class
 class ListenSyslog : public core::Processor {
  public:
@@ -75,41 +75,25 @@ class ListenSyslog : public core::Processor {
    */
   ListenSyslog(std::string name,  utils::Identifier uuid = utils::Identifier()) // NOLINT
       : Processor(name, uuid),
-        logger_(logging::LoggerFactory<ListenSyslog>::getLogger()) {
-    _eventQueueByteSize = 0;
-    _serverSocket = 0;
-    _recvBufSize = 65507;
-    _maxSocketBufSize = 1024 * 1024;
-    _maxConnections = 2;
-    _maxBatchSize = 1;
-    _messageDelimiter = "\n";
-    _protocol = "UDP";
-    _port = 514;
-    _parseMessages = false;
-    _serverSocket = 0;
-    _maxFds = 0;
-    FD_ZERO(&_readfds);
-    _thread = NULL;
-    _resetServerSocket = false;
-    _serverTheadRunning = false;
+        logger_(logging::LoggerFactory<ListenSyslog>::getLogger()),
+        recv_buf_size_(65507),
+        max_socket_buf_size_(1024 * 1024),
+        max_connections_(2),
+        max_batch_size_(1),
+        max_queue_size_(10000),
+        message_delimiter_("\n"),
+        protocol_("UDP"),
+        port_(514),
+        parse_messages_(false),
+        running_(false),
+        server_socket_(-1),
+        poll_fd_(-1),
+        queued_messages_(0),
+        dropped_messages_(0) {
   }
   // Destructor
   virtual ~ListenSyslog() {
-    _serverTheadRunning = false;
-    if (this->_thread)
-      delete this->_thread;
-    // need to reset the socket
-    std::vector<int>::iterator it;
-    for (it = _clientSockets.begin(); it != _clientSockets.end(); ++it) {
-      int clientSocket = *it;
-      close(clientSocket);
-    }
-    _clientSockets.clear();
-    if (_serverSocket > 0) {
-      logger_->log_debug("ListenSysLog Server socket %d close", _serverSocket);
-      close(_serverSocket);
-      _serverSocket = 0;
-    }
+    stopServer();
   }
   // Processor Name
   static constexpr char const *ProcessorName = "ListenSyslog";
@@ -118,6 +102,7 @@ class ListenSyslog : public core::Processor {
   static core::Property MaxSocketBufSize;
   static core::Property MaxConnections;
   static core::Property MaxBatchSize;
+  static core::Property MaxQueueSize;
   static core::Property MessageDelimiter;
   static core::Property ParseMessages;
   static core::Property Protocol;
@@ -128,8 +113,8 @@ class ListenSyslog : public core::Processor {
   // Nest Callback Class for write stream
   class WriteCallback : public OutputStreamCallback {
    public:
-    WriteCallback(char *data, uint64_t size)
-        : _data(reinterpret_cast<uint8_t*>(data)),
+    WriteCallback(const char *data, uint64_t size)
+        : _data(reinterpret_cast<uint8_t*>(const_cast<char*>(data))),
           _dataSize(size) {
     }
     uint8_t *_data;
@@ -147,78 +132,97 @@ class ListenSyslog : public core::Processor {
   virtual void onTrigger(core::ProcessContext *context, core::ProcessSession *session);
   // Initialize, over write by NiFi ListenSyslog
   virtual void initialize(void);
+  // Reads the properties and starts the receiving thread
+  virtual void onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory);
+
+ protected:
+  virtual void notifyStop() {
+    stopServer();
+  }
 
  private:
+  /**
+   * Messages received by the server thread, stored back to back in a single buffer
+   * with the message delimiter between them, so that a batch is written to its
+   * FlowFile in one write. Batches are recycled to avoid reallocating the buffer.
+   */
+  struct MessageBatch {
+    std::string data;
+    // offset and length of each message in data
+    std::vector<std::pair<size_t, size_t>> messages;
+
+    void clear() {
+      data.clear();
+      messages.clear();
+    }
+  };
+
+  // TCP client connection along with the bytes of its last, incomplete frame
+  struct Connection {
+    int fd;
+    std::string pending;
+  };
+
   // Logger
   std::shared_ptr<logging::Logger> logger_;
-  // Run function for the thread
-  static void run(ListenSyslog *process);
-  // Run Thread
-  void runThread();
-  // Queue for store syslog event
-  std::queue<SysLogEvent> _eventQueue;
-  // Size of Event queue in bytes
-  uint64_t _eventQueueByteSize;
-  // Get event queue size
-  uint64_t getEventQueueSize() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return _eventQueue.size();
-  }
-  // Get event queue byte size
-  uint64_t getEventQueueByteSize() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return _eventQueueByteSize;
-  }
-  // Whether the event queue  is empty
-  bool isEventQueueEmpty() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return _eventQueue.empty();
-  }
-  // Put event into directory listing
-  void putEvent(uint8_t *payload, uint64_t len) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    SysLogEvent event;
-    event.payload = reinterpret_cast<char*>(payload);
-    event.len = len;
-    _eventQueue.push(event);
-    _eventQueueByteSize += len;
-  }
-  // Read \n terminated line from TCP socket
-  int readline(int fd, char *bufptr, size_t len);
-  // start server socket and handling client socket
-  void startSocketThread();
-  // Poll event
-  void pollEvent(std::queue<SysLogEvent> &list, int maxSize) {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    while (!_eventQueue.empty() && (maxSize == 0 || list.size() < maxSize)) {
-      SysLogEvent event = _eventQueue.front();
-      _eventQueue.pop();
-      _eventQueueByteSize -= event.len;
-      list.push(event);
-    }
-    return;
-  }
-  // Mutex for protection of the directory listing
+
+  void startServer();
+  void stopServer();
+  int openServerSocket();
+  // Server thread: waits for readable sockets and frames the received messages
+  void runServer();
+  bool addToPoll(int fd);
+  void removeFromPoll(int fd);
+  // Waits at most timeout_ms for readable sockets, returns their descriptors in ready
+  bool waitForEvents(std::vector<int> &ready, int timeout_ms);
+  void acceptConnections();
+  // Returns false once the connection is closed
+  bool receiveStream(Connection &connection);
+  void receiveDatagrams();
+  /**
+   * Splits data into messages using octet counting (RFC 6587) when a frame starts with its length,
+   * and newline delimiters otherwise.
+   * @return number of bytes consumed, the rest is an incomplete frame
+   */
+  size_t frameMessages(const char *data, size_t length);
+  // Appends a message to the open batch, mutex_ must be held
+  void addMessage(const char *data, size_t length);
+  std::unique_ptr<MessageBatch> takeBatch();
+  void releaseBatch(std::unique_ptr<MessageBatch> batch);
+  std::unique_ptr<MessageBatch> newBatch();
+  void transferParsed(core::ProcessSession *session, const std::string &message);
+
+  int64_t recv_buf_size_;
+  int64_t max_socket_buf_size_;
+  int64_t max_connections_;
+  int64_t max_batch_size_;
+  int64_t max_queue_size_;
+  std::string message_delimiter_;
+  std::string protocol_;
+  int64_t port_;
+  bool parse_messages_;
+  utils::Regex rfc5424_;
+  utils::Regex rfc3164_;
+
+  std::atomic<bool> running_;
+  std::thread server_thread_;
+  int server_socket_;
+  // epoll instance, unused by the poll() fallback
+  int poll_fd_;
+#ifndef __linux__
+  std::vector<struct pollfd> poll_fds_;
+#endif
+  // accessed only by the server thread
+  std::unordered_map<int, Connection> connections_;
+  std::vector<char> recv_buffer_;
+
+  // Mutex for protection of the batches
   std::mutex mutex_;
-  int64_t _recvBufSize;
-  int64_t _maxSocketBufSize;
-  int64_t _maxConnections;
-  int64_t _maxBatchSize;
-  std::string _messageDelimiter;
-  std::string _protocol;
-  int64_t _port;
-  bool _parseMessages;
-  int _serverSocket;
-  std::vector<int> _clientSockets;
-  int _maxFds;
-  fd_set _readfds;
-  // thread
-  std::thread *_thread;
-  // whether to reset the server socket
-  bool _resetServerSocket; bool _serverTheadRunning;
-  // buffer for read socket
-  char _buffer[2048];
+  std::unique_ptr<MessageBatch> open_batch_;
+  std::deque<std::unique_ptr<MessageBatch>> ready_batches_;
+  std::vector<std::unique_ptr<MessageBatch>> batch_pool_;
+  int64_t queued_messages_;
+  uint64_t dropped_messages_;
 };
 
 REGISTER_RESOURCE(ListenSyslog, "Listens for Syslog messages being sent to a given port over TCP or UDP. Incoming messages are checked against regular expressions for RFC5424 and RFC3164 formatted messages. " // NOLINT
@@ -131,10 +131,8 @@ void LogAttribute::onTrigger(const std::shared_ptr<core::ProcessContext> &contex
     message << "\n" << "lineageStartDate:" << getTimeStr(flow->getlineageStartDate());
     message << "\n" << "Size:" << flow->getSize() << " Offset:" << flow->getOffset();
     message << "\nFlowFile Attributes Map Content";
-    std::map<std::string, std::string> attrs = flow->getAttributes();
-    std::map<std::string, std::string>::iterator it;
-    for (it = attrs.begin(); it != attrs.end(); it++) {
-      message << "\n" << "key:" << it->first << " value:" << it->second;
+    for (const auto& attr : flow->getAttributes()) {
+      message << "\n" << "key:" << attr.first << " value:" << attr.second;
     }
     message << "\nFlowFile Resource Claim Content";
     std::shared_ptr<ResourceClaim> claim = flow->getResourceClaim();
@@ -20,9 +20,13 @@
 
 #include "RouteOnAttribute.h"
 
+#include <algorithm>
 #include <memory>
+#include <regex>
 #include <string>
 #include <set>
+#include <utility>
+#include <vector>
 
 namespace org {
 namespace apache {
@@ -33,8 +37,31 @@ namespace processors {
 core::Relationship RouteOnAttribute::Unmatched("unmatched", "Files which do not match any expression are routed here");
 core::Relationship RouteOnAttribute::Failure("failure", "Failed files are transferred to failure");
 
+core::Property RouteOnAttribute::BatchSize(
+    core::PropertyBuilder::createProperty("Batch Size")->withDescription("The maximum number of flow files to route in each iteration")->withDefaultValue<uint32_t>(10)->build());
+
+namespace {
+
+/**
+ * Recognizes expressions of the form ${attribute:equals('literal')}. Only literals without quotes,
+ * escapes or nested expressions qualify, so the literal compares exactly as the expression language would.
+ */
+bool parseEqualityPredicate(const std::string &expression, std::string &attribute, std::string &value) {
+  static const std::regex equality_predicate("^\\$\\{([a-zA-Z][a-zA-Z_0-9.]*):equals\\((['\"])([^'\"\\\\$]*)\\2\\)\\}$");
+  std::smatch match;
+  if (!std::regex_match(expression, match, equality_predicate)) {
+    return false;
+  }
+  attribute = match[1];
+  value = match[3];
+  return true;
+}
+
+}  // namespace
+
 void RouteOnAttribute::initialize() {
   std::set<core::Property> properties;
+  properties.insert(BatchSize);
   setSupportedProperties(properties);
   std::set<core::Relationship> relationships;
   relationships.insert(Unmatched);
@@ -60,34 +87,93 @@ void RouteOnAttribute::onDynamicPropertyModified(const core::Property &orig_prop
   setSupportedRelationships(relationships);
 }
 
+void RouteOnAttribute::onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory) {
+  if (!context->getProperty(BatchSize.getName(), batch_size_) || batch_size_ == 0) {
+    batch_size_ = 1;
+  }
+
+  routes_.clear();
+  dispatch_tables_.clear();
+  evaluated_routes_.clear();
+
+  for (const auto &route_property : route_properties_) {
+    const size_t index = routes_.size();
+    routes_.push_back(Route { route_rels_[route_property.first], context->getDynamicPropertyHandle(route_property.second) });
+
+    std::string expression;
+    std::string attribute;
+    std::string value;
+    if (context->getDynamicProperty(route_property.first, expression) && parseEqualityPredicate(expression, attribute, value)) {
+      auto table = std::find_if(dispatch_tables_.begin(), dispatch_tables_.end(), [&attribute](const EqualityDispatch &dispatch) {
+        return dispatch.attribute == attribute;
+      });
+      if (table == dispatch_tables_.end()) {
+        dispatch_tables_.push_back(EqualityDispatch { attribute, { }, { } });
+        table = std::prev(dispatch_tables_.end());
+      }
+      table->routes_by_value.emplace(value, index);
+      table->routes.push_back(index);
+    } else {
+      evaluated_routes_.push_back(index);
+    }
+  }
+
+  logger_->log_debug("RouteOnAttribute dispatches %d route(s) on %d attribute(s), evaluates %d route(s)", routes_.size() - evaluated_routes_.size(), dispatch_tables_.size(),
+                     evaluated_routes_.size());
+}
+
 void RouteOnAttribute::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
-  auto flow_file = session->get();
+  for (uint32_t i = 0; i < batch_size_; i++) {
+    auto flow_file = session->get();
 
-  // Do nothing if there are no incoming files
-  if (!flow_file) {
-    return;
+    // Do nothing if there are no incoming files
+    if (!flow_file) {
+      return;
+    }
+
+    route(context, session, flow_file);
   }
+}
 
+void RouteOnAttribute::route(core::ProcessContext *context, core::ProcessSession *session, const std::shared_ptr<core::FlowFile> &flow_file) {
   try {
-    bool did_match = false;
-
-    // Perform dynamic routing logic
-    for (const auto &route : route_properties_) {
-      std::string do_route;
-      context->getDynamicProperty(route.second, do_route, flow_file);
+    std::vector<size_t> matched;
+
+    for (const auto &table : dispatch_tables_) {
+      std::string value;
+      if (flow_file->getAttribute(table.attribute, value)) {
+        const auto range = table.routes_by_value.equal_range(value);
+        for (auto it = range.first; it != range.second; ++it) {
+          matched.push_back(it->second);
+        }
+      } else {
+        // a missing attribute may still resolve from the configuration, leave that to the expression language
+        for (const auto index : table.routes) {
+          if (evaluate(context, index, flow_file)) {
+            matched.push_back(index);
+          }
+        }
+      }
+    }
 
-      if (do_route == "true") {
-        did_match = true;
-        auto clone = session->clone(flow_file);
-        session->transfer(clone, route_rels_[route.first]);
+    for (const auto index : evaluated_routes_) {
+      if (evaluate(context, index, flow_file)) {
+        matched.push_back(index);
       }
     }
 
-    if (!did_match) {
+    if (matched.empty()) {
       session->transfer(flow_file, Unmatched);
-    } else {
-      session->remove(flow_file);
+      return;
     }
+
+    // keep the routes in the order of their names, independent of how they were matched
+    std::sort(matched.begin(), matched.end());
+    for (const auto index : matched) {
+      auto clone = session->clone(flow_file);
+      session->transfer(clone, routes_[index].relationship);
+    }
+    session->remove(flow_file);
   } catch (const std::exception &e) {
     logger_->log_error("Caught exception while updating attributes: %s", e.what());
     session->transfer(flow_file, Failure);
@@ -95,6 +181,12 @@ void RouteOnAttribute::onTrigger(core::ProcessContext *context, core::ProcessSes
   }
 }
 
+bool RouteOnAttribute::evaluate(core::ProcessContext *context, size_t route, const std::shared_ptr<core::FlowFile> &flow_file) const {
+  std::string do_route;
+  context->getProperty(routes_[route].handle, do_route, flow_file);
+  return do_route == "true";
+}
+
 } /* namespace processors */
 } /* namespace minifi */
 } /* namespace nifi */
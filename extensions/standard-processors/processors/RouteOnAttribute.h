@@ -23,6 +23,8 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "FlowFileRecord.h"
 #include "core/Processor.h"
@@ -51,6 +53,12 @@ class RouteOnAttribute : public core::Processor {
   static core::Relationship Unmatched;
   static core::Relationship Failure;
 
+  /**
+   * Properties
+   */
+
+  static core::Property BatchSize;
+
   /**
    * NiFi API implementation
    */
@@ -63,14 +71,44 @@ class RouteOnAttribute : public core::Processor {
     return true;
   }
 
+  virtual bool supportsBatching() const {
+    return true;
+  }
+
   virtual void onDynamicPropertyModified(const core::Property &orig_property, const core::Property &new_property);
+  virtual void onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory);
   virtual void onTrigger(core::ProcessContext *context, core::ProcessSession *session);
   virtual void initialize(void);
 
  private:
+  struct Route {
+    core::Relationship relationship;
+    core::PropertyHandle handle;
+  };
+
+  /**
+   * Routes whose expression compares a single attribute to a literal, e.g. ${status:equals('ok')}, indexed
+   * by the literal, so that all of them are decided by one attribute lookup and one hash lookup.
+   */
+  struct EqualityDispatch {
+    std::string attribute;
+    std::unordered_multimap<std::string, size_t> routes_by_value;
+    std::vector<size_t> routes;
+  };
+
+  void route(core::ProcessContext *context, core::ProcessSession *session, const std::shared_ptr<core::FlowFile> &flow_file);
+
+  bool evaluate(core::ProcessContext *context, size_t route, const std::shared_ptr<core::FlowFile> &flow_file) const;
+
   std::shared_ptr<logging::Logger> logger_;
   std::map<std::string, core::Property> route_properties_;
   std::map<std::string, core::Relationship> route_rels_;
+
+  std::vector<Route> routes_;
+  std::vector<EqualityDispatch> dispatch_tables_;
+  // routes which are not equality tests and are evaluated one by one
+  std::vector<size_t> evaluated_routes_;
+  uint32_t batch_size_ = 1;
 };
 
 REGISTER_RESOURCE(RouteOnAttribute, "Routes FlowFiles based on their Attributes using the Attribute Expression Language.");
@@ -49,7 +49,8 @@ void UpdateAttribute::onSchedule(core::ProcessContext *context, core::ProcessSes
   logger_->log_info("UpdateAttribute registering %d keys", dynamic_prop_keys.size());
 
   for (const auto &key : dynamic_prop_keys) {
-    attributes_.emplace_back(core::PropertyBuilder::createProperty(key)->withDescription("auto generated")->supportsExpressionLanguage(true)->build());
+    const auto property = core::PropertyBuilder::createProperty(key)->withDescription("auto generated")->supportsExpressionLanguage(true)->build();
+    attributes_.push_back(context->getDynamicPropertyHandle(property));
     logger_->log_info("UpdateAttribute registered attribute '%s'", key);
   }
 }
@@ -65,7 +66,7 @@ void UpdateAttribute::onTrigger(core::ProcessContext *context, core::ProcessSess
   try {
     for (const auto &attribute : attributes_) {
       std::string value;
-      context->getDynamicProperty(attribute, value, flow_file);
+      context->getProperty(attribute, value, flow_file);
       flow_file->setAttribute(attribute.getName(), value);
       logger_->log_info("Set attribute '%s' of flow file '%s' with value '%s'", attribute.getName(), flow_file->getUUIDStr(), value);
     }
@@ -59,6 +59,10 @@ class UpdateAttribute : public core::Processor {
     return true;
   }
 
+  virtual bool supportsBatching() const {
+    return true;
+  }
+
   virtual void onSchedule(core::ProcessContext *context,
                           core::ProcessSessionFactory *sessionFactory);
   virtual void onTrigger(core::ProcessContext *context,
@@ -67,7 +71,7 @@ class UpdateAttribute : public core::Processor {
 
  private:
   std::shared_ptr<logging::Logger> logger_;
-  std::vector<core::Property> attributes_;
+  std::vector<core::PropertyHandle> attributes_;
 };
 
 REGISTER_RESOURCE(UpdateAttribute, "This processor updates the attributes of a FlowFile using properties that are added by the user. "
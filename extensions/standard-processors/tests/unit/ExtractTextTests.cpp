@@ -98,7 +98,8 @@ TEST_CASE("Test usage of ExtractText", "[extracttextTest]") {
 
   REQUIRE(LogTestController::getInstance().contains(log_check));
 
-  plan->reset();
+  // properties are read in onSchedule, so the processor has to be rescheduled to pick up the new size limit
+  plan->reset(true);
 
   plan->setProperty(maprocessor, org::apache::nifi::minifi::processors::ExtractText::SizeLimit.getName(), "4");
 
@@ -181,3 +182,80 @@ TEST_CASE("Test usage of ExtractText in regex mode", "[extracttextRegexTest]") {
 
   LogTestController::getInstance().reset();
 }
+
+TEST_CASE("ExtractText steps over empty matches of repeating capture groups", "[extracttextRegexTest]") {
+  TestController testController;
+  LogTestController::getInstance().setTrace<org::apache::nifi::minifi::processors::LogAttribute>();
+
+  std::shared_ptr<TestPlan> plan = testController.createPlan();
+
+  char dirtemplate[] = "/tmp/gt.XXXXXX";
+  auto dir = testController.createTempDirectory(dirtemplate);
+  REQUIRE(!dir.empty());
+  std::shared_ptr<core::Processor> getfile = plan->addProcessor("GetFile", "getfileCreate2");
+  plan->setProperty(getfile, org::apache::nifi::minifi::processors::GetFile::Directory.getName(), dir);
+  plan->setProperty(getfile, org::apache::nifi::minifi::processors::GetFile::KeepSourceFile.getName(), "true");
+
+  std::shared_ptr<core::Processor> maprocessor = plan->addProcessor("ExtractText", "testExtractText", core::Relationship("success", "description"), true);
+  plan->setProperty(maprocessor, org::apache::nifi::minifi::processors::ExtractText::RegexMode.getName(), "true");
+  plan->setProperty(maprocessor, org::apache::nifi::minifi::processors::ExtractText::IgnoreCaptureGroupZero.getName(), "true");
+  plan->setProperty(maprocessor, org::apache::nifi::minifi::processors::ExtractText::EnableRepeatingCaptureGroup.getName(), "true");
+  // matches the empty string in front of every letter
+  plan->setProperty(maprocessor, "Numbers", "([0-9]*)", true);
+
+  plan->addProcessor("LogAttribute", "outputLogAttribute", core::Relationship("success", "description"), true);
+
+  std::ofstream test_file(dir + utils::file::FileUtils::get_separator() + TEST_FILE);
+  test_file << "a1b22";
+  test_file.close();
+
+  plan->runNextProcessor();  // GetFile
+  plan->runNextProcessor();  // ExtractText
+  plan->runNextProcessor();  // LogAttribute
+
+  REQUIRE(LogTestController::getInstance().contains("key:Numbers.1 value:1"));
+  REQUIRE(LogTestController::getInstance().contains("key:Numbers.3 value:22"));
+
+  LogTestController::getInstance().reset();
+}
+
+TEST_CASE("ExtractText compiles its regular expressions once per schedule", "[extracttextRegexTest]") {
+  TestController testController;
+  LogTestController::getInstance().setTrace<org::apache::nifi::minifi::processors::ExtractText>();
+  LogTestController::getInstance().setTrace<org::apache::nifi::minifi::processors::LogAttribute>();
+
+  std::shared_ptr<TestPlan> plan = testController.createPlan();
+
+  char dirtemplate[] = "/tmp/gt.XXXXXX";
+  auto dir = testController.createTempDirectory(dirtemplate);
+  REQUIRE(!dir.empty());
+  std::shared_ptr<core::Processor> getfile = plan->addProcessor("GetFile", "getfileCreate2");
+  plan->setProperty(getfile, org::apache::nifi::minifi::processors::GetFile::Directory.getName(), dir);
+  plan->setProperty(getfile, org::apache::nifi::minifi::processors::GetFile::KeepSourceFile.getName(), "true");
+
+  std::shared_ptr<core::Processor> maprocessor = plan->addProcessor("ExtractText", "testExtractText", core::Relationship("success", "description"), true);
+  plan->setProperty(maprocessor, org::apache::nifi::minifi::processors::ExtractText::RegexMode.getName(), "true");
+  plan->setProperty(maprocessor, "RegexAttr", "Speed limit ([0-9]+)", true);
+  plan->setProperty(maprocessor, "InvalidRegex", "[Invalid)A(F)", true);
+
+  plan->addProcessor("LogAttribute", "outputLogAttribute", core::Relationship("success", "description"), true);
+
+  for (const auto &name : { "first.txt", "second.txt" }) {
+    std::ofstream test_file(dir + utils::file::FileUtils::get_separator() + name);
+    test_file << REGEX_TEST_TEXT;
+  }
+
+  plan->runNextProcessor();  // GetFile
+  plan->runNextProcessor();  // ExtractText
+  plan->runCurrentProcessor();  // ExtractText, without scheduling it again
+  plan->runNextProcessor();  // LogAttribute
+
+  REQUIRE(LogTestController::getInstance().contains("key:RegexAttr value:130"));
+  const std::string logs = LogTestController::getInstance().log_output.str();
+  const std::string error_str = "error encountered when trying to construct regular expression from property (key: InvalidRegex)";
+  const auto first_error = logs.find(error_str);
+  REQUIRE(first_error != std::string::npos);
+  REQUIRE(logs.find(error_str, first_error + 1) == std::string::npos);
+
+  LogTestController::getInstance().reset();
+}
@@ -133,4 +133,48 @@ TEST_CASE("Test usage of ExtractText", "[extracttextTest]") {
   REQUIRE(LogTestController::getInstance().contains(log_check));
 }
 
+TEST_CASE("Test multiple algorithms in one HashContent", "[HashContentMulti]") {
+  TestController testController;
+  LogTestController::getInstance().setTrace<org::apache::nifi::minifi::processors::LogAttribute>();
+  LogTestController::getInstance().setTrace<org::apache::nifi::minifi::processors::HashContent>();
+
+  std::shared_ptr<TestPlan> plan = testController.createPlan();
+
+  char dir[] = "/tmp/gt.XXXXXX";
+
+  auto tempdir = testController.createTempDirectory(dir);
+  REQUIRE(!tempdir.empty());
+
+  std::shared_ptr<core::Processor> getfile = plan->addProcessor("GetFile", "getfileCreate2");
+  plan->setProperty(getfile, org::apache::nifi::minifi::processors::GetFile::Directory.getName(), tempdir);
+  plan->setProperty(getfile, org::apache::nifi::minifi::processors::GetFile::KeepSourceFile.getName(), "true");
+
+  std::shared_ptr<core::Processor> hashprocessor = plan->addProcessor("HashContent", "HashContentMulti",
+      core::Relationship("success", "description"), true);
+  plan->setProperty(hashprocessor, org::apache::nifi::minifi::processors::HashContent::HashAttribute.getName(), "Hash");
+  plan->setProperty(hashprocessor, org::apache::nifi::minifi::processors::HashContent::HashAlgorithm.getName(), "md5, sha-1,SHA256");
+  plan->setProperty(hashprocessor, org::apache::nifi::minifi::processors::HashContent::ReadBufferSize.getName(), "4 B");
+
+  plan->addProcessor("LogAttribute", "outputLogAttribute", core::Relationship("success", "description"), true);
+
+  std::stringstream ss1;
+  ss1 << tempdir << utils::file::FileUtils::get_separator() << TEST_FILE;
+
+  std::ofstream test_file(ss1.str(), std::ios::binary);
+  if (test_file.is_open()) {
+    test_file << TEST_TEXT;
+    char newline = '\n';
+    test_file.write(&newline, 1);
+    test_file.close();
+  }
+
+  for (int i = 0; i < 3; ++i) {
+    plan->runNextProcessor();
+  }
+
+  REQUIRE(LogTestController::getInstance().contains(std::string("key:Hash.MD5 value:") + MD5_CHECKSUM));
+  REQUIRE(LogTestController::getInstance().contains(std::string("key:Hash.SHA1 value:") + SHA1_CHECKSUM));
+  REQUIRE(LogTestController::getInstance().contains(std::string("key:Hash.SHA256 value:") + SHA256_CHECKSUM));
+}
+
 #endif  // OPENSSL_SUPPORT
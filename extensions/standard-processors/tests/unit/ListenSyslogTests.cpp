@@ -0,0 +1,130 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef WIN32
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "TestBase.h"
+#include "core/Core.h"
+#include "core/Processor.h"
+#include "ListenSyslog.h"
+#include "LogAttribute.h"
+
+namespace {
+
+struct sockaddr_in localAddress(uint16_t port) {
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  return addr;
+}
+
+void sendDatagram(uint16_t port, const std::string &message) {
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  REQUIRE(fd >= 0);
+  struct sockaddr_in addr = localAddress(port);
+  sendto(fd, message.data(), message.size(), 0, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr));
+  close(fd);
+}
+
+void sendStream(uint16_t port, const std::string &data) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  REQUIRE(fd >= 0);
+  struct sockaddr_in addr = localAddress(port);
+  REQUIRE(connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == 0);
+  // split the data to exercise framing across reads
+  const size_t half = data.size() / 2;
+  send(fd, data.data(), half, 0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  send(fd, data.data() + half, data.size() - half, 0);
+  close(fd);
+}
+
+}  // namespace
+
+TEST_CASE("ListenSyslog parses UDP messages", "[listensyslog]") {
+  TestController testController;
+  LogTestController::getInstance().setTrace<minifi::processors::ListenSyslog>();
+  LogTestController::getInstance().setTrace<minifi::processors::LogAttribute>();
+
+  std::shared_ptr<TestPlan> plan = testController.createPlan();
+  std::shared_ptr<core::Processor> listen = plan->addProcessor("ListenSyslog", "listensyslog");
+  plan->setProperty(listen, minifi::processors::ListenSyslog::Port.getName(), "10514");
+  plan->setProperty(listen, minifi::processors::ListenSyslog::ParseMessages.getName(), "true");
+  std::shared_ptr<core::Processor> log = plan->addProcessor("LogAttribute", "logattribute", core::Relationship("success", "description"), true);
+  plan->setProperty(log, minifi::processors::LogAttribute::FlowFilesToLog.getName(), "0");
+
+  // starts the server
+  plan->runNextProcessor();
+
+  sendDatagram(10514, "<34>1 2003-10-11T22:14:15.003Z mymachine.example.com su - ID47 - 'su root' failed\n");
+  sendDatagram(10514, "<13>Feb  5 17:32:18 10.0.0.99 Use the BFG!");
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  plan->runCurrentProcessor();
+  plan->runNextProcessor();
+
+  REQUIRE(LogTestController::getInstance().contains("key:syslog.hostname value:mymachine.example.com"));
+  REQUIRE(LogTestController::getInstance().contains("key:syslog.severity value:2"));
+  REQUIRE(LogTestController::getInstance().contains("key:syslog.facility value:4"));
+  REQUIRE(LogTestController::getInstance().contains("key:syslog.timestamp value:Feb  5 17:32:18"));
+  REQUIRE(LogTestController::getInstance().contains("key:syslog.body value:Use the BFG!"));
+  LogTestController::getInstance().reset();
+}
+
+TEST_CASE("ListenSyslog batches octet counted and newline delimited TCP messages", "[listensyslog]") {
+  TestController testController;
+  LogTestController::getInstance().setTrace<minifi::processors::ListenSyslog>();
+  LogTestController::getInstance().setTrace<minifi::processors::LogAttribute>();
+
+  std::shared_ptr<TestPlan> plan = testController.createPlan();
+  std::shared_ptr<core::Processor> listen = plan->addProcessor("ListenSyslog", "listensyslog");
+  plan->setProperty(listen, minifi::processors::ListenSyslog::Port.getName(), "10515");
+  plan->setProperty(listen, minifi::processors::ListenSyslog::Protocol.getName(), "TCP");
+  plan->setProperty(listen, minifi::processors::ListenSyslog::MaxBatchSize.getName(), "10");
+  plan->setProperty(listen, minifi::processors::ListenSyslog::MessageDelimiter.getName(), "|");
+  std::shared_ptr<core::Processor> log = plan->addProcessor("LogAttribute", "logattribute", core::Relationship("success", "description"), true);
+  plan->setProperty(log, minifi::processors::LogAttribute::LogPayload.getName(), "true");
+
+  plan->runNextProcessor();
+
+  const std::string counted = "<34>Oct 11 22:14:15 mymachine two\nlines";
+  sendStream(10515, "<34>Oct 11 22:14:15 mymachine first\r\n" + std::to_string(counted.size()) + " " + counted + "<34>Oct 11 22:14:15 mymachine last\n");
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  plan->runCurrentProcessor();
+  plan->runNextProcessor();
+
+  REQUIRE(LogTestController::getInstance().contains("key:syslog.protocol value:TCP"));
+  REQUIRE(LogTestController::getInstance().contains(
+      "<34>Oct 11 22:14:15 mymachine first|<34>Oct 11 22:14:15 mymachine two\nlines|<34>Oct 11 22:14:15 mymachine last"));
+  LogTestController::getInstance().reset();
+}
+
+#endif
@@ -34,6 +34,8 @@
 #include "core/logging/Logger.h"
 #include "core/Relationship.h"
 #include "core/FlowFile.h"
+#include "core/FlowFilePrioritizer.h"
+#include "core/FlowFileQueue.h"
 #include "core/Repository.h"
 
 namespace org {
@@ -103,6 +105,10 @@ class Connection : public core::Connectable, public std::enable_shared_from_this
   void addRelationship(core::Relationship relationship) {
     relationships_.insert(relationship);
   }
+  // Replace Connection relationships
+  void setRelationships(const std::set<core::Relationship> &relationships) {
+    relationships_ = relationships;
+  }
   // ! Get Connection relationship
   const std::set<core::Relationship> &getRelationships() const {
     return relationships_;
@@ -140,6 +146,20 @@ class Connection : public core::Connectable, public std::enable_shared_from_this
     return drop_empty_;
   }
 
+  /**
+   * Sets the prioritizers deciding which FlowFile is polled next, the first one
+   * takes precedence. Without prioritizers FlowFiles are polled in order of arrival.
+   */
+  void setPrioritizers(std::vector<std::shared_ptr<core::FlowFilePrioritizer>> prioritizers) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.setPrioritizers(std::move(prioritizers));
+  }
+
+  std::vector<std::shared_ptr<core::FlowFilePrioritizer>> getPrioritizers() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.getPrioritizers();
+  }
+
   // Check whether the queue is empty
   bool isEmpty();
   // Check whether the queue is full to apply back pressure
@@ -172,8 +192,10 @@ class Connection : public core::Connectable, public std::enable_shared_from_this
 
   void yield() override {}
 
+  // penalized FlowFiles are not work until their penalty is over
   bool isWorkAvailable() override {
-    return !isEmpty();
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.isWorkAvailable(getTimeMillis());
   }
 
   bool isRunning() override {
@@ -209,7 +231,7 @@ class Connection : public core::Connectable, public std::enable_shared_from_this
   // Queued data size
   std::atomic<uint64_t> queued_data_size_;
   // Queue for the Flow File
-  std::queue<std::shared_ptr<core::FlowFile>> queue_;
+  core::FlowFileQueue queue_;
   // flow repository
   // Logger
   std::shared_ptr<logging::Logger> logger_;
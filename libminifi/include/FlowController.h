@@ -43,6 +43,7 @@
 #include "core/ProcessSession.h"
 #include "core/Property.h"
 #include "core/Relationship.h"
+#include "core/state/MetricsPublisher.h"
 #include "core/state/nodes/FlowInformation.h"
 #include "core/state/nodes/MetricsBase.h"
 #include "core/state/UpdateController.h"
@@ -53,6 +54,7 @@
 #include "properties/Configure.h"
 #include "TimerDrivenSchedulingAgent.h"
 #include "utils/Id.h"
+#include "utils/ThreadAffinity.h"
 
 namespace org {
 namespace apache {
@@ -316,6 +318,12 @@ class FlowController : public core::controller::ControllerServiceProvider, publi
    */
   std::shared_ptr<state::response::ResponseNode> getAgentManifest() const override;
 
+  /**
+   * Retrieves the flow metrics published by the metrics publisher
+   * @return a list of response nodes
+   */
+  std::vector<std::shared_ptr<state::response::ResponseNode>> getPublishedMetricsNodes() const override;
+
   uint64_t getUptime() override;
 
   std::vector<BackTrace> getTraces() override;
@@ -331,9 +339,27 @@ class FlowController : public core::controller::ControllerServiceProvider, publi
 
   std::shared_ptr<state::response::ResponseNode> loadC2ResponseConfiguration(const std::string &prefix, std::shared_ptr<state::response::ResponseNode>);
 
+  // creates the queue, repository and processor metrics of the current flow
+  std::vector<std::shared_ptr<state::response::ResponseNode>> createFlowMetricsNodes();
+
+  // starts the metrics publisher if one is configured, refreshing the metrics it publishes
+  void initializeMetricsPublisher();
+
+  // reads where the flow threads run from the configuration
+  utils::ThreadAffinity getThreadAffinity();
+
+  // numbers the pipeline segments, processors connected to each other, of the current flow
+  void assignPipelineSegments();
+
   // function to load the flow file repo.
   void loadFlowRepo();
 
+  /**
+   * Applies the updated flow to the running one, stopping only the processors affected by the update.
+   * @return false if the flow has to be restarted instead, in which case newRoot is left as it was
+   */
+  bool updateFlow(std::unique_ptr<core::ProcessGroup> &newRoot);
+
   void initializeExternalComponents();
 
   /**
@@ -413,6 +439,11 @@ class FlowController : public core::controller::ControllerServiceProvider, publi
   // metrics last run
   std::chrono::steady_clock::time_point last_metrics_capture_;
 
+  // metrics published outside of C2
+  std::vector<std::shared_ptr<state::response::ResponseNode>> published_metrics_;
+
+  std::shared_ptr<state::MetricsPublisher> metrics_publisher_;
+
  private:
   std::shared_ptr<logging::Logger> logger_;
   std::string serial_number_;
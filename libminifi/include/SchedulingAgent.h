@@ -28,6 +28,7 @@
 #include <mutex>
 #include <atomic>
 #include <algorithm>
+#include <chrono>
 #include <thread>
 #include "utils/CallBackTimer.h"
 #include "utils/Monitors.h"
@@ -87,8 +88,10 @@ class SchedulingAgent {
     watchDogTimer_.reset();
   }
 
-  // onTrigger, return whether the yield is need
-  bool onTrigger(const std::shared_ptr<core::Processor> &processor, const std::shared_ptr<core::ProcessContext> &processContext, const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory);
+  // onTrigger, return whether the yield is need. Keeps triggering the processor while it has work
+  // for up to run_duration, so that a single dispatch can process more than one trigger worth of work.
+  bool onTrigger(const std::shared_ptr<core::Processor> &processor, const std::shared_ptr<core::ProcessContext> &processContext, const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory,
+                 std::chrono::nanoseconds run_duration = std::chrono::nanoseconds(0));
   // Whether agent has work to do
   bool hasWorkToDo(std::shared_ptr<core::Processor> processor);
   // Whether the outgoing need to be backpressure
@@ -107,6 +110,11 @@ class SchedulingAgent {
 
   virtual std::future<utils::TaskRescheduleInfo> enableControllerService(std::shared_ptr<core::controller::ControllerServiceNode> &serviceNode);
   virtual std::future<utils::TaskRescheduleInfo> disableControllerService(std::shared_ptr<core::controller::ControllerServiceNode> &serviceNode);
+  /**
+   * Enables the given controller services concurrently, each one once the services it refers to,
+   * through Linked Services or any other property, are enabled. Returns when all of them are enabled.
+   */
+  virtual void enableControllerServices(const std::vector<std::shared_ptr<core::controller::ControllerServiceNode>> &serviceNodes);
   // schedule, overwritten by different DrivenSchedulingAgent
   virtual void schedule(std::shared_ptr<core::Processor> processor) = 0;
   // unschedule, overwritten by different DrivenSchedulingAgent
@@ -154,6 +162,9 @@ class SchedulingAgent {
     }
   };
 
+  // Whether the processor is triggered once more within the same dispatch
+  bool triggerAgain(const std::shared_ptr<core::Processor> &processor, std::chrono::steady_clock::time_point deadline);
+
   // Logger
   std::shared_ptr<logging::Logger> logger_;
   mutable std::mutex watchdog_mtx_;  // used to protect the set below
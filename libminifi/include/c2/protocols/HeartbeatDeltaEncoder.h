@@ -0,0 +1,91 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_C2_PROTOCOLS_HEARTBEATDELTAENCODER_H_
+#define LIBMINIFI_INCLUDE_C2_PROTOCOLS_HEARTBEATDELTAENCODER_H_
+
+#include <cstdint>
+#include <string>
+
+#include "rapidjson/document.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace c2 {
+
+/**
+ * Purpose: Shrinks JSON heartbeats by sending only what changed since the last heartbeat the
+ * server acknowledged.
+ *
+ * A delta heartbeat holds the members whose values changed, recursively for objects; arrays
+ * and other values are sent whole, and members which disappeared are sent as null. The
+ * operation and the identifier of each top level object are always included, so the server
+ * knows which agent the delta belongs to. The heartbeatEncoding member tells "full" heartbeats
+ * from "delta" ones.
+ *
+ * A full heartbeat is sent first, after every full_heartbeat_interval heartbeats and after
+ * any heartbeat which was not acknowledged, as the server may or may not have applied it.
+ */
+class HeartbeatDeltaEncoder {
+ public:
+  static constexpr const char *ENCODING = "heartbeatEncoding";
+  static constexpr const char *FULL = "full";
+  static constexpr const char *DELTA = "delta";
+
+  explicit HeartbeatDeltaEncoder(uint32_t full_heartbeat_interval = 20);
+
+  /**
+   * Encodes a heartbeat against the last acknowledged one.
+   * @param heartbeat the full heartbeat, which becomes the base of the next deltas once acknowledged
+   * @return the JSON to send
+   */
+  std::string encode(rapidjson::Document &&heartbeat);
+
+  /**
+   * The server received the last encoded heartbeat.
+   */
+  void acknowledge();
+
+  /**
+   * The last encoded heartbeat failed, the next one will be full.
+   */
+  void reject();
+
+  /**
+   * Builds into delta, an object, what changed between the two objects.
+   * @return whether anything changed
+   */
+  static bool diff(const rapidjson::Value &previous, const rapidjson::Value &current, rapidjson::Value &delta, rapidjson::Document::AllocatorType &alloc);
+
+ private:
+  uint32_t full_heartbeat_interval_;
+  uint32_t deltas_since_full_;
+  bool has_base_;
+  bool pending_full_;
+  rapidjson::Document base_;
+  rapidjson::Document pending_;
+};
+
+}  // namespace c2
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
+
+#endif  // LIBMINIFI_INCLUDE_C2_PROTOCOLS_HEARTBEATDELTAENCODER_H_
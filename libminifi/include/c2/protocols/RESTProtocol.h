@@ -82,6 +82,13 @@ class RESTProtocol {
 
   virtual std::string serializeJsonRootPayload(const C2Payload& payload);
 
+  /**
+   * Builds the JSON document which serializeJsonRootPayload writes out.
+   */
+  virtual void buildJsonRootPayload(const C2Payload& payload, rapidjson::Document &json_payload);
+
+  static std::string serializeJsonDocument(const rapidjson::Value &json);
+
   virtual void mergePayloadContent(rapidjson::Value &target, const C2Payload &payload, rapidjson::Document::AllocatorType &alloc);
 
   virtual const C2Payload parseJsonResponse(const C2Payload &payload, const std::vector<char> &response);
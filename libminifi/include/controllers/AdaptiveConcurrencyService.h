@@ -0,0 +1,154 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CONTROLLERS_ADAPTIVECONCURRENCYSERVICE_H_
+#define LIBMINIFI_INCLUDE_CONTROLLERS_ADAPTIVECONCURRENCYSERVICE_H_
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "core/Resource.h"
+#include "core/controller/ControllerService.h"
+#include "core/logging/LoggerConfiguration.h"
+#include "utils/AdaptiveLimit.h"
+#include "ThreadManagementService.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace controllers {
+
+/**
+ * Purpose: Adaptive concurrency service sizes the thread pools, and the concurrent tasks of each
+ * processor, from the queued work, the task latency and the CPU use of the agent, keeping the
+ * latter within a budget.
+ */
+class AdaptiveConcurrencyService : public ThreadManagementService {
+ public:
+  explicit AdaptiveConcurrencyService(const std::string &name, const std::string &id)
+      : ThreadManagementService(name, id),
+        enabled_(false),
+        min_threads_(1),
+        max_threads_(1),
+        cpu_budget_(0),
+        adjustment_period_(250),
+        last_cpu_time_(0),
+        last_cpu_nanos_(0),
+        cpu_cores_(-1),
+        logger_(logging::LoggerFactory<AdaptiveConcurrencyService>::getLogger()) {
+  }
+
+  explicit AdaptiveConcurrencyService(const std::string &name, utils::Identifier uuid = utils::Identifier())
+      : ThreadManagementService(name, uuid),
+        enabled_(false),
+        min_threads_(1),
+        max_threads_(1),
+        cpu_budget_(0),
+        adjustment_period_(250),
+        last_cpu_time_(0),
+        last_cpu_nanos_(0),
+        cpu_cores_(-1),
+        logger_(logging::LoggerFactory<AdaptiveConcurrencyService>::getLogger()) {
+  }
+
+  explicit AdaptiveConcurrencyService(const std::string &name, const std::shared_ptr<Configure> &configuration)
+      : AdaptiveConcurrencyService(name) {
+    setConfiguration(configuration);
+    initialize();
+  }
+
+  static core::Property CPUBudget;
+  static core::Property MinThreads;
+  static core::Property MaxThreads;
+  static core::Property AdjustmentPeriod;
+
+  /**
+   * Pools are sized as a whole, so adding tasks never takes them above their maximum.
+   */
+  virtual bool isAboveMax(const int new_tasks);
+
+  virtual uint16_t getMaxThreads();
+
+  virtual bool shouldReduce();
+
+  virtual void reduce();
+
+  virtual bool canIncrease();
+
+  virtual uint16_t getTargetThreads(const std::string &pool_name, utils::ConcurrencySample sample, uint16_t current_threads);
+
+  virtual uint16_t getConcurrentTasks(core::Processor &processor);
+
+  virtual std::chrono::milliseconds getAdjustmentPeriod();
+
+  void initialize();
+
+  virtual void onEnable();
+
+ protected:
+  struct ProcessorLimit {
+    utils::AdaptiveLimit limit;
+    uint64_t last_update;
+    uint64_t invocations;
+    uint64_t on_trigger_nanos;
+  };
+
+  /**
+   * Returns the cores the agent kept busy recently, negative when unknown. Requires mutex_.
+   */
+  double measureCpu(uint64_t now);
+
+  std::atomic<bool> enabled_;
+
+  uint16_t min_threads_;
+
+  uint16_t max_threads_;
+
+  double cpu_budget_;
+
+  std::atomic<int64_t> adjustment_period_;
+
+  std::mutex mutex_;
+
+  std::map<std::string, utils::AdaptiveLimit> pool_limits_;
+
+  std::map<std::string, ProcessorLimit> processor_limits_;
+
+  uint64_t last_cpu_time_;
+
+  uint64_t last_cpu_nanos_;
+
+  double cpu_cores_;
+
+ private:
+  std::shared_ptr<logging::Logger> logger_;
+};
+
+REGISTER_RESOURCE(AdaptiveConcurrencyService, "Sizes the thread pools and the concurrent tasks of processors from queued work, task latency and CPU use, within a CPU budget. "
+                  "Use name \"ThreadPoolManager\" to manage the thread pools of the agent"); // NOLINT
+
+}  // namespace controllers
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
+
+#endif  // LIBMINIFI_INCLUDE_CONTROLLERS_ADAPTIVECONCURRENCYSERVICE_H_
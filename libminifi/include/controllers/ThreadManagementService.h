@@ -21,7 +21,10 @@
 #include <string>
 #include <iostream>
 #include <memory>
+#include <chrono>
+#include <limits>
 #include "core/Resource.h"
+#include "utils/AdaptiveLimit.h"
 #include "utils/StringUtils.h"
 #include "io/validation.h"
 #include "core/controller/ControllerService.h"
@@ -31,6 +34,9 @@ namespace org {
 namespace apache {
 namespace nifi {
 namespace minifi {
+namespace core {
+class Processor;
+}  // namespace core
 namespace controllers {
 
 /**
@@ -92,6 +98,34 @@ class ThreadManagementService : public core::controller::ControllerService {
    */
   virtual bool canIncrease() = 0;
 
+  /**
+   * Sizes a thread pool from what was observed of it. Services which only answer the questions above
+   * return 0, thread pools then add or remove a thread at a time based on those answers.
+   * @param pool_name name of the thread pool
+   * @param sample observations of the pool since the last adjustment
+   * @param current_threads threads the pool runs
+   * @return threads the pool should run, 0 if the service does not size pools
+   */
+  virtual uint16_t getTargetThreads(const std::string &pool_name, utils::ConcurrencySample sample, uint16_t current_threads) {
+    return 0;
+  }
+
+  /**
+   * Returns the number of tasks of the processor which may run concurrently
+   * @param processor processor about to be triggered
+   * @return concurrent tasks, which never exceed the processor's max concurrent tasks anyway
+   */
+  virtual uint16_t getConcurrentTasks(core::Processor &processor) {
+    return (std::numeric_limits<uint16_t>::max)();
+  }
+
+  /**
+   * Returns how often thread pools are adjusted
+   */
+  virtual std::chrono::milliseconds getAdjustmentPeriod() {
+    return std::chrono::milliseconds(500);
+  }
+
   virtual void initialize() {
     ControllerService::initialize();
   }
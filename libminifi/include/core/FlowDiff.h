@@ -0,0 +1,137 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CORE_FLOWDIFF_H_
+#define LIBMINIFI_INCLUDE_CORE_FLOWDIFF_H_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Connection.h"
+#include "core/ProcessGroup.h"
+#include "core/Processor.h"
+#include "core/controller/ControllerServiceNode.h"
+#include "core/logging/Logger.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+
+/**
+ * Purpose: Turns a running flow into an updated version of it without restarting it as a whole.
+ *
+ * Processors and connections are matched by UUID. Processors whose configuration is the same are
+ * kept running, the others are replaced by the ones of the updated flow. Connections are kept
+ * along with their queues as long as their UUID is, even if their configuration changed. Only
+ * the processors which are replaced or removed, and the neighbours whose connections change, have
+ * to be stopped while the update is applied.
+ *
+ * Flows whose controller services differ cannot be updated this way, as processors would be left
+ * referring to the services of the previous flow.
+ */
+class FlowDiff {
+ public:
+  FlowDiff(ProcessGroup &current, ProcessGroup &updated, const std::vector<std::shared_ptr<controller::ControllerServiceNode>> &current_services,
+           const std::vector<std::shared_ptr<controller::ControllerServiceNode>> &updated_services);
+
+  /**
+   * @return whether the updated flow can be applied to the running one, otherwise the flow has to be restarted.
+   */
+  bool isIncremental() const {
+    return incremental_;
+  }
+
+  /**
+   * @return why the update cannot be applied incrementally
+   */
+  const std::string &getReason() const {
+    return reason_;
+  }
+
+  /**
+   * @return the processors of the current flow which have to be stopped before calling apply
+   */
+  const std::vector<std::shared_ptr<Processor>> &getProcessorsToStop() const {
+    return processors_to_stop_;
+  }
+
+  /**
+   * Moves the processors and connections which are kept from the current flow into the updated one,
+   * which takes the place of the current flow. Nothing of the current flow but its removed
+   * connections is drained.
+   * @return the processors to start, by the process group of the updated flow they belong to
+   */
+  std::map<ProcessGroup*, std::set<std::shared_ptr<Processor>>> apply();
+
+  /**
+   * @return a one line summary for logging
+   */
+  std::string getSummary() const;
+
+  static bool isSameConfiguration(const std::shared_ptr<Processor> &current, const std::shared_ptr<Processor> &updated);
+
+  static bool isSameConfiguration(const std::shared_ptr<Connection> &current, const std::shared_ptr<Connection> &updated);
+
+ private:
+  template<typename T>
+  struct Component {
+    std::shared_ptr<T> component;
+    ProcessGroup *group;
+  };
+
+  using Processors = std::map<std::string, Component<Processor>>;
+  using Connections = std::map<std::string, Component<Connection>>;
+
+  static void collect(ProcessGroup &group, Processors &processors, Connections &connections, std::vector<ProcessGroup*> &groups);
+
+  void diffServices(const std::vector<std::shared_ptr<controller::ControllerServiceNode>> &current_services,
+                    const std::vector<std::shared_ptr<controller::ControllerServiceNode>> &updated_services);
+
+  bool isSameRemoteGroup(const ProcessGroup &current, const ProcessGroup &updated) const;
+
+  // processor and connection UUIDs of the current flow which are stopped, respectively detached, while applying
+  std::set<std::string> replaced_processors_;
+  std::set<std::string> disturbed_processors_;
+  std::set<std::string> reattached_connections_;
+
+  Processors current_processors_;
+  Processors updated_processors_;
+  Connections current_connections_;
+  Connections updated_connections_;
+  std::vector<ProcessGroup*> current_groups_;
+  std::vector<ProcessGroup*> updated_groups_;
+
+  std::vector<std::shared_ptr<Processor>> processors_to_stop_;
+
+  bool incremental_;
+  std::string reason_;
+
+  std::shared_ptr<logging::Logger> logger_;
+};
+
+}  // namespace core
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
+
+#endif  // LIBMINIFI_INCLUDE_CORE_FLOWDIFF_H_
@@ -24,6 +24,7 @@
 #include <string>
 
 #include "utils/TimeUtil.h"
+#include "FlowFileAttributes.h"
 #include "ResourceClaim.h"
 #include "Connectable.h"
 #include "WeakReference.h"
@@ -156,22 +157,31 @@ class FlowFile : public core::Connectable, public ReferenceContainer {
    * setAttribute, if attribute already there, update it, else, add it
    */
   void setAttribute(const std::string &key, const std::string &value) {
-    attributes_[key] = value;
+    attributes_.set(key, value);
   }
 
   /**
-   * Returns the map of attributes
+   * Replaces all attributes. Copies of FlowFileAttributes share their storage,
+   * so this does not copy the attributes themselves.
+   */
+  void setAttributes(FlowFileAttributes attributes) {
+    attributes_ = std::move(attributes);
+  }
+
+  /**
+   * Returns the attributes. The view is invalidated by any change to the
+   * attributes of this FlowFile, copy it to keep it.
    * @return attributes.
    */
-  std::map<std::string, std::string> getAttributes() const {
+  const FlowFileAttributes &getAttributes() const {
     return attributes_;
   }
 
   /**
-   * Returns the map of attributes
+   * Returns the attributes
    * @return attributes.
    */
-  std::map<std::string, std::string> *getAttributesPtr() {
+  FlowFileAttributes *getAttributesPtr() {
     return &attributes_;
   }
 
@@ -312,7 +322,7 @@ class FlowFile : public core::Connectable, public ReferenceContainer {
   // Penalty expiration
   uint64_t penaltyExpiration_ms_;
   // Attributes key/values pairs for the flow record
-  std::map<std::string, std::string> attributes_;
+  FlowFileAttributes attributes_;
   // Pointer to the associated content resource claim
   std::shared_ptr<ResourceClaim> claim_;
   // Pointers to stashed content resource claims
@@ -0,0 +1,254 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CORE_FLOWFILEATTRIBUTES_H_
+#define LIBMINIFI_INCLUDE_CORE_FLOWFILEATTRIBUTES_H_
+
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+
+/**
+ * Purpose: Interns attribute keys, so that the few distinct keys of a flow are stored once
+ * rather than once per FlowFile.
+ *
+ * Interned keys live for the lifetime of the process. To bound the memory of flows that derive
+ * keys from data, at most MAX_KEYS keys are interned, intern() returns nullptr after that.
+ */
+class AttributeKeyRegistry {
+ public:
+  static constexpr size_t MAX_KEYS = 16384;
+
+  static const std::string* intern(const std::string &key);
+};
+
+/**
+ * Purpose: Attributes of a FlowFile.
+ *
+ * Entries are kept in a flat vector sorted by key, so iteration order matches that of the
+ * std::map it replaces. Copies share the entries until either side is modified, which makes
+ * snapshots, provenance events and clones of a FlowFile cheap.
+ *
+ * Iterators, and the references they yield, are invalidated by any modification.
+ */
+class FlowFileAttributes {
+ private:
+  class Entry {
+   public:
+    Entry(const std::string &key, std::string value)
+        : key_(AttributeKeyRegistry::intern(key)),
+          owned_key_(key_ ? nullptr : new std::string(key)),
+          value_(std::move(value)) {
+    }
+
+    Entry(const Entry &other)
+        : key_(other.key_),
+          owned_key_(other.owned_key_ ? new std::string(*other.owned_key_) : nullptr),
+          value_(other.value_) {
+    }
+
+    Entry(Entry &&other) = default;
+
+    Entry &operator=(const Entry &other) {
+      key_ = other.key_;
+      owned_key_.reset(other.owned_key_ ? new std::string(*other.owned_key_) : nullptr);
+      value_ = other.value_;
+      return *this;
+    }
+
+    Entry &operator=(Entry &&other) = default;
+
+    const std::string &key() const {
+      return key_ ? *key_ : *owned_key_;
+    }
+
+    const std::string &value() const {
+      return value_;
+    }
+
+    std::string &value() {
+      return value_;
+    }
+
+   private:
+    const std::string *key_;
+    // only set for keys which did not fit into the registry
+    std::unique_ptr<std::string> owned_key_;
+    std::string value_;
+  };
+
+  using Entries = std::vector<Entry>;
+
+ public:
+  using value_type = std::pair<const std::string&, const std::string&>;
+
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = FlowFileAttributes::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type;
+
+    class pointer {
+     public:
+      explicit pointer(value_type value)
+          : value_(value) {
+      }
+      const value_type *operator->() const {
+        return &value_;
+      }
+     private:
+      value_type value_;
+    };
+
+    const_iterator() = default;
+
+    explicit const_iterator(Entries::const_iterator it)
+        : it_(it) {
+    }
+
+    value_type operator*() const {
+      return value_type(it_->key(), it_->value());
+    }
+
+    pointer operator->() const {
+      return pointer(**this);
+    }
+
+    const_iterator &operator++() {
+      ++it_;
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator previous = *this;
+      ++it_;
+      return previous;
+    }
+
+    bool operator==(const const_iterator &other) const {
+      return it_ == other.it_;
+    }
+
+    bool operator!=(const const_iterator &other) const {
+      return it_ != other.it_;
+    }
+
+   private:
+    Entries::const_iterator it_;
+  };
+
+  using iterator = const_iterator;
+
+  FlowFileAttributes() = default;
+
+  FlowFileAttributes(const std::map<std::string, std::string> &attributes); // NOLINT
+
+  const_iterator begin() const {
+    return const_iterator(entries().begin());
+  }
+
+  const_iterator end() const {
+    return const_iterator(entries().end());
+  }
+
+  size_t size() const {
+    return entries_ ? entries_->size() : 0;
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+  const_iterator find(const std::string &key) const;
+
+  size_t count(const std::string &key) const {
+    return find(key) != end() ? 1 : 0;
+  }
+
+  /**
+   * Returns the value of key, throws std::out_of_range if it is not set.
+   */
+  const std::string &at(const std::string &key) const;
+
+  /**
+   * Sets key to value, adding the attribute if it does not exist yet.
+   */
+  void set(const std::string &key, std::string value);
+
+  /**
+   * Adds the attribute if it does not exist yet.
+   * @return whether the attribute has been added
+   */
+  bool insert(const std::string &key, std::string value);
+
+  /**
+   * Changes the value of an existing attribute.
+   * @return whether the attribute existed
+   */
+  bool update(const std::string &key, std::string value);
+
+  /**
+   * @return the number of attributes removed (0 or 1)
+   */
+  size_t erase(const std::string &key);
+
+  void clear() {
+    entries_.reset();
+  }
+
+  std::map<std::string, std::string> toMap() const;
+
+  bool operator==(const FlowFileAttributes &other) const;
+
+  bool operator!=(const FlowFileAttributes &other) const {
+    return !(*this == other);
+  }
+
+ private:
+  static const Entries &emptyEntries();
+
+  const Entries &entries() const {
+    return entries_ ? *entries_ : emptyEntries();
+  }
+
+  // position of the first entry whose key is not less than key
+  Entries::const_iterator lowerBound(const std::string &key) const;
+
+  // makes the entries exclusively owned by this object, returns them for modification
+  Entries &mutableEntries();
+
+  std::shared_ptr<Entries> entries_;
+};
+
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif  // LIBMINIFI_INCLUDE_CORE_FLOWFILEATTRIBUTES_H_
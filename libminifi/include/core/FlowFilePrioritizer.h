@@ -0,0 +1,117 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CORE_FLOWFILEPRIORITIZER_H_
+#define LIBMINIFI_INCLUDE_CORE_FLOWFILEPRIORITIZER_H_
+
+#include <memory>
+#include <string>
+
+#include "FlowFile.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+
+/**
+ * Purpose: Decides the order in which the FlowFiles of a connection are handed to its
+ * destination. Connections may chain several prioritizers, the next one breaks the ties of
+ * the previous, and FlowFiles that are still equal leave in the order they arrived.
+ */
+class FlowFilePrioritizer {
+ public:
+  virtual ~FlowFilePrioritizer() = default;
+
+  virtual std::string getName() const = 0;
+
+  /**
+   * @return a negative number if first should be dequeued before second, a positive
+   * number if after, 0 if this prioritizer has no preference
+   */
+  virtual int compare(const FlowFile &first, const FlowFile &second) const = 0;
+
+  /**
+   * Creates a prioritizer by its name. Names may carry the package of the NiFi prioritizers,
+   * e.g. org.apache.nifi.prioritizer.PriorityAttributePrioritizer.
+   * @return the prioritizer, or nullptr if there is none with that name
+   */
+  static std::shared_ptr<FlowFilePrioritizer> create(const std::string &name);
+};
+
+/**
+ * Keeps the order of arrival.
+ */
+class FirstInFirstOutPrioritizer : public FlowFilePrioritizer {
+ public:
+  std::string getName() const override {
+    return "FirstInFirstOutPrioritizer";
+  }
+
+  int compare(const FlowFile&, const FlowFile&) const override {
+    return 0;
+  }
+};
+
+/**
+ * FlowFiles which entered the flow first leave first.
+ */
+class OldestFlowFileFirstPrioritizer : public FlowFilePrioritizer {
+ public:
+  std::string getName() const override {
+    return "OldestFlowFileFirstPrioritizer";
+  }
+
+  int compare(const FlowFile &first, const FlowFile &second) const override;
+};
+
+/**
+ * FlowFiles which entered the flow last leave first.
+ */
+class NewestFlowFileFirstPrioritizer : public FlowFilePrioritizer {
+ public:
+  std::string getName() const override {
+    return "NewestFlowFileFirstPrioritizer";
+  }
+
+  int compare(const FlowFile &first, const FlowFile &second) const override;
+};
+
+/**
+ * Orders by the "priority" attribute. Numeric priorities come before textual ones and are
+ * compared as numbers, lower first; textual ones are compared lexicographically. FlowFiles
+ * without the attribute come last.
+ */
+class PriorityAttributePrioritizer : public FlowFilePrioritizer {
+ public:
+  static constexpr const char *PRIORITY_ATTRIBUTE = "priority";
+
+  std::string getName() const override {
+    return "PriorityAttributePrioritizer";
+  }
+
+  int compare(const FlowFile &first, const FlowFile &second) const override;
+};
+
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif  // LIBMINIFI_INCLUDE_CORE_FLOWFILEPRIORITIZER_H_
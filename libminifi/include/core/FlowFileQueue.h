@@ -0,0 +1,126 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CORE_FLOWFILEQUEUE_H_
+#define LIBMINIFI_INCLUDE_CORE_FLOWFILEQUEUE_H_
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "FlowFile.h"
+#include "FlowFilePrioritizer.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+
+/**
+ * Purpose: The queue of a connection.
+ *
+ * FlowFiles ready to be processed are kept apart from penalized ones, so a penalized FlowFile
+ * never holds back those behind it. Penalized FlowFiles wait in a heap ordered by the end of
+ * their penalty and rejoin the ready ones once it has passed.
+ *
+ * Without prioritizers the ready FlowFiles form a FIFO, otherwise a heap ordered by the
+ * prioritizers and then by arrival.
+ *
+ * Not thread safe, the connection synchronizes access.
+ */
+class FlowFileQueue {
+ public:
+  FlowFileQueue()
+      : next_sequence_(0) {
+  }
+
+  /**
+   * Replaces the prioritizers, reordering the FlowFiles already queued.
+   */
+  void setPrioritizers(std::vector<std::shared_ptr<FlowFilePrioritizer>> prioritizers);
+
+  const std::vector<std::shared_ptr<FlowFilePrioritizer>> &getPrioritizers() const {
+    return prioritizers_;
+  }
+
+  void push(std::shared_ptr<FlowFile> flow_file);
+
+  /**
+   * Removes the FlowFile to be processed next.
+   * @param now current time in milliseconds, penalties ending by then are over
+   * @return the FlowFile, or nullptr if none is ready
+   */
+  std::shared_ptr<FlowFile> pop(uint64_t now);
+
+  /**
+   * @return whether pop would return a FlowFile at the given time
+   */
+  bool isWorkAvailable(uint64_t now) const;
+
+  /**
+   * Removes and returns every FlowFile, in no particular order.
+   */
+  std::vector<std::shared_ptr<FlowFile>> clear();
+
+  size_t size() const {
+    return ready_fifo_.size() + ready_heap_.size() + penalized_.size();
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+ private:
+  struct Entry {
+    std::shared_ptr<FlowFile> flow_file;
+    // order of arrival, breaks ties
+    uint64_t sequence;
+  };
+
+  // orders a heap so that its front is the entry to be processed next
+  struct ReadyOrder {
+    const FlowFileQueue *queue;
+    bool operator()(const Entry &first, const Entry &second) const;
+  };
+
+  struct PenaltyOrder {
+    bool operator()(const Entry &first, const Entry &second) const {
+      return first.flow_file->getPenaltyExpiration() > second.flow_file->getPenaltyExpiration();
+    }
+  };
+
+  void pushReady(Entry entry);
+  void releasePenalized(uint64_t now);
+
+  std::vector<std::shared_ptr<FlowFilePrioritizer>> prioritizers_;
+  uint64_t next_sequence_;
+  // ready entries when there are no prioritizers
+  std::deque<Entry> ready_fifo_;
+  // ready entries when there are prioritizers
+  std::vector<Entry> ready_heap_;
+  std::vector<Entry> penalized_;
+};
+
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif  // LIBMINIFI_INCLUDE_CORE_FLOWFILEQUEUE_H_
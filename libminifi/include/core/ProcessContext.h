@@ -41,6 +41,7 @@
 #include "core/CoreComponentState.h"
 #include "utils/file/FileUtils.h"
 #include "VariableRegistry.h"
+#include "provenance/ProvenancePolicy.h"
 
 namespace org {
 namespace apache {
@@ -48,6 +49,45 @@ namespace nifi {
 namespace minifi {
 namespace core {
 
+/**
+ * Property resolved ahead of time by ProcessContext::getPropertyHandle, so that
+ * retrieving its value does not require a lookup by name.
+ */
+class PropertyHandle {
+ public:
+  PropertyHandle(const Property &property, bool dynamic, int index = -1)
+      : property_(property),
+        name_(property.getName()),
+        dynamic_(dynamic),
+        index_(index) {
+  }
+
+  const Property &getProperty() const {
+    return property_;
+  }
+
+  const std::string &getName() const {
+    return name_;
+  }
+
+  bool isDynamic() const {
+    return dynamic_;
+  }
+
+  /**
+   * @return index assigned by the context that resolved the handle or -1 if it has none
+   */
+  int getIndex() const {
+    return index_;
+  }
+
+ private:
+  Property property_;
+  std::string name_;
+  bool dynamic_;
+  int index_;
+};
+
 // ProcessContext Class
 class ProcessContext : public controller::ControllerServiceLookup, public core::VariableRegistry, public std::enable_shared_from_this<VariableRegistry> {
  public:
@@ -89,6 +129,9 @@ class ProcessContext : public controller::ControllerServiceLookup, public core::
     if (!configure_) {
       configure_ = std::make_shared<minifi::Configure>();
     }
+    if (processor_node_) {
+      provenance_policy_ = provenance::ProvenancePolicy::create(*configure_, processor_node_->getUUIDStr(), processor_node_->getName());
+    }
   }
   // Destructor
   virtual ~ProcessContext() = default;
@@ -114,6 +157,27 @@ class ProcessContext : public controller::ControllerServiceLookup, public core::
   std::vector<std::string> getDynamicPropertyKeys() const {
     return processor_node_->getDynamicPropertyKeys();
   }
+  /**
+   * Called each time the processor is scheduled, before Processor::onSchedule.
+   */
+  virtual void onSchedule() {
+  }
+  /**
+   * Resolves a property to a handle. Processors should resolve handles in onSchedule; they are
+   * valid until the next schedule.
+   */
+  virtual PropertyHandle getPropertyHandle(const Property &property) {
+    return PropertyHandle(property, false);
+  }
+  virtual PropertyHandle getDynamicPropertyHandle(const Property &property) {
+    return PropertyHandle(property, true);
+  }
+  virtual bool getProperty(const PropertyHandle &handle, std::string &value, const std::shared_ptr<FlowFile> &flow_file) {
+    if (handle.isDynamic()) {
+      return getDynamicProperty(handle.getProperty(), value, flow_file);
+    }
+    return getProperty(handle.getProperty(), value, flow_file);
+  }
   // Sets the property value using the property's string name
   bool setProperty(const std::string &name, std::string value) {
     return processor_node_->setProperty(name, value);
@@ -146,6 +210,12 @@ class ProcessContext : public controller::ControllerServiceLookup, public core::
   std::shared_ptr<core::Repository> getProvenanceRepository() {
     return repo_;
   }
+  /**
+   * @return policy deciding which provenance events of the processor are recorded, nullptr if all of them are
+   */
+  std::shared_ptr<provenance::ProvenancePolicy> getProvenancePolicy() const {
+    return provenance_policy_;
+  }
 
   /**
    * Returns a reference to the content repository for the running instance.
@@ -345,6 +415,7 @@ class ProcessContext : public controller::ControllerServiceLookup, public core::
   // Logger
   std::shared_ptr<logging::Logger> logger_;
   std::shared_ptr<Configure> configure_;
+  std::shared_ptr<provenance::ProvenancePolicy> provenance_policy_;
 
   bool initialized_;
 };
@@ -46,6 +46,8 @@ namespace nifi {
 namespace minifi {
 namespace core {
 
+class FlowDiff;
+
 // Process Group Type
 enum ProcessGroupType {
   ROOT_PROCESS_GROUP = 0,
@@ -54,9 +56,12 @@ enum ProcessGroupType {
 };
 
 #define ONSCHEDULE_RETRY_INTERVAL 30000  // millisecs
+#define ONSCHEDULE_CONCURRENCY 8  // processors of a group scheduled at the same time
 
 // ProcessGroup Class
 class ProcessGroup {
+  friend class FlowDiff;
+
  public:
   // Constructor
   /*!
@@ -175,6 +180,12 @@ class ProcessGroup {
   }
   // Start Processing
   void startProcessing(const std::shared_ptr<TimerDrivenSchedulingAgent> timeScheduler, const std::shared_ptr<EventDrivenSchedulingAgent> &eventScheduler, const std::shared_ptr<CronDrivenSchedulingAgent> &cronScheduler); // NOLINT
+  /**
+   * Starts the given processors of this group, which are retried like the ones of
+   * startProcessing if they fail to start.
+   */
+  void startProcessing(const std::set<std::shared_ptr<Processor>> &processors, const std::shared_ptr<TimerDrivenSchedulingAgent> timeScheduler,
+                       const std::shared_ptr<EventDrivenSchedulingAgent> &eventScheduler, const std::shared_ptr<CronDrivenSchedulingAgent> &cronScheduler); // NOLINT
   // Stop Processing
   void stopProcessing(const std::shared_ptr<TimerDrivenSchedulingAgent> timeScheduler, const std::shared_ptr<EventDrivenSchedulingAgent> &eventScheduler, const std::shared_ptr<CronDrivenSchedulingAgent> &cronScheduler); // NOLINT
   // Whether it is root process group
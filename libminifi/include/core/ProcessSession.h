@@ -37,6 +37,7 @@
 #include "FlowFile.h"
 #include "WeakReference.h"
 #include "provenance/Provenance.h"
+#include "ProcessorMetrics.h"
 
 namespace org {
 namespace apache {
@@ -56,7 +57,9 @@ class ProcessSession : public ReferenceContainer {
         logger_(logging::LoggerFactory<ProcessSession>::getLogger()) {
     logger_->log_trace("ProcessSession created for %s", process_context_->getProcessorNode()->getName());
     auto repo = process_context_->getProvenanceRepository();
-    provenance_report_ = std::make_shared<provenance::ProvenanceReporter>(repo, process_context_->getProcessorNode()->getName(), process_context_->getProcessorNode()->getName());
+    provenance_report_ = std::make_shared<provenance::ProvenanceReporter>(repo, process_context_->getProcessorNode()->getName(), process_context_->getProcessorNode()->getName(),
+                                                                         process_context_->getProvenancePolicy());
+    metrics_ = findProcessorMetrics();
   }
 
 // Destructor
@@ -156,12 +159,15 @@ class ProcessSession : public ReferenceContainer {
  private:
 // Clone the flow file during transfer to multiple connections for a relationship
   std::shared_ptr<core::FlowFile> cloneDuringTransfer(std::shared_ptr<core::FlowFile> &parent);
+  // Metrics of the processor running this session, nullptr if it is not a processor
+  std::shared_ptr<ProcessorMetrics> findProcessorMetrics() const;
   // ProcessContext
   std::shared_ptr<ProcessContext> process_context_;
   // Logger
   std::shared_ptr<logging::Logger> logger_;
   // Provenance Report
   std::shared_ptr<provenance::ProvenanceReporter> provenance_report_;
+  std::shared_ptr<ProcessorMetrics> metrics_;
 
   static std::shared_ptr<utils::IdGenerator> id_generator_;
 };
@@ -42,6 +42,7 @@
 #include "Core.h"
 #include "io/StreamFactory.h"
 #include "ProcessContext.h"
+#include "ProcessorMetrics.h"
 #include "ProcessSession.h"
 #include "ProcessSessionFactory.h"
 #include "Property.h"
@@ -175,6 +176,14 @@ class Processor : public Connectable, public ConfigurableComponent, public std::
   void incrementActiveTasks(void) {
     active_tasks_++;
   }
+  // Set the pipeline segment, processors connected to each other form one
+  void setPipelineSegment(int segment) {
+    pipeline_segment_ = segment;
+  }
+  // Get the pipeline segment, negative when none was assigned
+  int getPipelineSegment() const {
+    return pipeline_segment_;
+  }
   // decrement Active Task Counts
   void decrementActiveTask(void) {
     if (active_tasks_ > 0)
@@ -212,6 +221,8 @@ class Processor : public Connectable, public ConfigurableComponent, public std::
   }
   // Whether flow file queued in incoming connection
   bool flowFilesQueued();
+  // Number of flow files queued in the incoming connections
+  uint64_t getQueuedFlowFiles();
   // Whether flow file queue full in any of the outgoin connection
   bool flowFilesOutGoingFull();
 
@@ -270,8 +281,22 @@ class Processor : public Connectable, public ConfigurableComponent, public std::
     return false;
   }
 
+  /**
+   * Whether consecutive triggers within the run duration may share one session, which is committed
+   * once they are done. Processors which only work on the flow files of their session, and do not
+   * commit or create sessions on their own, can opt in to save the cost of a commit per trigger.
+   */
+  virtual bool supportsBatching() const {
+    return false;
+  }
+
   bool isThrottledByBackpressure() const;
 
+  // Performance counters of this processor
+  const std::shared_ptr<ProcessorMetrics> &getMetrics() const {
+    return metrics_;
+  }
+
   std::shared_ptr<Connectable> pickIncomingConnection() override;
 
  protected:
@@ -296,9 +321,13 @@ class Processor : public Connectable, public ConfigurableComponent, public std::
   std::atomic<uint8_t> active_tasks_;
   // Trigger the Processor even if the incoming connection is empty
   std::atomic<bool> _triggerWhenEmpty;
+  // Pipeline segment the processor is part of
+  std::atomic<int> pipeline_segment_;
 
   std::string cron_period_;
 
+  std::shared_ptr<ProcessorMetrics> metrics_;
+
  private:
   // Mutex for protection
   std::mutex mutex_;
@@ -0,0 +1,173 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CORE_PROCESSORMETRICS_H_
+#define LIBMINIFI_INCLUDE_CORE_PROCESSORMETRICS_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+
+/**
+ * Purpose: A counter incremented from many threads. Each thread adds to one of several
+ * shards, each on its own cache line, so concurrent increments do not contend; reads sum
+ * the shards and are therefore only a snapshot.
+ */
+class ShardedCounter {
+ public:
+  static constexpr size_t SHARDS = 8;
+
+  ShardedCounter();
+
+  void add(uint64_t value) {
+    shards_[shardIndex()].value.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  uint64_t load() const;
+
+ private:
+  struct Shard {
+    std::atomic<uint64_t> value;
+    char padding[64 - sizeof(std::atomic<uint64_t>)];
+  };
+
+  // threads are assigned shards round robin the first time they add
+  static size_t shardIndex();
+
+  std::array<Shard, SHARDS> shards_;
+};
+
+/**
+ * Purpose: A histogram of durations in nanoseconds with a bounded relative error.
+ *
+ * Values are bucketed by their most significant bit and the SUB_BUCKET_BITS bits after it,
+ * as HdrHistogram does, so any recorded value is reported within 1/2^SUB_BUCKET_BITS of
+ * itself whatever its magnitude. Recording is a couple of relaxed atomic increments.
+ */
+class LatencyHistogram {
+ public:
+  static constexpr unsigned SUB_BUCKET_BITS = 3;
+  static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+  static constexpr size_t BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+  LatencyHistogram();
+
+  void record(uint64_t nanos);
+
+  uint64_t getCount() const {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t getTotal() const {
+    return total_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t getMax() const {
+    return max_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @param percentile between 0 and 100
+   * @return the highest value of the bucket holding the given percentile, 0 if nothing
+   * was recorded
+   */
+  uint64_t getPercentile(double percentile) const;
+
+  static size_t bucketIndex(uint64_t value);
+
+  // highest value which falls into the bucket
+  static uint64_t bucketUpperBound(size_t index);
+
+ private:
+  std::array<std::atomic<uint64_t>, BUCKETS> buckets_;
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> total_;
+  std::atomic<uint64_t> max_;
+};
+
+/**
+ * Purpose: What a processor costs, kept for every processor. The scheduling agents fill in
+ * the invocations, the time spent in onTrigger and under backpressure; the process sessions
+ * the FlowFiles taken and transferred and the time spent committing.
+ */
+class ProcessorMetrics {
+ public:
+  ProcessorMetrics()
+      : backpressure_start_(0) {
+  }
+
+  ProcessorMetrics(const ProcessorMetrics &other) = delete;
+  ProcessorMetrics &operator=(const ProcessorMetrics &other) = delete;
+
+  static uint64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  void recordOnTrigger(uint64_t nanos) {
+    invocations.add(1);
+    on_trigger_nanos.record(nanos);
+  }
+
+  void recordIncoming(uint64_t size) {
+    flow_files_in.add(1);
+    bytes_in.add(size);
+  }
+
+  void recordOutgoing(uint64_t flow_files, uint64_t bytes) {
+    flow_files_out.add(flow_files);
+    bytes_out.add(bytes);
+  }
+
+  /**
+   * Marks the processor as held back by backpressure at the given time, unless it already is.
+   */
+  void backpressureApplied(uint64_t at);
+
+  /**
+   * Ends a backpressure period begun by backpressureApplied, accounting for its duration.
+   */
+  void backpressureReleased(uint64_t at);
+
+  ShardedCounter invocations;
+  ShardedCounter flow_files_in;
+  ShardedCounter bytes_in;
+  ShardedCounter flow_files_out;
+  ShardedCounter bytes_out;
+  ShardedCounter backpressure_nanos;
+  LatencyHistogram on_trigger_nanos;
+  LatencyHistogram commit_nanos;
+
+ private:
+  // start of the current backpressure period, 0 if there is none
+  std::atomic<uint64_t> backpressure_start_;
+};
+
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif  // LIBMINIFI_INCLUDE_CORE_PROCESSORMETRICS_H_
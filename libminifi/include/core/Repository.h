@@ -188,6 +188,42 @@ class Repository : public virtual core::SerializableComponent, public core::Trac
     return true;
   }
 
+  /**
+   * Resumable variant of DeSerialize for repositories which keep their records in storage order.
+   * @param position key of the last record already consumed, empty to start from the oldest record.
+   * Upon return it holds the key of the last record read, so that passing it back continues after it.
+   *
+   * Base implementation ignores the position and reads like DeSerialize without it.
+   */
+  virtual bool DeSerialize(std::vector<std::shared_ptr<core::SerializableComponent>> &store, size_t &max_size, std::function<std::shared_ptr<core::SerializableComponent>()> lambdaConstructor,
+                           std::string &position) {
+    return DeSerialize(store, max_size, lambdaConstructor);
+  }
+
+  /**
+   * Retrieves a position persisted with setCursor.
+   * Base implementation does not persist cursors and returns false.
+   */
+  virtual bool getCursor(const std::string &name, std::string &position) {
+    return false;
+  }
+
+  /**
+   * Persists a position returned by DeSerialize under the given name, so that a reader resumes from it after a restart.
+   * Base implementation does not persist cursors and returns false.
+   */
+  virtual bool setCursor(const std::string &name, const std::string &position) {
+    return false;
+  }
+
+  /**
+   * Deletes the records after position from, up to and including position to, as returned by DeSerialize.
+   * Base implementation does not support ranges and returns false.
+   */
+  virtual bool DeleteRange(const std::string &from, const std::string &to) {
+    return false;
+  }
+
   /**
    * Base implementation returns true;
    */
@@ -111,14 +111,7 @@ class StandardControllerServiceProvider : public ControllerServiceProvider, publ
 
   virtual void enableAllControllerServices() {
     logger_->log_info("Enabling %u controller services", controller_map_->getAllControllerServices().size());
-    for (auto service : controller_map_->getAllControllerServices()) {
-      if (service->canEnable()) {
-        logger_->log_info("Enabling %s", service->getName());
-        agent_->enableControllerService(service);
-      } else {
-        logger_->log_warn("Could not enable %s", service->getName());
-      }
-    }
+    enableControllerServices(controller_map_->getAllControllerServices());
   }
 
   virtual void disableAllControllerServices() {
@@ -131,9 +124,15 @@ class StandardControllerServiceProvider : public ControllerServiceProvider, publ
   }
 
   void enableControllerServices(std::vector<std::shared_ptr<ControllerServiceNode>> serviceNodes) {
-    for (auto node : serviceNodes) {
-      enableControllerService(node);
+    std::vector<std::shared_ptr<ControllerServiceNode>> services;
+    for (auto service : serviceNodes) {
+      if (service->canEnable()) {
+        services.push_back(service);
+      } else {
+        logger_->log_warn("Could not enable %s", service->getName());
+      }
     }
+    agent_->enableControllerServices(services);
   }
 
   std::future<utils::TaskRescheduleInfo> disableControllerService(std::shared_ptr<ControllerServiceNode> &serviceNode) {
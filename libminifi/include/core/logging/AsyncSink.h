@@ -0,0 +1,110 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CORE_LOGGING_ASYNCSINK_H_
+#define LIBMINIFI_INCLUDE_CORE_LOGGING_ASYNCSINK_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "spdlog/common.h"
+#include "spdlog/details/log_msg.h"
+#include "spdlog/details/mpmc_bounded_q.h"
+#include "spdlog/sinks/sink.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+namespace logging {
+namespace internal {
+
+/**
+ * Sink which hands formatted messages to a bounded lock-free queue that a background thread
+ * drains into the wrapped sink, so that logging threads do not wait on I/O. When the queue is
+ * full, messages are either discarded or the caller retries until there is room.
+ */
+class AsyncSink : public spdlog::sinks::sink {
+ public:
+  static constexpr size_t DEFAULT_QUEUE_SIZE = 8192;
+
+  /**
+   * @param queue_size capacity of the queue, rounded up to the next power of two
+   */
+  AsyncSink(std::shared_ptr<spdlog::sinks::sink> sink, size_t queue_size = DEFAULT_QUEUE_SIZE,
+            spdlog::async_overflow_policy overflow_policy = spdlog::async_overflow_policy::block_retry);
+
+  AsyncSink(const AsyncSink&) = delete;
+  AsyncSink& operator=(const AsyncSink&) = delete;
+
+  /**
+   * Drains the queue before returning.
+   */
+  ~AsyncSink() override;
+
+  void log(const spdlog::details::log_msg &msg) override;
+
+  /**
+   * Queues a flush of the wrapped sink behind the messages logged so far; does not wait for it.
+   */
+  void flush() override;
+
+  /**
+   * @return number of messages discarded because the queue was full
+   */
+  uint64_t getDroppedCount() const {
+    return dropped_count_;
+  }
+
+ private:
+  struct Entry {
+    std::string logger_name;
+    spdlog::level::level_enum level = spdlog::level::off;
+    spdlog::log_clock::time_point time;
+    size_t thread_id = 0;
+    std::string raw;
+    std::string formatted;
+    bool flush = false;
+  };
+
+  void enqueue(Entry &&entry);
+
+  void run();
+
+  void write(const Entry &entry);
+
+  std::shared_ptr<spdlog::sinks::sink> sink_;
+  spdlog::details::mpmc_bounded_queue<Entry> queue_;
+  spdlog::async_overflow_policy overflow_policy_;
+  std::atomic<bool> running_;
+  std::atomic<uint64_t> dropped_count_;
+  std::thread worker_;
+};
+
+}  // namespace internal
+}  // namespace logging
+}  // namespace core
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
+
+#endif  // LIBMINIFI_INCLUDE_CORE_LOGGING_ASYNCSINK_H_
@@ -18,6 +18,7 @@
 #ifndef LIBMINIFI_INCLUDE_CORE_LOGGING_LOGGER_H_
 #define LIBMINIFI_INCLUDE_CORE_LOGGING_LOGGER_H_
 
+#include <atomic>
 #include <string>
 #include <mutex>
 #include <memory>
@@ -176,6 +177,11 @@ class Logger : public BaseLogger {
 
   Logger(std::shared_ptr<spdlog::logger> delegate); // NOLINT
 
+  /**
+   * Replaces the spdlog logger. Log calls may still be using the replaced one without holding a lock,
+   * so it is kept alive until the next replacement, i.e. the next time the configuration is reloaded.
+   */
+  void set_delegate(std::shared_ptr<spdlog::logger> delegate);
 
   std::shared_ptr<spdlog::logger> delegate_;
   std::shared_ptr<LoggerControl> controller_;
@@ -187,14 +193,18 @@ class Logger : public BaseLogger {
   inline void log(spdlog::level::level_enum level, const char * const format, const Args& ... args) {
     if (controller_ && !controller_->is_enabled())
          return;
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (!delegate_->should_log(level)) {
+    // the level check is a single acquire load, so disabled levels neither lock nor format
+    spdlog::logger *delegate = current_delegate_.load(std::memory_order_acquire);
+    if (!delegate->should_log(level)) {
       return;
     }
-    const auto str = format_string(format, conditional_conversion(args)...);
-    delegate_->log(level, str);
+    delegate->log(level, format_string(format, conditional_conversion(args)...));
   }
 
+  std::atomic<spdlog::logger*> current_delegate_;
+  // the delegate replaced last, which unlocked log calls may still be using
+  std::shared_ptr<spdlog::logger> retired_delegate_;
+
   Logger(Logger const&);
   Logger& operator=(Logger const&);
 };
@@ -143,10 +143,7 @@ class LoggerConfiguration {
           name(name) {
     }
 
-    void set_delegate(std::shared_ptr<spdlog::logger> delegate) {
-      std::lock_guard<std::mutex> lock(mutex_);
-      delegate_ = delegate;
-    }
+    using Logger::set_delegate;
     const std::string name;
   };
 
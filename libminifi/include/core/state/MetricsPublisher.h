@@ -0,0 +1,66 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CORE_STATE_METRICSPUBLISHER_H_
+#define LIBMINIFI_INCLUDE_CORE_STATE_METRICSPUBLISHER_H_
+
+#include <memory>
+#include <string>
+
+#include "core/Core.h"
+#include "core/state/nodes/MetricsBase.h"
+#include "properties/Configure.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace state {
+
+/**
+ * Purpose: Makes the metrics of the agent available outside of C2, for instance to be
+ * scraped by monitoring tools. The flow controller creates the publisher named by
+ * nifi.metrics.publisher.class, whether or not C2 is enabled.
+ */
+class MetricsPublisher : public core::CoreComponent {
+ public:
+  MetricsPublisher(std::string name, utils::Identifier &uuid)
+      : core::CoreComponent(name, uuid) {
+  }
+
+  explicit MetricsPublisher(std::string name)
+      : core::CoreComponent(name) {
+  }
+
+  virtual ~MetricsPublisher() = default;
+
+  /**
+   * Starts publishing.
+   * @param configuration agent configuration
+   * @param reporter source of the metric nodes, to be queried each time they are published.
+   * Publishers must not keep it alive.
+   */
+  virtual void initialize(const std::shared_ptr<Configure> &configuration, const std::shared_ptr<response::NodeReporter> &reporter) = 0;
+};
+
+}  // namespace state
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
+
+#endif  // LIBMINIFI_INCLUDE_CORE_STATE_METRICSPUBLISHER_H_
@@ -0,0 +1,65 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CORE_STATE_OPENMETRICSSERIALIZER_H_
+#define LIBMINIFI_INCLUDE_CORE_STATE_OPENMETRICSSERIALIZER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/state/nodes/MetricsBase.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace state {
+
+/**
+ * Purpose: Renders metric nodes in the OpenMetrics text format, which Prometheus scrapes.
+ *
+ * Every numeric value becomes a gauge named after the node and the path leading to the
+ * value, e.g. minifi_queuemetrics_queued. Monotonic values become counters instead, whose
+ * samples carry the _total suffix, e.g. minifi_processorperformancemetrics_invocations_total.
+ * Nodes report one entry per component (connection,
+ * processor, repository), so the name of a top level entry which has children becomes the
+ * "component" label rather than part of the metric name:
+ *
+ *   minifi_queuemetrics_queued{component="TransferFilesToRPG"} 3
+ *
+ * Values which are not numbers are left out.
+ */
+class OpenMetricsSerializer {
+ public:
+  static const char *CONTENT_TYPE;
+
+  static std::string serialize(const std::vector<std::shared_ptr<response::ResponseNode>> &nodes);
+
+  // lower case name made of [a-z0-9_] only
+  static std::string sanitizeName(const std::string &name);
+
+  static std::string escapeLabelValue(const std::string &value);
+};
+
+}  // namespace state
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
+
+#endif  // LIBMINIFI_INCLUDE_CORE_STATE_OPENMETRICSSERIALIZER_H_
@@ -484,11 +484,14 @@ struct SerializedResponseNode {
   ValueNode value;
   bool array;
   bool collapsible;
+  // the value only ever grows, like a count of invocations, so it can be published as a counter
+  bool monotonic;
   std::vector<SerializedResponseNode> children;
 
   SerializedResponseNode(bool collapsible = true) // NOLINT
       : array(false),
-        collapsible(collapsible) {
+        collapsible(collapsible),
+        monotonic(false) {
   }
 
   SerializedResponseNode(const SerializedResponseNode &other) = default;
@@ -203,6 +203,12 @@ class NodeReporter {
    */
   virtual std::vector<std::shared_ptr<ResponseNode>> getHeartbeatNodes(bool includeManifest) const = 0;
 
+  /**
+   * Retrieves the nodes to be published by the metrics publisher
+   * @return a list of response nodes
+   */
+  virtual std::vector<std::shared_ptr<ResponseNode>> getPublishedMetricsNodes() const = 0;
+
   /**
    * Retrieves the agent manifest to be sent as a response to C2 DESCRIBE manifest
    * @return the agent manifest response node
@@ -0,0 +1,137 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CORE_STATE_NODES_PROCESSORPERFORMANCEMETRICS_H_
+#define LIBMINIFI_INCLUDE_CORE_STATE_NODES_PROCESSORPERFORMANCEMETRICS_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../nodes/MetricsBase.h"
+#include "core/Processor.h"
+#include "core/ProcessorMetrics.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace state {
+namespace response {
+
+/**
+ * Justification and Purpose: Provides what each processor costs: invocations, time spent in
+ * onTrigger, committing and under backpressure, and the FlowFiles and bytes flowing in and out.
+ * Times are in nanoseconds.
+ */
+class ProcessorPerformanceMetrics : public ResponseNode {
+ public:
+  ProcessorPerformanceMetrics(const std::string &name, utils::Identifier &uuid)
+      : ResponseNode(name, uuid) {
+  }
+
+  ProcessorPerformanceMetrics(const std::string &name) // NOLINT
+      : ResponseNode(name) {
+  }
+
+  ProcessorPerformanceMetrics()
+      : ResponseNode("ProcessorPerformanceMetrics") {
+  }
+
+  virtual std::string getName() const {
+    return "ProcessorPerformanceMetrics";
+  }
+
+  void addProcessor(const std::shared_ptr<core::Processor> &processor) {
+    if (nullptr != processor) {
+      processors_.insert(std::make_pair(processor->getName(), processor->getMetrics()));
+    }
+  }
+
+  std::vector<SerializedResponseNode> serialize() {
+    std::vector<SerializedResponseNode> serialized;
+    for (const auto &processor : processors_) {
+      const auto &metrics = processor.second;
+      SerializedResponseNode parent;
+      parent.name = processor.first;
+
+      parent.children.push_back(counter("invocations", metrics->invocations));
+      parent.children.push_back(counter("flowfilesin", metrics->flow_files_in));
+      parent.children.push_back(counter("bytesin", metrics->bytes_in));
+      parent.children.push_back(counter("flowfilesout", metrics->flow_files_out));
+      parent.children.push_back(counter("bytesout", metrics->bytes_out));
+      parent.children.push_back(counter("backpressuretime", metrics->backpressure_nanos));
+      parent.children.push_back(histogram("ontriggertime", metrics->on_trigger_nanos));
+      parent.children.push_back(histogram("committime", metrics->commit_nanos));
+
+      serialized.push_back(parent);
+    }
+    return serialized;
+  }
+
+ protected:
+  static SerializedResponseNode counter(const std::string &name, const core::ShardedCounter &counter) {
+    SerializedResponseNode node;
+    node.name = name;
+    node.value = counter.load();
+    node.monotonic = true;
+    return node;
+  }
+
+  static SerializedResponseNode histogram(const std::string &name, const core::LatencyHistogram &histogram) {
+    SerializedResponseNode node;
+    node.name = name;
+
+    SerializedResponseNode count;
+    count.name = "count";
+    count.value = histogram.getCount();
+    count.monotonic = true;
+    node.children.push_back(count);
+
+    SerializedResponseNode total;
+    total.name = "total";
+    total.value = histogram.getTotal();
+    total.monotonic = true;
+    node.children.push_back(total);
+
+    for (const auto &percentile : { std::make_pair("p50", 50.0), std::make_pair("p90", 90.0), std::make_pair("p99", 99.0) }) {
+      SerializedResponseNode value;
+      value.name = percentile.first;
+      value.value = histogram.getPercentile(percentile.second);
+      node.children.push_back(value);
+    }
+
+    SerializedResponseNode max;
+    max.name = "max";
+    max.value = histogram.getMax();
+    node.children.push_back(max);
+    return node;
+  }
+
+  std::map<std::string, std::shared_ptr<core::ProcessorMetrics>> processors_;
+};
+
+}  // namespace response
+}  // namespace state
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
+
+#endif  // LIBMINIFI_INCLUDE_CORE_STATE_NODES_PROCESSORPERFORMANCEMETRICS_H_
@@ -0,0 +1,91 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_IO_HASHINGSTREAM_H_
+#define LIBMINIFI_INCLUDE_IO_HASHINGSTREAM_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BaseStream.h"
+#include "utils/HashUtils.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace io {
+
+/**
+ * Pass-through stream that feeds every byte read from or written to the
+ * underlying stream into a set of hashers, so that any number of digests
+ * can be computed in a single pass over the data.
+ */
+class HashingStream : public BaseStream {
+ public:
+  static constexpr size_t DEFAULT_BUFFER_SIZE = 1024 * 1024;
+
+  /**
+   * Raw pointer because the caller guarantees that
+   * it will exceed our lifetime.
+   */
+  HashingStream(DataStream *child_stream, std::vector<std::unique_ptr<utils::Hasher>> hashers);
+
+  HashingStream(const HashingStream&) = delete;
+  HashingStream& operator=(const HashingStream&) = delete;
+
+  ~HashingStream() override = default;
+
+  int readData(std::vector<uint8_t> &buf, int buflen) override;
+
+  int readData(uint8_t *buf, int buflen) override;
+
+  int writeData(uint8_t *value, int size) override;
+
+  /**
+   * Reads the underlying stream until it is exhausted.
+   * @param buffer_size size of the read buffer, capped at the size of the underlying stream
+   * @return number of bytes hashed or -1 on read failure
+   */
+  int64_t consume(size_t buffer_size = DEFAULT_BUFFER_SIZE);
+
+  /**
+   * Finalizes every hasher.
+   * @return (algorithm name, hex digest) pairs in the order the hashers were given
+   */
+  std::vector<std::pair<std::string, std::string>> getDigests();
+
+  uint64_t getBytesHashed() const {
+    return bytes_hashed_;
+  }
+
+ private:
+  void update(const uint8_t *data, int length);
+
+  std::vector<std::unique_ptr<utils::Hasher>> hashers_;
+  uint64_t bytes_hashed_;
+};
+
+}  // namespace io
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
+#endif  // LIBMINIFI_INCLUDE_IO_HASHINGSTREAM_H_
@@ -58,6 +58,8 @@ class Configure : public Properties {
   static const char *nifi_flow_configuration_file_exit_failure;
   static const char *nifi_flow_configuration_file_backup_update;
   static const char *nifi_flow_engine_threads;
+  static const char *nifi_flow_engine_threads_affinity;
+  static const char *nifi_flow_engine_threads_cores;
   static const char *nifi_flow_engine_alert_period;
   static const char *nifi_flow_engine_event_driven_time_slice;
   static const char *nifi_administrative_yield_duration;
@@ -73,6 +75,10 @@ class Configure : public Properties {
   static const char *nifi_server_port;
   static const char *nifi_server_report_interval;
   static const char *nifi_provenance_repository_max_storage_time;
+  static const char *nifi_provenance_repository_secondary_indexes;
+  static const char *nifi_provenance_excluded_event_types;
+  static const char *nifi_provenance_sampling_percentage;
+  static const char *nifi_provenance_rate_limit;
   static const char *nifi_provenance_repository_max_storage_size;
   static const char *nifi_provenance_repository_directory_default;
   static const char *nifi_provenance_repository_enable;
@@ -101,6 +107,9 @@ class Configure : public Properties {
   static const char *nifi_c2_flow_base_url;
   static const char *nifi_c2_full_heartbeat;
 
+  // metrics options
+  static const char *nifi_metrics_publisher_class;
+
   // state management options
   static const char *nifi_state_management_provider_local;
   static const char *nifi_state_management_provider_local_always_persist;
@@ -40,6 +40,7 @@
 #include "io/Serializable.h"
 #include "utils/Id.h"
 #include "utils/TimeUtil.h"
+#include "provenance/ProvenancePolicy.h"
 
 namespace org {
 namespace apache {
@@ -179,7 +180,7 @@ class ProvenanceEventRecord : public core::SerializableComponent {
     setUUIDStr(id);
   }
   // Get Attributes
-  std::map<std::string, std::string> getAttributes() {
+  const core::FlowFileAttributes &getAttributes() const {
     return _attributes;
   }
   // Get Size
@@ -363,34 +364,20 @@ class ProvenanceEventRecord : public core::SerializableComponent {
   // DeSerialize
   bool DeSerialize(const std::shared_ptr<core::SerializableComponent> &repo);
 
-  uint64_t getEventTime(const uint8_t *buffer, const size_t bufferSize) {
-    int size = bufferSize > 72 ? 72 : bufferSize;
-    org::apache::nifi::minifi::io::DataStream outStream(buffer, size);
+  // Get the event time of a serialized event without deserializing it, 0 if the buffer does not hold an event
+  static uint64_t getEventTime(const uint8_t *buffer, const size_t bufferSize);
 
-    std::string uuid;
-    int ret = readUTF(uuid, &outStream);
-
-    if (ret <= 0) {
-      return 0;
-    }
-
-    uint32_t eventType;
-    ret = read(eventType, &outStream);
-    if (ret != 4) {
-      return 0;
-    }
-
-    uint64_t event_time;
-
-    ret = read(event_time, &outStream);
-    if (ret != 8) {
-      return 0;
-    }
-
-    return event_time;
-  }
+  /**
+   * Reads the identifiers at the head of a serialized event without deserializing
+   * the remainder, so that repositories can maintain indexes on them.
+   * @return false if the buffer does not start with a valid event header
+   */
+  static bool getIdentifiers(const uint8_t *buffer, const size_t bufferSize, std::string &uuid, std::string &componentId, std::string &flowFileUuid);
 
  protected:
+  // DeSerialize an event written by versions preceding the compact encoding
+  bool DeSerializeLegacy(const uint8_t *buffer, const size_t bufferSize);
+
   // Event type
   ProvenanceEventType _eventType;
   // Date at which the event was created
@@ -414,7 +401,8 @@ class ProvenanceEventRecord : public core::SerializableComponent {
   // Full path to the content
   std::string _contentFullPath;
   // Attributes key/values pairs for the flow record
-  std::map<std::string, std::string> _attributes;
+  // shares the storage of the FlowFile's attributes
+  core::FlowFileAttributes _attributes;
   // UUID string for all parents
   std::set<std::string> _lineageIdentifiers;
   // transitUri
@@ -450,8 +438,9 @@ class ProvenanceReporter {
   /*!
    * Create a new provenance reporter associated with the process session
    */
-  ProvenanceReporter(std::shared_ptr<core::Repository> repo, std::string componentId, std::string componentType)
-      : logger_(logging::LoggerFactory<ProvenanceReporter>::getLogger()) {
+  ProvenanceReporter(std::shared_ptr<core::Repository> repo, std::string componentId, std::string componentType, std::shared_ptr<ProvenancePolicy> policy = nullptr)
+      : logger_(logging::LoggerFactory<ProvenanceReporter>::getLogger()),
+        policy_(std::move(policy)) {
     _componentId = componentId;
     _componentType = componentType;
     repo_ = repo;
@@ -480,6 +469,13 @@ class ProvenanceReporter {
   void clear() {
     _events.clear();
   }
+  /**
+   * Whether events of the given type on the given FlowFile are recorded. Lets callers skip
+   * preparing the details of events which would be discarded.
+   */
+  bool isEnabled(ProvenanceEventRecord::ProvenanceEventType eventType, const std::shared_ptr<core::FlowFile> &flow) const {
+    return !repo_->isNoop() && (nullptr == policy_ || policy_->isEnabled(eventType, flow->getUUIDStr()));
+  }
   // commit
   void commit();
   // create
@@ -510,7 +506,7 @@ class ProvenanceReporter {
  protected:
   // allocate
   std::shared_ptr<ProvenanceEventRecord> allocate(ProvenanceEventRecord::ProvenanceEventType eventType, std::shared_ptr<core::FlowFile> flow) {
-    if (repo_->isNoop()) {
+    if (!isEnabled(eventType, flow) || (policy_ && !policy_->acquire())) {
       return nullptr;
     }
 
@@ -532,6 +528,8 @@ class ProvenanceReporter {
   std::set<std::shared_ptr<ProvenanceEventRecord>> _events;
   // provenance repository.
   std::shared_ptr<core::Repository> repo_;
+  // events recorded, nullptr to record every event
+  std::shared_ptr<ProvenancePolicy> policy_;
 
   // Prevent default copy constructor and assignment operation
   // Only support pass by reference or pointer
@@ -0,0 +1,82 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_PROVENANCE_PROVENANCEPOLICY_H_
+#define LIBMINIFI_INCLUDE_PROVENANCE_PROVENANCEPOLICY_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "properties/Configure.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace provenance {
+
+/**
+ * Decides which provenance events of a component are recorded. It is consulted before an event
+ * is created, so that events which are not recorded cost neither allocations nor formatting.
+ *
+ * Configured through the following properties, each of which can be overridden for a single
+ * processor by appending "." and the processor's UUID or name to the property name:
+ *  - nifi.provenance.excluded.event.types: comma separated event types which are not recorded
+ *  - nifi.provenance.sampling.percentage: percentage of FlowFiles whose events are recorded. The decision
+ *    only depends on the FlowFile UUID, so the events of a FlowFile are either all recorded or none of them
+ *  - nifi.provenance.rate.limit: maximum number of events recorded per second, 0 for no limit
+ */
+class ProvenancePolicy {
+ public:
+  ProvenancePolicy(uint32_t excluded_types, double sampling_percentage, uint64_t rate_limit);
+
+  /**
+   * @return the policy of the component or nullptr if all of its events are recorded
+   */
+  static std::shared_ptr<ProvenancePolicy> create(const Configure &configure, const std::string &component_uuid, const std::string &component_name);
+
+  /**
+   * Whether the events of the given type on the given FlowFile are recorded, regardless of the rate limit.
+   * @param event_type ProvenanceEventRecord::ProvenanceEventType of the event
+   */
+  bool isEnabled(int event_type, const std::string &flow_file_uuid) const;
+
+  /**
+   * Takes up a slot of the rate limit.
+   * @return false if the limit of the current second has been reached
+   */
+  bool acquire();
+
+ private:
+  const uint32_t excluded_types_;
+  const bool sampling_;
+  // FlowFiles whose UUID hashes below the threshold are sampled
+  const uint64_t sampling_threshold_;
+  const uint64_t rate_limit_;
+  std::atomic<uint64_t> window_;
+  std::atomic<uint64_t> window_count_;
+};
+
+}  // namespace provenance
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
+
+#endif  // LIBMINIFI_INCLUDE_PROVENANCE_PROVENANCEPOLICY_H_
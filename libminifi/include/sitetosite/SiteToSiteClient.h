@@ -43,14 +43,14 @@ namespace sitetosite {
  */
 class DataPacket {
  public:
-  DataPacket(const std::shared_ptr<logging::Logger> &logger, const std::shared_ptr<Transaction> &transaction, std::map<std::string, std::string> attributes, const std::string &payload)
+  DataPacket(const std::shared_ptr<logging::Logger> &logger, const std::shared_ptr<Transaction> &transaction, core::FlowFileAttributes attributes, const std::string &payload)
       : payload_(payload),
         logger_reference_(logger) {
     _size = 0;
     transaction_ = transaction;
-    _attributes = attributes;
+    _attributes = std::move(attributes);
   }
-  std::map<std::string, std::string> _attributes;
+  core::FlowFileAttributes _attributes;
   uint64_t _size;
   std::shared_ptr<Transaction> transaction_;
   const std::string & payload_;
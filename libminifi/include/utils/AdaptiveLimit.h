@@ -0,0 +1,95 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_UTILS_ADAPTIVELIMIT_H_
+#define LIBMINIFI_INCLUDE_UTILS_ADAPTIVELIMIT_H_
+
+#include <cstdint>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+
+/**
+ * What was observed of a thread pool or a processor during one adjustment period.
+ */
+struct ConcurrencySample {
+  // tasks finished during the period
+  uint64_t tasks = 0;
+  // time the finished tasks ran for
+  uint64_t task_nanos = 0;
+  // length of the period
+  uint64_t period_nanos = 0;
+  // tasks waiting for a thread at the end of the period
+  uint64_t queued = 0;
+  // cores the process kept busy during the period, negative when unknown
+  double cpu_cores = -1.0;
+};
+
+/**
+ * Purpose: Concurrency limit which follows the observed load, in the manner of a gradient limiter.
+ *
+ * The limit grows while work is queued up and tasks run as fast as they used to. It shrinks when
+ * tasks slow down compared to the long term average, which means they compete for something, when
+ * the threads are mostly idle, and multiplicatively when the process uses more CPU than its budget.
+ */
+class AdaptiveLimit {
+ public:
+  /**
+   * @param min_limit lowest limit
+   * @param max_limit highest limit
+   * @param cpu_budget cores the process may keep busy, 0 for no budget
+   * @param initial_limit limit to start from
+   */
+  AdaptiveLimit(uint16_t min_limit, uint16_t max_limit, double cpu_budget, uint16_t initial_limit);
+
+  /**
+   * Adjusts the limit to what was observed during the last period
+   * @param sample observations of the last period
+   * @return the new limit
+   */
+  uint16_t update(const ConcurrencySample &sample);
+
+  uint16_t getLimit() const;
+
+  // latency may grow by this factor before the limit is reduced
+  static constexpr double TOLERANCE = 1.5;
+  // weight of the last period in the long term latency
+  static constexpr double LATENCY_SMOOTHING = 0.1;
+  // weight of the new limit compared to the previous one
+  static constexpr double LIMIT_SMOOTHING = 0.2;
+  // factor the limit is reduced by when the CPU budget is exceeded
+  static constexpr double BACKOFF = 0.75;
+  // share of the CPU budget above which the limit is not increased
+  static constexpr double CPU_HEADROOM = 0.9;
+
+ private:
+  const double min_limit_;
+  const double max_limit_;
+  const double cpu_budget_;
+  double limit_;
+  double long_latency_;
+};
+
+}  // namespace utils
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
+
+#endif  // LIBMINIFI_INCLUDE_UTILS_ADAPTIVELIMIT_H_
@@ -0,0 +1,106 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_UTILS_HASHUTILS_H_
+#define LIBMINIFI_INCLUDE_UTILS_HASHUTILS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+
+/**
+ * Incremental message digest. Implementations are fed with update() and produce
+ * the hex encoded digest once all data has been consumed.
+ */
+class Hasher {
+ public:
+  virtual ~Hasher() = default;
+
+  /**
+   * Canonical name of the algorithm, e.g. SHA256
+   */
+  virtual std::string getName() const = 0;
+
+  virtual void update(const uint8_t *data, size_t length) = 0;
+
+  /**
+   * Finalizes the digest. The hasher must not be updated afterwards.
+   * @return upper case hex encoded digest
+   */
+  virtual std::string digest() = 0;
+};
+
+/**
+ * XXH64 non-cryptographic hash. Considerably faster than the cryptographic digests,
+ * which makes it suitable for deduplication but not for integrity checks against tampering.
+ */
+class XXHash64Hasher : public Hasher {
+ public:
+  explicit XXHash64Hasher(uint64_t seed = 0);
+
+  std::string getName() const override {
+    return "XXH64";
+  }
+
+  void update(const uint8_t *data, size_t length) override;
+
+  std::string digest() override;
+
+  uint64_t digestValue() const;
+
+ private:
+  uint64_t seed_;
+  uint64_t total_length_;
+  uint64_t v_[4];
+  uint8_t mem_[32];
+  size_t mem_size_;
+};
+
+class HashUtils {
+ public:
+  /**
+   * Normalizes an algorithm name: upper cases it and removes dashes, so that sha-256 and SHA256 are equivalent.
+   */
+  static std::string normalizeAlgorithmName(const std::string &name);
+
+  /**
+   * Creates a hasher for the given algorithm name.
+   * @return the hasher or nullptr if the algorithm is not supported
+   */
+  static std::unique_ptr<Hasher> createHasher(const std::string &name);
+
+  /**
+   * @return the normalized names of all algorithms createHasher() supports
+   */
+  static std::vector<std::string> getSupportedAlgorithms();
+};
+
+}  // namespace utils
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
+
+#endif  // LIBMINIFI_INCLUDE_UTILS_HASHUTILS_H_
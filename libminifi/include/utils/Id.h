@@ -161,9 +161,22 @@ class IdGenerator {
   int implementation_;
   std::shared_ptr<minifi::core::logging::Logger> logger_;
 
+  void generateRandom(UUID_FIELD output);
+  void generateTime(UUID_FIELD output);
+  void generateMinifiUid(UUID_FIELD output);
+  void initializeTimeSuffix();
+
   unsigned char deterministic_prefix_[8];
   std::atomic<uint64_t> incrementor_;
 
+  // Threads reserve blocks of timestamps and minifi uid counter values, the epoch tells them
+  // whether a reserved block still belongs to the current configuration.
+  std::atomic<uint64_t> epoch_;
+  // last timestamp (in 100ns intervals since the Gregorian calendar reform) reserved by a thread
+  std::atomic<uint64_t> last_timestamp_;
+  // clock sequence and node of the time based ids
+  unsigned char time_suffix_[8];
+
   std::mutex uuid_mutex_;
 #ifndef WIN32
   std::unique_ptr<uuid> uuid_impl_;
@@ -19,10 +19,15 @@
 #ifndef LIBMINIFI_INCLUDE_UTILS_REGEXUTILS_H_
 #define LIBMINIFI_INCLUDE_UTILS_REGEXUTILS_H_
 
+#include <memory>
 #include <string>
 #include <vector>
 
-#if defined(__GNUC__) && (__GNUC__ < 4 || (__GNUC__ == 4 && __GNUC_MINOR__ < 9))
+#if defined(RE2_SUPPORT)
+namespace re2 {
+class RE2;
+}  // namespace re2
+#elif defined(__GNUC__) && (__GNUC__ < 4 || (__GNUC__ == 4 && __GNUC_MINOR__ < 9))
 #include <regex.h>
 #else
 #include <regex>
@@ -35,6 +40,13 @@ namespace nifi {
 namespace minifi {
 namespace utils {
 
+/**
+ * Compiled regular expression. The expression is compiled once at construction, so instances
+ * should be created outside of hot paths (e.g. in onSchedule) and reused.
+ *
+ * When built with RE2_SUPPORT the linear time RE2 engine is used, otherwise std::regex (ECMAScript)
+ * or POSIX extended regular expressions on old compilers.
+ */
 class Regex {
  public:
   enum class Mode { ICASE };
@@ -52,26 +64,43 @@ class Regex {
   const std::vector<std::string>& getResult() const;
   const std::string& getSuffix() const;
 
+  /**
+   * Searches input for the first match starting at offset. Unlike match(), this does not
+   * modify the Regex, so a single instance can be shared by concurrent threads.
+   * @param input text to search in
+   * @param offset position in input where the search starts; it is treated as the start of the text
+   * @param results set to the capture groups of the match, group 0 being the entire match
+   * @param match_end set to the position in input right after the match
+   * @return true if a match was found
+   */
+  bool search(const std::string &input, size_t offset, std::vector<std::string> &results, size_t &match_end) const;
+
+  bool isValid() const {
+    return valid_;
+  }
+
   static bool matchesFullInput(const std::string &regex, const std::string &input);
 
  private:
-  std::string pat_;
   std::string suffix_;
   std::string regexStr_;
   std::vector<std::string> results_;
   bool valid_;
 
-#ifdef NO_MORE_REGFREEE
+#if defined(RE2_SUPPORT)
+
+  std::unique_ptr<re2::RE2> compiledRegex_;
+
+#elif defined(NO_MORE_REGFREEE)
 
   std::regex compiledRegex_;
   std::regex_constants::syntax_option_type regex_mode_;
-  std::smatch matches_;
 
 #else
 
   regex_t compiledRegex_;
   int regex_mode_;
-  std::vector<regmatch_t> matches_;
+  size_t maxGroups_;
 
 #endif
 };
@@ -0,0 +1,118 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_UTILS_THREADAFFINITY_H_
+#define LIBMINIFI_INCLUDE_UTILS_THREADAFFINITY_H_
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+
+/**
+ * Purpose: Places the worker threads of a thread pool onto cores.
+ *
+ * Workers are numbered and placed in order: compact fills up the cores of one NUMA node before
+ * moving on to the next, scatter takes turns between the nodes, and explicit uses the configured
+ * cores in the configured order. Workers beyond the number of cores start over.
+ */
+class ThreadAffinity {
+ public:
+  enum Policy {
+    NONE,
+    COMPACT,
+    SCATTER,
+    EXPLICIT
+  };
+
+  /**
+   * Cores of each NUMA node.
+   */
+  typedef std::vector<std::vector<int>> Topology;
+
+  /**
+   * Leaves the threads wherever the operating system puts them.
+   */
+  ThreadAffinity();
+
+  /**
+   * @param policy how workers are placed
+   * @param cores cores to place workers on, all of them when empty. Required for the explicit policy.
+   * @param topology cores of each NUMA node
+   */
+  ThreadAffinity(Policy policy, const std::vector<int> &cores, const Topology &topology = detectTopology());
+
+  bool isEnabled() const {
+    return !placement_.empty();
+  }
+
+  /**
+   * @param worker number of the worker
+   * @return the core the worker runs on, -1 if it is not pinned
+   */
+  int getCore(size_t worker) const;
+
+  /**
+   * @param worker number of the worker
+   * @return the NUMA node the worker runs on, 0 if it is not pinned
+   */
+  int getNode(size_t worker) const;
+
+  /**
+   * Pins the calling thread to a core.
+   * @return false if the thread cannot be pinned, e.g. as the platform does not support it
+   */
+  static bool pinCurrentThread(int core);
+
+  /**
+   * Reads the NUMA nodes and their cores usable by this process. Everything is a single node
+   * on platforms which do not tell.
+   */
+  static Topology detectTopology();
+
+  /**
+   * @param policy none, compact, scatter or explicit, in any case
+   * @param out the policy
+   * @return false if the policy is unknown
+   */
+  static bool parsePolicy(const std::string &policy, Policy &out);
+
+  /**
+   * Parses lists of cores the way Linux prints them, e.g. 0-3,8,10-11
+   * @param cores the list
+   * @param out the cores in the order listed
+   * @return false if the list is malformed
+   */
+  static bool parseCoreList(const std::string &cores, std::vector<int> &out);
+
+ private:
+  // core and NUMA node of each worker, in order
+  std::vector<std::pair<int, int>> placement_;
+};
+
+}  // namespace utils
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
+
+#endif  // LIBMINIFI_INCLUDE_UTILS_THREADAFFINITY_H_
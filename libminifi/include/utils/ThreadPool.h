@@ -32,9 +32,11 @@
 #include <thread>
 #include <functional>
 
+#include "AdaptiveLimit.h"
 #include "BackTrace.h"
 #include "MinifiConcurrentQueue.h"
 #include "Monitors.h"
+#include "ThreadAffinity.h"
 #include "core/expect.h"
 #include "controllers/ThreadManagementService.h"
 #include "core/controller/ControllerService.h"
@@ -56,6 +58,7 @@ class Worker {
   explicit Worker(const std::function<T()> &task, const std::string &identifier, std::unique_ptr<AfterExecute<T>> run_determinant)
       : identifier_(identifier),
         next_exec_time_(std::chrono::steady_clock::now()),
+        placement_(-1),
         task(task),
         run_determinant_(std::move(run_determinant)) {
     promise = std::make_shared<std::promise<T>>();
@@ -64,6 +67,7 @@ class Worker {
   explicit Worker(const std::function<T()> &task, const std::string &identifier)
       : identifier_(identifier),
         next_exec_time_(std::chrono::steady_clock::now()),
+        placement_(-1),
         task(task),
         run_determinant_(nullptr) {
     promise = std::make_shared<std::promise<T>>();
@@ -71,7 +75,8 @@ class Worker {
 
   explicit Worker(const std::string identifier = "")
       : identifier_(identifier),
-        next_exec_time_(std::chrono::steady_clock::now()) {
+        next_exec_time_(std::chrono::steady_clock::now()),
+        placement_(-1) {
   }
 
   virtual ~Worker() = default;
@@ -82,6 +87,7 @@ class Worker {
   Worker(Worker &&other) noexcept
       : identifier_(std::move(other.identifier_)),
         next_exec_time_(std::move(other.next_exec_time_)),
+        placement_(other.placement_),
         task(std::move(other.task)),
         run_determinant_(std::move(other.run_determinant_)),
         promise(other.promise) {
@@ -127,9 +133,23 @@ class Worker {
     return identifier_;
   }
 
+  /**
+   * Tasks with the same placement preferably run on the same NUMA node, when the
+   * thread pool spans several of them.
+   * @param placement placement of the task, negative for none
+   */
+  void setPlacement(int placement) {
+    placement_ = placement;
+  }
+
+  int getPlacement() const {
+    return placement_;
+  }
+
  protected:
   std::string identifier_;
   std::chrono::time_point<std::chrono::steady_clock> next_exec_time_;
+  int placement_;
   std::function<T()> task;
   std::unique_ptr<AfterExecute<T>> run_determinant_;
   std::shared_ptr<std::promise<T>> promise;
@@ -148,6 +168,7 @@ Worker<T>& Worker<T>::operator =(Worker<T> && other) noexcept {
   task = std::move(other.task);
   promise = other.promise;
   next_exec_time_ = std::move(other.next_exec_time_);
+  placement_ = other.placement_;
   identifier_ = std::move(other.identifier_);
   run_determinant_ = std::move(other.run_determinant_);
   return *this;
@@ -163,15 +184,23 @@ class WorkerThread {
   explicit WorkerThread(std::thread thread, const std::string &name = "NamelessWorker")
       : is_running_(false),
         thread_(std::move(thread)),
-        name_(name) {
+        name_(name),
+        core_(-1),
+        queue_(0) {
   }
   WorkerThread(const std::string &name = "NamelessWorker") // NOLINT
       : is_running_(false),
-        name_(name) {
+        name_(name),
+        core_(-1),
+        queue_(0) {
   }
   std::atomic<bool> is_running_;
   std::thread thread_;
   std::string name_;
+  // core the thread is pinned to, -1 if it is not
+  int core_;
+  // worker queue of the thread's NUMA node
+  size_t queue_;
 };
 
 /**
@@ -190,11 +219,16 @@ class ThreadPool {
         max_worker_threads_(max_worker_threads),
         adjust_threads_(false),
         running_(false),
+        sample_tasks_(false),
+        completed_tasks_(0),
+        task_nanos_(0),
         controller_service_provider_(controller_service_provider),
+        next_queue_(0),
         name_(name) {
     current_workers_ = 0;
     task_count_ = 0;
     thread_manager_ = nullptr;
+    worker_queues_.emplace_back(new ConditionConcurrentQueue<Worker<T>>());
   }
 
   ThreadPool(const ThreadPool<T> &other) = delete;
@@ -223,6 +257,14 @@ class ThreadPool {
    */
   void stopTasks(const std::string &identifier);
 
+  /**
+   * Waits until the tasks stopped by stopTasks are no longer queued or running.
+   * @param identifier for worker tasks
+   * @param timeout time to wait for
+   * @return false if some of them are still around after the timeout
+   */
+  bool waitForStoppedTasks(const std::string &identifier, std::chrono::milliseconds timeout);
+
   /**
    * Returns true if a task is running.
    */
@@ -275,10 +317,35 @@ class ThreadPool {
       shutdown();
     }
     max_worker_threads_ = max;
+    createWorkerQueues();
+    if (was_running)
+      start();
+  }
+
+  /**
+   * Sets where the worker threads run. The pool keeps a worker queue for each NUMA node its
+   * threads run on, threads run the tasks of their own node first and those of other nodes
+   * when theirs are done.
+   */
+  void setAffinity(const ThreadAffinity &affinity) {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex_);
+    bool was_running = running_;
+    if (was_running) {
+      shutdown();
+    }
+    affinity_ = affinity;
+    createWorkerQueues();
     if (was_running)
       start();
   }
 
+  /**
+   * Returns the service managing the threads of this pool, if there is one.
+   */
+  std::shared_ptr<controllers::ThreadManagementService> getThreadManager() const {
+    return std::atomic_load(&thread_manager_);
+  }
+
   void setControllerServiceProvider(std::shared_ptr<core::controller::ControllerServiceProvider> controller_service_provider) {
     std::lock_guard<std::recursive_mutex> lock(manager_mutex_);
     bool was_running = running_;
@@ -301,7 +368,9 @@ class ThreadPool {
    * Drain will notify tasks to stop following notification
    */
   void drain() {
-    worker_queue_.stop();
+    for (auto &queue : worker_queues_) {
+      queue->stop();
+    }
     while (current_workers_ > 0) {
       // The sleeping workers were waken up and stopped, but we have to wait
       // the ones that actually worked on something when the queue was stopped.
@@ -327,14 +396,25 @@ class ThreadPool {
   std::atomic<bool> adjust_threads_;
 // atomic running boolean
   std::atomic<bool> running_;
+// whether tasks are timed for the thread manager
+  std::atomic<bool> sample_tasks_;
+// tasks finished and the time they ran for since the thread manager last looked at them
+  std::atomic<uint64_t> completed_tasks_;
+  std::atomic<uint64_t> task_nanos_;
 // controller service provider
   std::shared_ptr<core::controller::ControllerServiceProvider> controller_service_provider_;
 // integrated power manager
   std::shared_ptr<controllers::ThreadManagementService> thread_manager_;
   // thread queue for the recently deceased threads.
   ConcurrentQueue<std::shared_ptr<WorkerThread>> deceased_thread_queue_;
-// worker queue of worker objects
-  ConditionConcurrentQueue<Worker<T>> worker_queue_;
+// placement of the worker threads
+  ThreadAffinity affinity_;
+// worker queues of worker objects, one for each NUMA node the worker threads run on
+  std::vector<std::unique_ptr<ConditionConcurrentQueue<Worker<T>>>> worker_queues_;
+// worker queue of each NUMA node
+  std::map<int, size_t> node_queues_;
+// worker queue for tasks without a placement
+  std::atomic<size_t> next_queue_;
   std::priority_queue<Worker<T>, std::vector<Worker<T>>, DelayedTaskComparator<T>> delayed_worker_queue_;
 // mutex to  protect task status and delayed queue
   std::mutex worker_queue_mutex_;
@@ -342,6 +422,10 @@ class ThreadPool {
   std::condition_variable delayed_task_available_;
 // map to identify if a task should be
   std::map<std::string, bool> task_status_;
+// number of tasks queued or running by identifier
+  std::map<std::string, uint32_t> tasks_by_identifier_;
+// notification for the last task of an identifier being gone
+  std::condition_variable task_finished_;
 // manager mutex
   std::recursive_mutex manager_mutex_;
   // thread pool name
@@ -352,12 +436,46 @@ class ThreadPool {
    */
   void manageWorkers();
 
+  /**
+   * Starts one more worker thread. Requires worker_queue_mutex_.
+   */
+  void addWorker();
+
+  /**
+   * Places a worker thread onto its core and the worker queue of its node.
+   */
+  void placeWorker(WorkerThread &thread, size_t index);
+
+  /**
+   * Creates a worker queue for each NUMA node the worker threads run on. Tasks still queued are dropped.
+   */
+  void createWorkerQueues();
+
+  /**
+   * Returns the worker queue a task goes to
+   * @param task the task
+   * @param queue the queue to use when the task has no placement
+   */
+  ConditionConcurrentQueue<Worker<T>> &getWorkerQueue(const Worker<T> &task, size_t queue);
+
+  /**
+   * Takes the next task for a worker thread, from its own queue or from the others if there is
+   * nothing in it.
+   * @return false if the pool is stopped or should lose a thread
+   */
+  bool dequeueTask(const WorkerThread &thread, Worker<T> &task);
+
   /**
    * Runs worker tasks
    */
   void run_tasks(std::shared_ptr<WorkerThread> thread);
 
   void manage_delayed_queue();
+
+  /**
+   * Accounts for a task which is not going to run again. Requires worker_queue_mutex_.
+   */
+  void taskFinished(const std::string &identifier);
 };
 
 }  // namespace utils
@@ -28,6 +28,8 @@ const char *Configure::nifi_flow_configuration_file = "nifi.flow.configuration.f
 const char *Configure::nifi_flow_configuration_file_exit_failure = "nifi.flow.configuration.file.exit.onfailure";
 const char *Configure::nifi_flow_configuration_file_backup_update = "nifi.flow.configuration.backup.on.update";
 const char *Configure::nifi_flow_engine_threads = "nifi.flow.engine.threads";
+const char *Configure::nifi_flow_engine_threads_affinity = "nifi.flow.engine.threads.affinity";
+const char *Configure::nifi_flow_engine_threads_cores = "nifi.flow.engine.threads.cores";
 const char *Configure::nifi_flow_engine_alert_period = "nifi.flow.engine.alert.period";
 const char *Configure::nifi_flow_engine_event_driven_time_slice = "nifi.flow.engine.event.driven.time.slice";
 const char *Configure::nifi_administrative_yield_duration = "nifi.administrative.yield.duration";
@@ -44,6 +46,10 @@ const char *Configure::nifi_server_port = "nifi.server.port";
 const char *Configure::nifi_server_report_interval = "nifi.server.report.interval";
 const char *Configure::nifi_provenance_repository_max_storage_size = "nifi.provenance.repository.max.storage.size";
 const char *Configure::nifi_provenance_repository_max_storage_time = "nifi.provenance.repository.max.storage.time";
+const char *Configure::nifi_provenance_repository_secondary_indexes = "nifi.provenance.repository.secondary.indexes";
+const char *Configure::nifi_provenance_excluded_event_types = "nifi.provenance.excluded.event.types";
+const char *Configure::nifi_provenance_sampling_percentage = "nifi.provenance.sampling.percentage";
+const char *Configure::nifi_provenance_rate_limit = "nifi.provenance.rate.limit";
 const char *Configure::nifi_provenance_repository_directory_default = "nifi.provenance.repository.directory.default";
 const char *Configure::nifi_flowfile_repository_max_storage_size = "nifi.flowfile.repository.max.storage.size";
 const char *Configure::nifi_flowfile_repository_max_storage_time = "nifi.flowfile.repository.max.storage.time";
@@ -63,6 +69,7 @@ const char *Configure::nifi_c2_flow_id = "nifi.c2.flow.id";
 const char *Configure::nifi_c2_flow_url = "nifi.c2.flow.url";
 const char *Configure::nifi_c2_flow_base_url = "nifi.c2.flow.base.url";
 const char *Configure::nifi_c2_full_heartbeat = "nifi.c2.full.heartbeat";
+const char *Configure::nifi_metrics_publisher_class = "nifi.metrics.publisher.class";
 const char *Configure::nifi_state_management_provider_local = "nifi.state.management.provider.local";
 const char *Configure::nifi_state_management_provider_local_always_persist = "nifi.state.management.provider.local.always.persist";
 const char *Configure::nifi_state_management_provider_local_auto_persistence_interval = "nifi.state.management.provider.local.auto.persistence.interval";
@@ -26,6 +26,8 @@
 #include <map>
 #include <set>
 #include <chrono>
+#include <cinttypes>
+#include <functional>
 #include <future>
 #include <thread>
 #include <utility>
@@ -38,6 +40,7 @@
 #include "core/state/nodes/FlowInformation.h"
 #include "core/state/nodes/ProcessMetrics.h"
 #include "core/state/nodes/QueueMetrics.h"
+#include "core/state/nodes/ProcessorPerformanceMetrics.h"
 #include "core/state/nodes/RepositoryMetrics.h"
 #include "core/state/nodes/SystemMetrics.h"
 #include "core/state/ProcessorController.h"
@@ -45,6 +48,7 @@
 #include "c2/C2Agent.h"
 #include "core/ProcessContext.h"
 #include "core/ProcessGroup.h"
+#include "core/FlowDiff.h"
 #include "utils/StringUtils.h"
 #include "core/Core.h"
 #include "core/ClassLoader.h"
@@ -70,6 +74,14 @@ namespace minifi {
 
 #define DEFAULT_CONFIG_NAME "conf/config.yml"
 
+namespace {
+
+int64_t millisSince(const std::chrono::steady_clock::time_point &start) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
 FlowController::FlowController(std::shared_ptr<core::Repository> provenance_repo, std::shared_ptr<core::Repository> flow_file_repo, std::shared_ptr<Configure> configure,
                                std::unique_ptr<core::FlowConfiguration> flow_configuration, std::shared_ptr<core::ContentRepository> content_repo, const std::string name, bool headless_mode)
     : core::controller::ControllerServiceProvider(core::getClassName<FlowController>()),
@@ -200,40 +212,103 @@ bool FlowController::applyConfiguration(const std::string &source, const std::st
   updating_ = true;
 
   std::lock_guard<std::recursive_mutex> flow_lock(mutex_);
-  stop(true);
-  waitUnload(30000);
-  controller_map_->clear();
-  auto prevRoot = std::move(this->root_);
-  this->root_ = std::move(newRoot);
-  initialized_ = false;
   bool started = false;
   try {
-    load(this->root_, true);
-    flow_update_ = true;
-    started = start() == 0;
-
-    updating_ = false;
-
-    if (started) {
-      auto flowVersion = flow_configuration_->getFlowVersion();
-      if (flowVersion) {
-        logger_->log_debug("Setting flow id to %s", flowVersion->getFlowId());
-        configuration_->set(Configure::nifi_c2_flow_id, flowVersion->getFlowId());
-        configuration_->set(Configure::nifi_c2_flow_url, flowVersion->getFlowIdentifier()->getRegistryUrl());
-      } else {
-        logger_->log_debug("Invalid flow version, not setting");
-      }
+    started = updateFlow(newRoot);
+  } catch (const std::exception &e) {
+    logger_->log_error("Could not update the flow in place: %s", e.what());
+    // unless the updated flow has already taken over, it is started from scratch
+    started = newRoot == nullptr;
+  }
+  if (!started) {
+    stop(true);
+    waitUnload(30000);
+    controller_map_->clear();
+    auto prevRoot = std::move(this->root_);
+    this->root_ = std::move(newRoot);
+    initialized_ = false;
+    try {
+      load(this->root_, true);
+      flow_update_ = true;
+      started = start() == 0;
+    } catch (...) {
+      this->root_ = std::move(prevRoot);
+      load(this->root_, true);
+      flow_update_ = true;
+    }
+  }
+  updating_ = false;
+
+  if (started) {
+    auto flowVersion = flow_configuration_->getFlowVersion();
+    if (flowVersion) {
+      logger_->log_debug("Setting flow id to %s", flowVersion->getFlowId());
+      configuration_->set(Configure::nifi_c2_flow_id, flowVersion->getFlowId());
+      configuration_->set(Configure::nifi_c2_flow_url, flowVersion->getFlowIdentifier()->getRegistryUrl());
+    } else {
+      logger_->log_debug("Invalid flow version, not setting");
     }
-  } catch (...) {
-    this->root_ = std::move(prevRoot);
-    load(this->root_, true);
-    flow_update_ = true;
-    updating_ = false;
   }
 
   return started;
 }
 
+bool FlowController::updateFlow(std::unique_ptr<core::ProcessGroup> &newRoot) {
+  if (!running_ || root_ == nullptr) {
+    return false;
+  }
+  core::FlowDiff diff(*root_, *newRoot, controller_service_provider_->getAllControllerServices(), flow_configuration_->getControllerServiceProvider()->getAllControllerServices());
+  if (!diff.isIncremental()) {
+    logger_->log_info("Restarting the flow as %s", diff.getReason());
+    return false;
+  }
+
+  for (const auto &processor : diff.getProcessorsToStop()) {
+    switch (processor->getSchedulingStrategy()) {
+      case core::TIMER_DRIVEN:
+        timer_scheduler_->unschedule(processor);
+        break;
+      case core::EVENT_DRIVEN:
+        event_scheduler_->unschedule(processor);
+        break;
+      case core::CRON_DRIVEN:
+        cron_scheduler_->unschedule(processor);
+        break;
+    }
+  }
+  for (const auto &processor : diff.getProcessorsToStop()) {
+    // the processors of the updated flow may share the identifier, so nothing of the previous ones may be left to run
+    if (!thread_pool_.waitForStoppedTasks(processor->getUUIDStr(), std::chrono::milliseconds(30000))) {
+      logger_->log_warn("Processor %s did not stop in time, restarting the flow", processor->getName());
+      return false;
+    }
+  }
+
+  auto processorsToStart = diff.apply();
+  auto prevRoot = std::move(this->root_);
+  this->root_ = std::move(newRoot);
+  std::static_pointer_cast<core::controller::StandardControllerServiceProvider>(controller_service_provider_)->setRootGroup(root_);
+  assignPipelineSegments();
+  for (const auto &group : processorsToStart) {
+    for (const auto &processor : group.second) {
+      processor->setScheduledState(core::RUNNING);
+    }
+    group.first->startProcessing(group.second, timer_scheduler_, event_scheduler_, cron_scheduler_);
+  }
+
+  if (flow_file_repo_ != nullptr) {
+    std::map<std::string, std::shared_ptr<core::Connectable>> connectionMap;
+    root_->getConnections(connectionMap);
+    flow_file_repo_->setConnectionMap(connectionMap);
+  }
+
+  flow_update_ = true;
+  initializeC2();
+  initializeMetricsPublisher();
+  logger_->log_info("Updated the flow without restarting it, %s", diff.getSummary());
+  return true;
+}
+
 int16_t FlowController::stop(bool force, uint64_t timeToWait) {
   std::lock_guard<std::recursive_mutex> flow_lock(mutex_);
   if (running_) {
@@ -313,7 +388,9 @@ void FlowController::load(const std::shared_ptr<core::ProcessGroup> &root, bool
       io::NetworkPrioritizerFactory::getInstance()->clearPrioritizer();
     }
 
+    auto phase_start = std::chrono::steady_clock::now();
     this->root_ = root == nullptr ? std::shared_ptr<core::ProcessGroup>(flow_configuration_->getRoot(configuration_filename_)) : root;
+    const int64_t flow_millis = millisSince(phase_start);
 
     logger_->log_info("Loaded root processor Group");
 
@@ -326,6 +403,7 @@ void FlowController::load(const std::shared_ptr<core::ProcessGroup> &root, bool
     if (!thread_pool_.isRunning() || reload) {
       thread_pool_.shutdown();
       thread_pool_.setMaxConcurrentTasks(configuration_->getInt(Configure::nifi_flow_engine_threads, 2));
+      thread_pool_.setAffinity(getThreadAffinity());
       thread_pool_.setControllerServiceProvider(base_shared_ptr);
       thread_pool_.start();
     }
@@ -348,8 +426,10 @@ void FlowController::load(const std::shared_ptr<core::ProcessGroup> &root, bool
 
     logger_->log_info("Loaded controller service provider");
     // Load Flow File from Repo
+    phase_start = std::chrono::steady_clock::now();
     loadFlowRepo();
     logger_->log_info("Loaded flow repository");
+    logger_->log_info("Startup timings: flow configuration %" PRId64 " ms, flow repository %" PRId64 " ms", flow_millis, millisSince(phase_start));
     initialized_ = true;
   }
 }
@@ -395,16 +475,23 @@ int16_t FlowController::start() {
   } else {
     if (!running_) {
       logger_->log_info("Starting Flow Controller");
+      const auto services_start = std::chrono::steady_clock::now();
       controller_service_provider_->enableAllControllerServices();
+      const int64_t services_millis = millisSince(services_start);
       this->timer_scheduler_->start();
       this->event_scheduler_->start();
       this->cron_scheduler_->start();
 
+      int64_t processors_millis = 0;
       if (this->root_ != nullptr) {
         start_time_ = std::chrono::steady_clock::now();
+        assignPipelineSegments();
         this->root_->startProcessing(timer_scheduler_, event_scheduler_, cron_scheduler_);
+        processors_millis = millisSince(start_time_);
       }
+      logger_->log_info("Startup timings: controller services %" PRId64 " ms, processors %" PRId64 " ms", services_millis, processors_millis);
       initializeC2();
+      initializeMetricsPublisher();
       running_ = true;
       this->protocol_->start();
       this->provenance_repo_->start();
@@ -416,6 +503,146 @@ int16_t FlowController::start() {
   }
 }
 
+std::vector<std::shared_ptr<state::response::ResponseNode>> FlowController::createFlowMetricsNodes() {
+  std::vector<std::shared_ptr<state::response::ResponseNode>> nodes;
+  if (root_ == nullptr) {
+    return nodes;
+  }
+
+  std::shared_ptr<state::response::QueueMetrics> queueMetrics = std::make_shared<state::response::QueueMetrics>();
+
+  std::map<std::string, std::shared_ptr<Connection>> connections;
+  root_->getConnections(connections);
+  for (auto con : connections) {
+    queueMetrics->addConnection(con.second);
+  }
+  nodes.push_back(queueMetrics);
+
+  std::shared_ptr<state::response::RepositoryMetrics> repoMetrics = std::make_shared<state::response::RepositoryMetrics>();
+
+  repoMetrics->addRepository(provenance_repo_);
+  repoMetrics->addRepository(flow_file_repo_);
+
+  nodes.push_back(repoMetrics);
+
+  std::shared_ptr<state::response::ProcessorPerformanceMetrics> processorMetrics = std::make_shared<state::response::ProcessorPerformanceMetrics>();
+
+  std::vector<std::shared_ptr<core::Processor>> processors;
+  root_->getAllProcessors(processors);
+  for (const auto &processor : processors) {
+    processorMetrics->addProcessor(processor);
+  }
+
+  nodes.push_back(processorMetrics);
+  return nodes;
+}
+
+utils::ThreadAffinity FlowController::getThreadAffinity() {
+  std::string policy_name;
+  std::string core_list;
+  configuration_->get(Configure::nifi_flow_engine_threads_affinity, policy_name);
+  configuration_->get(Configure::nifi_flow_engine_threads_cores, core_list);
+
+  utils::ThreadAffinity::Policy policy;
+  std::vector<int> cores;
+  if (!utils::ThreadAffinity::parsePolicy(policy_name, policy)) {
+    logger_->log_warn("Unknown thread affinity %s, threads are not pinned", policy_name);
+    return utils::ThreadAffinity();
+  }
+  if (!utils::ThreadAffinity::parseCoreList(core_list, cores)) {
+    logger_->log_warn("Invalid list of cores %s, threads are not pinned", core_list);
+    return utils::ThreadAffinity();
+  }
+  if (policy == utils::ThreadAffinity::EXPLICIT && cores.empty()) {
+    logger_->log_warn("%s requires %s, threads are not pinned", Configure::nifi_flow_engine_threads_affinity, Configure::nifi_flow_engine_threads_cores);
+    return utils::ThreadAffinity();
+  }
+  utils::ThreadAffinity affinity(policy, cores);
+  if (affinity.isEnabled()) {
+    logger_->log_info("Pinning flow threads %s", policy_name);
+  }
+  return affinity;
+}
+
+void FlowController::assignPipelineSegments() {
+  std::vector<std::shared_ptr<core::Processor>> processors;
+  std::map<std::string, std::shared_ptr<Connection>> connections;
+  root_->getAllProcessors(processors);
+  root_->getConnections(connections);
+
+  std::map<std::string, std::string> parents;
+  std::function<std::string(const std::string&)> find = [&parents, &find](const std::string &id) -> std::string {
+    auto parent = parents.find(id);
+    if (parent == parents.end() || parent->second == id) {
+      return id;
+    }
+    parent->second = find(parent->second);
+    return parent->second;
+  };
+  for (const auto &connection : connections) {
+    auto source = connection.second->getSource();
+    auto destination = connection.second->getDestination();
+    if (source != nullptr && destination != nullptr) {
+      // the smaller id becomes the root, so segments are named, and numbered in the order of, their smallest id
+      const auto source_root = find(source->getUUIDStr());
+      const auto destination_root = find(destination->getUUIDStr());
+      parents[(std::max)(source_root, destination_root)] = (std::min)(source_root, destination_root);
+    }
+  }
+
+  std::map<std::string, int> segments;
+  for (const auto &processor : processors) {
+    segments.emplace(find(processor->getUUIDStr()), 0);
+  }
+  int segment = 0;
+  for (auto &entry : segments) {
+    entry.second = segment++;
+  }
+  for (const auto &processor : processors) {
+    processor->setPipelineSegment(segments[find(processor->getUUIDStr())]);
+  }
+  logger_->log_debug("Flow consists of %d pipeline segments", segment);
+}
+
+void FlowController::initializeMetricsPublisher() {
+  std::string publisher_class;
+  if (!configuration_->get(Configure::nifi_metrics_publisher_class, publisher_class) || publisher_class.empty()) {
+    return;
+  }
+
+  // rebuilt on every start, as the flow may have been updated
+  auto nodes = createFlowMetricsNodes();
+  std::string class_csv;
+  if (configuration_->get("nifi.metrics.publisher.metrics", class_csv)) {
+    for (const auto &clazz : utils::StringUtils::split(class_csv, ",")) {
+      auto ptr = core::ClassLoader::getDefaultClassLoader().instantiate(clazz, clazz);
+      auto node = std::dynamic_pointer_cast<state::response::ResponseNode>(ptr);
+      if (nullptr == node) {
+        logger_->log_error("No metric defined for %s", clazz);
+        continue;
+      }
+      nodes.push_back(node);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(metrics_mutex_);
+    published_metrics_ = std::move(nodes);
+  }
+
+  if (metrics_publisher_ != nullptr) {
+    return;
+  }
+  auto ptr = core::ClassLoader::getDefaultClassLoader().instantiate(publisher_class, publisher_class);
+  metrics_publisher_ = std::dynamic_pointer_cast<state::MetricsPublisher>(ptr);
+  if (nullptr == metrics_publisher_) {
+    logger_->log_error("Could not instantiate metrics publisher %s", publisher_class);
+    return;
+  }
+  logger_->log_info("Publishing metrics through %s", publisher_class);
+  metrics_publisher_->initialize(configuration_, std::dynamic_pointer_cast<state::response::NodeReporter>(shared_from_this()));
+}
+
 void FlowController::initializeC2() {
   if (!c2_enabled_) {
     return;
@@ -471,22 +698,8 @@ void FlowController::initializeC2() {
   component_metrics_by_id_.clear();
 
   std::string class_csv;
-  if (root_ != nullptr) {
-    std::shared_ptr<state::response::QueueMetrics> queueMetrics = std::make_shared<state::response::QueueMetrics>();
-
-    std::map<std::string, std::shared_ptr<Connection>> connections;
-    root_->getConnections(connections);
-    for (auto con : connections) {
-      queueMetrics->addConnection(con.second);
-    }
-    device_information_[queueMetrics->getName()] = queueMetrics;
-
-    std::shared_ptr<state::response::RepositoryMetrics> repoMetrics = std::make_shared<state::response::RepositoryMetrics>();
-
-    repoMetrics->addRepository(provenance_repo_);
-    repoMetrics->addRepository(flow_file_repo_);
-
-    device_information_[repoMetrics->getName()] = repoMetrics;
+  for (const auto &metrics : createFlowMetricsNodes()) {
+    device_information_[metrics->getName()] = metrics;
   }
 
   if (configuration_->get("nifi.c2.root.classes", class_csv)) {
@@ -948,6 +1161,11 @@ std::shared_ptr<state::response::ResponseNode> FlowController::getMetricsNode(co
   return nullptr;
 }
 
+std::vector<std::shared_ptr<state::response::ResponseNode>> FlowController::getPublishedMetricsNodes() const {
+  std::lock_guard<std::mutex> lock(metrics_mutex_);
+  return published_metrics_;
+}
+
 std::vector<std::shared_ptr<state::response::ResponseNode>> FlowController::getHeartbeatNodes(bool includeManifest) const {
   std::string fullHb{"true"};
   configuration_->get("nifi.c2.full.heartbeat", fullHb);
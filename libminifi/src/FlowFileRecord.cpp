@@ -249,7 +249,7 @@ bool FlowFileRecord::Serialize(io::DataStream &outStream) {
     return false;
   }
 
-  for (auto& itAttribute : attributes_) {
+  for (const auto& itAttribute : attributes_) {
     ret = writeUTF(itAttribute.first, &outStream, true);
     if (ret <= 0) {
       return false;
@@ -348,7 +348,7 @@ bool FlowFileRecord::DeSerialize(const uint8_t *buffer, const int bufferSize) {
     if (ret <= 0) {
       return false;
     }
-    this->attributes_[key] = value;
+    this->attributes_.set(key, std::move(value));
   }
 
   ret = readUTF(this->content_full_fath_, &outStream);
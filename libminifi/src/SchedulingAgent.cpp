@@ -18,10 +18,16 @@
  * limitations under the License.
  */
 #include "SchedulingAgent.h"
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <map>
+#include <set>
 #include <thread>
 #include <utility>
 #include <memory>
+#include <string>
+#include <vector>
 #include "core/Processor.h"
 #include "utils/GeneralUtils.h"
 #include "utils/gsl.h"
@@ -31,6 +37,27 @@ namespace apache {
 namespace nifi {
 namespace minifi {
 
+namespace {
+
+// names or ids of the controller services a controller service refers to
+std::vector<std::string> getReferencedServices(const std::shared_ptr<core::controller::ControllerServiceNode> &serviceNode) {
+  std::vector<std::string> references;
+  core::Property linked_services("Linked Services", "Referenced Controller Services");
+  if (serviceNode->getProperty(linked_services.getName(), linked_services)) {
+    references = linked_services.getValues();
+  }
+  const auto &implementation = serviceNode->getControllerServiceImplementation();
+  if (implementation != nullptr) {
+    for (auto property : implementation->getProperties()) {
+      const auto values = property.second.getValues();
+      references.insert(references.end(), values.begin(), values.end());
+    }
+  }
+  return references;
+}
+
+}  // namespace
+
 bool SchedulingAgent::hasWorkToDo(std::shared_ptr<core::Processor> processor) {
   // Whether it has work to do
   if (processor->getTriggerWhenEmpty() || !processor->hasIncomingConnections() || processor->flowFilesQueued())
@@ -80,12 +107,103 @@ std::future<utils::TaskRescheduleInfo> SchedulingAgent::disableControllerService
   return future;
 }
 
+void SchedulingAgent::enableControllerServices(const std::vector<std::shared_ptr<core::controller::ControllerServiceNode>> &serviceNodes) {
+  using ServiceNode = core::controller::ControllerServiceNode;
+  std::map<std::string, std::shared_ptr<ServiceNode>> services_by_reference;
+  for (const auto &service : serviceNodes) {
+    services_by_reference[service->getName()] = service;
+    services_by_reference[service->getUUIDStr()] = service;
+  }
+
+  // number of services each service waits for, and the services waiting for each service
+  std::map<ServiceNode*, size_t> dependency_count;
+  std::map<ServiceNode*, std::vector<std::shared_ptr<ServiceNode>>> dependents;
+  std::vector<std::shared_ptr<ServiceNode>> ready;
+  for (const auto &service : serviceNodes) {
+    std::set<ServiceNode*> dependencies;
+    for (const auto &reference : getReferencedServices(service)) {
+      auto it = services_by_reference.find(reference);
+      if (it != services_by_reference.end() && it->second != service && dependencies.insert(it->second.get()).second) {
+        dependents[it->second.get()].push_back(service);
+      }
+    }
+    dependency_count[service.get()] = dependencies.size();
+    if (dependencies.empty()) {
+      ready.push_back(service);
+    }
+  }
+
+  std::mutex mutex;
+  std::condition_variable service_enabled;
+  std::vector<ServiceNode*> enabled;
+  std::map<ServiceNode*, std::future<utils::TaskRescheduleInfo>> running;
+  size_t enabled_count = 0;
+
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    for (const auto &service : ready) {
+      logger_->log_info("Enabling CSN in SchedulingAgent %s", service->getName());
+      std::function<utils::TaskRescheduleInfo()> f_ex = [this, service, &mutex, &service_enabled, &enabled] {
+        try {
+          service->enable();
+        } catch (const std::exception &exception) {
+          logger_->log_error("Failed to enable %s: %s", service->getName(), exception.what());
+        } catch (...) {
+          logger_->log_error("Failed to enable %s", service->getName());
+        }
+        std::lock_guard<std::mutex> enabled_lock(mutex);
+        enabled.push_back(service.get());
+        service_enabled.notify_one();
+        return utils::TaskRescheduleInfo::Done();
+      };
+      auto monitor = utils::make_unique<utils::ComplexMonitor>();
+      utils::Worker<utils::TaskRescheduleInfo> functor(f_ex, service->getUUIDStr(), std::move(monitor));
+      thread_pool_.execute(std::move(functor), running[service.get()]);
+    }
+    ready.clear();
+    if (running.empty()) {
+      break;
+    }
+
+    service_enabled.wait_for(lock, std::chrono::milliseconds(100), [&enabled] { return !enabled.empty(); });
+    // a task which never ran, e.g. as the thread pool was shut down, leaves its future without a value
+    for (auto it = running.begin(); it != running.end(); ++it) {
+      if (std::find(enabled.begin(), enabled.end(), it->first) == enabled.end() && it->second.valid()
+          && it->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        logger_->log_warn("Could not enable %s", it->first->getName());
+        enabled.push_back(it->first);
+      }
+    }
+    for (auto *service : enabled) {
+      running.erase(service);
+      ++enabled_count;
+      for (const auto &dependent : dependents[service]) {
+        if (--dependency_count[dependent.get()] == 0) {
+          ready.push_back(dependent);
+        }
+      }
+    }
+    enabled.clear();
+  }
+
+  if (enabled_count < serviceNodes.size()) {
+    // services referring to each other are enabled one after the other, in no particular order
+    lock.unlock();
+    for (auto service : serviceNodes) {
+      if (dependency_count[service.get()] > 0) {
+        logger_->log_warn("Enabling %s, which is part of or depends on a reference cycle", service->getName());
+        enableControllerService(service);
+      }
+    }
+  }
+}
+
 bool SchedulingAgent::hasTooMuchOutGoing(std::shared_ptr<core::Processor> processor) {
   return processor->flowFilesOutGoingFull();
 }
 
 bool SchedulingAgent::onTrigger(const std::shared_ptr<core::Processor> &processor, const std::shared_ptr<core::ProcessContext> &processContext,
-                                const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory) {
+                                const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory, std::chrono::nanoseconds run_duration) {
   if (processor->isYield()) {
     logger_->log_debug("Not running %s since it must yield", processor->getName());
     return false;
@@ -98,8 +216,22 @@ bool SchedulingAgent::onTrigger(const std::shared_ptr<core::Processor> &processo
     // No work to do, yield
     return true;
   }
+  // take the slot before checking the limit, so that triggers racing each other cannot all get below it
+  processor->incrementActiveTasks();
+  const auto active_task = gsl::finally([&processor]() {
+    processor->decrementActiveTask();
+  });
+  if (processor->getMaxConcurrentTasks() > 1) {
+    const auto thread_manager = thread_pool_.getThreadManager();
+    if (thread_manager != nullptr && processor->getActiveTasks() > thread_manager->getConcurrentTasks(*processor)) {
+      // the processor runs as many tasks as it currently benefits from
+      return true;
+    }
+  }
+  const auto &metrics = processor->getMetrics();
   if (processor->isThrottledByBackpressure()) {
     logger_->log_debug("backpressure applied because too much outgoing for %s", processor->getUUIDStr());
+    metrics->backpressureApplied(core::ProcessorMetrics::now());
     // need to apply backpressure
     return true;
   }
@@ -116,23 +248,57 @@ bool SchedulingAgent::onTrigger(const std::shared_ptr<core::Processor> &processo
     scheduled_processors_.erase(schedule_it);
   });
 
-  processor->incrementActiveTasks();
+  metrics->backpressureReleased(core::ProcessorMetrics::now());
+
+  const auto deadline = std::chrono::steady_clock::now() + run_duration;
+  // triggers within the run duration share a session if the processor allows it
+  std::shared_ptr<core::ProcessSession> batch;
+  if (run_duration.count() > 0 && processor->supportsBatching()) {
+    batch = sessionFactory->createSession();
+  }
+
   try {
-    processor->onTrigger(processContext, sessionFactory);
-    processor->decrementActiveTask();
+    do {
+      const uint64_t start = core::ProcessorMetrics::now();
+      const auto record_time = gsl::finally([&metrics, start]() {
+        metrics->recordOnTrigger(core::ProcessorMetrics::now() - start);
+      });
+      if (batch) {
+        processor->onTrigger(processContext, batch);
+      } else {
+        processor->onTrigger(processContext, sessionFactory);
+      }
+    } while (run_duration.count() > 0 && triggerAgain(processor, deadline));
+    if (batch) {
+      batch->commit();
+    }
   } catch (std::exception &exception) {
     logger_->log_debug("Caught Exception %s", exception.what());
+    if (batch) {
+      logger_->log_warn("Caught Exception %s during batched onTrigger of processor: %s (%s)", exception.what(), processor->getUUIDStr(), processor->getName());
+      batch->rollback();
+    }
     processor->yield(admin_yield_duration_);
-    processor->decrementActiveTask();
   } catch (...) {
     logger_->log_debug("Caught Exception during SchedulingAgent::onTrigger");
+    if (batch) {
+      logger_->log_warn("Caught Exception during batched onTrigger of processor: %s (%s)", processor->getUUIDStr(), processor->getName());
+      batch->rollback();
+    }
     processor->yield(admin_yield_duration_);
-    processor->decrementActiveTask();
   }
 
   return false;
 }
 
+bool SchedulingAgent::triggerAgain(const std::shared_ptr<core::Processor> &processor, std::chrono::steady_clock::time_point deadline) {
+  if (!running_ || !processor->isRunning() || std::chrono::steady_clock::now() >= deadline) {
+    return false;
+  }
+  // stop as soon as the processor asks to yield or runs out of work, like a new dispatch would
+  return !processor->isYield() && hasWorkToDo(processor) && !processor->isThrottledByBackpressure();
+}
+
 void SchedulingAgent::watchDogFunc() {
   std::lock_guard<std::mutex> lock(watchdog_mtx_);
   auto now = std::chrono::steady_clock::now();
@@ -43,7 +43,7 @@ namespace nifi {
 namespace minifi {
 
 void ThreadedSchedulingAgent::schedule(std::shared_ptr<core::Processor> processor) {
-  std::lock_guard<std::mutex> lock(mutex_);
+  std::unique_lock<std::mutex> lock(mutex_);
 
   admin_yield_duration_ = 100;  // We should prevent burning CPU in case of rollbacks
   std::string yieldValue;
@@ -73,6 +73,9 @@ void ThreadedSchedulingAgent::schedule(std::shared_ptr<core::Processor> processo
     return;
   }
 
+  // onSchedule may take a while, e.g. when connecting to a remote system, and processors are scheduled concurrently
+  lock.unlock();
+
   std::shared_ptr<core::ProcessorNode> processor_node = std::make_shared<core::ProcessorNode>(processor);
 
   auto contextBuilder = core::ClassLoader::getDefaultClassLoader().instantiate<core::ProcessContextBuilder>("ProcessContextBuilder");
@@ -84,8 +87,16 @@ void ThreadedSchedulingAgent::schedule(std::shared_ptr<core::Processor> processo
 
   auto sessionFactory = std::make_shared<core::ProcessSessionFactory>(processContext);
 
+  processContext->onSchedule();
   processor->onSchedule(processContext, sessionFactory);
 
+  lock.lock();
+
+  if (processor->getScheduledState() != core::RUNNING || thread_pool_.isTaskRunning(processor->getUUIDStr())) {
+    logger_->log_warn("Processor %s was stopped or scheduled again while it was being scheduled", processor->getName());
+    return;
+  }
+
   std::vector<std::thread *> threads;
 
   ThreadedSchedulingAgent *agent = this;
@@ -100,6 +111,8 @@ void ThreadedSchedulingAgent::schedule(std::shared_ptr<core::Processor> processo
     // create a functor that will be submitted to the thread pool.
     auto monitor = utils::make_unique<utils::ComplexMonitor>();
     utils::Worker<utils::TaskRescheduleInfo> functor(f_ex, processor->getUUIDStr(), std::move(monitor));
+    // processors of a pipeline segment share the flow files passed between them, so they share a NUMA node as well
+    functor.setPlacement(processor->getPipelineSegment());
     // move the functor into the thread pool. While a future is returned
     // we aren't terribly concerned with the result.
     std::future<utils::TaskRescheduleInfo> future;
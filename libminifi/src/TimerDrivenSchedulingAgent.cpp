@@ -32,7 +32,7 @@ namespace minifi {
 utils::TaskRescheduleInfo TimerDrivenSchedulingAgent::run(const std::shared_ptr<core::Processor> &processor, const std::shared_ptr<core::ProcessContext> &processContext,
                                          const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory) {
   if (this->running_ && processor->isRunning()) {
-    bool shouldYield = this->onTrigger(processor, processContext, sessionFactory);
+    bool shouldYield = this->onTrigger(processor, processContext, sessionFactory, std::chrono::nanoseconds(processor->getRunDurationNano()));
     if (processor->isYield()) {
       // Honor the yield
       return utils::TaskRescheduleInfo::RetryIn(std::chrono::milliseconds(processor->getYieldTime()));
@@ -0,0 +1,141 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "c2/protocols/HeartbeatDeltaEncoder.h"
+
+#include <string>
+#include <utility>
+
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace c2 {
+
+namespace {
+
+std::string write(const rapidjson::Value &json) {
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  json.Accept(writer);
+  return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+void setMember(rapidjson::Value &object, const rapidjson::Value &name, rapidjson::Value &&value, rapidjson::Document::AllocatorType &alloc) {
+  auto member = object.FindMember(name);
+  if (member != object.MemberEnd()) {
+    member->value = value;
+  } else {
+    object.AddMember(rapidjson::Value(name, alloc), value, alloc);
+  }
+}
+
+}  // namespace
+
+constexpr const char *HeartbeatDeltaEncoder::ENCODING;
+constexpr const char *HeartbeatDeltaEncoder::FULL;
+constexpr const char *HeartbeatDeltaEncoder::DELTA;
+
+HeartbeatDeltaEncoder::HeartbeatDeltaEncoder(uint32_t full_heartbeat_interval)
+    : full_heartbeat_interval_(full_heartbeat_interval),
+      deltas_since_full_(0),
+      has_base_(false),
+      pending_full_(false) {
+}
+
+bool HeartbeatDeltaEncoder::diff(const rapidjson::Value &previous, const rapidjson::Value &current, rapidjson::Value &delta, rapidjson::Document::AllocatorType &alloc) {
+  bool changed = false;
+  for (auto member = current.MemberBegin(); member != current.MemberEnd(); ++member) {
+    auto old_member = previous.FindMember(member->name);
+    if (old_member == previous.MemberEnd()) {
+      delta.AddMember(rapidjson::Value(member->name, alloc), rapidjson::Value(member->value, alloc), alloc);
+      changed = true;
+    } else if (member->value.IsObject() && old_member->value.IsObject()) {
+      rapidjson::Value nested(rapidjson::kObjectType);
+      if (diff(old_member->value, member->value, nested, alloc)) {
+        delta.AddMember(rapidjson::Value(member->name, alloc), nested, alloc);
+        changed = true;
+      }
+    } else if (member->value != old_member->value) {
+      delta.AddMember(rapidjson::Value(member->name, alloc), rapidjson::Value(member->value, alloc), alloc);
+      changed = true;
+    }
+  }
+  for (auto member = previous.MemberBegin(); member != previous.MemberEnd(); ++member) {
+    if (!current.HasMember(member->name)) {
+      delta.AddMember(rapidjson::Value(member->name, alloc), rapidjson::Value(rapidjson::kNullType), alloc);
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+std::string HeartbeatDeltaEncoder::encode(rapidjson::Document &&heartbeat) {
+  const bool full = !has_base_ || !heartbeat.IsObject() || !base_.IsObject() || deltas_since_full_ + 1 >= full_heartbeat_interval_;
+  std::string encoded;
+  if (full) {
+    heartbeat.AddMember(rapidjson::StringRef(ENCODING), rapidjson::StringRef(FULL), heartbeat.GetAllocator());
+    encoded = write(heartbeat);
+    heartbeat.RemoveMember(ENCODING);
+  } else {
+    rapidjson::Document delta(rapidjson::kObjectType);
+    auto &alloc = delta.GetAllocator();
+    diff(base_, heartbeat, delta, alloc);
+    // whatever changed, the server needs to know what and whose heartbeat this is
+    for (auto member = heartbeat.MemberBegin(); member != heartbeat.MemberEnd(); ++member) {
+      if (member->name == "operation") {
+        setMember(delta, member->name, rapidjson::Value(member->value, alloc), alloc);
+      } else if (member->value.IsObject() && member->value.HasMember("identifier")) {
+        auto nested = delta.FindMember(member->name);
+        if (nested == delta.MemberEnd()) {
+          delta.AddMember(rapidjson::Value(member->name, alloc), rapidjson::Value(rapidjson::kObjectType), alloc);
+          nested = delta.FindMember(member->name);
+        }
+        setMember(nested->value, rapidjson::Value(rapidjson::StringRef("identifier")), rapidjson::Value(member->value["identifier"], alloc), alloc);
+      }
+    }
+    delta.AddMember(rapidjson::StringRef(ENCODING), rapidjson::StringRef(DELTA), alloc);
+    encoded = write(delta);
+  }
+  pending_ = std::move(heartbeat);
+  pending_full_ = full;
+  return encoded;
+}
+
+void HeartbeatDeltaEncoder::acknowledge() {
+  if (pending_.IsNull()) {
+    return;
+  }
+  deltas_since_full_ = pending_full_ ? 0 : deltas_since_full_ + 1;
+  base_ = std::move(pending_);
+  pending_.SetNull();
+  has_base_ = true;
+}
+
+void HeartbeatDeltaEncoder::reject() {
+  has_base_ = false;
+  pending_.SetNull();
+}
+
+}  // namespace c2
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
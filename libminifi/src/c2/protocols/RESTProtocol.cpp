@@ -251,7 +251,24 @@ void RESTProtocol::mergePayloadContent(rapidjson::Value &target, const C2Payload
 }
 
 std::string RESTProtocol::serializeJsonRootPayload(const C2Payload& payload) {
-  rapidjson::Document json_payload(payload.isContainer() ? rapidjson::kArrayType : rapidjson::kObjectType);
+  rapidjson::Document json_payload;
+  buildJsonRootPayload(payload, json_payload);
+  return serializeJsonDocument(json_payload);
+}
+
+std::string RESTProtocol::serializeJsonDocument(const rapidjson::Value &json) {
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  json.Accept(writer);
+  return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+void RESTProtocol::buildJsonRootPayload(const C2Payload& payload, rapidjson::Document &json_payload) {
+  if (payload.isContainer()) {
+    json_payload.SetArray();
+  } else {
+    json_payload.SetObject();
+  }
   rapidjson::Document::AllocatorType &alloc = json_payload.GetAllocator();
 
   rapidjson::Value opReqStrVal;
@@ -301,11 +318,6 @@ std::string RESTProtocol::serializeJsonRootPayload(const C2Payload& payload) {
       json_payload.AddMember(np_key, np_value, alloc);
     }
   }
-
-  rapidjson::StringBuffer buffer;
-  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
-  json_payload.Accept(writer);
-  return buffer.GetString();
 }
 
 bool RESTProtocol::containsPayload(const C2Payload &o) {
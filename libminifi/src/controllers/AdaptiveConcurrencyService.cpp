@@ -0,0 +1,190 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "controllers/AdaptiveConcurrencyService.h"
+
+#ifndef WIN32
+#include <sys/resource.h>
+#endif
+
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "core/Processor.h"
+#include "core/ProcessorMetrics.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace controllers {
+
+core::Property AdaptiveConcurrencyService::CPUBudget(
+    core::PropertyBuilder::createProperty("CPU Budget")->withDescription("Percentage of the cores the agent may keep busy. Concurrency is reduced when the agent uses more")
+        ->isRequired(true)->withDefaultValue<int>(100)->build());
+
+core::Property AdaptiveConcurrencyService::MinThreads(
+    core::PropertyBuilder::createProperty("Min Threads")->withDescription("Fewest threads a thread pool is reduced to")->isRequired(true)->withDefaultValue<int>(1)->build());
+
+core::Property AdaptiveConcurrencyService::MaxThreads(
+    core::PropertyBuilder::createProperty("Max Threads")->withDescription("Most threads a thread pool is grown to, 0 for twice the number of cores")->isRequired(true)
+        ->withDefaultValue<int>(0)->build());
+
+core::Property AdaptiveConcurrencyService::AdjustmentPeriod(
+    core::PropertyBuilder::createProperty("Adjustment Period")->withDescription("Time between adjustments of the thread pools and the concurrent tasks of processors")
+        ->isRequired(true)->withDefaultValue<core::TimePeriodValue>("250 ms")->build());
+
+bool AdaptiveConcurrencyService::isAboveMax(const int new_tasks) {
+  return false;
+}
+
+uint16_t AdaptiveConcurrencyService::getMaxThreads() {
+  if (!enabled_) {
+    return (std::numeric_limits<uint16_t>::max)();
+  }
+  return max_threads_;
+}
+
+bool AdaptiveConcurrencyService::shouldReduce() {
+  return false;
+}
+
+void AdaptiveConcurrencyService::reduce() {
+}
+
+bool AdaptiveConcurrencyService::canIncrease() {
+  return false;
+}
+
+uint16_t AdaptiveConcurrencyService::getTargetThreads(const std::string &pool_name, utils::ConcurrencySample sample, uint16_t current_threads) {
+  if (!enabled_) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  sample.cpu_cores = measureCpu(core::ProcessorMetrics::now());
+  auto limit = pool_limits_.find(pool_name);
+  if (limit == pool_limits_.end()) {
+    limit = pool_limits_.emplace(pool_name, utils::AdaptiveLimit(min_threads_, max_threads_, cpu_budget_, current_threads)).first;
+  }
+  const uint16_t target = limit->second.update(sample);
+  if (target != current_threads) {
+    logger_->log_debug("Resizing %s from %d to %d threads, %llu tasks queued, %f cores busy", pool_name, current_threads, target, sample.queued, sample.cpu_cores);
+  }
+  return target;
+}
+
+uint16_t AdaptiveConcurrencyService::getConcurrentTasks(core::Processor &processor) {
+  const uint16_t max_tasks = processor.getMaxConcurrentTasks();
+  if (!enabled_ || max_tasks <= 1) {
+    return max_tasks;
+  }
+  const auto &metrics = processor.getMetrics();
+  const uint64_t now = core::ProcessorMetrics::now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto limit = processor_limits_.find(processor.getUUIDStr());
+  if (limit == processor_limits_.end()) {
+    // start from the configured concurrency, there is nothing to go by yet
+    ProcessorLimit initial{utils::AdaptiveLimit(1, max_tasks, cpu_budget_, max_tasks), now, metrics->invocations.load(), metrics->on_trigger_nanos.getTotal()};
+    processor_limits_.emplace(processor.getUUIDStr(), initial);
+    return max_tasks;
+  }
+  ProcessorLimit &state = limit->second;
+  const uint64_t period = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::milliseconds(adjustment_period_.load())).count();
+  if (now - state.last_update >= period) {
+    utils::ConcurrencySample sample;
+    const uint64_t invocations = metrics->invocations.load();
+    const uint64_t on_trigger_nanos = metrics->on_trigger_nanos.getTotal();
+    sample.tasks = invocations - state.invocations;
+    sample.task_nanos = on_trigger_nanos - state.on_trigger_nanos;
+    sample.period_nanos = now - state.last_update;
+    sample.queued = processor.getQueuedFlowFiles();
+    sample.cpu_cores = measureCpu(now);
+    state.limit.update(sample);
+    state.last_update = now;
+    state.invocations = invocations;
+    state.on_trigger_nanos = on_trigger_nanos;
+  }
+  return state.limit.getLimit();
+}
+
+std::chrono::milliseconds AdaptiveConcurrencyService::getAdjustmentPeriod() {
+  return std::chrono::milliseconds(adjustment_period_.load());
+}
+
+double AdaptiveConcurrencyService::measureCpu(uint64_t now) {
+#ifndef WIN32
+  const uint64_t period = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::milliseconds(adjustment_period_.load())).count();
+  if (now - last_cpu_time_ < period) {
+    return cpu_cores_;
+  }
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return -1;
+  }
+  const uint64_t cpu_nanos = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000000ULL + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000ULL;
+  if (last_cpu_time_ > 0) {
+    cpu_cores_ = double(cpu_nanos - last_cpu_nanos_) / (now - last_cpu_time_);
+  }
+  last_cpu_time_ = now;
+  last_cpu_nanos_ = cpu_nanos;
+  return cpu_cores_;
+#else
+  return -1;
+#endif
+}
+
+void AdaptiveConcurrencyService::initialize() {
+  ThreadManagementService::initialize();
+  std::set<core::Property> supportedProperties;
+  supportedProperties.insert(CPUBudget);
+  supportedProperties.insert(MinThreads);
+  supportedProperties.insert(MaxThreads);
+  supportedProperties.insert(AdjustmentPeriod);
+  setSupportedProperties(supportedProperties);
+}
+
+void AdaptiveConcurrencyService::onEnable() {
+  const unsigned cores = (std::max)(std::thread::hardware_concurrency(), 1U);
+  int budget = 100;
+  int min_threads = 1;
+  int max_threads = 0;
+  uint64_t period = 250;
+  getProperty(CPUBudget.getName(), budget);
+  getProperty(MinThreads.getName(), min_threads);
+  getProperty(MaxThreads.getName(), max_threads);
+  getProperty(AdjustmentPeriod.getName(), period);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  cpu_budget_ = budget > 0 ? cores * budget / 100.0 : 0;
+  min_threads_ = static_cast<uint16_t>((std::min)((std::max)(min_threads, 1), 0xFFFF));
+  max_threads_ = static_cast<uint16_t>((std::min)(max_threads > 0 ? max_threads : static_cast<int>(2 * cores), 0xFFFF));
+  max_threads_ = (std::max)(max_threads_, min_threads_);
+  adjustment_period_ = (std::max)(period, uint64_t(10));
+  pool_limits_.clear();
+  processor_limits_.clear();
+  enabled_ = true;
+  logger_->log_debug("Sizing thread pools from %d to %d threads within %f cores", min_threads_, max_threads_, cpu_budget_);
+}
+
+}  // namespace controllers
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
@@ -0,0 +1,343 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "core/FlowDiff.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "core/logging/LoggerConfiguration.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+
+namespace {
+
+bool isSameProperties(const ConfigurableComponent &current, const ConfigurableComponent &updated) {
+  auto current_properties = current.getProperties();
+  auto updated_properties = updated.getProperties();
+  if (current_properties.size() != updated_properties.size()) {
+    return false;
+  }
+  for (auto &property : current_properties) {
+    auto updated_property = updated_properties.find(property.first);
+    if (updated_property == updated_properties.end() || property.second.getValues() != updated_property->second.getValues()) {
+      return false;
+    }
+  }
+
+  auto current_keys = current.getDynamicPropertyKeys();
+  auto updated_keys = updated.getDynamicPropertyKeys();
+  std::sort(current_keys.begin(), current_keys.end());
+  std::sort(updated_keys.begin(), updated_keys.end());
+  if (current_keys != updated_keys) {
+    return false;
+  }
+  for (const auto &key : current_keys) {
+    std::string current_value, updated_value;
+    current.getDynamicProperty(key, current_value);
+    updated.getDynamicProperty(key, updated_value);
+    if (current_value != updated_value) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<std::string> getPrioritizerNames(const std::shared_ptr<Connection> &connection) {
+  std::vector<std::string> names;
+  for (const auto &prioritizer : connection->getPrioritizers()) {
+    names.push_back(prioritizer->getName());
+  }
+  return names;
+}
+
+void configure(const std::shared_ptr<Connection> &connection, const std::shared_ptr<Connection> &updated) {
+  utils::Identifier uuid;
+  connection->setName(updated->getName());
+  updated->getSourceUUID(uuid);
+  connection->setSourceUUID(uuid);
+  updated->getDestinationUUID(uuid);
+  connection->setDestinationUUID(uuid);
+  connection->setRelationships(updated->getRelationships());
+  connection->setMaxQueueSize(updated->getMaxQueueSize());
+  connection->setMaxQueueDataSize(updated->getMaxQueueDataSize());
+  connection->setFlowExpirationDuration(updated->getFlowExpirationDuration());
+  connection->setDropEmptyFlowFiles(updated->getDropEmptyFlowFiles());
+  connection->setPrioritizers(updated->getPrioritizers());
+}
+
+}  // namespace
+
+FlowDiff::FlowDiff(ProcessGroup &current, ProcessGroup &updated, const std::vector<std::shared_ptr<controller::ControllerServiceNode>> &current_services,
+                   const std::vector<std::shared_ptr<controller::ControllerServiceNode>> &updated_services)
+    : incremental_(true),
+      logger_(logging::LoggerFactory<FlowDiff>::getLogger()) {
+  collect(current, current_processors_, current_connections_, current_groups_);
+  collect(updated, updated_processors_, updated_connections_, updated_groups_);
+
+  diffServices(current_services, updated_services);
+  if (!incremental_) {
+    return;
+  }
+
+  // removed processors are replaced by nothing
+  for (const auto &processor : current_processors_) {
+    auto updated_processor = updated_processors_.find(processor.first);
+    if (updated_processor == updated_processors_.end() || !isSameConfiguration(processor.second.component, updated_processor->second.component)
+        || !isSameRemoteGroup(*processor.second.group, *updated_processor->second.group)) {
+      replaced_processors_.insert(processor.first);
+    }
+  }
+
+  // the processors at either end of a connection which is added, removed or attached to a replaced processor
+  std::set<std::string> touched_processors;
+  auto touch = [&touched_processors](const std::shared_ptr<Connection> &connection) {
+    utils::Identifier uuid;
+    connection->getSourceUUID(uuid);
+    touched_processors.insert(uuid.to_string());
+    connection->getDestinationUUID(uuid);
+    touched_processors.insert(uuid.to_string());
+  };
+  for (const auto &connection : current_connections_) {
+    auto updated_connection = updated_connections_.find(connection.first);
+    if (updated_connection == updated_connections_.end()) {
+      touch(connection.second.component);
+      continue;
+    }
+    utils::Identifier source, destination;
+    connection.second.component->getSourceUUID(source);
+    connection.second.component->getDestinationUUID(destination);
+    if (!isSameConfiguration(connection.second.component, updated_connection->second.component) || replaced_processors_.count(source.to_string()) > 0
+        || replaced_processors_.count(destination.to_string()) > 0) {
+      reattached_connections_.insert(connection.first);
+      touch(connection.second.component);
+      touch(updated_connection->second.component);
+    }
+  }
+  for (const auto &connection : updated_connections_) {
+    if (current_connections_.find(connection.first) == current_connections_.end()) {
+      touch(connection.second.component);
+    }
+  }
+
+  for (const auto &uuid : touched_processors) {
+    if (current_processors_.count(uuid) > 0 && replaced_processors_.count(uuid) == 0) {
+      disturbed_processors_.insert(uuid);
+    }
+  }
+  for (const auto &uuid : replaced_processors_) {
+    processors_to_stop_.push_back(current_processors_[uuid].component);
+  }
+  for (const auto &uuid : disturbed_processors_) {
+    processors_to_stop_.push_back(current_processors_[uuid].component);
+  }
+}
+
+void FlowDiff::collect(ProcessGroup &group, Processors &processors, Connections &connections, std::vector<ProcessGroup*> &groups) {
+  std::lock_guard<std::recursive_mutex> lock(group.mutex_);
+  groups.push_back(&group);
+  for (const auto &processor : group.processors_) {
+    processors[processor->getUUIDStr()] = Component<Processor> { processor, &group };
+  }
+  for (const auto &connection : group.connections_) {
+    connections[connection->getUUIDStr()] = Component<Connection> { connection, &group };
+  }
+  for (const auto &child : group.child_process_groups_) {
+    collect(*child, processors, connections, groups);
+  }
+}
+
+void FlowDiff::diffServices(const std::vector<std::shared_ptr<controller::ControllerServiceNode>> &current_services,
+                            const std::vector<std::shared_ptr<controller::ControllerServiceNode>> &updated_services) {
+  std::map<std::string, std::shared_ptr<controller::ControllerServiceNode>> current_by_id;
+  for (const auto &service : current_services) {
+    current_by_id[service->getUUIDStr()] = service;
+  }
+  std::map<std::string, std::shared_ptr<controller::ControllerServiceNode>> updated_by_id;
+  for (const auto &service : updated_services) {
+    updated_by_id[service->getUUIDStr()] = service;
+  }
+
+  if (current_by_id.size() != updated_by_id.size()) {
+    incremental_ = false;
+    reason_ = "controller services were added or removed";
+    return;
+  }
+  for (const auto &service : current_by_id) {
+    auto updated_service = updated_by_id.find(service.first);
+    if (updated_service == updated_by_id.end()) {
+      incremental_ = false;
+      reason_ = "controller service " + service.second->getName() + " was removed";
+      return;
+    }
+    const auto &current_node = service.second;
+    const auto &updated_node = updated_service->second;
+    if (current_node == updated_node) {
+      continue;
+    }
+    const auto &current_implementation = current_node->getControllerServiceImplementation();
+    const auto &updated_implementation = updated_node->getControllerServiceImplementation();
+    if (current_node->getName() != updated_node->getName() || typeid(*current_implementation) != typeid(*updated_implementation) || !isSameProperties(*current_node, *updated_node)
+        || !isSameProperties(*current_implementation, *updated_implementation)) {
+      incremental_ = false;
+      reason_ = "controller service " + current_node->getName() + " changed";
+      return;
+    }
+  }
+}
+
+bool FlowDiff::isSameRemoteGroup(const ProcessGroup &current, const ProcessGroup &updated) const {
+  // ports of remote process groups are configured from their group
+  if (current.type_ != REMOTE_PROCESS_GROUP && updated.type_ != REMOTE_PROCESS_GROUP) {
+    return true;
+  }
+  return current.type_ == updated.type_ && current.url_ == updated.url_ && current.timeOut_ == updated.timeOut_ && current.yield_period_msec_ == updated.yield_period_msec_
+      && current.transmitting_ == updated.transmitting_ && current.local_network_interface_ == updated.local_network_interface_
+      && current.transport_protocol_ == updated.transport_protocol_ && current.proxy_.host == updated.proxy_.host && current.proxy_.port == updated.proxy_.port
+      && current.proxy_.username == updated.proxy_.username && current.proxy_.password == updated.proxy_.password;
+}
+
+bool FlowDiff::isSameConfiguration(const std::shared_ptr<Processor> &current, const std::shared_ptr<Processor> &updated) {
+  if (typeid(*current) != typeid(*updated) || current->getName() != updated->getName() || current->getSchedulingStrategy() != updated->getSchedulingStrategy()
+      || current->getSchedulingPeriodNano() != updated->getSchedulingPeriodNano() || current->getCronPeriod() != updated->getCronPeriod()
+      || current->getRunDurationNano() != updated->getRunDurationNano() || current->getYieldPeriodMsec() != updated->getYieldPeriodMsec()
+      || current->getPenalizationPeriodMsec() != updated->getPenalizationPeriodMsec() || current->getMaxConcurrentTasks() != updated->getMaxConcurrentTasks()) {
+    return false;
+  }
+  for (const auto &relationship : current->getSupportedRelationships()) {
+    if (current->isAutoTerminated(relationship) != updated->isAutoTerminated(relationship)) {
+      return false;
+    }
+  }
+  return isSameProperties(*current, *updated);
+}
+
+bool FlowDiff::isSameConfiguration(const std::shared_ptr<Connection> &current, const std::shared_ptr<Connection> &updated) {
+  utils::Identifier current_source, updated_source, current_destination, updated_destination;
+  current->getSourceUUID(current_source);
+  updated->getSourceUUID(updated_source);
+  current->getDestinationUUID(current_destination);
+  updated->getDestinationUUID(updated_destination);
+  return current_source == updated_source && current_destination == updated_destination && current->getName() == updated->getName()
+      && current->getRelationships() == updated->getRelationships() && current->getMaxQueueSize() == updated->getMaxQueueSize()
+      && current->getMaxQueueDataSize() == updated->getMaxQueueDataSize() && current->getFlowExpirationDuration() == updated->getFlowExpirationDuration()
+      && current->getDropEmptyFlowFiles() == updated->getDropEmptyFlowFiles() && getPrioritizerNames(current) == getPrioritizerNames(updated);
+}
+
+std::map<ProcessGroup*, std::set<std::shared_ptr<Processor>>> FlowDiff::apply() {
+  // from now on the updated flow retries the processors which failed to start
+  std::set<std::string> failed_processors;
+  for (const auto &group : current_groups_) {
+    if (group->onScheduleTimer_) {
+      group->onScheduleTimer_->stop();
+    }
+    std::lock_guard<std::recursive_mutex> lock(group->mutex_);
+    for (const auto &processor : group->failed_processors_) {
+      failed_processors.insert(processor->getUUIDStr());
+    }
+  }
+
+  // connections of the updated flow are attached again once it holds the processors which are kept
+  for (const auto &connection : updated_connections_) {
+    connection.second.group->removeConnection(connection.second.component);
+  }
+
+  std::map<ProcessGroup*, std::set<std::shared_ptr<Processor>>> processors_to_start;
+  for (const auto &processor : updated_processors_) {
+    ProcessGroup *group = processor.second.group;
+    auto current_processor = current_processors_.find(processor.first);
+    if (current_processor == current_processors_.end() || replaced_processors_.count(processor.first) > 0) {
+      processors_to_start[group].insert(processor.second.component);
+      continue;
+    }
+    group->removeProcessor(processor.second.component);
+    group->addProcessor(current_processor->second.component);
+    if (disturbed_processors_.count(processor.first) > 0 || failed_processors.count(processor.first) > 0) {
+      processors_to_start[group].insert(current_processor->second.component);
+    }
+  }
+
+  for (const auto &connection : current_connections_) {
+    auto updated_connection = updated_connections_.find(connection.first);
+    if (updated_connection == updated_connections_.end()) {
+      connection.second.group->removeConnection(connection.second.component);
+      connection.second.component->drain(true);
+    } else if (reattached_connections_.count(connection.first) > 0) {
+      connection.second.group->removeConnection(connection.second.component);
+      configure(connection.second.component, updated_connection->second.component);
+      updated_connection->second.group->addConnection(connection.second.component);
+    } else {
+      // neither end changes, so the processors keep it as it is
+      {
+        std::lock_guard<std::recursive_mutex> lock(connection.second.group->mutex_);
+        connection.second.group->connections_.erase(connection.second.component);
+      }
+      std::lock_guard<std::recursive_mutex> lock(updated_connection->second.group->mutex_);
+      updated_connection->second.group->connections_.insert(connection.second.component);
+    }
+  }
+  for (const auto &connection : updated_connections_) {
+    if (current_connections_.find(connection.first) == current_connections_.end()) {
+      connection.second.group->addConnection(connection.second.component);
+    }
+  }
+
+  logger_->log_debug("Applied flow update: %s", getSummary());
+  return processors_to_start;
+}
+
+std::string FlowDiff::getSummary() const {
+  size_t removed_processors = 0;
+  for (const auto &processor : current_processors_) {
+    removed_processors += updated_processors_.count(processor.first) == 0 ? 1 : 0;
+  }
+  size_t added_processors = 0;
+  for (const auto &processor : updated_processors_) {
+    added_processors += current_processors_.count(processor.first) == 0 ? 1 : 0;
+  }
+  size_t removed_connections = 0;
+  for (const auto &connection : current_connections_) {
+    removed_connections += updated_connections_.count(connection.first) == 0 ? 1 : 0;
+  }
+  size_t added_connections = 0;
+  for (const auto &connection : updated_connections_) {
+    added_connections += current_connections_.count(connection.first) == 0 ? 1 : 0;
+  }
+
+  std::stringstream summary;
+  summary << "processors: " << (current_processors_.size() - replaced_processors_.size()) << " kept (" << disturbed_processors_.size() << " restarted), "
+          << (replaced_processors_.size() - removed_processors) << " replaced, " << removed_processors << " removed, " << added_processors << " added; connections: "
+          << (current_connections_.size() - removed_connections) << " kept (" << reattached_connections_.size() << " reattached), " << removed_connections << " removed, "
+          << added_connections << " added";
+  return summary.str();
+}
+
+}  // namespace core
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
@@ -164,34 +164,15 @@ uint64_t FlowFile::getOffset() const {
 }
 
 bool FlowFile::removeAttribute(const std::string key) {
-  auto it = attributes_.find(key);
-  if (it != attributes_.end()) {
-    attributes_.erase(key);
-    return true;
-  } else {
-    return false;
-  }
+  return attributes_.erase(key) > 0;
 }
 
 bool FlowFile::updateAttribute(const std::string key, const std::string value) {
-  auto it = attributes_.find(key);
-  if (it != attributes_.end()) {
-    attributes_[key] = value;
-    return true;
-  } else {
-    return false;
-  }
+  return attributes_.update(key, value);
 }
 
 bool FlowFile::addAttribute(const std::string &key, const std::string &value) {
-  auto it = attributes_.find(key);
-  if (it != attributes_.end()) {
-    // attribute already there in the map
-    return false;
-  } else {
-    attributes_[key] = value;
-    return true;
-  }
+  return attributes_.insert(key, value);
 }
 
 void FlowFile::setLineageStartDate(const uint64_t date) {
@@ -0,0 +1,195 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "core/FlowFileAttributes.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+
+namespace {
+
+struct InternedKeys {
+  std::mutex mutex;
+  std::unordered_set<std::string> keys;
+  std::atomic<bool> full{false};
+};
+
+InternedKeys &getInternedKeys() {
+  // never destroyed, attributes of static objects may refer to it until the very end
+  static InternedKeys *interned_keys = new InternedKeys();
+  return *interned_keys;
+}
+
+}  // namespace
+
+constexpr size_t AttributeKeyRegistry::MAX_KEYS;
+
+const std::string* AttributeKeyRegistry::intern(const std::string &key) {
+  // every thread looks up the keys it has seen before without locking
+  static thread_local std::unordered_map<std::string, const std::string*> cache;
+  auto cached = cache.find(key);
+  if (cached != cache.end()) {
+    return cached->second;
+  }
+
+  InternedKeys &interned_keys = getInternedKeys();
+  if (interned_keys.full) {
+    // a full registry is never modified again, so it can be read without the lock
+    auto it = interned_keys.keys.find(key);
+    if (it == interned_keys.keys.end()) {
+      return nullptr;
+    }
+    cache.emplace(key, &*it);
+    return &*it;
+  }
+
+  std::lock_guard<std::mutex> lock(interned_keys.mutex);
+  auto it = interned_keys.keys.find(key);
+  if (it == interned_keys.keys.end()) {
+    if (interned_keys.full) {
+      return nullptr;
+    }
+    it = interned_keys.keys.insert(key).first;
+  }
+  if (interned_keys.keys.size() >= MAX_KEYS) {
+    interned_keys.full = true;
+  }
+  cache.emplace(key, &*it);
+  return &*it;
+}
+
+FlowFileAttributes::FlowFileAttributes(const std::map<std::string, std::string> &attributes) {
+  if (attributes.empty()) {
+    return;
+  }
+  entries_ = std::make_shared<Entries>();
+  entries_->reserve(attributes.size());
+  for (const auto &attribute : attributes) {
+    entries_->emplace_back(attribute.first, attribute.second);
+  }
+}
+
+const FlowFileAttributes::Entries &FlowFileAttributes::emptyEntries() {
+  static const Entries empty;
+  return empty;
+}
+
+FlowFileAttributes::Entries::const_iterator FlowFileAttributes::lowerBound(const std::string &key) const {
+  const Entries &current = entries();
+  return std::lower_bound(current.begin(), current.end(), key, [](const Entry &entry, const std::string &value) {
+    return entry.key() < value;
+  });
+}
+
+FlowFileAttributes::const_iterator FlowFileAttributes::find(const std::string &key) const {
+  auto it = lowerBound(key);
+  if (it != entries().end() && it->key() == key) {
+    return const_iterator(it);
+  }
+  return end();
+}
+
+const std::string &FlowFileAttributes::at(const std::string &key) const {
+  auto it = lowerBound(key);
+  if (it == entries().end() || it->key() != key) {
+    throw std::out_of_range("No attribute named " + key);
+  }
+  return it->value();
+}
+
+FlowFileAttributes::Entries &FlowFileAttributes::mutableEntries() {
+  if (!entries_) {
+    entries_ = std::make_shared<Entries>();
+  } else if (entries_.use_count() > 1) {
+    entries_ = std::make_shared<Entries>(*entries_);
+  }
+  return *entries_;
+}
+
+void FlowFileAttributes::set(const std::string &key, std::string value) {
+  const size_t position = lowerBound(key) - entries().begin();
+  Entries &modified = mutableEntries();
+  if (position < modified.size() && modified[position].key() == key) {
+    modified[position].value() = std::move(value);
+  } else {
+    modified.emplace(modified.begin() + position, key, std::move(value));
+  }
+}
+
+bool FlowFileAttributes::insert(const std::string &key, std::string value) {
+  const size_t position = lowerBound(key) - entries().begin();
+  if (position < size() && entries()[position].key() == key) {
+    return false;
+  }
+  Entries &modified = mutableEntries();
+  modified.emplace(modified.begin() + position, key, std::move(value));
+  return true;
+}
+
+bool FlowFileAttributes::update(const std::string &key, std::string value) {
+  const size_t position = lowerBound(key) - entries().begin();
+  if (position >= size() || entries()[position].key() != key) {
+    return false;
+  }
+  mutableEntries()[position].value() = std::move(value);
+  return true;
+}
+
+size_t FlowFileAttributes::erase(const std::string &key) {
+  const size_t position = lowerBound(key) - entries().begin();
+  if (position >= size() || entries()[position].key() != key) {
+    return 0;
+  }
+  Entries &modified = mutableEntries();
+  modified.erase(modified.begin() + position);
+  return 1;
+}
+
+std::map<std::string, std::string> FlowFileAttributes::toMap() const {
+  std::map<std::string, std::string> attributes;
+  for (const auto &entry : entries()) {
+    attributes.emplace_hint(attributes.end(), entry.key(), entry.value());
+  }
+  return attributes;
+}
+
+bool FlowFileAttributes::operator==(const FlowFileAttributes &other) const {
+  if (entries_ == other.entries_) {
+    return true;
+  }
+  const Entries &current = entries();
+  const Entries &others = other.entries();
+  return current.size() == others.size() && std::equal(current.begin(), current.end(), others.begin(), [](const Entry &a, const Entry &b) {
+    return a.key() == b.key() && a.value() == b.value();
+  });
+}
+
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -0,0 +1,101 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "core/FlowFilePrioritizer.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+
+namespace {
+
+int compareDates(uint64_t first, uint64_t second) {
+  return first < second ? -1 : (first > second ? 1 : 0);
+}
+
+bool parsePriority(const std::string &value, int64_t &priority) {
+  if (value.empty()) {
+    return false;
+  }
+  char *end = nullptr;
+  errno = 0;
+  priority = std::strtoll(value.c_str(), &end, 10);
+  return errno == 0 && end == value.c_str() + value.size();
+}
+
+}  // namespace
+
+constexpr const char *PriorityAttributePrioritizer::PRIORITY_ATTRIBUTE;
+
+std::shared_ptr<FlowFilePrioritizer> FlowFilePrioritizer::create(const std::string &name) {
+  const std::string class_name = name.substr(name.find_last_of('.') + 1);
+  if (class_name == "FirstInFirstOutPrioritizer") {
+    return std::make_shared<FirstInFirstOutPrioritizer>();
+  } else if (class_name == "OldestFlowFileFirstPrioritizer") {
+    return std::make_shared<OldestFlowFileFirstPrioritizer>();
+  } else if (class_name == "NewestFlowFileFirstPrioritizer") {
+    return std::make_shared<NewestFlowFileFirstPrioritizer>();
+  } else if (class_name == "PriorityAttributePrioritizer") {
+    return std::make_shared<PriorityAttributePrioritizer>();
+  }
+  return nullptr;
+}
+
+int OldestFlowFileFirstPrioritizer::compare(const FlowFile &first, const FlowFile &second) const {
+  return compareDates(first.getEntryDate(), second.getEntryDate());
+}
+
+int NewestFlowFileFirstPrioritizer::compare(const FlowFile &first, const FlowFile &second) const {
+  return compareDates(second.getEntryDate(), first.getEntryDate());
+}
+
+int PriorityAttributePrioritizer::compare(const FlowFile &first, const FlowFile &second) const {
+  const auto first_it = first.getAttributes().find(PRIORITY_ATTRIBUTE);
+  const auto second_it = second.getAttributes().find(PRIORITY_ATTRIBUTE);
+  const bool first_set = first_it != first.getAttributes().end();
+  const bool second_set = second_it != second.getAttributes().end();
+  if (!first_set || !second_set) {
+    return first_set ? -1 : (second_set ? 1 : 0);
+  }
+
+  const std::string &first_value = first_it->second;
+  const std::string &second_value = second_it->second;
+  int64_t first_priority = 0;
+  int64_t second_priority = 0;
+  const bool first_numeric = parsePriority(first_value, first_priority);
+  const bool second_numeric = parsePriority(second_value, second_priority);
+  if (first_numeric && second_numeric) {
+    return first_priority < second_priority ? -1 : (first_priority > second_priority ? 1 : 0);
+  }
+  if (first_numeric != second_numeric) {
+    return first_numeric ? -1 : 1;
+  }
+  return first_value.compare(second_value);
+}
+
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -0,0 +1,123 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "core/FlowFileQueue.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+
+bool FlowFileQueue::ReadyOrder::operator()(const Entry &first, const Entry &second) const {
+  // std heaps keep the greatest element at the front, so "less" means processed later
+  for (const auto &prioritizer : queue->prioritizers_) {
+    const int result = prioritizer->compare(*first.flow_file, *second.flow_file);
+    if (result != 0) {
+      return result > 0;
+    }
+  }
+  return first.sequence > second.sequence;
+}
+
+void FlowFileQueue::setPrioritizers(std::vector<std::shared_ptr<FlowFilePrioritizer>> prioritizers) {
+  std::vector<Entry> ready(std::make_move_iterator(ready_fifo_.begin()), std::make_move_iterator(ready_fifo_.end()));
+  ready.insert(ready.end(), std::make_move_iterator(ready_heap_.begin()), std::make_move_iterator(ready_heap_.end()));
+  ready_fifo_.clear();
+  ready_heap_.clear();
+
+  prioritizers_ = std::move(prioritizers);
+  std::sort(ready.begin(), ready.end(), [](const Entry &first, const Entry &second) {
+    return first.sequence < second.sequence;
+  });
+  for (auto &entry : ready) {
+    pushReady(std::move(entry));
+  }
+}
+
+void FlowFileQueue::pushReady(Entry entry) {
+  if (prioritizers_.empty()) {
+    ready_fifo_.push_back(std::move(entry));
+  } else {
+    ready_heap_.push_back(std::move(entry));
+    std::push_heap(ready_heap_.begin(), ready_heap_.end(), ReadyOrder{this});
+  }
+}
+
+void FlowFileQueue::push(std::shared_ptr<FlowFile> flow_file) {
+  Entry entry{std::move(flow_file), next_sequence_++};
+  if (entry.flow_file->isPenalized()) {
+    penalized_.push_back(std::move(entry));
+    std::push_heap(penalized_.begin(), penalized_.end(), PenaltyOrder());
+  } else {
+    pushReady(std::move(entry));
+  }
+}
+
+void FlowFileQueue::releasePenalized(uint64_t now) {
+  while (!penalized_.empty() && penalized_.front().flow_file->getPenaltyExpiration() <= now) {
+    std::pop_heap(penalized_.begin(), penalized_.end(), PenaltyOrder());
+    Entry entry = std::move(penalized_.back());
+    penalized_.pop_back();
+    pushReady(std::move(entry));
+  }
+}
+
+std::shared_ptr<FlowFile> FlowFileQueue::pop(uint64_t now) {
+  releasePenalized(now);
+  std::shared_ptr<FlowFile> flow_file;
+  if (!ready_fifo_.empty()) {
+    flow_file = std::move(ready_fifo_.front().flow_file);
+    ready_fifo_.pop_front();
+  } else if (!ready_heap_.empty()) {
+    std::pop_heap(ready_heap_.begin(), ready_heap_.end(), ReadyOrder{this});
+    flow_file = std::move(ready_heap_.back().flow_file);
+    ready_heap_.pop_back();
+  }
+  return flow_file;
+}
+
+bool FlowFileQueue::isWorkAvailable(uint64_t now) const {
+  return !ready_fifo_.empty() || !ready_heap_.empty() || (!penalized_.empty() && penalized_.front().flow_file->getPenaltyExpiration() <= now);
+}
+
+std::vector<std::shared_ptr<FlowFile>> FlowFileQueue::clear() {
+  std::vector<std::shared_ptr<FlowFile>> flow_files;
+  flow_files.reserve(size());
+  for (auto *entries : {&ready_heap_, &penalized_}) {
+    for (auto &entry : *entries) {
+      flow_files.push_back(std::move(entry.flow_file));
+    }
+    entries->clear();
+  }
+  for (auto &entry : ready_fifo_) {
+    flow_files.push_back(std::move(entry.flow_file));
+  }
+  ready_fifo_.clear();
+  return flow_files;
+}
+
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -122,6 +122,7 @@ void ProcessGroup::removeProcessor(std::shared_ptr<Processor> processor) {
   if (processors_.find(processor) != processors_.end()) {
     // We do have the same processor in this process group yet
     processors_.erase(processor);
+    failed_processors_.erase(processor);
     logger_->log_debug("Remove processor %s from process group %s", processor->getName(), name_);
   }
 }
@@ -151,30 +152,48 @@ void ProcessGroup::startProcessingProcessors(const std::shared_ptr<TimerDrivenSc
   std::unique_lock<std::recursive_mutex> lock(mutex_);
 
   std::set<std::shared_ptr<Processor> > failed_processors;
-
-  for (const auto &processor : failed_processors_) {
-    try {
-      logger_->log_debug("Starting %s", processor->getName());
-      switch (processor->getSchedulingStrategy()) {
-        case TIMER_DRIVEN:
-          timeScheduler->schedule(processor);
-          break;
-        case EVENT_DRIVEN:
-          eventScheduler->schedule(processor);
-          break;
-        case CRON_DRIVEN:
-          cronScheduler->schedule(processor);
-          break;
+  std::mutex failed_processors_mutex;
+
+  // processors are scheduled concurrently, as onSchedule may block for a while, e.g. to connect to a remote system
+  const std::vector<std::shared_ptr<Processor>> processors(failed_processors_.begin(), failed_processors_.end());
+  std::atomic<size_t> next_processor(0);
+  auto schedule = [&]() {
+    for (size_t i = next_processor++; i < processors.size(); i = next_processor++) {
+      const auto &processor = processors[i];
+      try {
+        logger_->log_debug("Starting %s", processor->getName());
+        switch (processor->getSchedulingStrategy()) {
+          case TIMER_DRIVEN:
+            timeScheduler->schedule(processor);
+            break;
+          case EVENT_DRIVEN:
+            eventScheduler->schedule(processor);
+            break;
+          case CRON_DRIVEN:
+            cronScheduler->schedule(processor);
+            break;
+        }
+      }
+      catch (const std::exception &e) {
+        logger_->log_error("Failed to start processor %s (%s): %s", processor->getUUIDStr(), processor->getName(), e.what());
+        std::lock_guard<std::mutex> failed_lock(failed_processors_mutex);
+        failed_processors.insert(processor);
+      }
+      catch (...) {
+        logger_->log_error("Failed to start processor %s (%s)", processor->getUUIDStr(), processor->getName());
+        std::lock_guard<std::mutex> failed_lock(failed_processors_mutex);
+        failed_processors.insert(processor);
       }
     }
-    catch (const std::exception &e) {
-      logger_->log_error("Failed to start processor %s (%s): %s", processor->getUUIDStr(), processor->getName(), e.what());
-      failed_processors.insert(processor);
-    }
-    catch (...) {
-      logger_->log_error("Failed to start processor %s (%s)", processor->getUUIDStr(), processor->getName());
-      failed_processors.insert(processor);
-    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < (std::min)(processors.size(), static_cast<size_t>(ONSCHEDULE_CONCURRENCY)); ++i) {
+    threads.emplace_back(schedule);
+  }
+  schedule();
+  for (auto &thread : threads) {
+    thread.join();
   }
   failed_processors_ = std::move(failed_processors);
 
@@ -221,6 +240,18 @@ void ProcessGroup::startProcessing(const std::shared_ptr<TimerDrivenSchedulingAg
   }
 }
 
+void ProcessGroup::startProcessing(const std::set<std::shared_ptr<Processor>> &processors, const std::shared_ptr<TimerDrivenSchedulingAgent> timeScheduler,
+                                   const std::shared_ptr<EventDrivenSchedulingAgent> &eventScheduler, const std::shared_ptr<CronDrivenSchedulingAgent> &cronScheduler) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+
+  for (const auto &processor : processors) {
+    if (processors_.find(processor) != processors_.end()) {
+      failed_processors_.insert(processor);
+    }
+  }
+  startProcessingProcessors(timeScheduler, eventScheduler, cronScheduler);
+}
+
 void ProcessGroup::stopProcessing(const std::shared_ptr<TimerDrivenSchedulingAgent> timeScheduler, const std::shared_ptr<EventDrivenSchedulingAgent> &eventScheduler,
                                   const std::shared_ptr<CronDrivenSchedulingAgent> &cronScheduler) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
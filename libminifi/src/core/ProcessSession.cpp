@@ -31,6 +31,7 @@
 #include <vector>
 
 #include "core/ProcessSessionReadCallback.h"
+#include "core/Processor.h"
 #include "utils/gsl.h"
 
 /* This implementation is only for native Windows systems.  */
@@ -61,10 +62,38 @@ namespace core {
 
 std::shared_ptr<utils::IdGenerator> ProcessSession::id_generator_ = utils::IdGenerator::getIdGenerator();
 
+namespace {
+
+/**
+ * Gives the child the attributes of its parent, except for the special ones. The child
+ * shares the parent's attribute storage until one of them changes, and its own attributes
+ * are kept only where the parent has no value for them.
+ */
+void inheritAttributes(const std::shared_ptr<core::FlowFile> &parent, const std::shared_ptr<core::FlowFile> &child) {
+  FlowFileAttributes attributes = parent->getAttributes();
+  attributes.erase(FlowAttributeKey(ALTERNATE_IDENTIFIER));
+  attributes.erase(FlowAttributeKey(DISCARD_REASON));
+  for (const auto &attribute : child->getAttributes()) {
+    if (attribute.first == FlowAttributeKey(UUID)) {
+      attributes.set(attribute.first, attribute.second);
+    } else {
+      attributes.insert(attribute.first, attribute.second);
+    }
+  }
+  child->setAttributes(std::move(attributes));
+}
+
+}  // namespace
+
 ProcessSession::~ProcessSession() {
   removeReferences();
 }
 
+std::shared_ptr<ProcessorMetrics> ProcessSession::findProcessorMetrics() const {
+  auto processor = std::dynamic_pointer_cast<Processor>(process_context_->getProcessorNode()->getProcessor());
+  return processor != nullptr ? processor->getMetrics() : nullptr;
+}
+
 std::shared_ptr<core::FlowFile> ProcessSession::create() {
   std::map<std::string, std::string> empty;
 
@@ -80,9 +109,11 @@ std::shared_ptr<core::FlowFile> ProcessSession::create() {
 
   _addedFlowFiles[record->getUUIDStr()] = record;
   logger_->log_debug("Create FlowFile with UUID %s", record->getUUIDStr());
-  std::stringstream details;
-  details << process_context_->getProcessorNode()->getName() << " creates flow record " << record->getUUIDStr();
-  provenance_report_->create(record, details.str());
+  if (provenance_report_->isEnabled(provenance::ProvenanceEventRecord::CREATE, record)) {
+    std::stringstream details;
+    details << process_context_->getProcessorNode()->getName() << " creates flow record " << record->getUUIDStr();
+    provenance_report_->create(record, details.str());
+  }
 
   return record;
 }
@@ -108,14 +139,7 @@ std::shared_ptr<core::FlowFile> ProcessSession::create(const std::shared_ptr<cor
 
   if (record) {
     // Copy attributes
-    std::map<std::string, std::string> parentAttributes = parent->getAttributes();
-    std::map<std::string, std::string>::iterator it;
-    for (it = parentAttributes.begin(); it != parentAttributes.end(); it++) {
-      if (it->first == FlowAttributeKey(ALTERNATE_IDENTIFIER) || it->first == FlowAttributeKey(DISCARD_REASON) || it->first == FlowAttributeKey(UUID))
-        // Do not copy special attributes from parent
-        continue;
-      record->setAttribute(it->first, it->second);
-    }
+    inheritAttributes(parent, record);
     record->setLineageStartDate(parent->getlineageStartDate());
     record->setLineageIdentifiers(parent->getlineageIdentifiers());
     parent->getlineageIdentifiers().insert(parent->getUUIDStr());
@@ -154,14 +178,7 @@ std::shared_ptr<core::FlowFile> ProcessSession::cloneDuringTransfer(std::shared_
     this->_clonedFlowFiles[record->getUUIDStr()] = record;
     logger_->log_debug("Clone FlowFile with UUID %s during transfer", record->getUUIDStr());
     // Copy attributes
-    std::map<std::string, std::string> parentAttributes = parent->getAttributes();
-    std::map<std::string, std::string>::iterator it;
-    for (it = parentAttributes.begin(); it != parentAttributes.end(); it++) {
-      if (it->first == FlowAttributeKey(ALTERNATE_IDENTIFIER) || it->first == FlowAttributeKey(DISCARD_REASON) || it->first == FlowAttributeKey(UUID))
-        // Do not copy special attributes from parent
-        continue;
-      record->setAttribute(it->first, it->second);
-    }
+    inheritAttributes(parent, record);
     record->setLineageStartDate(parent->getlineageStartDate());
 
     record->setLineageIdentifiers(parent->getlineageIdentifiers());
@@ -221,22 +238,28 @@ void ProcessSession::remove(const std::shared_ptr<core::FlowFile> &flow) {
     process_context_->getFlowFileRepository()->Delete(flow->getUUIDStr());
   }
   _deletedFlowFiles[flow->getUUIDStr()] = flow;
-  std::string reason = process_context_->getProcessorNode()->getName() + " drop flow record " + flow->getUUIDStr();
-  provenance_report_->drop(flow, reason);
+  if (provenance_report_->isEnabled(provenance::ProvenanceEventRecord::DROP, flow)) {
+    std::string reason = process_context_->getProcessorNode()->getName() + " drop flow record " + flow->getUUIDStr();
+    provenance_report_->drop(flow, reason);
+  }
 }
 
 void ProcessSession::putAttribute(const std::shared_ptr<core::FlowFile> &flow, std::string key, std::string value) {
   flow->setAttribute(key, value);
-  std::stringstream details;
-  details << process_context_->getProcessorNode()->getName() << " modify flow record " << flow->getUUIDStr() << " attribute " << key << ":" << value;
-  provenance_report_->modifyAttributes(flow, details.str());
+  if (provenance_report_->isEnabled(provenance::ProvenanceEventRecord::ATTRIBUTES_MODIFIED, flow)) {
+    std::stringstream details;
+    details << process_context_->getProcessorNode()->getName() << " modify flow record " << flow->getUUIDStr() << " attribute " << key << ":" << value;
+    provenance_report_->modifyAttributes(flow, details.str());
+  }
 }
 
 void ProcessSession::removeAttribute(const std::shared_ptr<core::FlowFile> &flow, std::string key) {
   flow->removeAttribute(key);
-  std::stringstream details;
-  details << process_context_->getProcessorNode()->getName() << " remove flow record " << flow->getUUIDStr() << " attribute " + key;
-  provenance_report_->modifyAttributes(flow, details.str());
+  if (provenance_report_->isEnabled(provenance::ProvenanceEventRecord::ATTRIBUTES_MODIFIED, flow)) {
+    std::stringstream details;
+    details << process_context_->getProcessorNode()->getName() << " remove flow record " << flow->getUUIDStr() << " attribute " + key;
+    provenance_report_->modifyAttributes(flow, details.str());
+  }
 }
 
 void ProcessSession::penalize(const std::shared_ptr<core::FlowFile> &flow) {
@@ -280,10 +303,12 @@ void ProcessSession::write(const std::shared_ptr<core::FlowFile> &flow, OutputSt
     flow->setResourceClaim(claim);
 
     stream->closeStream();
-    std::stringstream details;
-    details << process_context_->getProcessorNode()->getName() << " modify flow record content " << flow->getUUIDStr();
-    uint64_t endTime = getTimeMillis();
-    provenance_report_->modifyContent(flow, details.str(), endTime - startTime);
+    if (provenance_report_->isEnabled(provenance::ProvenanceEventRecord::CONTENT_MODIFIED, flow)) {
+      std::stringstream details;
+      details << process_context_->getProcessorNode()->getName() << " modify flow record content " << flow->getUUIDStr();
+      uint64_t endTime = getTimeMillis();
+      provenance_report_->modifyContent(flow, details.str(), endTime - startTime);
+    }
   } catch (std::exception &exception) {
     if (flow && flow->getResourceClaim() == claim) {
       flow->getResourceClaim()->decreaseFlowFileRecordOwnedCount();
@@ -329,10 +354,12 @@ void ProcessSession::append(const std::shared_ptr<core::FlowFile> &flow, OutputS
     }
     flow->setSize(stream->getSize());
 
-    std::stringstream details;
-    details << process_context_->getProcessorNode()->getName() << " modify flow record content " << flow->getUUIDStr();
-    uint64_t endTime = getTimeMillis();
-    provenance_report_->modifyContent(flow, details.str(), endTime - startTime);
+    if (provenance_report_->isEnabled(provenance::ProvenanceEventRecord::CONTENT_MODIFIED, flow)) {
+      std::stringstream details;
+      details << process_context_->getProcessorNode()->getName() << " modify flow record content " << flow->getUUIDStr();
+      uint64_t endTime = getTimeMillis();
+      provenance_report_->modifyContent(flow, details.str(), endTime - startTime);
+    }
   } catch (std::exception &exception) {
     logger_->log_debug("Caught Exception %s", exception.what());
     throw;
@@ -425,10 +452,12 @@ void ProcessSession::importFrom(io::DataStream &stream, const std::shared_ptr<co
         flow->getOffset(), flow->getSize(), flow->getResourceClaim()->getContentFullPath(), flow->getUUIDStr());
 
     content_stream->closeStream();
-    std::stringstream details;
-    details << process_context_->getProcessorNode()->getName() << " modify flow record content " << flow->getUUIDStr();
-    auto endTime = getTimeMillis();
-    provenance_report_->modifyContent(flow, details.str(), endTime - startTime);
+    if (provenance_report_->isEnabled(provenance::ProvenanceEventRecord::CONTENT_MODIFIED, flow)) {
+      std::stringstream details;
+      details << process_context_->getProcessorNode()->getName() << " modify flow record content " << flow->getUUIDStr();
+      auto endTime = getTimeMillis();
+      provenance_report_->modifyContent(flow, details.str(), endTime - startTime);
+    }
   } catch (std::exception &exception) {
     if (flow && flow->getResourceClaim() == claim) {
       flow->getResourceClaim()->decreaseFlowFileRecordOwnedCount();
@@ -504,10 +533,12 @@ void ProcessSession::import(std::string source, const std::shared_ptr<core::Flow
         input.close();
         if (!keepSource)
           std::remove(source.c_str());
-        std::stringstream details;
-        details << process_context_->getProcessorNode()->getName() << " modify flow record content " << flow->getUUIDStr();
-        auto endTime = getTimeMillis();
-        provenance_report_->modifyContent(flow, details.str(), endTime - startTime);
+        if (provenance_report_->isEnabled(provenance::ProvenanceEventRecord::CONTENT_MODIFIED, flow)) {
+          std::stringstream details;
+          details << process_context_->getProcessorNode()->getName() << " modify flow record content " << flow->getUUIDStr();
+          auto endTime = getTimeMillis();
+          provenance_report_->modifyContent(flow, details.str(), endTime - startTime);
+        }
       } else {
         stream->closeStream();
         input.close();
@@ -619,9 +650,11 @@ void ProcessSession::import(const std::string& source, std::vector<std::shared_p
           logging::LOG_DEBUG(logger_) << "Import offset " << flowFile->getOffset() << " length " << flowFile->getSize() << " content " << flowFile->getResourceClaim()->getContentFullPath()
                                       << ", FlowFile UUID " << flowFile->getUUIDStr();
           stream->closeStream();
-          std::string details = process_context_->getProcessorNode()->getName() + " modify flow record content " + flowFile->getUUIDStr();
-          uint64_t endTime = getTimeMillis();
-          provenance_report_->modifyContent(flowFile, details, endTime - startTime);
+          if (provenance_report_->isEnabled(provenance::ProvenanceEventRecord::CONTENT_MODIFIED, flowFile)) {
+            std::string details = process_context_->getProcessorNode()->getName() + " modify flow record content " + flowFile->getUUIDStr();
+            uint64_t endTime = getTimeMillis();
+            provenance_report_->modifyContent(flowFile, details, endTime - startTime);
+          }
           flows.push_back(flowFile);
 
           /* Reset these to start processing the next FlowFile with a clean slate */
@@ -739,6 +772,7 @@ void ProcessSession::restore(const std::string &key, const std::shared_ptr<core:
 }
 
 void ProcessSession::commit() {
+  const uint64_t start = ProcessorMetrics::now();
   try {
     // First we clone the flow record based on the transfered relationship for updated flow record
     for (auto && it : _updatedFlowFiles) {
@@ -869,7 +903,13 @@ void ProcessSession::commit() {
       }
     }
 
+    uint64_t transferred = 0;
+    uint64_t transferred_bytes = 0;
     for (auto& cq : connectionQueues) {
+      transferred += cq.second.size();
+      for (const auto &record : cq.second) {
+        transferred_bytes += record->getSize();
+      }
       cq.first->multiPut(cq.second);
     }
 
@@ -884,6 +924,10 @@ void ProcessSession::commit() {
     // persistent the provenance report
     this->provenance_report_->commit();
     logger_->log_trace("ProcessSession committed for %s", process_context_->getProcessorNode()->getName());
+    if (metrics_ != nullptr) {
+      metrics_->recordOutgoing(transferred, transferred_bytes);
+      metrics_->commit_nanos.record(ProcessorMetrics::now() - start);
+    }
   } catch (std::exception &exception) {
     logger_->log_debug("Caught Exception %s", exception.what());
     throw;
@@ -946,15 +990,20 @@ std::shared_ptr<core::FlowFile> ProcessSession::get() {
     if (!expired.empty()) {
       // Remove expired flow record
       for (const auto& record : expired) {
-        std::stringstream details;
-        details << process_context_->getProcessorNode()->getName() << " expire flow record " << record->getUUIDStr();
-        provenance_report_->expire(record, details.str());
+        if (provenance_report_->isEnabled(provenance::ProvenanceEventRecord::EXPIRE, record)) {
+          std::stringstream details;
+          details << process_context_->getProcessorNode()->getName() << " expire flow record " << record->getUUIDStr();
+          provenance_report_->expire(record, details.str());
+        }
       }
     }
     if (ret) {
       // add the flow record to the current process session update map
       ret->setDeleted(false);
       _updatedFlowFiles[ret->getUUIDStr()] = ret;
+      if (metrics_ != nullptr) {
+        metrics_->recordIncoming(ret->getSize());
+      }
       std::map<std::string, std::string> empty;
       std::shared_ptr<core::FlowFile> snapshot = std::make_shared<FlowFileRecord>(process_context_->getFlowFileRepository(), process_context_->getContentRepository(), empty);
       auto flow_version = process_context_->getProcessorNode()->getFlowIdentifier();
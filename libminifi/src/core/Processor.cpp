@@ -51,6 +51,7 @@ namespace core {
 Processor::Processor(std::string name)
     : Connectable(name),
       ConfigurableComponent(),
+      metrics_(std::make_shared<ProcessorMetrics>()),
       logger_(logging::LoggerFactory<Processor>::getLogger()) {
   has_work_.store(false);
   // Setup the default values
@@ -64,6 +65,7 @@ Processor::Processor(std::string name)
   _penalizationPeriodMsec = DEFAULT_PENALIZATION_PERIOD_SECONDS * 1000;
   max_concurrent_tasks_ = DEFAULT_MAX_CONCURRENT_TASKS;
   active_tasks_ = 0;
+  pipeline_segment_ = -1;
   yield_expiration_ = 0;
   incoming_connections_Iter = this->_incomingConnections.begin();
   logger_->log_debug("Processor %s created UUID %s", name_, uuidStr_);
@@ -72,6 +74,7 @@ Processor::Processor(std::string name)
 Processor::Processor(std::string name, utils::Identifier &uuid)
     : Connectable(name, uuid),
       ConfigurableComponent(),
+      metrics_(std::make_shared<ProcessorMetrics>()),
       logger_(logging::LoggerFactory<Processor>::getLogger()) {
   has_work_.store(false);
   // Setup the default values
@@ -85,6 +88,7 @@ Processor::Processor(std::string name, utils::Identifier &uuid)
   _penalizationPeriodMsec = DEFAULT_PENALIZATION_PERIOD_SECONDS * 1000;
   max_concurrent_tasks_ = DEFAULT_MAX_CONCURRENT_TASKS;
   active_tasks_ = 0;
+  pipeline_segment_ = -1;
   yield_expiration_ = 0;
   incoming_connections_Iter = this->_incomingConnections.begin();
   logger_->log_debug("Processor %s created UUID %s with uuid %s", name_, uuidStr_, uuid.to_string());
@@ -231,6 +235,16 @@ bool Processor::flowFilesQueued() {
   return false;
 }
 
+uint64_t Processor::getQueuedFlowFiles() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  uint64_t queued = 0;
+  for (auto &&conn : _incomingConnections) {
+    queued += std::static_pointer_cast<Connection>(conn)->getQueueSize();
+  }
+  return queued;
+}
+
 bool Processor::flowFilesOutGoingFull() {
   std::lock_guard<std::mutex> lock(mutex_);
 
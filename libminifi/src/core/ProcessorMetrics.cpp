@@ -0,0 +1,139 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "core/ProcessorMetrics.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+
+namespace {
+
+unsigned mostSignificantBit(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return 63 - __builtin_clzll(value);
+#else
+  unsigned msb = 0;
+  while (value >>= 1) {
+    ++msb;
+  }
+  return msb;
+#endif
+}
+
+}  // namespace
+
+constexpr size_t ShardedCounter::SHARDS;
+constexpr unsigned LatencyHistogram::SUB_BUCKET_BITS;
+constexpr size_t LatencyHistogram::SUB_BUCKETS;
+constexpr size_t LatencyHistogram::BUCKETS;
+
+ShardedCounter::ShardedCounter() {
+  for (auto &shard : shards_) {
+    shard.value.store(0, std::memory_order_relaxed);
+  }
+}
+
+uint64_t ShardedCounter::load() const {
+  uint64_t sum = 0;
+  for (const auto &shard : shards_) {
+    sum += shard.value.load(std::memory_order_relaxed);
+  }
+  return sum;
+}
+
+size_t ShardedCounter::shardIndex() {
+  static std::atomic<size_t> next_shard(0);
+  thread_local size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+  return shard;
+}
+
+LatencyHistogram::LatencyHistogram()
+    : count_(0),
+      total_(0),
+      max_(0) {
+  for (auto &bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t value) {
+  if (value < SUB_BUCKETS) {
+    return static_cast<size_t>(value);
+  }
+  const unsigned shift = mostSignificantBit(value) - SUB_BUCKET_BITS;
+  return (shift + 1) * SUB_BUCKETS + static_cast<size_t>((value >> shift) - SUB_BUCKETS);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+  if (index < SUB_BUCKETS) {
+    return index;
+  }
+  const unsigned shift = static_cast<unsigned>(index / SUB_BUCKETS - 1);
+  const uint64_t lower = (SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+  return lower + ((uint64_t(1) << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t nanos) {
+  buckets_[bucketIndex(nanos)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  total_.fetch_add(nanos, std::memory_order_relaxed);
+  uint64_t max = max_.load(std::memory_order_relaxed);
+  while (nanos > max && !max_.compare_exchange_weak(max, nanos, std::memory_order_relaxed)) {
+  }
+}
+
+uint64_t LatencyHistogram::getPercentile(double percentile) const {
+  const uint64_t count = getCount();
+  if (count == 0) {
+    return 0;
+  }
+  const double clamped = std::min(100.0, std::max(0.0, percentile));
+  const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * count)));
+  uint64_t seen = 0;
+  for (size_t index = 0; index < BUCKETS; ++index) {
+    seen += buckets_[index].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      return std::min(bucketUpperBound(index), getMax());
+    }
+  }
+  // buckets updated after the count was read
+  return getMax();
+}
+
+void ProcessorMetrics::backpressureApplied(uint64_t at) {
+  uint64_t expected = 0;
+  backpressure_start_.compare_exchange_strong(expected, at);
+}
+
+void ProcessorMetrics::backpressureReleased(uint64_t at) {
+  const uint64_t start = backpressure_start_.exchange(0);
+  if (start != 0 && at > start) {
+    backpressure_nanos.add(at - start);
+  }
+}
+
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -0,0 +1,140 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/logging/AsyncSink.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+namespace logging {
+namespace internal {
+
+constexpr size_t AsyncSink::DEFAULT_QUEUE_SIZE;
+
+namespace {
+
+size_t roundUpToPowerOfTwo(size_t value) {
+  size_t result = 2;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+}  // namespace
+
+AsyncSink::AsyncSink(std::shared_ptr<spdlog::sinks::sink> sink, size_t queue_size, spdlog::async_overflow_policy overflow_policy)
+    : sink_(std::move(sink)),
+      queue_(roundUpToPowerOfTwo(queue_size)),
+      overflow_policy_(overflow_policy),
+      running_(true),
+      dropped_count_(0) {
+  worker_ = std::thread(&AsyncSink::run, this);
+}
+
+AsyncSink::~AsyncSink() {
+  running_ = false;
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+void AsyncSink::log(const spdlog::details::log_msg &msg) {
+  Entry entry;
+  entry.logger_name = msg.logger_name ? *msg.logger_name : "";
+  entry.level = msg.level;
+  entry.time = msg.time;
+  entry.thread_id = msg.thread_id;
+  entry.raw = msg.raw.str();
+  entry.formatted = msg.formatted.str();
+  enqueue(std::move(entry));
+}
+
+void AsyncSink::flush() {
+  Entry entry;
+  entry.flush = true;
+  enqueue(std::move(entry));
+}
+
+void AsyncSink::enqueue(Entry &&entry) {
+  if (queue_.enqueue(std::move(entry))) {
+    return;
+  }
+  if (overflow_policy_ == spdlog::async_overflow_policy::discard_log_msg) {
+    ++dropped_count_;
+    return;
+  }
+  // enqueue leaves the entry untouched when the queue is full
+  while (!queue_.enqueue(std::move(entry))) {
+    std::this_thread::yield();
+  }
+}
+
+void AsyncSink::run() {
+  Entry entry;
+  int idle_rounds = 0;
+  while (true) {
+    if (queue_.dequeue(entry)) {
+      idle_rounds = 0;
+      write(entry);
+      continue;
+    }
+    if (!running_) {
+      // the destructor runs after the last log call, so the queue stays empty from here on
+      break;
+    }
+    // back off gradually, so that a quiet agent does not spin on an empty queue
+    if (++idle_rounds < 64) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  sink_->flush();
+}
+
+void AsyncSink::write(const Entry &entry) {
+  if (entry.flush) {
+    sink_->flush();
+    return;
+  }
+  if (!sink_->should_log(entry.level)) {
+    return;
+  }
+  spdlog::details::log_msg msg(&entry.logger_name, entry.level);
+  msg.time = entry.time;
+  msg.thread_id = entry.thread_id;
+  msg.raw << entry.raw;
+  msg.formatted << entry.formatted;
+  sink_->log(msg);
+}
+
+}  // namespace internal
+}  // namespace logging
+}  // namespace core
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
@@ -100,8 +100,7 @@ bool Logger::should_log(const LOG_LEVEL &level) {
       break;
   }
 
-  std::lock_guard<std::mutex> lock(mutex_);
-  return delegate_->should_log(logger_level);
+  return current_delegate_.load(std::memory_order_acquire)->should_log(logger_level);
 }
 
 void Logger::log_string(LOG_LEVEL level, std::string str) {
@@ -130,11 +129,22 @@ void Logger::log_string(LOG_LEVEL level, std::string str) {
 }
 
 Logger::Logger(std::shared_ptr<spdlog::logger> delegate, std::shared_ptr<LoggerControl> controller)
-    : delegate_(delegate), controller_(controller) {
+    : delegate_(delegate), controller_(controller), current_delegate_(delegate.get()) {
 }
 
 Logger::Logger(std::shared_ptr<spdlog::logger> delegate)
-    : delegate_(delegate), controller_(nullptr) {
+    : delegate_(delegate), controller_(nullptr), current_delegate_(delegate.get()) {
+}
+
+void Logger::set_delegate(std::shared_ptr<spdlog::logger> delegate) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (delegate_ == delegate) {
+    return;
+  }
+  current_delegate_.store(delegate.get(), std::memory_order_release);
+  // releases the delegate retired before, together with its sinks
+  retired_delegate_ = std::move(delegate_);
+  delegate_ = std::move(delegate);
 }
 
 } /* namespace logging */
@@ -37,6 +37,7 @@
 #include "spdlog/spdlog.h"
 #include "spdlog/sinks/stdout_sinks.h"
 #include "spdlog/sinks/null_sink.h"
+#include "core/logging/AsyncSink.h"
 
 #ifdef WIN32
 #include "core/logging/WindowsEventLogSink.h"
@@ -193,6 +194,34 @@ std::shared_ptr<internal::LoggerNamespace> LoggerConfiguration::initialize_names
     }
   }
 
+  std::string async_str;
+  bool async = false;
+  if (logger_properties->get("spdlog.async", async_str)) {
+    utils::StringUtils::StringToBool(async_str, async);
+  }
+  if (async) {
+    size_t queue_size = internal::AsyncSink::DEFAULT_QUEUE_SIZE;
+    std::string queue_size_str;
+    if (logger_properties->get("spdlog.async.queue_size", queue_size_str)) {
+      try {
+        queue_size = std::stoul(queue_size_str);
+      } catch (const std::invalid_argument &ia) {
+      } catch (const std::out_of_range &oor) {
+      }
+    }
+    auto overflow_policy = spdlog::async_overflow_policy::block_retry;
+    std::string overflow_policy_str;
+    if (logger_properties->get("spdlog.async.overflow_policy", overflow_policy_str)) {
+      std::transform(overflow_policy_str.begin(), overflow_policy_str.end(), overflow_policy_str.begin(), ::tolower);
+      if ("discard" == overflow_policy_str) {
+        overflow_policy = spdlog::async_overflow_policy::discard_log_msg;
+      }
+    }
+    for (auto &sink : sink_map) {
+      sink.second = std::make_shared<internal::AsyncSink>(sink.second, queue_size, overflow_policy);
+    }
+  }
+
   std::shared_ptr<internal::LoggerNamespace> root_namespace = std::make_shared<internal::LoggerNamespace>();
   std::string logger_type = "logger";
   for (auto const & logger_key : logger_properties->get_keys_of_type(logger_type)) {
@@ -37,9 +37,7 @@
 #include "provenance/Provenance.h"
 #include "FlowController.h"
 
-#include "rapidjson/document.h"
 #include "rapidjson/writer.h"
-#include "rapidjson/stringbuffer.h"
 #include "rapidjson/prettywriter.h"
 
 
@@ -56,92 +54,113 @@ void SiteToSiteProvenanceReportingTask::initialize() {
   RemoteProcessorGroupPort::initialize();
 }
 
-void setJsonStr(const std::string& key, const std::string& value, rapidjson::Value& parent, rapidjson::Document::AllocatorType& alloc) { // NOLINT
-  rapidjson::Value keyVal;
-  rapidjson::Value valueVal;
-  const char* c_key = key.c_str();
-  const char* c_val = value.c_str();
+namespace {
 
-  keyVal.SetString(c_key, key.length(), alloc);
-  valueVal.SetString(c_val, value.length(), alloc);
+/**
+ * rapidjson output stream appending to a string, so that the report is written in place
+ * rather than built as a document and copied out of a StringBuffer.
+ */
+class StringOutputStream {
+ public:
+  typedef char Ch;
+
+  explicit StringOutputStream(std::string &str)
+      : str_(str) {
+  }
+
+  void Put(Ch c) {
+    str_.push_back(c);
+  }
+
+  void Flush() {
+  }
 
-  parent.AddMember(keyVal, valueVal, alloc);
+ private:
+  std::string &str_;
+};
+
+template<typename Writer>
+void writeString(Writer &writer, const std::string &value) {
+  writer.String(value.c_str(), static_cast<rapidjson::SizeType>(value.length()));
 }
 
-rapidjson::Value getStringValue(const std::string& value, rapidjson::Document::AllocatorType& alloc) { // NOLINT
-  rapidjson::Value Val;
-  Val.SetString(value.c_str(), value.length(), alloc);
-  return Val;
+template<typename Writer>
+void writeMember(Writer &writer, const char *key, const std::string &value) {
+  writer.Key(key);
+  writeString(writer, value);
 }
 
-void appendJsonStr(const std::string& value, rapidjson::Value& parent, rapidjson::Document::AllocatorType& alloc) { // NOLINT
-  rapidjson::Value valueVal;
-  const char* c_val = value.c_str();
-  valueVal.SetString(c_val, value.length(), alloc);
-  parent.PushBack(valueVal, alloc);
+template<typename Writer>
+void writeMember(Writer &writer, const char *key, uint64_t value) {
+  writer.Key(key);
+  writer.Uint64(value);
 }
 
+}  // namespace
+
 void SiteToSiteProvenanceReportingTask::getJsonReport(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session,
                                                       std::vector<std::shared_ptr<core::SerializableComponent>> &records, std::string &report) {
-  rapidjson::Document array(rapidjson::kArrayType);
-  rapidjson::Document::AllocatorType &alloc = array.GetAllocator();
-
-  for (auto sercomp : records) {
+  report.clear();
+  // events take roughly a kilobyte each once pretty printed
+  report.reserve(records.size() * 1024);
+  StringOutputStream stream(report);
+  rapidjson::PrettyWriter<StringOutputStream> writer(stream);
+
+  writer.StartArray();
+  for (const auto &sercomp : records) {
     std::shared_ptr<provenance::ProvenanceEventRecord> record = std::dynamic_pointer_cast<provenance::ProvenanceEventRecord>(sercomp);
     if (nullptr == record) {
       break;
     }
 
-    rapidjson::Value recordJson(rapidjson::kObjectType);
-    rapidjson::Value updatedAttributesJson(rapidjson::kObjectType);
-    rapidjson::Value parentUuidJson(rapidjson::kArrayType);
-    rapidjson::Value childUuidJson(rapidjson::kArrayType);
-
-    recordJson.AddMember("timestampMillis", record->getEventTime(), alloc);
-    recordJson.AddMember("durationMillis", record->getEventDuration(), alloc);
-    recordJson.AddMember("lineageStart", record->getlineageStartDate(), alloc);
-    recordJson.AddMember("entitySize", record->getFileSize(), alloc);
-    recordJson.AddMember("entityOffset", record->getFileOffset(), alloc);
-
-    recordJson.AddMember("entityType", "org.apache.nifi.flowfile.FlowFile", alloc);
-
-    recordJson.AddMember("eventId", getStringValue(record->getEventId(), alloc), alloc);
-    recordJson.AddMember("eventType", getStringValue(provenance::ProvenanceEventRecord::ProvenanceEventTypeStr[record->getEventType()], alloc), alloc);
-    recordJson.AddMember("details", getStringValue(record->getDetails(), alloc), alloc);
-    recordJson.AddMember("componentId", getStringValue(record->getComponentId(), alloc), alloc);
-    recordJson.AddMember("componentType", getStringValue(record->getComponentType(), alloc), alloc);
-    recordJson.AddMember("entityId", getStringValue(record->getFlowFileUuid(), alloc), alloc);
-    recordJson.AddMember("transitUri", getStringValue(record->getTransitUri(), alloc), alloc);
-    recordJson.AddMember("remoteIdentifier", getStringValue(record->getSourceSystemFlowFileIdentifier(), alloc), alloc);
-    recordJson.AddMember("alternateIdentifier", getStringValue(record->getAlternateIdentifierUri(), alloc), alloc);
-
-    for (auto attr : record->getAttributes()) {
-      setJsonStr(attr.first, attr.second, updatedAttributesJson, alloc);
+    writer.StartObject();
+    writeMember(writer, "timestampMillis", record->getEventTime());
+    writeMember(writer, "durationMillis", record->getEventDuration());
+    writeMember(writer, "lineageStart", record->getlineageStartDate());
+    writeMember(writer, "entitySize", record->getFileSize());
+    writeMember(writer, "entityOffset", record->getFileOffset());
+
+    writer.Key("entityType");
+    writer.String("org.apache.nifi.flowfile.FlowFile");
+
+    writeMember(writer, "eventId", record->getEventId());
+    writer.Key("eventType");
+    writer.String(provenance::ProvenanceEventRecord::ProvenanceEventTypeStr[record->getEventType()]);
+    writeMember(writer, "details", record->getDetails());
+    writeMember(writer, "componentId", record->getComponentId());
+    writeMember(writer, "componentType", record->getComponentType());
+    writeMember(writer, "entityId", record->getFlowFileUuid());
+    writeMember(writer, "transitUri", record->getTransitUri());
+    writeMember(writer, "remoteIdentifier", record->getSourceSystemFlowFileIdentifier());
+    writeMember(writer, "alternateIdentifier", record->getAlternateIdentifierUri());
+
+    writer.Key("updatedAttributes");
+    writer.StartObject();
+    for (const auto &attr : record->getAttributes()) {
+      writer.Key(attr.first.c_str(), static_cast<rapidjson::SizeType>(attr.first.length()));
+      writeString(writer, attr.second);
     }
-    recordJson.AddMember("updatedAttributes", updatedAttributesJson, alloc);
+    writer.EndObject();
 
-    for (auto parentUUID : record->getParentUuids()) {
-      appendJsonStr(parentUUID, parentUuidJson, alloc);
+    writer.Key("parentIds");
+    writer.StartArray();
+    for (const auto &parentUUID : record->getParentUuids()) {
+      writeString(writer, parentUUID);
     }
-    recordJson.AddMember("parentIds", parentUuidJson, alloc);
+    writer.EndArray();
 
-    for (auto childUUID : record->getChildrenUuids()) {
-      appendJsonStr(childUUID, childUuidJson, alloc);
+    writer.Key("childIds");
+    writer.StartArray();
+    for (const auto &childUUID : record->getChildrenUuids()) {
+      writeString(writer, childUUID);
     }
-    recordJson.AddMember("childIds", childUuidJson, alloc);
-
-    rapidjson::Value applicationVal;
-    applicationVal.SetString(ProvenanceAppStr, std::strlen(ProvenanceAppStr));
-    recordJson.AddMember("application", applicationVal, alloc);
+    writer.EndArray();
 
-    array.PushBack(recordJson, alloc);
+    writer.Key("application");
+    writer.String(ProvenanceAppStr);
+    writer.EndObject();
   }
-
-  rapidjson::StringBuffer buffer;
-  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
-  array.Accept(writer);
-
-  report = buffer.GetString();
+  writer.EndArray();
 }
 
 void SiteToSiteProvenanceReportingTask::onSchedule(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory) {
@@ -154,7 +173,11 @@ void SiteToSiteProvenanceReportingTask::onTrigger(const std::shared_ptr<core::Pr
   size_t deserialized = batch_size_;
   std::shared_ptr<core::Repository> repo = context->getProvenanceRepository();
   std::function<std::shared_ptr<core::SerializableComponent>()> constructor = []() {return std::make_shared<provenance::ProvenanceEventRecord>();};
-  if (!repo->DeSerialize(records, deserialized, constructor) && deserialized == 0) {
+  // resume after the last record transmitted, repositories without cursors start over from their oldest record
+  std::string position;
+  repo->getCursor(getUUIDStr(), position);
+  const std::string last_transmitted = position;
+  if (!repo->DeSerialize(records, deserialized, constructor, position) && deserialized == 0) {
     return;
   }
   logging::LOG_DEBUG(logger_) << "Captured " << deserialized << " records";
@@ -182,7 +205,11 @@ void SiteToSiteProvenanceReportingTask::onTrigger(const std::shared_ptr<core::Pr
   }
 
   // we transfer the record, purge the record from DB
-  repo->Delete(records);
+  if (repo->setCursor(getUUIDStr(), position)) {
+    repo->DeleteRange(last_transmitted, position);
+  } else {
+    repo->Delete(records);
+  }
   returnProtocol(std::move(protocol_));
 }
 
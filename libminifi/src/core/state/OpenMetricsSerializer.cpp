@@ -0,0 +1,193 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "core/state/OpenMetricsSerializer.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace state {
+
+namespace {
+
+const char *const TOTAL_SUFFIX = "_total";
+
+struct Sample {
+  std::string labels;
+  std::string value;
+};
+
+struct Family {
+  std::string name;
+  bool counter;
+  std::vector<Sample> samples;
+};
+
+/**
+ * Samples grouped by metric family, in the order the families were first seen, as the
+ * format requires the samples of a family to be contiguous.
+ */
+class Families {
+ public:
+  void add(const std::string &family, bool counter, Sample sample) {
+    auto it = index_.find(family);
+    if (it == index_.end()) {
+      it = index_.insert(std::make_pair(family, families_.size())).first;
+      families_.push_back(Family{family, counter, std::vector<Sample>()});
+    }
+    families_[it->second].samples.push_back(std::move(sample));
+  }
+
+  const std::vector<Family> &get() const {
+    return families_;
+  }
+
+ private:
+  std::map<std::string, size_t> index_;
+  std::vector<Family> families_;
+};
+
+bool isNumber(const std::string &value) {
+  if (value.empty() || std::isspace(static_cast<unsigned char>(value[0]))) {
+    return false;
+  }
+  char *end = nullptr;
+  std::strtod(value.c_str(), &end);
+  return end == value.c_str() + value.size();
+}
+
+std::string append(const std::string &prefix, const std::string &name) {
+  const std::string sanitized = OpenMetricsSerializer::sanitizeName(name);
+  return sanitized.empty() ? prefix : prefix + "_" + sanitized;
+}
+
+void collect(const response::SerializedResponseNode &node, const std::string &prefix, const std::string &labels, Families &families) {
+  const std::string name = append(prefix, node.name);
+  if (node.children.empty()) {
+    const std::string value = node.value.to_string();
+    if (!isNumber(value)) {
+      return;
+    }
+    if (!node.monotonic) {
+      families.add(name, false, Sample{labels, value});
+      return;
+    }
+    // the samples of a counter carry the suffix, so it must not end up in the family name twice
+    const size_t suffix_length = std::strlen(TOTAL_SUFFIX);
+    const bool has_suffix = name.size() > suffix_length && name.compare(name.size() - suffix_length, suffix_length, TOTAL_SUFFIX) == 0;
+    families.add(has_suffix ? name.substr(0, name.size() - suffix_length) : name, true, Sample{labels, value});
+    return;
+  }
+  for (const auto &child : node.children) {
+    collect(child, name, labels, families);
+  }
+}
+
+}  // namespace
+
+const char *OpenMetricsSerializer::CONTENT_TYPE = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+std::string OpenMetricsSerializer::sanitizeName(const std::string &name) {
+  std::string sanitized;
+  sanitized.reserve(name.size());
+  for (const char c : name) {
+    if (std::isalnum(static_cast<unsigned char>(c))) {
+      sanitized += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    } else if (!sanitized.empty() && sanitized.back() != '_') {
+      sanitized += '_';
+    }
+  }
+  while (!sanitized.empty() && sanitized.back() == '_') {
+    sanitized.pop_back();
+  }
+  return sanitized;
+}
+
+std::string OpenMetricsSerializer::escapeLabelValue(const std::string &value) {
+  std::string escaped;
+  escaped.reserve(value.size());
+  for (const char c : value) {
+    switch (c) {
+      case '\\':
+        escaped += "\\\\";
+        break;
+      case '"':
+        escaped += "\\\"";
+        break;
+      case '\n':
+        escaped += "\\n";
+        break;
+      default:
+        escaped += c;
+    }
+  }
+  return escaped;
+}
+
+std::string OpenMetricsSerializer::serialize(const std::vector<std::shared_ptr<response::ResponseNode>> &nodes) {
+  Families families;
+  for (const auto &node : nodes) {
+    if (node == nullptr) {
+      continue;
+    }
+    const std::string prefix = append("minifi", node->getName());
+    for (const auto &entry : node->serialize()) {
+      if (entry.children.empty()) {
+        collect(entry, prefix, "", families);
+        continue;
+      }
+      const std::string labels = "component=\"" + escapeLabelValue(entry.name) + "\"";
+      for (const auto &child : entry.children) {
+        collect(child, prefix, labels, families);
+      }
+    }
+  }
+
+  std::stringstream output;
+  for (const auto &family : families.get()) {
+    output << "# TYPE " << family.name << (family.counter ? " counter\n" : " gauge\n");
+    for (const auto &sample : family.samples) {
+      output << family.name;
+      if (family.counter) {
+        output << TOTAL_SUFFIX;
+      }
+      if (!sample.labels.empty()) {
+        output << "{" << sample.labels << "}";
+      }
+      output << " " << sample.value << "\n";
+    }
+  }
+  output << "# EOF\n";
+  return output.str();
+}
+
+}  // namespace state
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
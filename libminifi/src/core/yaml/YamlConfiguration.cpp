@@ -690,6 +690,34 @@ void YamlConfiguration::parseConnectionYaml(YAML::Node *connectionsNode, core::P
           }
         }
 
+        if (connectionNode["queue prioritizer class"]) {
+          // a single class name, a comma separated list or a sequence of them, in order of precedence
+          std::vector<std::string> prioritizerNames;
+          auto prioritizerNode = connectionNode["queue prioritizer class"];
+          if (prioritizerNode.IsSequence()) {
+            for (const auto &prioritizerName : prioritizerNode) {
+              prioritizerNames.push_back(prioritizerName.as<std::string>());
+            }
+          } else {
+            prioritizerNames = utils::StringUtils::split(prioritizerNode.as<std::string>(), ",");
+          }
+          std::vector<std::shared_ptr<core::FlowFilePrioritizer>> prioritizers;
+          for (const auto &prioritizerName : prioritizerNames) {
+            const std::string trimmedName = utils::StringUtils::trim(prioritizerName);
+            if (trimmedName.empty()) {
+              continue;
+            }
+            auto prioritizer = core::FlowFilePrioritizer::create(trimmedName);
+            if (!prioritizer) {
+              logger_->log_error("Unknown queue prioritizer class %s for connection %s", trimmedName, name);
+              throw std::invalid_argument("Unknown queue prioritizer class " + trimmedName + " for connection " + name);
+            }
+            logger_->log_debug("parseConnection: queue prioritizer class => [%s]", prioritizer->getName());
+            prioritizers.push_back(prioritizer);
+          }
+          connection->setPrioritizers(std::move(prioritizers));
+        }
+
         if (connection) {
           parent->addConnection(connection);
         }
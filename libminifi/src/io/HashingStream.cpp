@@ -0,0 +1,103 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "io/HashingStream.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace io {
+
+constexpr size_t HashingStream::DEFAULT_BUFFER_SIZE;
+
+HashingStream::HashingStream(DataStream *child_stream, std::vector<std::unique_ptr<utils::Hasher>> hashers)
+    : BaseStream(child_stream),
+      hashers_(std::move(hashers)),
+      bytes_hashed_(0) {
+}
+
+int HashingStream::readData(std::vector<uint8_t> &buf, int buflen) {
+  if (buflen < 0) {
+    return -1;
+  }
+  if (buf.size() < static_cast<size_t>(buflen)) {
+    buf.resize(buflen);
+  }
+  return readData(buf.data(), buflen);
+}
+
+int HashingStream::readData(uint8_t *buf, int buflen) {
+  const int ret = composable_stream_->readData(buf, buflen);
+  if (ret > 0) {
+    update(buf, ret);
+  }
+  return ret;
+}
+
+int HashingStream::writeData(uint8_t *value, int size) {
+  const int ret = composable_stream_->writeData(value, size);
+  if (ret > 0) {
+    update(value, ret);
+  }
+  return ret;
+}
+
+int64_t HashingStream::consume(size_t buffer_size) {
+  const uint64_t stream_size = composable_stream_->getSize();
+  if (stream_size > 0) {
+    buffer_size = std::min<uint64_t>(buffer_size, stream_size);
+  }
+  buffer_size = std::max<size_t>(std::min<size_t>(buffer_size, std::numeric_limits<int>::max()), 1);
+  std::vector<uint8_t> buffer(buffer_size);
+
+  int64_t total = 0;
+  int ret;
+  while ((ret = readData(buffer.data(), static_cast<int>(buffer.size()))) > 0) {
+    total += ret;
+  }
+  return ret < 0 ? -1 : total;
+}
+
+std::vector<std::pair<std::string, std::string>> HashingStream::getDigests() {
+  std::vector<std::pair<std::string, std::string>> digests;
+  digests.reserve(hashers_.size());
+  for (const auto &hasher : hashers_) {
+    digests.emplace_back(hasher->getName(), hasher->digest());
+  }
+  return digests;
+}
+
+void HashingStream::update(const uint8_t *data, int length) {
+  for (const auto &hasher : hashers_) {
+    hasher->update(data, length);
+  }
+  bytes_hashed_ += length;
+}
+
+}  // namespace io
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
@@ -38,6 +38,262 @@ namespace provenance {
 std::shared_ptr<utils::IdGenerator> ProvenanceEventRecord::id_generator_ = utils::IdGenerator::getIdGenerator();
 std::shared_ptr<logging::Logger> ProvenanceEventRecord::logger_ = logging::LoggerFactory<ProvenanceEventRecord>::getLogger();
 
+namespace {
+
+/**
+ * Events are encoded compactly: integers as varints, UUIDs as their 16 bytes and well known attribute keys
+ * as indexes into ATTRIBUTE_KEYS. The encoding starts with COMPACT_FORMAT_MARKER, which events written by earlier
+ * versions never start with: their first field is the big endian length of the event UUID, so their first byte is zero.
+ */
+constexpr uint8_t COMPACT_FORMAT_MARKER = 0xFE;
+constexpr uint8_t COMPACT_FORMAT_VERSION = 1;
+
+constexpr uint8_t IDENTIFIER_STRING = 0;
+constexpr uint8_t IDENTIFIER_UUID = 1;
+constexpr size_t UUID_LENGTH = 16;
+constexpr size_t UUID_STRING_LENGTH = 36;
+
+// stored events refer to keys by their position: only ever append to this table
+const char * const ATTRIBUTE_KEYS[] = { "path", "absolute.path", "filename", "uuid", "priority", "mime.type", "discard.reason", "alternate.identifier", "flow.id" };
+constexpr size_t ATTRIBUTE_KEY_COUNT = sizeof(ATTRIBUTE_KEYS) / sizeof(ATTRIBUTE_KEYS[0]);
+
+int hexValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  } else if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+bool isDashPosition(size_t i) {
+  return i == 8 || i == 13 || i == 18 || i == 23;
+}
+
+/**
+ * Parses the canonical lower case form of a UUID. Anything else, including upper case UUIDs,
+ * is rejected so that formatting the bytes always restores the original string.
+ */
+bool parseUuid(const std::string &str, uint8_t *uuid) {
+  if (str.length() != UUID_STRING_LENGTH) {
+    return false;
+  }
+  size_t byte = 0;
+  for (size_t i = 0; i < UUID_STRING_LENGTH; i++) {
+    if (isDashPosition(i)) {
+      if (str[i] != '-') {
+        return false;
+      }
+      continue;
+    }
+    const int high = hexValue(str[i]);
+    const int low = hexValue(str[++i]);
+    if (high < 0 || low < 0) {
+      return false;
+    }
+    uuid[byte++] = static_cast<uint8_t>((high << 4) | low);
+  }
+  return true;
+}
+
+void formatUuid(const uint8_t *uuid, std::string &str) {
+  static const char digits[] = "0123456789abcdef";
+  str.resize(UUID_STRING_LENGTH);
+  size_t byte = 0;
+  for (size_t i = 0; i < UUID_STRING_LENGTH; i++) {
+    if (isDashPosition(i)) {
+      str[i] = '-';
+      continue;
+    }
+    str[i] = digits[uuid[byte] >> 4];
+    str[++i] = digits[uuid[byte++] & 0x0F];
+  }
+}
+
+class CompactWriter {
+ public:
+  explicit CompactWriter(std::vector<uint8_t> &buffer)
+      : buffer_(buffer) {
+  }
+
+  void writeHeader() {
+    buffer_.push_back(COMPACT_FORMAT_MARKER);
+    buffer_.push_back(COMPACT_FORMAT_VERSION);
+  }
+
+  void writeVarInt(uint64_t value) {
+    while (value >= 0x80) {
+      buffer_.push_back(static_cast<uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    buffer_.push_back(static_cast<uint8_t>(value));
+  }
+
+  // zigzag encoding keeps small negative values short
+  void writeSignedVarInt(int64_t value) {
+    writeVarInt((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+  }
+
+  void writeString(const std::string &value) {
+    writeVarInt(value.length());
+    buffer_.insert(buffer_.end(), value.begin(), value.end());
+  }
+
+  void writeIdentifier(const std::string &value) {
+    uint8_t uuid[UUID_LENGTH];
+    if (parseUuid(value, uuid)) {
+      buffer_.push_back(IDENTIFIER_UUID);
+      buffer_.insert(buffer_.end(), uuid, uuid + UUID_LENGTH);
+    } else {
+      buffer_.push_back(IDENTIFIER_STRING);
+      writeString(value);
+    }
+  }
+
+  void writeAttributeKey(const std::string &key) {
+    for (size_t i = 0; i < ATTRIBUTE_KEY_COUNT; i++) {
+      if (key == ATTRIBUTE_KEYS[i]) {
+        writeVarInt(i + 1);
+        return;
+      }
+    }
+    writeVarInt(0);
+    writeString(key);
+  }
+
+ private:
+  std::vector<uint8_t> &buffer_;
+};
+
+/**
+ * Reads the compact encoding in place, every read fails rather than running past the end of the buffer.
+ */
+class CompactReader {
+ public:
+  CompactReader(const uint8_t *buffer, size_t size)
+      : position_(buffer),
+        end_(buffer + size) {
+  }
+
+  bool readHeader() {
+    if (end_ - position_ < 2 || position_[0] != COMPACT_FORMAT_MARKER || position_[1] != COMPACT_FORMAT_VERSION) {
+      return false;
+    }
+    position_ += 2;
+    return true;
+  }
+
+  bool readVarInt(uint64_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && position_ < end_; shift += 7) {
+      const uint8_t byte = *position_++;
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool readSignedVarInt(int64_t &value) {
+    uint64_t encoded;
+    if (!readVarInt(encoded)) {
+      return false;
+    }
+    value = static_cast<int64_t>(encoded >> 1) ^ -static_cast<int64_t>(encoded & 1);
+    return true;
+  }
+
+  bool readString(std::string &value) {
+    uint64_t length;
+    if (!readVarInt(length) || length > static_cast<uint64_t>(end_ - position_)) {
+      return false;
+    }
+    value.assign(reinterpret_cast<const char*>(position_), length);
+    position_ += length;
+    return true;
+  }
+
+  bool skipString() {
+    uint64_t length;
+    if (!readVarInt(length) || length > static_cast<uint64_t>(end_ - position_)) {
+      return false;
+    }
+    position_ += length;
+    return true;
+  }
+
+  bool readIdentifier(std::string &value) {
+    if (position_ >= end_) {
+      return false;
+    }
+    const uint8_t type = *position_++;
+    if (type == IDENTIFIER_STRING) {
+      return readString(value);
+    } else if (type == IDENTIFIER_UUID && static_cast<size_t>(end_ - position_) >= UUID_LENGTH) {
+      formatUuid(position_, value);
+      position_ += UUID_LENGTH;
+      return true;
+    }
+    return false;
+  }
+
+  bool skipIdentifier() {
+    if (position_ >= end_) {
+      return false;
+    }
+    const uint8_t type = *position_++;
+    if (type == IDENTIFIER_STRING) {
+      return skipString();
+    } else if (type == IDENTIFIER_UUID && static_cast<size_t>(end_ - position_) >= UUID_LENGTH) {
+      position_ += UUID_LENGTH;
+      return true;
+    }
+    return false;
+  }
+
+  bool readAttributeKey(std::string &key) {
+    uint64_t index;
+    if (!readVarInt(index)) {
+      return false;
+    }
+    if (index == 0) {
+      return readString(key);
+    } else if (index <= ATTRIBUTE_KEY_COUNT) {
+      key = ATTRIBUTE_KEYS[index - 1];
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  const uint8_t *position_;
+  const uint8_t *end_;
+};
+
+uint64_t getLegacyEventTime(const uint8_t *buffer, const size_t bufferSize) {
+  io::DataStream stream(buffer, bufferSize > 72 ? 72 : bufferSize);
+  io::Serializable reader;
+
+  std::string uuid;
+  if (reader.readUTF(uuid, &stream) <= 0) {
+    return 0;
+  }
+
+  uint32_t eventType;
+  if (reader.read(eventType, &stream) != 4) {
+    return 0;
+  }
+
+  uint64_t event_time;
+  if (reader.read(event_time, &stream) != 8) {
+    return 0;
+  }
+  return event_time;
+}
+
+}  // namespace
+
 const char *ProvenanceEventRecord::ProvenanceEventTypeStr[REPLAY + 1] = { "CREATE", "RECEIVE", "FETCH", "SEND", "DOWNLOAD", "DROP", "EXPIRE", "FORK", "JOIN", "CLONE", "CONTENT_MODIFIED",
     "ATTRIBUTES_MODIFIED", "ROUTE", "ADDINFO", "REPLAY" };
 
@@ -72,167 +328,172 @@ bool ProvenanceEventRecord::DeSerialize(const std::shared_ptr<core::Serializable
     logger_->log_debug("NiFi Provenance Read event %s", uuidStr_);
   }
 
-  org::apache::nifi::minifi::io::DataStream stream((const uint8_t*) value.data(), value.length());
-
-  ret = DeSerialize(stream);
+  ret = DeSerialize(reinterpret_cast<const uint8_t*>(value.data()), value.length());
 
   if (ret) {
-    logger_->log_debug("NiFi Provenance retrieve event %s size %llu eventType %d success", uuidStr_, stream.getSize(), _eventType);
+    logger_->log_debug("NiFi Provenance retrieve event %s size %llu eventType %d success", uuidStr_, value.length(), _eventType);
   } else {
-    logger_->log_debug("NiFi Provenance retrieve event %s size %llu eventType %d fail", uuidStr_, stream.getSize(), _eventType);
+    logger_->log_debug("NiFi Provenance retrieve event %s size %llu eventType %d fail", uuidStr_, value.length(), _eventType);
   }
 
   return ret;
 }
 
-bool ProvenanceEventRecord::Serialize(org::apache::nifi::minifi::io::DataStream& outStream) {
-  int ret;
-
-  ret = writeUTF(this->uuidStr_, &outStream);
-  if (ret <= 0) {
-    return false;
+uint64_t ProvenanceEventRecord::getEventTime(const uint8_t *buffer, const size_t bufferSize) {
+  CompactReader reader(buffer, bufferSize);
+  uint64_t eventType;
+  uint64_t eventTime;
+  if (!reader.readHeader()) {
+    return getLegacyEventTime(buffer, bufferSize);
   }
-
-  uint32_t eventType = this->_eventType;
-  ret = write(eventType, &outStream);
-  if (ret != 4) {
-    return false;
-  }
-
-  ret = write(this->_eventTime, &outStream);
-  if (ret != 8) {
-    return false;
+  if (!reader.skipIdentifier() || !reader.readVarInt(eventType) || !reader.readVarInt(eventTime)) {
+    return 0;
   }
+  return eventTime;
+}
 
-  ret = write(this->_entryDate, &outStream);
-  if (ret != 8) {
+bool ProvenanceEventRecord::getIdentifiers(const uint8_t *buffer, const size_t bufferSize, std::string &uuid, std::string &componentId, std::string &flowFileUuid) {
+  CompactReader reader(buffer, bufferSize);
+  if (!reader.readHeader()) {
     return false;
   }
+  // skip event type, event time, entry date, duration and lineage start date
+  uint64_t value;
+  int64_t delta;
+  return reader.readIdentifier(uuid) && reader.readVarInt(value) && reader.readVarInt(value) && reader.readSignedVarInt(delta) && reader.readVarInt(value) && reader.readSignedVarInt(delta)
+      && reader.readIdentifier(componentId) && reader.skipString() && reader.readIdentifier(flowFileUuid);
+}
 
-  ret = write(this->_eventDuration, &outStream);
-  if (ret != 8) {
-    return false;
+bool ProvenanceEventRecord::Serialize(org::apache::nifi::minifi::io::DataStream& outStream) {
+  std::vector<uint8_t> buffer;
+  buffer.reserve(256 + _details.size() + _contentFullPath.size() + _transitUri.size());
+  CompactWriter writer(buffer);
+
+  writer.writeHeader();
+  writer.writeIdentifier(uuidStr_);
+  writer.writeVarInt(_eventType);
+  writer.writeVarInt(_eventTime);
+  // entry and lineage start dates are close to the event time, their differences encode in a few bytes
+  writer.writeSignedVarInt(static_cast<int64_t>(_eventTime - _entryDate));
+  writer.writeVarInt(_eventDuration);
+  writer.writeSignedVarInt(static_cast<int64_t>(_eventTime - _lineageStartDate));
+  writer.writeIdentifier(_componentId);
+  writer.writeString(_componentType);
+  writer.writeIdentifier(flow_uuid_);
+  writer.writeString(_details);
+
+  writer.writeVarInt(_attributes.size());
+  for (const auto& itAttribute : _attributes) {
+    writer.writeAttributeKey(itAttribute.first);
+    writer.writeString(itAttribute.second);
   }
 
-  ret = write(this->_lineageStartDate, &outStream);
-  if (ret != 8) {
-    return false;
-  }
+  writer.writeString(_contentFullPath);
+  writer.writeVarInt(_size);
+  writer.writeVarInt(_offset);
+  writer.writeIdentifier(_sourceQueueIdentifier);
 
-  ret = writeUTF(this->_componentId, &outStream);
-  if (ret <= 0) {
-    return false;
+  if (this->_eventType == ProvenanceEventRecord::FORK || this->_eventType == ProvenanceEventRecord::CLONE || this->_eventType == ProvenanceEventRecord::JOIN) {
+    writer.writeVarInt(_parentUuids.size());
+    for (const auto& parentUUID : _parentUuids) {
+      writer.writeIdentifier(parentUUID);
+    }
+    writer.writeVarInt(_childrenUuids.size());
+    for (const auto& childUUID : _childrenUuids) {
+      writer.writeIdentifier(childUUID);
+    }
+  } else if (this->_eventType == ProvenanceEventRecord::SEND || this->_eventType == ProvenanceEventRecord::FETCH) {
+    writer.writeString(_transitUri);
+  } else if (this->_eventType == ProvenanceEventRecord::RECEIVE) {
+    writer.writeString(_transitUri);
+    writer.writeString(_sourceSystemFlowFileIdentifier);
   }
 
-  ret = writeUTF(this->_componentType, &outStream);
-  if (ret <= 0) {
-    return false;
-  }
+  return outStream.writeData(buffer.data(), buffer.size()) == static_cast<int>(buffer.size());
+}
 
-  ret = writeUTF(this->flow_uuid_, &outStream);
-  if (ret <= 0) {
-    return false;
-  }
+bool ProvenanceEventRecord::Serialize(const std::shared_ptr<core::SerializableComponent> &repo) {
+  org::apache::nifi::minifi::io::DataStream outStream;
 
-  ret = writeUTF(this->_details, &outStream);
-  if (ret <= 0) {
-    return false;
-  }
+  Serialize(outStream);
 
-  // write flow attributes
-  uint32_t numAttributes = this->_attributes.size();
-  ret = write(numAttributes, &outStream);
-  if (ret != 4) {
-    return false;
+  // Persist to the DB
+  if (!repo->Serialize(uuidStr_, const_cast<uint8_t*>(outStream.getBuffer()), outStream.getSize())) {
+    logger_->log_error("NiFi Provenance Store event %s size %llu fail", uuidStr_, outStream.getSize());
   }
+  return true;
+}
 
-  for (const auto& itAttribute : _attributes) {
-    ret = writeUTF(itAttribute.first, &outStream, true);
-    if (ret <= 0) {
-      return false;
-    }
-    ret = writeUTF(itAttribute.second, &outStream, true);
-    if (ret <= 0) {
-      return false;
-    }
+bool ProvenanceEventRecord::DeSerialize(const uint8_t *buffer, const size_t bufferSize) {
+  CompactReader reader(buffer, bufferSize);
+  if (!reader.readHeader()) {
+    return DeSerializeLegacy(buffer, bufferSize);
   }
 
-  ret = writeUTF(this->_contentFullPath, &outStream);
-  if (ret <= 0) {
+  uint64_t eventType;
+  int64_t entryDelta;
+  int64_t lineageDelta;
+  if (!reader.readIdentifier(uuidStr_) || !reader.readVarInt(eventType) || !reader.readVarInt(_eventTime) || !reader.readSignedVarInt(entryDelta) || !reader.readVarInt(_eventDuration)
+      || !reader.readSignedVarInt(lineageDelta)) {
     return false;
   }
+  _eventType = (ProvenanceEventRecord::ProvenanceEventType) eventType;
+  _entryDate = _eventTime - static_cast<uint64_t>(entryDelta);
+  _lineageStartDate = _eventTime - static_cast<uint64_t>(lineageDelta);
 
-  ret = write(this->_size, &outStream);
-  if (ret != 8) {
+  if (!reader.readIdentifier(_componentId) || !reader.readString(_componentType) || !reader.readIdentifier(flow_uuid_) || !reader.readString(_details)) {
     return false;
   }
 
-  ret = write(this->_offset, &outStream);
-  if (ret != 8) {
+  uint64_t numAttributes;
+  if (!reader.readVarInt(numAttributes)) {
     return false;
   }
+  for (uint64_t i = 0; i < numAttributes; i++) {
+    std::string key;
+    std::string value;
+    if (!reader.readAttributeKey(key) || !reader.readString(value)) {
+      return false;
+    }
+    _attributes.set(key, std::move(value));
+  }
 
-  ret = writeUTF(this->_sourceQueueIdentifier, &outStream);
-  if (ret <= 0) {
+  if (!reader.readString(_contentFullPath) || !reader.readVarInt(_size) || !reader.readVarInt(_offset) || !reader.readIdentifier(_sourceQueueIdentifier)) {
     return false;
   }
 
   if (this->_eventType == ProvenanceEventRecord::FORK || this->_eventType == ProvenanceEventRecord::CLONE || this->_eventType == ProvenanceEventRecord::JOIN) {
-    // write UUIDs
-    uint32_t number = this->_parentUuids.size();
-    ret = write(number, &outStream);
-    if (ret != 4) {
+    uint64_t number;
+    if (!reader.readVarInt(number)) {
       return false;
     }
-    for (const auto& parentUUID : _parentUuids) {
-      ret = writeUTF(parentUUID, &outStream);
-      if (ret <= 0) {
+    for (uint64_t i = 0; i < number; i++) {
+      std::string parentUUID;
+      if (!reader.readIdentifier(parentUUID)) {
         return false;
       }
+      this->addParentUuid(parentUUID);
     }
-    number = this->_childrenUuids.size();
-    ret = write(number, &outStream);
-    if (ret != 4) {
+    if (!reader.readVarInt(number)) {
       return false;
     }
-    for (const auto& childUUID : _childrenUuids) {
-      ret = writeUTF(childUUID, &outStream);
-      if (ret <= 0) {
+    for (uint64_t i = 0; i < number; i++) {
+      std::string childUUID;
+      if (!reader.readIdentifier(childUUID)) {
         return false;
       }
+      this->addChildUuid(childUUID);
     }
   } else if (this->_eventType == ProvenanceEventRecord::SEND || this->_eventType == ProvenanceEventRecord::FETCH) {
-    ret = writeUTF(this->_transitUri, &outStream);
-    if (ret <= 0) {
-      return false;
-    }
+    return reader.readString(_transitUri);
   } else if (this->_eventType == ProvenanceEventRecord::RECEIVE) {
-    ret = writeUTF(this->_transitUri, &outStream);
-    if (ret <= 0) {
-      return false;
-    }
-    ret = writeUTF(this->_sourceSystemFlowFileIdentifier, &outStream);
-    if (ret <= 0) {
-      return false;
-    }
+    return reader.readString(_transitUri) && reader.readString(_sourceSystemFlowFileIdentifier);
   }
 
   return true;
 }
 
-bool ProvenanceEventRecord::Serialize(const std::shared_ptr<core::SerializableComponent> &repo) {
-  org::apache::nifi::minifi::io::DataStream outStream;
-
-  Serialize(outStream);
-
-  // Persist to the DB
-  if (!repo->Serialize(uuidStr_, const_cast<uint8_t*>(outStream.getBuffer()), outStream.getSize())) {
-    logger_->log_error("NiFi Provenance Store event %s size %llu fail", uuidStr_, outStream.getSize());
-  }
-  return true;
-}
-
-bool ProvenanceEventRecord::DeSerialize(const uint8_t *buffer, const size_t bufferSize) {
+bool ProvenanceEventRecord::DeSerializeLegacy(const uint8_t *buffer, const size_t bufferSize) {
   int ret;
 
   org::apache::nifi::minifi::io::DataStream outStream(buffer, bufferSize);
@@ -309,7 +570,7 @@ bool ProvenanceEventRecord::DeSerialize(const uint8_t *buffer, const size_t buff
     if (ret <= 0) {
       return false;
     }
-    this->_attributes[key] = value;
+    this->_attributes.set(key, std::move(value));
   }
 
   ret = readUTF(this->_contentFullPath, &outStream);
@@ -391,6 +652,7 @@ void ProvenanceReporter::commit() {
   }
 
   std::vector<std::pair<std::string, std::unique_ptr<io::DataStream>>> flowData;
+  flowData.reserve(_events.size());
 
   for (auto& event : _events) {
     std::unique_ptr<io::DataStream> stramptr(new io::DataStream());
@@ -0,0 +1,132 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "provenance/ProvenancePolicy.h"
+
+#include <exception>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "core/logging/LoggerConfiguration.h"
+#include "core/Property.h"
+#include "provenance/Provenance.h"
+#include "utils/HashUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtil.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace provenance {
+
+namespace {
+
+/**
+ * Looks up a property overridden for the component before falling back on the agent wide value.
+ */
+bool getComponentProperty(const Configure &configure, const char *key, const std::string &component_uuid, const std::string &component_name, std::string &value) {
+  const std::string prefix = std::string(key) + ".";
+  return (!component_uuid.empty() && configure.get(prefix + component_uuid, value)) || (!component_name.empty() && configure.get(prefix + component_name, value)) || configure.get(key, value);
+}
+
+}  // namespace
+
+ProvenancePolicy::ProvenancePolicy(uint32_t excluded_types, double sampling_percentage, uint64_t rate_limit)
+    : excluded_types_(excluded_types),
+      sampling_(sampling_percentage < 100.0),
+      // 2^64 scaled by the sampling ratio
+      sampling_threshold_(sampling_percentage <= 0.0 ? 0 : sampling_percentage >= 100.0 ? std::numeric_limits<uint64_t>::max() : static_cast<uint64_t>(sampling_percentage / 100.0 * 18446744073709551616.0)),
+      rate_limit_(rate_limit),
+      window_(0),
+      window_count_(0) {
+}
+
+std::shared_ptr<ProvenancePolicy> ProvenancePolicy::create(const Configure &configure, const std::string &component_uuid, const std::string &component_name) {
+  auto logger = logging::LoggerFactory<ProvenancePolicy>::getLogger();
+
+  uint32_t excluded_types = 0;
+  std::string value;
+  if (getComponentProperty(configure, Configure::nifi_provenance_excluded_event_types, component_uuid, component_name, value)) {
+    for (const auto &type_name : utils::StringUtils::split(value, ",")) {
+      const std::string type = utils::StringUtils::trim(type_name);
+      bool found = false;
+      for (int type_index = ProvenanceEventRecord::CREATE; type_index <= ProvenanceEventRecord::REPLAY; type_index++) {
+        if (type == ProvenanceEventRecord::ProvenanceEventTypeStr[type_index]) {
+          excluded_types |= 1u << type_index;
+          found = true;
+        }
+      }
+      if (!found && !type.empty()) {
+        logger->log_warn("Unknown provenance event type %s is ignored", type);
+      }
+    }
+  }
+
+  double sampling_percentage = 100.0;
+  if (getComponentProperty(configure, Configure::nifi_provenance_sampling_percentage, component_uuid, component_name, value)) {
+    try {
+      sampling_percentage = std::stod(value);
+    } catch (const std::exception &) {
+      logger->log_warn("Invalid provenance sampling percentage %s, every FlowFile is sampled", value);
+    }
+  }
+
+  int64_t rate_limit = 0;
+  if (getComponentProperty(configure, Configure::nifi_provenance_rate_limit, component_uuid, component_name, value) && !core::Property::StringToInt(value, rate_limit)) {
+    logger->log_warn("Invalid provenance rate limit %s, events are not limited", value);
+    rate_limit = 0;
+  }
+
+  if (excluded_types == 0 && sampling_percentage >= 100.0 && rate_limit <= 0) {
+    return nullptr;
+  }
+  logger->log_debug("Provenance policy of %s: excluded event types %u, sampling %f%%, limit %lld events/s", component_name, excluded_types, sampling_percentage, rate_limit);
+  return std::make_shared<ProvenancePolicy>(excluded_types, sampling_percentage, rate_limit > 0 ? rate_limit : 0);
+}
+
+bool ProvenancePolicy::isEnabled(int event_type, const std::string &flow_file_uuid) const {
+  if (excluded_types_ & (1u << event_type)) {
+    return false;
+  }
+  if (sampling_) {
+    utils::XXHash64Hasher hasher;
+    hasher.update(reinterpret_cast<const uint8_t*>(flow_file_uuid.data()), flow_file_uuid.length());
+    return hasher.digestValue() < sampling_threshold_;
+  }
+  return true;
+}
+
+bool ProvenancePolicy::acquire() {
+  if (rate_limit_ == 0) {
+    return true;
+  }
+  const uint64_t window = getTimeMillis() / 1000;
+  uint64_t current = window_.load();
+  if (current != window && window_.compare_exchange_strong(current, window)) {
+    window_count_ = 0;
+  }
+  return ++window_count_ <= rate_limit_;
+}
+
+}  // namespace provenance
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
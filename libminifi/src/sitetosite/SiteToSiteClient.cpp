@@ -447,18 +447,17 @@ int16_t SiteToSiteClient::send(std::string transactionID, DataPacket *packet, co
     return -1;
   }
 
-  std::map<std::string, std::string>::iterator itAttribute;
-  for (itAttribute = packet->_attributes.begin(); itAttribute != packet->_attributes.end(); itAttribute++) {
-    ret = transaction->getStream().writeUTF(itAttribute->first, true);
+  for (const auto& attribute : packet->_attributes) {
+    ret = transaction->getStream().writeUTF(attribute.first, true);
 
     if (ret <= 0) {
       return -1;
     }
-    ret = transaction->getStream().writeUTF(itAttribute->second, true);
+    ret = transaction->getStream().writeUTF(attribute.second, true);
     if (ret <= 0) {
       return -1;
     }
-    logger_->log_debug("Site2Site transaction %s send attribute key %s value %s", transactionID, itAttribute->first, itAttribute->second);
+    logger_->log_debug("Site2Site transaction %s send attribute key %s value %s", transactionID, attribute.first, attribute.second);
   }
 
   bool flowfile_has_content = (flowFile != nullptr);
@@ -609,7 +608,7 @@ bool SiteToSiteClient::receive(std::string transactionID, DataPacket *packet, bo
     if (ret <= 0) {
       return false;
     }
-    packet->_attributes[key] = value;
+    packet->_attributes.set(key, value);
     logger_->log_debug("Site2Site transaction %s receives attribute key %s value %s", transactionID, key, value);
   }
 
@@ -684,12 +683,11 @@ bool SiteToSiteClient::receiveFlowFiles(const std::shared_ptr<core::ProcessConte
       if (!flowFile) {
         throw Exception(SITE2SITE_EXCEPTION, "Flow File Creation Failed");
       }
-      std::map<std::string, std::string>::iterator it;
       std::string sourceIdentifier;
-      for (it = packet._attributes.begin(); it != packet._attributes.end(); it++) {
-        if (it->first == FlowAttributeKey(UUID))
-          sourceIdentifier = it->second;
-        flowFile->addAttribute(it->first, it->second);
+      for (const auto& attribute : packet._attributes) {
+        if (attribute.first == FlowAttributeKey(UUID))
+          sourceIdentifier = attribute.second;
+        flowFile->addAttribute(attribute.first, attribute.second);
       }
 
       if (packet._size > 0) {
@@ -0,0 +1,81 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/AdaptiveLimit.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+
+constexpr double AdaptiveLimit::TOLERANCE;
+constexpr double AdaptiveLimit::LATENCY_SMOOTHING;
+constexpr double AdaptiveLimit::LIMIT_SMOOTHING;
+constexpr double AdaptiveLimit::BACKOFF;
+constexpr double AdaptiveLimit::CPU_HEADROOM;
+
+AdaptiveLimit::AdaptiveLimit(uint16_t min_limit, uint16_t max_limit, double cpu_budget, uint16_t initial_limit)
+    : min_limit_((std::max)(min_limit, uint16_t(1))),
+      max_limit_((std::max)(min_limit_, double(max_limit))),
+      cpu_budget_(cpu_budget),
+      limit_((std::min)((std::max)(double(initial_limit), min_limit_), max_limit_)),
+      long_latency_(0) {
+}
+
+uint16_t AdaptiveLimit::update(const ConcurrencySample &sample) {
+  const bool cpu_known = sample.cpu_cores >= 0 && cpu_budget_ > 0;
+  if (cpu_known && sample.cpu_cores > cpu_budget_) {
+    // react at once, oversubscription slows everything down
+    limit_ *= BACKOFF;
+  } else {
+    double gradient = 1.0;
+    if (sample.tasks > 0) {
+      const double latency = double(sample.task_nanos) / sample.tasks;
+      long_latency_ = long_latency_ > 0 ? long_latency_ * (1 - LATENCY_SMOOTHING) + latency * LATENCY_SMOOTHING : latency;
+      if (latency > 0) {
+        gradient = (std::max)(0.5, (std::min)(1.0, TOLERANCE * long_latency_ / latency));
+      }
+    }
+    double new_limit = limit_ * gradient;
+    if (sample.queued > 0) {
+      if (!cpu_known || sample.cpu_cores < cpu_budget_ * CPU_HEADROOM) {
+        new_limit += std::sqrt(limit_);
+      }
+    } else if (sample.period_nanos > 0 && double(sample.task_nanos) / sample.period_nanos < limit_ / 2) {
+      // most of the threads had nothing to do
+      new_limit -= 1;
+    }
+    limit_ = limit_ * (1 - LIMIT_SMOOTHING) + new_limit * LIMIT_SMOOTHING;
+  }
+  limit_ = (std::min)((std::max)(limit_, min_limit_), max_limit_);
+  return getLimit();
+}
+
+uint16_t AdaptiveLimit::getLimit() const {
+  return static_cast<uint16_t>(std::lround(limit_));
+}
+
+} /* namespace utils */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -0,0 +1,262 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/HashUtils.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef OPENSSL_SUPPORT
+#include <openssl/evp.h>
+#endif
+
+#include "utils/StringUtils.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+
+namespace {
+
+constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotl64(uint64_t x, int r) {
+  return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t readLE64(const uint8_t *p) {
+  uint64_t v = 0;
+  for (int i = 7; i >= 0; --i) {
+    v = (v << 8) | p[i];
+  }
+  return v;
+}
+
+inline uint32_t readLE32(const uint8_t *p) {
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint64_t xxh64Round(uint64_t acc, uint64_t input) {
+  acc += input * PRIME64_2;
+  acc = rotl64(acc, 31);
+  return acc * PRIME64_1;
+}
+
+inline uint64_t xxh64MergeRound(uint64_t acc, uint64_t val) {
+  acc ^= xxh64Round(0, val);
+  return acc * PRIME64_1 + PRIME64_4;
+}
+
+#ifdef OPENSSL_SUPPORT
+/**
+ * Digest backed by the OpenSSL EVP interface, which dispatches to the
+ * hardware accelerated implementations (SHA-NI, ARMv8 crypto extensions) when available.
+ */
+class EVPHasher : public Hasher {
+ public:
+  EVPHasher(std::string name, const EVP_MD *md)
+      : name_(std::move(name)),
+        ctx_(EVP_MD_CTX_create()) {
+    EVP_DigestInit_ex(ctx_, md, nullptr);
+  }
+
+  EVPHasher(const EVPHasher&) = delete;
+  EVPHasher& operator=(const EVPHasher&) = delete;
+
+  ~EVPHasher() override {
+    EVP_MD_CTX_destroy(ctx_);
+  }
+
+  std::string getName() const override {
+    return name_;
+  }
+
+  void update(const uint8_t *data, size_t length) override {
+    EVP_DigestUpdate(ctx_, data, length);
+  }
+
+  std::string digest() override {
+    unsigned char md[EVP_MAX_MD_SIZE];
+    unsigned int md_length = 0;
+    EVP_DigestFinal_ex(ctx_, md, &md_length);
+    return StringUtils::to_hex(md, md_length, true /*uppercase*/);
+  }
+
+ private:
+  std::string name_;
+  EVP_MD_CTX *ctx_;
+};
+
+const EVP_MD *getEVPDigest(const std::string &normalized_name) {
+  if (normalized_name == "MD5") {
+    return EVP_md5();
+  } else if (normalized_name == "SHA1") {
+    return EVP_sha1();
+  } else if (normalized_name == "SHA224") {
+    return EVP_sha224();
+  } else if (normalized_name == "SHA256") {
+    return EVP_sha256();
+  } else if (normalized_name == "SHA384") {
+    return EVP_sha384();
+  } else if (normalized_name == "SHA512") {
+    return EVP_sha512();
+  }
+  return nullptr;
+}
+#endif
+
+}  // namespace
+
+XXHash64Hasher::XXHash64Hasher(uint64_t seed)
+    : seed_(seed),
+      total_length_(0),
+      mem_size_(0) {
+  v_[0] = seed + PRIME64_1 + PRIME64_2;
+  v_[1] = seed + PRIME64_2;
+  v_[2] = seed;
+  v_[3] = seed - PRIME64_1;
+}
+
+void XXHash64Hasher::update(const uint8_t *data, size_t length) {
+  total_length_ += length;
+
+  if (mem_size_ + length < sizeof(mem_)) {
+    std::memcpy(mem_ + mem_size_, data, length);
+    mem_size_ += length;
+    return;
+  }
+
+  const uint8_t *p = data;
+  const uint8_t * const end = data + length;
+
+  if (mem_size_ > 0) {
+    const size_t fill = sizeof(mem_) - mem_size_;
+    std::memcpy(mem_ + mem_size_, p, fill);
+    for (int i = 0; i < 4; ++i) {
+      v_[i] = xxh64Round(v_[i], readLE64(mem_ + 8 * i));
+    }
+    p += fill;
+    mem_size_ = 0;
+  }
+
+  while (static_cast<size_t>(end - p) >= sizeof(mem_)) {
+    v_[0] = xxh64Round(v_[0], readLE64(p));
+    v_[1] = xxh64Round(v_[1], readLE64(p + 8));
+    v_[2] = xxh64Round(v_[2], readLE64(p + 16));
+    v_[3] = xxh64Round(v_[3], readLE64(p + 24));
+    p += sizeof(mem_);
+  }
+
+  if (p < end) {
+    mem_size_ = end - p;
+    std::memcpy(mem_, p, mem_size_);
+  }
+}
+
+uint64_t XXHash64Hasher::digestValue() const {
+  uint64_t h;
+  if (total_length_ >= sizeof(mem_)) {
+    h = rotl64(v_[0], 1) + rotl64(v_[1], 7) + rotl64(v_[2], 12) + rotl64(v_[3], 18);
+    for (int i = 0; i < 4; ++i) {
+      h = xxh64MergeRound(h, v_[i]);
+    }
+  } else {
+    h = seed_ + PRIME64_5;
+  }
+  h += total_length_;
+
+  const uint8_t *p = mem_;
+  const uint8_t * const end = mem_ + mem_size_;
+  while (p + 8 <= end) {
+    h ^= xxh64Round(0, readLE64(p));
+    h = rotl64(h, 27) * PRIME64_1 + PRIME64_4;
+    p += 8;
+  }
+  if (p + 4 <= end) {
+    h ^= static_cast<uint64_t>(readLE32(p)) * PRIME64_1;
+    h = rotl64(h, 23) * PRIME64_2 + PRIME64_3;
+    p += 4;
+  }
+  while (p < end) {
+    h ^= (*p) * PRIME64_5;
+    h = rotl64(h, 11) * PRIME64_1;
+    ++p;
+  }
+
+  h ^= h >> 33;
+  h *= PRIME64_2;
+  h ^= h >> 29;
+  h *= PRIME64_3;
+  h ^= h >> 32;
+  return h;
+}
+
+std::string XXHash64Hasher::digest() {
+  // canonical representation is big endian
+  const uint64_t value = digestValue();
+  uint8_t canonical[8];
+  for (int i = 0; i < 8; ++i) {
+    canonical[i] = static_cast<uint8_t>(value >> (56 - 8 * i));
+  }
+  return StringUtils::to_hex(canonical, sizeof(canonical), true /*uppercase*/);
+}
+
+std::string HashUtils::normalizeAlgorithmName(const std::string &name) {
+  std::string normalized = StringUtils::trim(name);
+  std::transform(normalized.begin(), normalized.end(), normalized.begin(), ::toupper);
+  normalized.erase(std::remove(normalized.begin(), normalized.end(), '-'), normalized.end());
+  return normalized;
+}
+
+std::unique_ptr<Hasher> HashUtils::createHasher(const std::string &name) {
+  const std::string normalized = normalizeAlgorithmName(name);
+  if (normalized == "XXH64") {
+    return std::unique_ptr<Hasher>(new XXHash64Hasher());
+  }
+#ifdef OPENSSL_SUPPORT
+  const EVP_MD *md = getEVPDigest(normalized);
+  if (md != nullptr) {
+    return std::unique_ptr<Hasher>(new EVPHasher(normalized, md));
+  }
+#endif
+  return nullptr;
+}
+
+std::vector<std::string> HashUtils::getSupportedAlgorithms() {
+#ifdef OPENSSL_SUPPORT
+  return {"MD5", "SHA1", "SHA224", "SHA256", "SHA384", "SHA512", "XXH64"};
+#else
+  return {"XXH64"};
+#endif
+}
+
+}  // namespace utils
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
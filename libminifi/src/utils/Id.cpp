@@ -30,6 +30,7 @@
 #include <cmath>
 #include <cstdio>
 #include <memory>
+#include <random>
 #include <string>
 #include <limits>
 #include "core/logging/LoggerConfiguration.h"
@@ -74,6 +75,65 @@ namespace {
 }  // namespace
 #endif
 
+namespace {
+
+// Number of consecutive timestamps or minifi uid counter values a thread reserves at once
+constexpr uint64_t ID_BLOCK_SIZE = 1024;
+
+// 100ns intervals between the Gregorian calendar reform (1582-10-15) and the unix epoch
+constexpr uint64_t UUID_EPOCH_OFFSET = 0x01B21DD213814000ULL;
+
+std::atomic<uint64_t> next_epoch(1);
+
+/**
+ * Per thread generator state, so that the common case takes no lock and touches
+ * no shared cache line.
+ */
+struct ThreadIdState {
+  uint64_t epoch = 0;
+  uint64_t next_timestamp = 0;
+  uint64_t timestamp_end = 0;
+  uint64_t next_counter = 0;
+  uint64_t counter_end = 0;
+  std::unique_ptr<std::mt19937_64> random;
+};
+
+ThreadIdState& getThreadIdState(uint64_t epoch) {
+  static thread_local ThreadIdState state;
+  if (state.epoch != epoch) {
+    state.epoch = epoch;
+    state.next_timestamp = state.timestamp_end = 0;
+    state.next_counter = state.counter_end = 0;
+  }
+  return state;
+}
+
+uint64_t currentUuidTimestamp() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count() / 100 + UUID_EPOCH_OFFSET;
+}
+
+void writeBigEndian(uint64_t value, unsigned char* output) {
+  for (int i = 0; i < 8; i++) {
+    output[i] = (value >> ((7 - i) * 8)) & std::numeric_limits<unsigned char>::max();
+  }
+}
+
+// "00" .. "ff" for every byte value
+struct HexTable {
+  char digits[256][2];
+  HexTable() {
+    static const char hex[] = "0123456789abcdef";
+    for (int i = 0; i < 256; i++) {
+      digits[i][0] = hex[i >> 4];
+      digits[i][1] = hex[i & 0x0f];
+    }
+  }
+};
+
+const HexTable hex_table;
+
+}  // namespace
+
 Identifier::Identifier(UUID_FIELD u)
     : IdentifierBase(u) {
   build_string();
@@ -143,11 +203,11 @@ bool Identifier::operator!=(const std::nullptr_t nullp) const {
 }
 
 bool Identifier::operator!=(const Identifier &other) const {
-  return converted_ != other.converted_;
+  return !(*this == other);
 }
 
 bool Identifier::operator==(const Identifier &other) const {
-  return converted_ == other.converted_;
+  return converted_.empty() == other.converted_.empty() && memcmp(id_, other.id_, sizeof(id_)) == 0;
 }
 
 std::string Identifier::to_string() const {
@@ -159,14 +219,16 @@ const unsigned char * const Identifier::toArray() const {
 }
 
 void Identifier::build_string() {
-  char uuidStr[37];
-  snprintf(uuidStr, sizeof(uuidStr), "%02hhx%02hhx%02hhx%02hhx-%02hhx%02hhx-%02hhx%02hhx-%02hhx%02hhx-%02hhx%02hhx%02hhx%02hhx%02hhx%02hhx",
-      id_[0], id_[1], id_[2], id_[3],
-      id_[4], id_[5],
-      id_[6], id_[7],
-      id_[8], id_[9],
-      id_[10], id_[11], id_[12], id_[13], id_[14], id_[15]);
-  converted_ = uuidStr;
+  char uuidStr[36];
+  char* out = uuidStr;
+  for (int i = 0; i < 16; i++) {
+    if (i == 4 || i == 6 || i == 8 || i == 10) {
+      *out++ = '-';
+    }
+    *out++ = hex_table.digits[id_[i]][0];
+    *out++ = hex_table.digits[id_[i]][1];
+  }
+  converted_.assign(uuidStr, sizeof(uuidStr));
 }
 
 uint64_t timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
@@ -179,10 +241,13 @@ NonRepeatingStringGenerator::NonRepeatingStringGenerator()
 IdGenerator::IdGenerator()
     : implementation_(UUID_TIME_IMPL),
       logger_(logging::LoggerFactory<IdGenerator>::getLogger()),
-      incrementor_(0) {
+      incrementor_(0),
+      epoch_(next_epoch++),
+      last_timestamp_(0) {
 #ifndef WIN32
   uuid_impl_ = std::unique_ptr<uuid>(new uuid());
 #endif
+  initializeTimeSuffix();
 }
 
 IdGenerator::~IdGenerator() = default;
@@ -275,6 +340,30 @@ void IdGenerator::initialize(const std::shared_ptr<Properties> & properties) {
   } else {
     logging::LOG_DEBUG(logger_) << "Using uuid_generate_time implementation for uids.";
   }
+  // blocks reserved under the previous configuration must not be used anymore
+  epoch_ = next_epoch++;
+}
+
+void IdGenerator::initializeTimeSuffix() {
+  // the node comes from the system uuid implementation, the clock sequence is random
+  UUID_FIELD time_uuid;
+#ifdef WIN32
+  windowsUuidGenerateTime(time_uuid);
+#else
+  if (!generateWithUuidImpl(UUID_MAKE_V1, time_uuid)) {
+    std::random_device random;
+    for (int i = 10; i < 16; i++) {
+      time_uuid[i] = random() & std::numeric_limits<unsigned char>::max();
+    }
+    // no hardware address, mark the node as a random multicast one
+    time_uuid[10] |= 0x01;
+  }
+#endif
+  std::random_device random;
+  uint16_t clock_sequence = random() & 0x3fff;
+  time_suffix_[0] = 0x80 | (clock_sequence >> 8);
+  time_suffix_[1] = clock_sequence & std::numeric_limits<unsigned char>::max();
+  std::memcpy(time_suffix_ + 2, time_uuid + 10, 6);
 }
 
 #ifndef WIN32
@@ -301,32 +390,69 @@ Identifier IdGenerator::generate() {
   return ident;
 }
 
+void IdGenerator::generateRandom(UUID_FIELD output) {
+  ThreadIdState& state = getThreadIdState(epoch_);
+  if (!state.random) {
+    std::random_device device;
+    std::seed_seq seed{device(), device(), device(), device(), device(), device(), device(), device()};
+    state.random.reset(new std::mt19937_64(seed));
+  }
+  writeBigEndian((*state.random)(), output);
+  writeBigEndian((*state.random)(), output + 8);
+  // version 4, RFC 4122 variant
+  output[6] = 0x40 | (output[6] & 0x0f);
+  output[8] = 0x80 | (output[8] & 0x3f);
+}
+
+void IdGenerator::generateTime(UUID_FIELD output) {
+  ThreadIdState& state = getThreadIdState(epoch_);
+  const uint64_t now = currentUuidTimestamp();
+  // a block that ran out or fell behind the clock is replaced by one starting at the current time
+  if (state.next_timestamp == state.timestamp_end || state.timestamp_end <= now) {
+    uint64_t last = last_timestamp_.load();
+    uint64_t start;
+    do {
+      start = (std::max)(now, last + 1);
+    } while (!last_timestamp_.compare_exchange_weak(last, start + ID_BLOCK_SIZE - 1));
+    state.next_timestamp = start;
+    state.timestamp_end = start + ID_BLOCK_SIZE;
+  }
+  const uint64_t timestamp = state.next_timestamp++;
+  // time_low, time_mid and time_hi_and_version of RFC 4122, version 1
+  output[0] = (timestamp >> 24) & 0xff;
+  output[1] = (timestamp >> 16) & 0xff;
+  output[2] = (timestamp >> 8) & 0xff;
+  output[3] = timestamp & 0xff;
+  output[4] = (timestamp >> 40) & 0xff;
+  output[5] = (timestamp >> 32) & 0xff;
+  output[6] = 0x10 | ((timestamp >> 56) & 0x0f);
+  output[7] = (timestamp >> 48) & 0xff;
+  std::memcpy(output + 8, time_suffix_, sizeof(time_suffix_));
+}
+
+void IdGenerator::generateMinifiUid(UUID_FIELD output) {
+  ThreadIdState& state = getThreadIdState(epoch_);
+  if (state.next_counter == state.counter_end) {
+    state.next_counter = incrementor_.fetch_add(ID_BLOCK_SIZE);
+    state.counter_end = state.next_counter + ID_BLOCK_SIZE;
+  }
+  std::memcpy(output, deterministic_prefix_, sizeof(deterministic_prefix_));
+  writeBigEndian(state.next_counter++, output + 8);
+}
+
 void IdGenerator::generate(Identifier &ident) {
   UUID_FIELD output;
   switch (implementation_) {
     case UUID_RANDOM_IMPL:
     case UUID_DEFAULT_IMPL:
-#ifdef WIN32
-      windowsUuidGenerateRandom(output);
-#else
-      generateWithUuidImpl(UUID_MAKE_V4, output);
-#endif
+      generateRandom(output);
+      break;
+    case MINIFI_UID_IMPL:
+      generateMinifiUid(output);
       break;
-    case MINIFI_UID_IMPL: {
-      std::memcpy(output, deterministic_prefix_, sizeof(deterministic_prefix_));
-      uint64_t incrementor_value = incrementor_++;
-      for (int i = 8; i < 16; i++) {
-        output[i] = (incrementor_value >> ((15 - i) * 8)) & std::numeric_limits<unsigned char>::max();
-      }
-    }
-    break;
     case UUID_TIME_IMPL:
     default:
-#ifdef WIN32
-      windowsUuidGenerateTime(output);
-#else
-      generateWithUuidImpl(UUID_MAKE_V1, output);
-#endif
+      generateTime(output);
       break;
   }
   ident = output;
@@ -18,9 +18,15 @@
 
 #include "utils/RegexUtils.h"
 #include "Exception.h"
+#include <algorithm>
 #include <iostream>
+#include <utility>
 #include <vector>
 
+#ifdef RE2_SUPPORT
+#include <re2/re2.h>
+#endif
+
 namespace org {
 namespace apache {
 namespace nifi {
@@ -38,6 +44,24 @@ Regex::Regex(const std::string &value,
   if (regexStr_.empty())
     return;
 
+#ifdef RE2_SUPPORT
+  RE2::Options options;
+  options.set_log_errors(false);
+  for (const auto m : mode) {
+    switch (m) {
+      case Mode::ICASE:
+        options.set_case_sensitive(false);
+        break;
+    }
+  }
+  compiledRegex_.reset(new RE2(regexStr_, options));
+  if (!compiledRegex_->ok()) {
+    const std::string error = compiledRegex_->error();
+    compiledRegex_.reset();
+    throw Exception(REGEX_EXCEPTION, error);
+  }
+  valid_ = true;
+#else
   // Create regex mode
 #ifdef NO_MORE_REGFREEE
   regex_mode_ = std::regex_constants::ECMAScript;
@@ -72,15 +96,16 @@ Regex::Regex(const std::string &value,
     throw Exception(REGEX_EXCEPTION, std::string(msg.begin(), msg.end()));
   }
   valid_ = true;
-  int maxGroups = std::count(regexStr_.begin(), regexStr_.end(), '(') + 1;
-  matches_.resize(maxGroups);
+  maxGroups_ = std::count(regexStr_.begin(), regexStr_.end(), '(') + 1;
+#endif
 #endif
 }
 
 Regex::Regex(Regex&& other)
-#ifndef NO_MORE_REGFREEE
+#if !defined(RE2_SUPPORT) && !defined(NO_MORE_REGFREEE)
   : valid_(false),
-    regex_mode_(REG_EXTENDED)
+    regex_mode_(REG_EXTENDED),
+    maxGroups_(0)
 #endif
 {
   *this = std::move(other);
@@ -91,20 +116,20 @@ Regex& Regex::operator=(Regex&& other) {
     return *this;
   }
 
-  pat_ = std::move(other.pat_);
   suffix_ = std::move(other.suffix_);
   regexStr_ = std::move(other.regexStr_);
   results_ = std::move(other.results_);
-#ifdef NO_MORE_REGFREEE
+#if defined(RE2_SUPPORT)
+  compiledRegex_ = std::move(other.compiledRegex_);
+#elif defined(NO_MORE_REGFREEE)
   compiledRegex_ = std::move(other.compiledRegex_);
   regex_mode_ = other.regex_mode_;
-  matches_ = std::move(other.matches_);
 #else
   if (valid_)
     regfree(&compiledRegex_);
   compiledRegex_ = other.compiledRegex_;
   regex_mode_ = other.regex_mode_;
-  matches_ = std::move(other.matches_);
+  maxGroups_ = other.maxGroups_;
 #endif
   valid_ = other.valid_;
   other.valid_ = false;
@@ -112,45 +137,63 @@ Regex& Regex::operator=(Regex&& other) {
 }
 
 Regex::~Regex() {
-#ifndef NO_MORE_REGFREEE
+#if !defined(RE2_SUPPORT) && !defined(NO_MORE_REGFREEE)
   if (valid_)
     regfree(&compiledRegex_);
 #endif
 }
 
 bool Regex::match(const std::string &pattern) {
-  if (!valid_) {
+  results_.clear();
+  size_t match_end = 0;
+  if (!search(pattern, 0, results_, match_end)) {
     return false;
   }
-  results_.clear();
-  pat_ = pattern;
-#ifdef NO_MORE_REGFREEE
-  if (std::regex_search(pattern, matches_, compiledRegex_)) {
-    for (const auto &m : matches_) {
-      results_.push_back(m.str());
-    }
-    suffix_ = matches_.suffix();
-    return true;
+  suffix_ = match_end >= pattern.size() ? "" : pattern.substr(match_end);
+  return true;
+}
+
+bool Regex::search(const std::string &input, size_t offset, std::vector<std::string> &results, size_t &match_end) const {
+  results.clear();
+  if (!valid_ || offset > input.size()) {
+    return false;
+  }
+#if defined(RE2_SUPPORT)
+  const re2::StringPiece text(input.data() + offset, input.size() - offset);
+  const int groups = compiledRegex_->NumberOfCapturingGroups() + 1;
+  std::vector<re2::StringPiece> matches(groups);
+  if (!compiledRegex_->Match(text, 0, text.size(), RE2::UNANCHORED, matches.data(), groups)) {
+    return false;
+  }
+  for (const auto &m : matches) {
+    results.emplace_back(m.data() == nullptr ? std::string() : std::string(m.data(), m.size()));
   }
-  return false;
+  match_end = offset + (matches[0].data() - text.data()) + matches[0].size();
+  return true;
+#elif defined(NO_MORE_REGFREEE)
+  std::smatch matches;
+  if (!std::regex_search(input.begin() + offset, input.end(), matches, compiledRegex_)) {
+    return false;
+  }
+  for (const auto &m : matches) {
+    results.push_back(m.str());
+  }
+  match_end = offset + matches.position(0) + matches.length(0);
+  return true;
 #else
-  if (regexec(&compiledRegex_, pattern.c_str(), matches_.size(),
-              matches_.data(), 0) == 0) {
-    for (const auto &m : matches_) {
-      if (m.rm_so == -1) {
-        break;
-      }
-      std::string s(pattern.begin() + m.rm_so, pattern.begin() + m.rm_eo);
-      results_.push_back(s);
-    }
-    if ((size_t) matches_[0].rm_eo >= pattern.size()) {
-      suffix_ = "";
-    } else {
-      suffix_ = pattern.substr(matches_[0].rm_eo);
+  std::vector<regmatch_t> matches(maxGroups_);
+  const char *text = input.c_str() + offset;
+  if (regexec(&compiledRegex_, text, matches.size(), matches.data(), 0) != 0) {
+    return false;
+  }
+  for (const auto &m : matches) {
+    if (m.rm_so == -1) {
+      break;
     }
-    return true;
+    results.emplace_back(text + m.rm_so, text + m.rm_eo);
   }
-  return false;
+  match_end = offset + matches[0].rm_eo;
+  return true;
 #endif
 }
 
@@ -159,7 +202,9 @@ const std::vector<std::string>& Regex::getResult() const { return results_; }
 const std::string& Regex::getSuffix() const { return suffix_; }
 
 bool Regex::matchesFullInput(const std::string &regex, const std::string &input) {
-#ifdef NO_MORE_REGFREEE
+#if defined(RE2_SUPPORT)
+  return RE2::FullMatch(input, RE2(regex));
+#elif defined(NO_MORE_REGFREEE)
   std::regex re{regex};
   return std::regex_match(input, re);
 #else
@@ -0,0 +1,226 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/ThreadAffinity.h"
+
+#ifdef __linux__
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "utils/StringUtils.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+
+ThreadAffinity::ThreadAffinity() = default;
+
+ThreadAffinity::ThreadAffinity(Policy policy, const std::vector<int> &cores, const Topology &topology) {
+  std::map<int, int> nodes;
+  for (size_t node = 0; node < topology.size(); node++) {
+    for (int core : topology[node]) {
+      nodes[core] = static_cast<int>(node);
+    }
+  }
+
+  if (policy == EXPLICIT) {
+    for (int core : cores) {
+      const auto node = nodes.find(core);
+      placement_.emplace_back(core, node != nodes.end() ? node->second : 0);
+    }
+    return;
+  }
+  if (policy == NONE) {
+    return;
+  }
+
+  const std::set<int> allowed(cores.begin(), cores.end());
+  std::vector<std::vector<int>> usable;
+  for (const auto &node_cores : topology) {
+    usable.emplace_back();
+    for (int core : node_cores) {
+      if (allowed.empty() || allowed.count(core) > 0) {
+        usable.back().push_back(core);
+      }
+    }
+  }
+
+  if (policy == COMPACT) {
+    for (size_t node = 0; node < usable.size(); node++) {
+      for (int core : usable[node]) {
+        placement_.emplace_back(core, static_cast<int>(node));
+      }
+    }
+  } else {
+    // take turns between the nodes until all their cores are used
+    for (size_t index = 0, added = 1; added > 0; index++) {
+      added = 0;
+      for (size_t node = 0; node < usable.size(); node++) {
+        if (index < usable[node].size()) {
+          placement_.emplace_back(usable[node][index], static_cast<int>(node));
+          added++;
+        }
+      }
+    }
+  }
+}
+
+int ThreadAffinity::getCore(size_t worker) const {
+  if (placement_.empty()) {
+    return -1;
+  }
+  return placement_[worker % placement_.size()].first;
+}
+
+int ThreadAffinity::getNode(size_t worker) const {
+  if (placement_.empty()) {
+    return 0;
+  }
+  return placement_[worker % placement_.size()].second;
+}
+
+bool ThreadAffinity::pinCurrentThread(int core) {
+#ifdef __linux__
+  if (core < 0 || core >= CPU_SETSIZE) {
+    return false;
+  }
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(core, &cpus);
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+#else
+  return false;
+#endif
+}
+
+ThreadAffinity::Topology ThreadAffinity::detectTopology() {
+  Topology topology;
+#ifdef __linux__
+  // cores outside of the process' cpuset cannot be used anyway
+  std::set<int> allowed;
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  if (sched_getaffinity(0, sizeof(cpus), &cpus) == 0) {
+    for (int core = 0; core < CPU_SETSIZE; core++) {
+      if (CPU_ISSET(core, &cpus)) {
+        allowed.insert(core);
+      }
+    }
+  }
+
+  std::map<int, std::vector<int>> nodes;
+  if (DIR *dir = opendir("/sys/devices/system/node")) {
+    while (struct dirent *entry = readdir(dir)) {
+      const std::string name = entry->d_name;
+      if (name.compare(0, 4, "node") != 0 || name.size() == 4 || name.find_first_not_of("0123456789", 4) != std::string::npos) {
+        continue;
+      }
+      std::ifstream cpulist("/sys/devices/system/node/" + name + "/cpulist");
+      std::string list;
+      std::vector<int> cores;
+      if (std::getline(cpulist, list) && parseCoreList(list, cores)) {
+        auto &node_cores = nodes[std::atoi(name.c_str() + 4)];
+        for (int core : cores) {
+          if (allowed.empty() || allowed.count(core) > 0) {
+            node_cores.push_back(core);
+          }
+        }
+      }
+    }
+    closedir(dir);
+  }
+  for (auto &node : nodes) {
+    if (!node.second.empty()) {
+      topology.push_back(std::move(node.second));
+    }
+  }
+  if (topology.empty() && !allowed.empty()) {
+    topology.emplace_back(allowed.begin(), allowed.end());
+  }
+#endif
+  if (topology.empty()) {
+    topology.emplace_back();
+    for (unsigned core = 0; core < (std::max)(std::thread::hardware_concurrency(), 1U); core++) {
+      topology.back().push_back(static_cast<int>(core));
+    }
+  }
+  return topology;
+}
+
+bool ThreadAffinity::parsePolicy(const std::string &policy, Policy &out) {
+  const std::string name = StringUtils::trim(policy);
+  if (name.empty() || StringUtils::equalsIgnoreCase(name, "none")) {
+    out = NONE;
+  } else if (StringUtils::equalsIgnoreCase(name, "compact")) {
+    out = COMPACT;
+  } else if (StringUtils::equalsIgnoreCase(name, "scatter")) {
+    out = SCATTER;
+  } else if (StringUtils::equalsIgnoreCase(name, "explicit")) {
+    out = EXPLICIT;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool ThreadAffinity::parseCoreList(const std::string &cores, std::vector<int> &out) {
+  std::vector<int> parsed;
+  for (const auto &range : StringUtils::split(cores, ",")) {
+    const std::string trimmed = StringUtils::trim(range);
+    if (trimmed.empty()) {
+      continue;
+    }
+    const auto dash = trimmed.find('-');
+    const std::string first = trimmed.substr(0, dash);
+    const std::string last = dash == std::string::npos ? first : trimmed.substr(dash + 1);
+    if (first.empty() || last.empty() || first.find_first_not_of("0123456789") != std::string::npos || last.find_first_not_of("0123456789") != std::string::npos
+        || first.size() > 6 || last.size() > 6) {
+      return false;
+    }
+    const int from = std::atoi(first.c_str());
+    const int to = std::atoi(last.c_str());
+    if (to < from) {
+      return false;
+    }
+    for (int core = from; core <= to; core++) {
+      parsed.push_back(core);
+    }
+  }
+  out = std::move(parsed);
+  return true;
+}
+
+} /* namespace utils */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
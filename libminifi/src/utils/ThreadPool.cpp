@@ -27,6 +27,10 @@ namespace utils {
 template<typename T>
 void ThreadPool<T>::run_tasks(std::shared_ptr<WorkerThread> thread) {
   thread->is_running_ = true;
+  if (thread->core_ >= 0) {
+    // memory the thread touches first is then allocated on its node as well
+    ThreadAffinity::pinCurrentThread(thread->core_);
+  }
   while (running_.load()) {
     if (UNLIKELY(thread_reduction_count_ > 0)) {
       if (--thread_reduction_count_ >= 0) {
@@ -39,21 +43,37 @@ void ThreadPool<T>::run_tasks(std::shared_ptr<WorkerThread> thread) {
     }
 
     Worker<T> task;
-    if (worker_queue_.dequeueWait(task)) {
+    if (dequeueTask(*thread, task)) {
       {
         std::unique_lock<std::mutex> lock(worker_queue_mutex_);
         if (!task_status_[task.getIdentifier()]) {
+          taskFinished(task.getIdentifier());
           continue;
         }
       }
-      if (task.run()) {
+      bool run_again;
+      if (sample_tasks_.load(std::memory_order_relaxed)) {
+        const auto start = std::chrono::steady_clock::now();
+        run_again = task.run();
+        task_nanos_ += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        completed_tasks_++;
+      } else {
+        run_again = task.run();
+      }
+      if (run_again) {
         if (task.getNextExecutionTime() <= std::chrono::steady_clock::now()) {
           // it can be rescheduled again as soon as there is a worker available
-          worker_queue_.enqueue(std::move(task));
+          auto &queue = getWorkerQueue(task, thread->queue_);
+          queue.enqueue(std::move(task));
           continue;
         }
         // Task will be put to the delayed queue as next exec time is in the future
         std::unique_lock<std::mutex> lock(worker_queue_mutex_);
+        if (!task_status_[task.getIdentifier()]) {
+          // stopped while running, there is no point in waiting for the next execution
+          taskFinished(task.getIdentifier());
+          continue;
+        }
         bool need_to_notify =
             delayed_worker_queue_.empty() ||
                 task.getNextExecutionTime() < delayed_worker_queue_.top().getNextExecutionTime();
@@ -62,11 +82,14 @@ void ThreadPool<T>::run_tasks(std::shared_ptr<WorkerThread> thread) {
         if (need_to_notify) {
           delayed_task_available_.notify_all();
         }
+      } else {
+        std::unique_lock<std::mutex> lock(worker_queue_mutex_);
+        taskFinished(task.getIdentifier());
       }
     } else {
       // This means that the threadpool is running, but the ConcurrentQueue is stopped -> shouldn't happen during normal conditions
       // Might happen during startup or shutdown for a very short time
-      if (running_.load()) {
+      if (running_.load() && thread_reduction_count_ <= 0) {
         std::this_thread::sleep_for(std::chrono::milliseconds(1));
       }
     }
@@ -85,7 +108,8 @@ void ThreadPool<T>::manage_delayed_queue() {
       // I'm very sorry for this - committee must has been seriously drunk when the interface of prio queue was submitted.
       Worker<T> task = std::move(const_cast<Worker<T>&>(delayed_worker_queue_.top()));
       delayed_worker_queue_.pop();
-      worker_queue_.enqueue(std::move(task));
+      auto &queue = getWorkerQueue(task, next_queue_++);
+      queue.enqueue(std::move(task));
     }
     if (delayed_worker_queue_.empty()) {
       delayed_task_available_.wait(lock);
@@ -102,21 +126,91 @@ bool ThreadPool<T>::execute(Worker<T> &&task, std::future<T> &future) {
   {
     std::unique_lock<std::mutex> lock(worker_queue_mutex_);
     task_status_[task.getIdentifier()] = true;
+    tasks_by_identifier_[task.getIdentifier()]++;
   }
   future = std::move(task.getPromise()->get_future());
-  worker_queue_.enqueue(std::move(task));
+  auto &queue = getWorkerQueue(task, next_queue_++);
+  queue.enqueue(std::move(task));
 
   task_count_++;
 
   return true;
 }
 
+template<typename T>
+bool ThreadPool<T>::dequeueTask(const WorkerThread &thread, Worker<T> &task) {
+  if (worker_queues_.size() == 1) {
+    return worker_queues_.front()->dequeueWait(task);
+  }
+  auto &own_queue = *worker_queues_[thread.queue_];
+  while (running_ && thread_reduction_count_ <= 0) {
+    if (own_queue.dequeueWaitFor(task, std::chrono::milliseconds(10))) {
+      return true;
+    }
+    if (!own_queue.isRunning()) {
+      return false;
+    }
+    // nothing to do on this node, help out the others
+    for (size_t i = 1; i < worker_queues_.size(); i++) {
+      if (worker_queues_[(thread.queue_ + i) % worker_queues_.size()]->tryDequeue(task)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+template<typename T>
+ConditionConcurrentQueue<Worker<T>> &ThreadPool<T>::getWorkerQueue(const Worker<T> &task, size_t queue) {
+  if (worker_queues_.size() == 1) {
+    return *worker_queues_.front();
+  }
+  const int placement = task.getPlacement();
+  return *worker_queues_[(placement >= 0 ? static_cast<size_t>(placement) : queue) % worker_queues_.size()];
+}
+
+template<typename T>
+void ThreadPool<T>::createWorkerQueues() {
+  node_queues_.clear();
+  for (int i = 0; i < (std::max)(max_worker_threads_, 1); i++) {
+    node_queues_.emplace(affinity_.getNode(i), node_queues_.size());
+  }
+  if (node_queues_.size() != worker_queues_.size()) {
+    worker_queues_.clear();
+    for (size_t i = 0; i < node_queues_.size(); i++) {
+      worker_queues_.emplace_back(new ConditionConcurrentQueue<Worker<T>>());
+    }
+  }
+}
+
+template<typename T>
+void ThreadPool<T>::placeWorker(WorkerThread &thread, size_t index) {
+  thread.core_ = affinity_.getCore(index);
+  const auto queue = node_queues_.find(affinity_.getNode(index));
+  thread.queue_ = queue != node_queues_.end() ? queue->second : index % worker_queues_.size();
+}
+
+template<typename T>
+void ThreadPool<T>::addWorker() {
+  std::stringstream thread_name;
+  thread_name << name_ << " #" << thread_queue_.size();
+  auto worker_thread = std::make_shared<WorkerThread>(thread_name.str());
+  placeWorker(*worker_thread, thread_queue_.size());
+  worker_thread->thread_ = createThread(std::bind(&ThreadPool::run_tasks, this, worker_thread));
+  if (daemon_threads_) {
+    worker_thread->thread_.detach();
+  }
+  thread_queue_.push_back(worker_thread);
+  current_workers_++;
+}
+
 template<typename T>
 void ThreadPool<T>::manageWorkers() {
   for (int i = 0; i < max_worker_threads_; i++) {
     std::stringstream thread_name;
     thread_name << name_ << " #" << i;
     auto worker_thread = std::make_shared<WorkerThread>(thread_name.str());
+    placeWorker(*worker_thread, i);
     worker_thread->thread_ = createThread(std::bind(&ThreadPool::run_tasks, this, worker_thread));
     thread_queue_.push_back(worker_thread);
     current_workers_++;
@@ -128,32 +222,49 @@ void ThreadPool<T>::manageWorkers() {
     }
   }
 
-  if (nullptr != thread_manager_) {
+  auto thread_manager = getThreadManager();
+  if (nullptr != thread_manager) {
+    auto last_sample = std::chrono::steady_clock::now();
     while (running_) {
-      auto waitperiod = std::chrono::milliseconds(500);
+      auto waitperiod = thread_manager->getAdjustmentPeriod();
       {
         std::unique_lock<std::recursive_mutex> lock(manager_mutex_, std::try_to_lock);
         if (!lock.owns_lock()) {
           // Threadpool is being stopped/started or config is being changed, better wait a bit
           std::this_thread::sleep_for(std::chrono::milliseconds(10));
         }
-        if (thread_manager_->isAboveMax(current_workers_)) {
-          auto max = thread_manager_->getMaxConcurrentTasks();
+        const auto now = std::chrono::steady_clock::now();
+        ConcurrencySample sample;
+        sample.tasks = completed_tasks_.exchange(0);
+        sample.task_nanos = task_nanos_.exchange(0);
+        sample.period_nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(now - last_sample).count();
+        for (const auto &queue : worker_queues_) {
+          sample.queued += queue->size();
+        }
+        last_sample = now;
+        const int alive_workers = current_workers_ - thread_reduction_count_;
+        const int target = (std::min)(thread_manager->getTargetThreads(name_, sample, (std::max)(alive_workers, 0)), thread_manager->getMaxThreads());
+        if (target > 0) {
+          // the manager sizes the pool itself
+          if (target < alive_workers) {
+            thread_reduction_count_ += alive_workers - target;
+          } else if (target > alive_workers && thread_reduction_count_ == 0) {
+            std::unique_lock<std::mutex> lock(worker_queue_mutex_);
+            while (current_workers_ < target) {
+              addWorker();
+            }
+          }
+        } else if (thread_manager->isAboveMax(current_workers_)) {
+          auto max = thread_manager->getMaxThreads();
           auto differential = current_workers_ - max;
           thread_reduction_count_ += differential;
-        } else if (thread_manager_->shouldReduce()) {
+        } else if (thread_manager->shouldReduce()) {
           if (current_workers_ > 1)
             thread_reduction_count_++;
-          thread_manager_->reduce();
-        } else if (thread_manager_->canIncrease() && max_worker_threads_ > current_workers_) {  // increase slowly
+          thread_manager->reduce();
+        } else if (thread_manager->canIncrease() && max_worker_threads_ > current_workers_) {  // increase slowly
           std::unique_lock<std::mutex> lock(worker_queue_mutex_);
-          auto worker_thread = std::make_shared<WorkerThread>();
-          worker_thread->thread_ = createThread(std::bind(&ThreadPool::run_tasks, this, worker_thread));
-          if (daemon_threads_) {
-            worker_thread->thread_.detach();
-          }
-          thread_queue_.push_back(worker_thread);
-          current_workers_++;
+          addWorker();
         }
         std::shared_ptr<WorkerThread> thread_ref;
         while (deceased_thread_queue_.tryDequeue(thread_ref)) {
@@ -177,15 +288,18 @@ template<typename T>
 void ThreadPool<T>::start() {
   if (nullptr != controller_service_provider_) {
     auto thread_man = controller_service_provider_->getControllerService("ThreadPoolManager");
-    thread_manager_ = thread_man != nullptr ? std::dynamic_pointer_cast<controllers::ThreadManagementService>(thread_man) : nullptr;
+    std::atomic_store(&thread_manager_, thread_man != nullptr ? std::dynamic_pointer_cast<controllers::ThreadManagementService>(thread_man) : nullptr);
   } else {
-    thread_manager_ = nullptr;
+    std::atomic_store(&thread_manager_, std::shared_ptr<controllers::ThreadManagementService>());
   }
+  sample_tasks_ = getThreadManager() != nullptr;
 
   std::lock_guard<std::recursive_mutex> lock(manager_mutex_);
   if (!running_) {
     running_ = true;
-    worker_queue_.start();
+    for (auto &queue : worker_queues_) {
+      queue->start();
+    }
     manager_thread_ = std::thread(&ThreadPool::manageWorkers, this);
 
     std::lock_guard<std::mutex> quee_lock(worker_queue_mutex_);
@@ -197,6 +311,37 @@ template<typename T>
 void ThreadPool<T>::stopTasks(const std::string &identifier) {
   std::unique_lock<std::mutex> lock(worker_queue_mutex_);
   task_status_[identifier] = false;
+
+  // delayed tasks are let go right away instead of when they would be executed next
+  std::vector<Worker<T>> delayed_tasks;
+  while (!delayed_worker_queue_.empty()) {
+    delayed_tasks.push_back(std::move(const_cast<Worker<T>&>(delayed_worker_queue_.top())));
+    delayed_worker_queue_.pop();
+  }
+  for (auto &task : delayed_tasks) {
+    if (task.getIdentifier() == identifier) {
+      taskFinished(identifier);
+    } else {
+      delayed_worker_queue_.push(std::move(task));
+    }
+  }
+}
+
+template<typename T>
+bool ThreadPool<T>::waitForStoppedTasks(const std::string &identifier, std::chrono::milliseconds timeout) {
+  std::unique_lock<std::mutex> lock(worker_queue_mutex_);
+  return task_finished_.wait_for(lock, timeout, [&] {
+    return tasks_by_identifier_.find(identifier) == tasks_by_identifier_.end();
+  });
+}
+
+template<typename T>
+void ThreadPool<T>::taskFinished(const std::string &identifier) {
+  auto tasks = tasks_by_identifier_.find(identifier);
+  if (tasks != tasks_by_identifier_.end() && --tasks->second == 0) {
+    tasks_by_identifier_.erase(tasks);
+    task_finished_.notify_all();
+  }
 }
 
 template<typename T>
@@ -228,7 +373,13 @@ void ThreadPool<T>::shutdown() {
       delayed_worker_queue_.pop();
     }
 
-    worker_queue_.clear();
+    for (auto &queue : worker_queues_) {
+      queue->clear();
+    }
+
+    std::lock_guard<std::mutex> queue_lock(worker_queue_mutex_);
+    tasks_by_identifier_.clear();
+    task_finished_.notify_all();
   }
 }
 
@@ -250,6 +250,7 @@ bool TestPlan::runNextProcessor(std::function<void(const std::shared_ptr<core::P
   std::shared_ptr<core::ProcessSessionFactory> factory = std::make_shared<core::ProcessSessionFactory>(context);
   factories_.push_back(factory);
   if (std::find(configured_processors_.begin(), configured_processors_.end(), processor) == configured_processors_.end()) {
+    context->onSchedule();
     processor->onSchedule(context, factory);
     configured_processors_.push_back(processor);
   }
@@ -121,3 +121,70 @@ TEST_CASE("Test time limit", "[timeLimitTest]") {
 
   verifyMaxKeyCount(provdb, 400);
 }
+
+TEST_CASE("Test reading from a persisted cursor", "[cursorTest]") {
+  TestController testController;
+
+  char dirtemplate[] = "/var/tmp/db.XXXXXX";
+  auto temp_dir = testController.createTempDirectory(dirtemplate);
+  REQUIRE(!temp_dir.empty());
+
+  auto configuration = std::make_shared<org::apache::nifi::minifi::Configure>();
+  configuration->set(minifi::Configure::nifi_provenance_repository_secondary_indexes, "true");
+
+  auto provdb = std::make_shared<minifi::provenance::ProvenanceRepository>("TestProvRepo", temp_dir, MAX_PROVENANCE_ENTRY_LIFE_TIME, TEST_MAX_PROVENANCE_STORAGE_SIZE, 1000);
+  REQUIRE(provdb->initialize(configuration));
+
+  std::vector<std::string> event_ids;
+  for (int i = 0; i < 10; ++i) {
+    minifi::provenance::ProvenanceEventRecord record(minifi::provenance::ProvenanceEventRecord::CREATE, i < 5 ? "first" : "second", "componenttype");
+    REQUIRE(record.Serialize(provdb));
+    event_ids.push_back(record.getEventId());
+  }
+
+  std::string value;
+  REQUIRE(provdb->Get(event_ids[3], value));
+
+  std::function<std::shared_ptr<core::SerializableComponent>()> constructor = []() {return std::make_shared<minifi::provenance::ProvenanceEventRecord>();};
+  std::string position;
+  REQUIRE_FALSE(provdb->getCursor("reader", position));
+
+  std::vector<std::shared_ptr<core::SerializableComponent>> records;
+  size_t batch = 4;
+  REQUIRE(provdb->DeSerialize(records, batch, constructor, position));
+  REQUIRE(batch == 4);
+  for (size_t i = 0; i < records.size(); ++i) {
+    REQUIRE(std::static_pointer_cast<minifi::provenance::ProvenanceEventRecord>(records[i])->getEventId() == event_ids[i]);
+  }
+
+  REQUIRE(provdb->setCursor("reader", position));
+  REQUIRE(provdb->DeleteRange("", position));
+  REQUIRE_FALSE(provdb->Get(event_ids[0], value));
+  REQUIRE(provdb->Get(event_ids[4], value));
+
+  std::vector<std::shared_ptr<minifi::provenance::ProvenanceEventRecord>> events;
+  REQUIRE(provdb->getEventsByComponent("first", events, 10));
+  REQUIRE(events.size() == 1);
+  REQUIRE(events[0]->getEventId() == event_ids[4]);
+
+  // reopen the repository, the cursor and the key order must survive
+  provdb->destroy();
+  provdb = std::make_shared<minifi::provenance::ProvenanceRepository>("TestProvRepo", temp_dir, MAX_PROVENANCE_ENTRY_LIFE_TIME, TEST_MAX_PROVENANCE_STORAGE_SIZE, 1000);
+  REQUIRE(provdb->initialize(configuration));
+
+  minifi::provenance::ProvenanceEventRecord record(minifi::provenance::ProvenanceEventRecord::CREATE, "third", "componenttype");
+  REQUIRE(record.Serialize(provdb));
+  event_ids.push_back(record.getEventId());
+
+  std::string restored;
+  REQUIRE(provdb->getCursor("reader", restored));
+  REQUIRE(restored == position);
+
+  records.clear();
+  batch = 10;
+  REQUIRE(provdb->DeSerialize(records, batch, constructor, restored));
+  REQUIRE(batch == 7);
+  for (size_t i = 0; i < records.size(); ++i) {
+    REQUIRE(std::static_pointer_cast<minifi::provenance::ProvenanceEventRecord>(records[i])->getEventId() == event_ids[i + 4]);
+  }
+}
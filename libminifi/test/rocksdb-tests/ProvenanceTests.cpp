@@ -163,3 +163,86 @@ TEST_CASE("Test Provenance record serialization NoOp", "[Testprovenance::Provena
   record2.setEventId(eventId);
   REQUIRE(record2.DeSerialize(testRepository) == false);
 }
+
+TEST_CASE("Test Provenance record compact encoding", "[Testprovenance::ProvenanceEventRecordCompact]") {
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::VolatileContentRepository>();
+  std::map<std::string, std::string> attributes;
+  attributes.insert(std::pair<std::string, std::string>("filename", "data.txt"));
+  attributes.insert(std::pair<std::string, std::string>("potato", "potatoe"));
+  std::shared_ptr<core::Repository> frepo = std::make_shared<core::repository::VolatileProvenanceRepository>();
+  frepo->initialize(0);
+  std::shared_ptr<core::FlowFile> flow = std::make_shared<minifi::FlowFileRecord>(frepo, content_repo, attributes);
+
+  provenance::ProvenanceEventRecord record1(provenance::ProvenanceEventRecord::ProvenanceEventType::RECEIVE, "not a uuid", "componenttype");
+  record1.fromFlowFile(flow);
+  record1.setTransitUri("http://localhost:8080");
+  record1.setSourceSystemFlowFileIdentifier("source");
+  record1.setEventDuration(65555);
+
+  minifi::io::DataStream stream;
+  REQUIRE(record1.Serialize(stream));
+
+  provenance::ProvenanceEventRecord record2;
+  REQUIRE(record2.DeSerialize(stream));
+  REQUIRE(record2.getEventId() == record1.getEventId());
+  REQUIRE(record2.getEventType() == record1.getEventType());
+  REQUIRE(record2.getEventTime() == record1.getEventTime());
+  REQUIRE(record2.getFlowFileEntryDate() == record1.getFlowFileEntryDate());
+  REQUIRE(record2.getlineageStartDate() == record1.getlineageStartDate());
+  REQUIRE(record2.getEventDuration() == 65555);
+  REQUIRE(record2.getComponentId() == "not a uuid");
+  REQUIRE(record2.getComponentType() == "componenttype");
+  REQUIRE(record2.getFlowFileUuid() == flow->getUUIDStr());
+  REQUIRE(record2.getAttributes() == record1.getAttributes());
+  REQUIRE(record2.getTransitUri() == "http://localhost:8080");
+  REQUIRE(record2.getSourceSystemFlowFileIdentifier() == "source");
+
+  REQUIRE(provenance::ProvenanceEventRecord::getEventTime(stream.getBuffer(), stream.getSize()) == record1.getEventTime());
+  std::string uuid;
+  std::string componentId;
+  std::string flowFileUuid;
+  REQUIRE(provenance::ProvenanceEventRecord::getIdentifiers(stream.getBuffer(), stream.getSize(), uuid, componentId, flowFileUuid));
+  REQUIRE(uuid == record1.getEventId());
+  REQUIRE(componentId == "not a uuid");
+  REQUIRE(flowFileUuid == flow->getUUIDStr());
+
+  // truncated events are rejected rather than read past their end
+  provenance::ProvenanceEventRecord record3;
+  REQUIRE_FALSE(record3.DeSerialize(stream.getBuffer(), stream.getSize() - 1));
+}
+
+TEST_CASE("Test Provenance record written by earlier versions", "[Testprovenance::ProvenanceEventRecordLegacy]") {
+  minifi::io::DataStream stream;
+  minifi::io::Serializable writer;
+  writer.writeUTF("8a1d8f50-1c2b-11ea-8f83-7bd3c1a1b0e4", &stream);
+  writer.write(static_cast<uint32_t>(provenance::ProvenanceEventRecord::SEND), &stream);
+  writer.write(static_cast<uint64_t>(1000), &stream);  // event time
+  writer.write(static_cast<uint64_t>(900), &stream);  // entry date
+  writer.write(static_cast<uint64_t>(5), &stream);  // duration
+  writer.write(static_cast<uint64_t>(800), &stream);  // lineage start date
+  writer.writeUTF("componentid", &stream);
+  writer.writeUTF("componenttype", &stream);
+  writer.writeUTF("9b2e9061-1c2b-11ea-8f83-7bd3c1a1b0e4", &stream);
+  writer.writeUTF("details", &stream);
+  writer.write(static_cast<uint32_t>(1), &stream);
+  writer.writeUTF("filename", &stream, true);
+  writer.writeUTF("a.txt", &stream, true);
+  writer.writeUTF("", &stream);  // content path
+  writer.write(static_cast<uint64_t>(10), &stream);  // size
+  writer.write(static_cast<uint64_t>(0), &stream);  // offset
+  writer.writeUTF("", &stream);  // source queue
+  writer.writeUTF("http://localhost:8080", &stream);
+
+  provenance::ProvenanceEventRecord record;
+  REQUIRE(record.DeSerialize(stream));
+  REQUIRE(record.getEventId() == "8a1d8f50-1c2b-11ea-8f83-7bd3c1a1b0e4");
+  REQUIRE(record.getEventType() == provenance::ProvenanceEventRecord::SEND);
+  REQUIRE(record.getEventTime() == 1000);
+  REQUIRE(record.getFlowFileEntryDate() == 900);
+  REQUIRE(record.getlineageStartDate() == 800);
+  REQUIRE(record.getFlowFileUuid() == "9b2e9061-1c2b-11ea-8f83-7bd3c1a1b0e4");
+  REQUIRE(record.getAttributes().at("filename") == "a.txt");
+  REQUIRE(record.getFileSize() == 10);
+  REQUIRE(record.getTransitUri() == "http://localhost:8080");
+  REQUIRE(provenance::ProvenanceEventRecord::getEventTime(stream.getBuffer(), stream.getSize()) == 1000);
+}
@@ -0,0 +1,221 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../TestBase.h"
+#include "utils/AdaptiveLimit.h"
+#include "utils/ThreadPool.h"
+#include "controllers/AdaptiveConcurrencyService.h"
+#include "core/controller/ControllerServiceMap.h"
+#include "core/controller/StandardControllerServiceNode.h"
+#include "core/controller/StandardControllerServiceProvider.h"
+
+namespace {
+
+const uint64_t PERIOD = 250 * 1000 * 1000;
+
+utils::ConcurrencySample busySample(uint64_t latency, uint64_t queued, double cpu_cores = -1) {
+  utils::ConcurrencySample sample;
+  sample.tasks = 100;
+  sample.task_nanos = 100 * latency;
+  sample.period_nanos = PERIOD;
+  sample.queued = queued;
+  sample.cpu_cores = cpu_cores;
+  return sample;
+}
+
+// remembers the sizes it gives the thread pools
+class RecordingConcurrencyService : public minifi::controllers::AdaptiveConcurrencyService {
+ public:
+  explicit RecordingConcurrencyService(const std::string &name)
+      : AdaptiveConcurrencyService(name),
+        largest_target_(0),
+        last_target_(0) {
+  }
+
+  uint16_t getTargetThreads(const std::string &pool_name, utils::ConcurrencySample sample, uint16_t current_threads) override {
+    const uint16_t target = AdaptiveConcurrencyService::getTargetThreads(pool_name, sample, current_threads);
+    largest_target_ = (std::max)(largest_target_.load(), target);
+    last_target_ = target;
+    return target;
+  }
+
+  std::atomic<uint16_t> largest_target_;
+  std::atomic<uint16_t> last_target_;
+};
+
+}  // namespace
+
+TEST_CASE("AdaptiveLimit grows while work is queued", "[adaptiveLimit]") {
+  utils::AdaptiveLimit limit(1, 16, 0, 1);
+  REQUIRE(limit.getLimit() == 1);
+  for (int i = 0; i < 100; i++) {
+    limit.update(busySample(1000000, 50));
+  }
+  REQUIRE(limit.getLimit() == 16);
+}
+
+TEST_CASE("AdaptiveLimit keeps its limit without queued work", "[adaptiveLimit]") {
+  utils::AdaptiveLimit limit(1, 16, 0, 4);
+  for (int i = 0; i < 100; i++) {
+    // the threads are busy but keep up
+    limit.update(busySample(40 * 1000 * 1000, 0));
+  }
+  REQUIRE(limit.getLimit() == 4);
+}
+
+TEST_CASE("AdaptiveLimit shrinks when tasks slow down", "[adaptiveLimit]") {
+  utils::AdaptiveLimit limit(1, 16, 0, 16);
+  for (int i = 0; i < 20; i++) {
+    limit.update(busySample(1000000, 50));
+  }
+  REQUIRE(limit.getLimit() == 16);
+  for (int i = 0; i < 5; i++) {
+    limit.update(busySample(10 * 1000000, 50));
+  }
+  REQUIRE(limit.getLimit() < 16);
+}
+
+TEST_CASE("AdaptiveLimit shrinks when threads are idle", "[adaptiveLimit]") {
+  utils::AdaptiveLimit limit(2, 16, 0, 16);
+  utils::ConcurrencySample idle;
+  idle.period_nanos = PERIOD;
+  for (int i = 0; i < 200; i++) {
+    limit.update(idle);
+  }
+  REQUIRE(limit.getLimit() == 2);
+}
+
+TEST_CASE("AdaptiveLimit honors the CPU budget", "[adaptiveLimit]") {
+  utils::AdaptiveLimit limit(1, 64, 4.0, 32);
+  limit.update(busySample(1000000, 50, 6.0));
+  REQUIRE(limit.getLimit() == 24);
+  for (int i = 0; i < 20; i++) {
+    limit.update(busySample(1000000, 50, 6.0));
+  }
+  REQUIRE(limit.getLimit() == 1);
+
+  // close to the budget queued work does not add threads
+  for (int i = 0; i < 20; i++) {
+    limit.update(busySample(1000000, 50, 3.8));
+  }
+  REQUIRE(limit.getLimit() == 1);
+  for (int i = 0; i < 20; i++) {
+    limit.update(busySample(1000000, 50, 2.0));
+  }
+  REQUIRE(limit.getLimit() > 1);
+}
+
+TEST_CASE("AdaptiveLimit stays within its bounds", "[adaptiveLimit]") {
+  utils::AdaptiveLimit limit(0, 0, 0, 10);
+  REQUIRE(limit.getLimit() == 1);
+  limit.update(busySample(1000000, 50));
+  REQUIRE(limit.getLimit() == 1);
+
+  utils::AdaptiveLimit bounded(3, 5, 0, 1);
+  REQUIRE(bounded.getLimit() == 3);
+  utils::ConcurrencySample idle;
+  idle.period_nanos = PERIOD;
+  bounded.update(idle);
+  REQUIRE(bounded.getLimit() == 3);
+}
+
+TEST_CASE("AdaptiveConcurrencyService sizes thread pools once enabled", "[adaptiveConcurrencyService]") {
+  auto service = std::make_shared<minifi::controllers::AdaptiveConcurrencyService>("ThreadPoolManager");
+  service->initialize();
+  REQUIRE(service->getTargetThreads("pool", busySample(1000000, 50), 2) == 0);
+  REQUIRE(service->getMaxThreads() == (std::numeric_limits<uint16_t>::max)());
+
+  service->setProperty(minifi::controllers::AdaptiveConcurrencyService::MinThreads.getName(), "2");
+  service->setProperty(minifi::controllers::AdaptiveConcurrencyService::MaxThreads.getName(), "6");
+  service->setProperty(minifi::controllers::AdaptiveConcurrencyService::CPUBudget.getName(), "0");
+  service->setProperty(minifi::controllers::AdaptiveConcurrencyService::AdjustmentPeriod.getName(), "100 ms");
+  service->onEnable();
+  REQUIRE(service->getMaxThreads() == 6);
+  REQUIRE(service->getAdjustmentPeriod() == std::chrono::milliseconds(100));
+  REQUIRE_FALSE(service->isAboveMax(100));
+  REQUIRE_FALSE(service->shouldReduce());
+  REQUIRE_FALSE(service->canIncrease());
+
+  uint16_t threads = 2;
+  for (int i = 0; i < 100; i++) {
+    threads = service->getTargetThreads("pool", busySample(1000000, 50), threads);
+  }
+  REQUIRE(threads == 6);
+  // pools are sized independently
+  REQUIRE(service->getTargetThreads("other pool", busySample(1000000, 0), 2) == 2);
+}
+
+TEST_CASE("AdaptiveConcurrencyService grows and shrinks a thread pool", "[adaptiveConcurrencyService]") {
+  auto configuration = std::make_shared<minifi::Configure>();
+  auto service = std::make_shared<RecordingConcurrencyService>("ThreadPoolManager");
+  service->initialize();
+  service->setProperty(minifi::controllers::AdaptiveConcurrencyService::MinThreads.getName(), "1");
+  service->setProperty(minifi::controllers::AdaptiveConcurrencyService::MaxThreads.getName(), "4");
+  service->setProperty(minifi::controllers::AdaptiveConcurrencyService::CPUBudget.getName(), "0");
+  service->setProperty(minifi::controllers::AdaptiveConcurrencyService::AdjustmentPeriod.getName(), "10 ms");
+  service->onEnable();
+
+  auto services = std::make_shared<core::controller::ControllerServiceMap>();
+  services->put("ThreadPoolManager", std::make_shared<core::controller::StandardControllerServiceNode>(service, "ThreadPoolManager", configuration));
+  auto provider = std::make_shared<core::controller::StandardControllerServiceProvider>(services, nullptr, configuration);
+
+  utils::ThreadPool<bool> pool(1, false, provider, "adaptive pool");
+  pool.start();
+
+  std::atomic<int> running(0);
+  std::atomic<int> most_running(0);
+  std::vector<std::future<bool>> futures;
+  for (int i = 0; i < 200; i++) {
+    std::function<bool()> task = [&running, &most_running]() {
+      const int now_running = ++running;
+      int most = most_running.load();
+      while (now_running > most && !most_running.compare_exchange_weak(most, now_running)) {
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      --running;
+      return true;
+    };
+    utils::Worker<bool> worker(task, "task" + std::to_string(i));
+    futures.emplace_back();
+    REQUIRE(pool.execute(std::move(worker), futures.back()));
+  }
+  for (auto &future : futures) {
+    REQUIRE(std::future_status::ready == future.wait_for(std::chrono::seconds(10)));
+  }
+
+  // queued work grows the pool up to its maximum
+  REQUIRE(4 == service->largest_target_);
+  REQUIRE(1 < most_running);
+  REQUIRE(most_running <= 4);
+
+  // and idle threads are given up again
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (service->last_target_ != 1 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  REQUIRE(1 == service->last_target_);
+  pool.shutdown();
+}
@@ -0,0 +1,181 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../TestBase.h"
+#include "TimerDrivenSchedulingAgent.h"
+#include "core/controller/ControllerService.h"
+#include "core/controller/ControllerServiceNode.h"
+#include "properties/Configure.h"
+#include "utils/ThreadPool.h"
+
+namespace minifi = org::apache::nifi::minifi;
+namespace core = org::apache::nifi::minifi::core;
+namespace utils = org::apache::nifi::minifi::utils;
+
+namespace {
+
+class ReferringService : public core::controller::ControllerService {
+ public:
+  explicit ReferringService(const std::string &name)
+      : ControllerService(name) {
+  }
+
+  void initialize() override {
+    ControllerService::initialize();
+    updateSupportedProperties({ core::Property("Other Service", "a service this one uses") });
+  }
+
+  void yield() override {
+  }
+
+  bool isRunning() override {
+    return true;
+  }
+
+  bool isWorkAvailable() override {
+    return false;
+  }
+};
+
+// the order in which services were enabled, and how many were enabled at the same time
+struct Enablements {
+  std::mutex mutex;
+  std::vector<std::string> order;
+  int active = 0;
+  int max_active = 0;
+};
+
+class RecordingServiceNode : public core::controller::ControllerServiceNode {
+ public:
+  RecordingServiceNode(const std::string &name, Enablements &enablements)
+      : ControllerServiceNode(std::make_shared<ReferringService>(name), name, std::make_shared<minifi::Configure>()),
+        enablements_(enablements) {
+    initialize();
+  }
+
+  bool canEnable() override {
+    return true;
+  }
+
+  bool enable() override {
+    {
+      std::lock_guard<std::mutex> lock(enablements_.mutex);
+      enablements_.max_active = (std::max)(enablements_.max_active, ++enablements_.active);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::lock_guard<std::mutex> lock(enablements_.mutex);
+    --enablements_.active;
+    enablements_.order.push_back(getName());
+    active = true;
+    return true;
+  }
+
+  bool disable() override {
+    active = false;
+    return true;
+  }
+
+ private:
+  Enablements &enablements_;
+};
+
+class Services {
+ public:
+  Services()
+      : thread_pool_(4),
+        agent_(nullptr, nullptr, nullptr, nullptr, std::make_shared<minifi::Configure>(), thread_pool_) {
+    thread_pool_.start();
+  }
+
+  ~Services() {
+    thread_pool_.shutdown();
+  }
+
+  std::shared_ptr<core::controller::ControllerServiceNode> add(const std::string &name) {
+    auto service = std::make_shared<RecordingServiceNode>(name, enablements);
+    services_.push_back(service);
+    return service;
+  }
+
+  void enable() {
+    agent_.enableControllerServices(services_);
+  }
+
+  size_t position(const std::string &name) {
+    return std::find(enablements.order.begin(), enablements.order.end(), name) - enablements.order.begin();
+  }
+
+  Enablements enablements;
+
+ private:
+  utils::ThreadPool<utils::TaskRescheduleInfo> thread_pool_;
+  minifi::TimerDrivenSchedulingAgent agent_;
+  std::vector<std::shared_ptr<core::controller::ControllerServiceNode>> services_;
+};
+
+}  // namespace
+
+TEST_CASE("Independent controller services are enabled concurrently", "[csenable]") {
+  Services services;
+  services.add("A");
+  services.add("B");
+  services.add("C");
+
+  services.enable();
+  REQUIRE(3 == services.enablements.order.size());
+  REQUIRE(1 < services.enablements.max_active);
+}
+
+TEST_CASE("Controller services are enabled after the services they link to", "[csenable]") {
+  Services services;
+  services.add("A")->setProperty("Linked Services", "B");
+  services.add("B")->setProperty("Linked Services", "C");
+  services.add("C");
+  services.add("D");
+
+  services.enable();
+  REQUIRE(4 == services.enablements.order.size());
+  REQUIRE(services.position("C") < services.position("B"));
+  REQUIRE(services.position("B") < services.position("A"));
+}
+
+TEST_CASE("Controller services are enabled after the services their properties refer to", "[csenable]") {
+  Services services;
+  services.add("A")->getControllerServiceImplementation()->setProperty("Other Service", "B");
+  services.add("B");
+
+  services.enable();
+  REQUIRE(2 == services.enablements.order.size());
+  REQUIRE(services.position("B") < services.position("A"));
+}
+
+TEST_CASE("Controller services linked to each other are all enabled", "[csenable]") {
+  Services services;
+  services.add("A")->setProperty("Linked Services", "B");
+  services.add("B")->setProperty("Linked Services", "A");
+  services.add("C")->setProperty("Linked Services", "A");
+
+  services.enable();
+  REQUIRE(3 == services.enablements.order.size());
+}
@@ -0,0 +1,222 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "../TestBase.h"
+#include "Connection.h"
+#include "core/FlowDiff.h"
+#include "core/ProcessGroup.h"
+#include "core/Processor.h"
+
+namespace minifi = org::apache::nifi::minifi;
+namespace core = org::apache::nifi::minifi::core;
+namespace utils = org::apache::nifi::minifi::utils;
+
+namespace {
+
+const core::Relationship Success("success", "everything");
+
+class DiffedProcessor : public core::Processor {
+ public:
+  DiffedProcessor(std::string name, utils::Identifier &uuid)
+      : Processor(name, uuid) {
+  }
+
+  void initialize() override {
+    setSupportedProperties({ core::Property("Setting", "a setting", "default") });
+    setSupportedRelationships({ Success });
+  }
+};
+
+/**
+ * Builds the flow A -> B -> C, with the same UUIDs every time.
+ */
+class Flow {
+ public:
+  Flow() {
+    utils::Identifier uuid;
+    uuid = std::string("00000000-0000-0000-0000-00000000000f").c_str();
+    root = std::unique_ptr<core::ProcessGroup>(new core::ProcessGroup(core::ROOT_PROCESS_GROUP, "root", uuid));
+    for (const std::string name : { "A", "B", "C" }) {
+      addProcessor(name);
+    }
+    connect("AB", "A", "B");
+    connect("BC", "B", "C");
+  }
+
+  std::shared_ptr<core::Processor> addProcessor(const std::string &name) {
+    utils::Identifier uuid;
+    uuid = ("00000000-0000-0000-0000-0000000000" + std::string(name.size() == 1 ? "0" : "") + name).c_str();
+    auto processor = std::make_shared<DiffedProcessor>(name, uuid);
+    processor->initialize();
+    processor->setScheduledState(core::RUNNING);
+    root->addProcessor(processor);
+    return processor;
+  }
+
+  std::shared_ptr<minifi::Connection> connect(const std::string &name, const std::string &source, const std::string &destination) {
+    utils::Identifier uuid, source_uuid, destination_uuid;
+    uuid = ("00000000-0000-0000-0000-000000000" + std::string(name.size() == 2 ? "0" : "") + name).c_str();
+    root->findProcessor(source)->getUUID(source_uuid);
+    root->findProcessor(destination)->getUUID(destination_uuid);
+    auto connection = std::make_shared<minifi::Connection>(nullptr, nullptr, name, uuid, source_uuid, destination_uuid);
+    connection->addRelationship(Success);
+    root->addConnection(connection);
+    return connection;
+  }
+
+  std::shared_ptr<minifi::Connection> connection(const std::string &name) {
+    std::map<std::string, std::shared_ptr<minifi::Connection>> connections;
+    root->getConnections(connections);
+    return connections[name];
+  }
+
+  std::shared_ptr<core::Processor> processor(const std::string &name) {
+    return root->findProcessor(name);
+  }
+
+  std::unique_ptr<core::ProcessGroup> root;
+};
+
+std::set<std::string> names(const std::vector<std::shared_ptr<core::Processor>> &processors) {
+  std::set<std::string> result;
+  for (const auto &processor : processors) {
+    result.insert(processor->getName());
+  }
+  return result;
+}
+
+std::set<std::string> names(const std::map<core::ProcessGroup*, std::set<std::shared_ptr<core::Processor>>> &processors) {
+  std::set<std::string> result;
+  for (const auto &group : processors) {
+    for (const auto &processor : group.second) {
+      result.insert(processor->getName());
+    }
+  }
+  return result;
+}
+
+std::set<std::shared_ptr<core::Connectable>> outgoing(const std::shared_ptr<core::Connectable> &processor) {
+  return processor->getOutGoingConnections(Success.getName());
+}
+
+}  // namespace
+
+TEST_CASE("An unchanged flow keeps everything running", "[flowdiff]") {
+  Flow current;
+  Flow updated;
+  auto a = current.processor("A");
+  auto ab = current.connection("AB");
+
+  core::FlowDiff diff(*current.root, *updated.root, {}, {});
+  REQUIRE(diff.isIncremental());
+  REQUIRE(diff.getProcessorsToStop().empty());
+  REQUIRE(diff.apply().empty());
+
+  REQUIRE(a == updated.processor("A"));
+  REQUIRE(ab == updated.connection("AB"));
+  REQUIRE(a == ab->getSource());
+}
+
+TEST_CASE("A changed processor is replaced and its neighbours restarted", "[flowdiff]") {
+  Flow current;
+  Flow updated;
+  updated.processor("B")->setProperty("Setting", "changed");
+  auto a = current.processor("A");
+  auto ab = current.connection("AB");
+  auto bc = current.connection("BC");
+  auto replacement = updated.processor("B");
+
+  core::FlowDiff diff(*current.root, *updated.root, {}, {});
+  REQUIRE(diff.isIncremental());
+  REQUIRE((std::set<std::string>{ "A", "B", "C" } == names(diff.getProcessorsToStop())));
+  for (const auto &processor : diff.getProcessorsToStop()) {
+    processor->setScheduledState(core::STOPPED);
+  }
+  REQUIRE((std::set<std::string>{ "A", "B", "C" } == names(diff.apply())));
+
+  REQUIRE(a == updated.processor("A"));
+  REQUIRE(replacement == updated.processor("B"));
+  REQUIRE(ab == updated.connection("AB"));
+  REQUIRE(bc == updated.connection("BC"));
+  REQUIRE(replacement == ab->getDestination());
+  REQUIRE(replacement == bc->getSource());
+  REQUIRE((std::set<std::shared_ptr<core::Connectable>>{ bc } == outgoing(replacement)));
+}
+
+TEST_CASE("Adding to the end of the flow leaves the rest running", "[flowdiff]") {
+  Flow current;
+  Flow updated;
+  updated.addProcessor("D");
+  auto cd = updated.connect("CD", "C", "D");
+  auto b = current.processor("B");
+  auto c = current.processor("C");
+
+  core::FlowDiff diff(*current.root, *updated.root, {}, {});
+  REQUIRE(diff.isIncremental());
+  REQUIRE((std::set<std::string>{ "C" } == names(diff.getProcessorsToStop())));
+  c->setScheduledState(core::STOPPED);
+  REQUIRE((std::set<std::string>{ "C", "D" } == names(diff.apply())));
+
+  REQUIRE(b == updated.processor("B"));
+  REQUIRE(c == updated.processor("C"));
+  REQUIRE(cd == updated.connection("CD"));
+  REQUIRE(c == cd->getSource());
+  REQUIRE((std::set<std::shared_ptr<core::Connectable>>{ cd } == outgoing(c)));
+}
+
+TEST_CASE("A reconfigured connection keeps its queue", "[flowdiff]") {
+  Flow current;
+  Flow updated;
+  updated.connection("BC")->setMaxQueueSize(5);
+  auto bc = current.connection("BC");
+
+  core::FlowDiff diff(*current.root, *updated.root, {}, {});
+  REQUIRE((std::set<std::string>{ "B", "C" } == names(diff.getProcessorsToStop())));
+  for (const auto &processor : diff.getProcessorsToStop()) {
+    processor->setScheduledState(core::STOPPED);
+  }
+  diff.apply();
+
+  REQUIRE(bc == updated.connection("BC"));
+  REQUIRE(5 == bc->getMaxQueueSize());
+  REQUIRE(current.processor("C") == bc->getDestination());
+}
+
+TEST_CASE("Removing a processor stops its neighbours", "[flowdiff]") {
+  Flow current;
+  Flow updated;
+  updated.root->removeConnection(updated.connection("BC"));
+  updated.root->removeProcessor(updated.processor("C"));
+  auto b = current.processor("B");
+
+  core::FlowDiff diff(*current.root, *updated.root, {}, {});
+  REQUIRE((std::set<std::string>{ "B", "C" } == names(diff.getProcessorsToStop())));
+  for (const auto &processor : diff.getProcessorsToStop()) {
+    processor->setScheduledState(core::STOPPED);
+  }
+  REQUIRE((std::set<std::string>{ "B" } == names(diff.apply())));
+
+  REQUIRE(b == updated.processor("B"));
+  REQUIRE(nullptr == updated.processor("C"));
+  REQUIRE(outgoing(b).empty());
+}
@@ -0,0 +1,76 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../TestBase.h"
+#include "core/FlowFileAttributes.h"
+
+using org::apache::nifi::minifi::core::AttributeKeyRegistry;
+using org::apache::nifi::minifi::core::FlowFileAttributes;
+
+TEST_CASE("FlowFileAttributes behave like a sorted map", "[attributes]") {
+  FlowFileAttributes attributes;
+  REQUIRE(attributes.empty());
+
+  REQUIRE(attributes.insert("path", "/tmp"));
+  REQUIRE(attributes.insert("filename", "a.txt"));
+  REQUIRE_FALSE(attributes.insert("filename", "b.txt"));
+  attributes.set("uuid", "1");
+  attributes.set("filename", "c.txt");
+  REQUIRE(attributes.update("path", "/var"));
+  REQUIRE_FALSE(attributes.update("mime.type", "text/plain"));
+
+  REQUIRE(3 == attributes.size());
+  REQUIRE("c.txt" == attributes.at("filename"));
+  REQUIRE(attributes.find("mime.type") == attributes.end());
+  REQUIRE_THROWS_AS(attributes.at("mime.type"), std::out_of_range);
+
+  std::vector<std::string> keys;
+  for (const auto &attribute : attributes) {
+    keys.push_back(attribute.first);
+  }
+  REQUIRE((std::vector<std::string>{"filename", "path", "uuid"}) == keys);
+
+  REQUIRE(1 == attributes.erase("path"));
+  REQUIRE(0 == attributes.erase("path"));
+  REQUIRE((std::map<std::string, std::string>{{"filename", "c.txt"}, {"uuid", "1"}}) == attributes.toMap());
+}
+
+TEST_CASE("Copies of FlowFileAttributes are independent", "[attributes]") {
+  FlowFileAttributes parent(std::map<std::string, std::string>{{"filename", "a.txt"}, {"path", "/tmp"}});
+  FlowFileAttributes child = parent;
+  REQUIRE(child == parent);
+  REQUIRE(&parent.at("filename") == &child.at("filename"));
+
+  child.set("filename", "b.txt");
+  REQUIRE("a.txt" == parent.at("filename"));
+  REQUIRE("b.txt" == child.at("filename"));
+  REQUIRE(child != parent);
+
+  // erasing a missing key leaves the storage shared
+  FlowFileAttributes snapshot = parent;
+  snapshot.erase("mime.type");
+  REQUIRE(&parent.at("path") == &snapshot.at("path"));
+}
+
+TEST_CASE("Attribute keys are interned", "[attributes]") {
+  REQUIRE(AttributeKeyRegistry::intern("filename") == AttributeKeyRegistry::intern(std::string("file") + "name"));
+  REQUIRE("filename" == *AttributeKeyRegistry::intern("filename"));
+}
@@ -0,0 +1,111 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <memory>
+#include <string>
+#include <vector>
+#include "../TestBase.h"
+#include "core/FlowFileQueue.h"
+#include "core/FlowFilePrioritizer.h"
+
+namespace core = org::apache::nifi::minifi::core;
+
+class QueuedFlowFile : public core::FlowFile {
+ public:
+  explicit QueuedFlowFile(const std::string &name) {
+    addAttribute("name", name);
+  }
+
+  void releaseClaim(const std::shared_ptr<org::apache::nifi::minifi::ResourceClaim>) override {
+  }
+
+  std::string name() const {
+    return getAttributes().at("name");
+  }
+};
+
+static std::shared_ptr<QueuedFlowFile> queued(const std::string &name, const std::string &priority = "") {
+  auto flow_file = std::make_shared<QueuedFlowFile>(name);
+  if (!priority.empty()) {
+    flow_file->addAttribute(core::PriorityAttributePrioritizer::PRIORITY_ATTRIBUTE, priority);
+  }
+  return flow_file;
+}
+
+static std::vector<std::string> drain(core::FlowFileQueue &queue, uint64_t now) {
+  std::vector<std::string> names;
+  while (auto flow_file = queue.pop(now)) {
+    names.push_back(std::static_pointer_cast<QueuedFlowFile>(flow_file)->name());
+  }
+  return names;
+}
+
+TEST_CASE("FlowFileQueue is first in first out by default", "[queue]") {
+  core::FlowFileQueue queue;
+  queue.push(queued("a"));
+  queue.push(queued("b"));
+  queue.push(queued("c"));
+  REQUIRE(3 == queue.size());
+  REQUIRE((std::vector<std::string>{"a", "b", "c"}) == drain(queue, getTimeMillis()));
+  REQUIRE(queue.empty());
+}
+
+TEST_CASE("FlowFileQueue orders by the priority attribute", "[queue]") {
+  core::FlowFileQueue queue;
+  queue.push(queued("none"));
+  queue.push(queued("text", "high"));
+  queue.push(queued("ten", "10"));
+  queue.push(queued("two", "2"));
+  queue.push(queued("other two", "2"));
+  queue.setPrioritizers({core::FlowFilePrioritizer::create("org.apache.nifi.prioritizer.PriorityAttributePrioritizer")});
+  queue.push(queued("one", "1"));
+  REQUIRE((std::vector<std::string>{"one", "two", "other two", "ten", "text", "none"}) == drain(queue, getTimeMillis()));
+}
+
+TEST_CASE("Penalized FlowFiles do not hold back ready ones", "[queue]") {
+  const uint64_t now = getTimeMillis();
+  core::FlowFileQueue queue;
+  auto penalized = queued("penalized");
+  penalized->setPenaltyExpiration(now + 60000);
+  queue.push(penalized);
+  queue.push(queued("ready"));
+
+  REQUIRE(queue.isWorkAvailable(now));
+  REQUIRE((std::vector<std::string>{"ready"}) == drain(queue, now));
+  REQUIRE_FALSE(queue.isWorkAvailable(now));
+  REQUIRE(1 == queue.size());
+
+  // once the penalty is over the FlowFile can be taken again
+  REQUIRE(queue.isWorkAvailable(now + 60000));
+  REQUIRE((std::vector<std::string>{"penalized"}) == drain(queue, now + 60000));
+  REQUIRE(queue.empty());
+}
+
+TEST_CASE("Clearing a FlowFileQueue returns every FlowFile", "[queue]") {
+  core::FlowFileQueue queue;
+  auto penalized = queued("penalized");
+  penalized->setPenaltyExpiration(getTimeMillis() + 60000);
+  queue.push(penalized);
+  queue.push(queued("ready"));
+  REQUIRE(2 == queue.clear().size());
+  REQUIRE(queue.empty());
+}
+
+TEST_CASE("Unknown prioritizers are not created", "[queue]") {
+  REQUIRE(nullptr == core::FlowFilePrioritizer::create("org.apache.nifi.prioritizer.NoSuchPrioritizer"));
+  REQUIRE("OldestFlowFileFirstPrioritizer" == core::FlowFilePrioritizer::create("OldestFlowFileFirstPrioritizer")->getName());
+}
@@ -0,0 +1,106 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../TestBase.h"
+#include "io/BaseStream.h"
+#include "io/HashingStream.h"
+#include "utils/HashUtils.h"
+
+namespace io = org::apache::nifi::minifi::io;
+
+namespace {
+
+std::string xxh64(const std::string& input) {
+  utils::XXHash64Hasher hasher;
+  hasher.update(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+  return hasher.digest();
+}
+
+}  // namespace
+
+TEST_CASE("XXH64 reference values", "[hash]") {
+  REQUIRE(xxh64("") == "EF46DB3751D8E999");
+  REQUIRE(xxh64("a") == "D24EC4F1A98C6E5B");
+  REQUIRE(xxh64("abc") == "44BC2CF5AD770999");
+}
+
+TEST_CASE("XXH64 is independent of update boundaries", "[hash]") {
+  std::string input;
+  for (int i = 0; i < 1000; i++) {
+    input += static_cast<char>(i % 251);
+  }
+
+  utils::XXHash64Hasher hasher;
+  for (size_t pos = 0; pos < input.size(); pos += 7) {
+    const size_t len = std::min<size_t>(7, input.size() - pos);
+    hasher.update(reinterpret_cast<const uint8_t*>(input.data() + pos), len);
+  }
+  REQUIRE(hasher.digest() == xxh64(input));
+}
+
+TEST_CASE("Algorithm names are normalized", "[hash]") {
+  REQUIRE(utils::HashUtils::normalizeAlgorithmName(" sha-256 ") == "SHA256");
+  REQUIRE(utils::HashUtils::createHasher("xxh-64") != nullptr);
+  REQUIRE(utils::HashUtils::createHasher("CRC7") == nullptr);
+}
+
+TEST_CASE("HashingStream computes every digest in one pass", "[hash]") {
+  io::BaseStream base;
+  std::string content = "Test text\n";
+  base.writeData(reinterpret_cast<uint8_t*>(const_cast<char*>(content.data())), content.size());
+
+  std::vector<std::unique_ptr<utils::Hasher>> hashers;
+  for (const auto& algorithm : utils::HashUtils::getSupportedAlgorithms()) {
+    hashers.push_back(utils::HashUtils::createHasher(algorithm));
+  }
+  io::HashingStream stream(&base, std::move(hashers));
+
+  REQUIRE(stream.consume(4) == static_cast<int64_t>(content.size()));
+  REQUIRE(stream.getBytesHashed() == content.size());
+
+  const auto digests = stream.getDigests();
+  REQUIRE(digests.size() == utils::HashUtils::getSupportedAlgorithms().size());
+  for (const auto& digest : digests) {
+    if (digest.first == "XXH64") {
+      REQUIRE(digest.second == xxh64(content));
+    }
+#ifdef OPENSSL_SUPPORT
+    if (digest.first == "MD5") {
+      REQUIRE(digest.second == "4FE8A693C64F93F65C5FAF42DC49AB23");
+    }
+    if (digest.first == "SHA256") {
+      REQUIRE(digest.second == "66D5B2CC06203137F8A0E9714638DC1085C57A3F1FA26C8823AE5CF89AB26488");
+    }
+#endif
+  }
+}
+
+TEST_CASE("HashingStream hashes data written through it", "[hash]") {
+  io::BaseStream sink;
+  std::vector<std::unique_ptr<utils::Hasher>> hashers;
+  hashers.push_back(utils::HashUtils::createHasher("XXH64"));
+  io::HashingStream stream(&sink, std::move(hashers));
+
+  std::string content = "foobar";
+  REQUIRE(stream.writeData(reinterpret_cast<uint8_t*>(const_cast<char*>(content.data())), content.size()) == static_cast<int>(content.size()));
+  REQUIRE(sink.getSize() == content.size());
+  REQUIRE(stream.getDigests().at(0).second == xxh64(content));
+}
@@ -0,0 +1,107 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string>
+#include "../TestBase.h"
+#include "c2/protocols/HeartbeatDeltaEncoder.h"
+#include "rapidjson/document.h"
+
+using org::apache::nifi::minifi::c2::HeartbeatDeltaEncoder;
+
+namespace {
+
+rapidjson::Document heartbeat(int queued, bool with_flow_info = true) {
+  std::string json = "{\"operation\":\"heartbeat\",\"agentInfo\":{\"identifier\":\"agent-1\",\"agentClass\":\"default\"}";
+  if (with_flow_info) {
+    json += ",\"flowInfo\":{\"identifier\":\"flow-1\",\"queues\":{\"q\":{\"size\":" + std::to_string(queued) + ",\"sizeMax\":100}}}";
+  }
+  json += "}";
+  rapidjson::Document document;
+  document.Parse(json.c_str());
+  return document;
+}
+
+rapidjson::Document parse(const std::string &json) {
+  rapidjson::Document document;
+  document.Parse(json.c_str());
+  REQUIRE(!document.HasParseError());
+  return document;
+}
+
+}  // namespace
+
+TEST_CASE("The first heartbeat is full", "[heartbeatdelta]") {
+  HeartbeatDeltaEncoder encoder;
+  auto sent = parse(encoder.encode(heartbeat(1)));
+  REQUIRE(std::string(HeartbeatDeltaEncoder::FULL) == sent[HeartbeatDeltaEncoder::ENCODING].GetString());
+  REQUIRE(100 == sent["flowInfo"]["queues"]["q"]["sizeMax"].GetInt());
+  REQUIRE(std::string("default") == sent["agentInfo"]["agentClass"].GetString());
+}
+
+TEST_CASE("A delta only holds what changed", "[heartbeatdelta]") {
+  HeartbeatDeltaEncoder encoder;
+  encoder.encode(heartbeat(1));
+  encoder.acknowledge();
+
+  auto sent = parse(encoder.encode(heartbeat(2)));
+  REQUIRE(std::string(HeartbeatDeltaEncoder::DELTA) == sent[HeartbeatDeltaEncoder::ENCODING].GetString());
+  REQUIRE(std::string("heartbeat") == sent["operation"].GetString());
+  REQUIRE(std::string("agent-1") == sent["agentInfo"]["identifier"].GetString());
+  REQUIRE_FALSE(sent["agentInfo"].HasMember("agentClass"));
+  REQUIRE(std::string("flow-1") == sent["flowInfo"]["identifier"].GetString());
+  REQUIRE(2 == sent["flowInfo"]["queues"]["q"]["size"].GetInt());
+  REQUIRE_FALSE(sent["flowInfo"]["queues"]["q"].HasMember("sizeMax"));
+  encoder.acknowledge();
+
+  // nothing changed
+  sent = parse(encoder.encode(heartbeat(2)));
+  REQUIRE(std::string(HeartbeatDeltaEncoder::DELTA) == sent[HeartbeatDeltaEncoder::ENCODING].GetString());
+  REQUIRE_FALSE(sent["flowInfo"].HasMember("queues"));
+}
+
+TEST_CASE("Removed members are sent as null", "[heartbeatdelta]") {
+  HeartbeatDeltaEncoder encoder;
+  encoder.encode(heartbeat(1));
+  encoder.acknowledge();
+
+  auto sent = parse(encoder.encode(heartbeat(1, false)));
+  REQUIRE(sent.HasMember("flowInfo"));
+  REQUIRE(sent["flowInfo"].IsNull());
+}
+
+TEST_CASE("A heartbeat which is not acknowledged is followed by a full one", "[heartbeatdelta]") {
+  HeartbeatDeltaEncoder encoder;
+  encoder.encode(heartbeat(1));
+  encoder.acknowledge();
+  encoder.encode(heartbeat(2));
+  encoder.reject();
+
+  auto sent = parse(encoder.encode(heartbeat(3)));
+  REQUIRE(std::string(HeartbeatDeltaEncoder::FULL) == sent[HeartbeatDeltaEncoder::ENCODING].GetString());
+  REQUIRE(3 == sent["flowInfo"]["queues"]["q"]["size"].GetInt());
+}
+
+TEST_CASE("A full heartbeat is sent periodically", "[heartbeatdelta]") {
+  HeartbeatDeltaEncoder encoder(3);
+  std::string encodings;
+  for (int i = 0; i < 7; i++) {
+    auto sent = parse(encoder.encode(heartbeat(i)));
+    encodings += sent[HeartbeatDeltaEncoder::ENCODING].GetString()[0];
+    encoder.acknowledge();
+  }
+  REQUIRE("fddfddf" == encodings);
+}
@@ -21,6 +21,9 @@
 #include <ctime>
 #include <algorithm>
 #include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
 #include "../TestBase.h"
 #include "utils/Id.h"
 
@@ -195,6 +198,59 @@ TEST_CASE("Test to_string", "[id]") {
   LogTestController::getInstance().reset();
 }
 
+TEST_CASE("Test time carries the current timestamp", "[id]") {
+  TestController test_controller;
+
+  std::shared_ptr<minifi::Properties> id_props = std::make_shared<minifi::Properties>();
+  id_props->set("uid.implementation", "time");
+
+  std::shared_ptr<utils::IdGenerator> generator = utils::IdGenerator::getIdGenerator();
+  generator->initialize(id_props);
+
+  const auto timestamp = [](const utils::Identifier& id) {
+    const uint8_t* bytes = id.toArray();
+    uint64_t value = bytes[6] & 0x0f;
+    for (int i : {7, 4, 5, 0, 1, 2, 3}) {
+      value = (value << 8) | bytes[i];
+    }
+    // 100ns intervals since 1582-10-15 to milliseconds since the unix epoch
+    return static_cast<int64_t>((value - 0x01B21DD213814000ULL) / 10000);
+  };
+  const int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+  // spans several reserved blocks
+  std::vector<utils::Identifier> uuids(4096U);
+  for (auto& uuid : uuids) {
+    generator->generate(uuid);
+    REQUIRE(0x80 == (uuid.toArray()[8] & 0xc0));
+  }
+  REQUIRE(std::abs(timestamp(uuids.front()) - now) < 10000);
+  for (size_t i = 1; i < uuids.size(); i++) {
+    REQUIRE(timestamp(uuids[i - 1]) <= timestamp(uuids[i]));
+    REQUIRE(uuids[i - 1] != uuids[i]);
+    REQUIRE(0 == memcmp(uuids[i - 1].toArray() + 8, uuids[i].toArray() + 8, 8U));
+  }
+}
+
+TEST_CASE("Test comparison", "[id]") {
+  utils::Identifier null_id;
+  utils::Identifier other_null_id;
+  REQUIRE(null_id == nullptr);
+  REQUIRE(null_id == other_null_id);
+
+  utils::UUID_FIELD zeros = {0};
+  utils::Identifier zero_id(zeros);
+  REQUIRE(zero_id != nullptr);
+  REQUIRE(null_id != zero_id);
+  REQUIRE("00000000-0000-0000-0000-000000000000" == zero_id.to_string());
+
+  utils::Identifier parsed;
+  parsed = std::string("1D412E16-0148-11EA-880B-9BF2C1D8F5BE");
+  utils::Identifier copy(parsed);
+  REQUIRE(copy == parsed);
+  REQUIRE("1d412e16-0148-11ea-880b-9bf2c1d8f5be" == copy.to_string());
+}
+
 TEST_CASE("Test Hex Device Segment 16 bits correct digits", "[id]") {
   TestController test_controller;
 
@@ -304,6 +360,9 @@ TEST_CASE("Collision", "[collision]") {
   SECTION("uuid_default") {
     id_props->set("uid.implementation", "uuid_default");
   }
+  SECTION("minifi_uid") {
+    id_props->set("uid.implementation", "minifi_uid");
+  }
 
   std::shared_ptr<utils::IdGenerator> generator = utils::IdGenerator::getIdGenerator();
   generator->initialize(id_props);
@@ -20,8 +20,16 @@
 #include <memory>
 #include <vector>
 #include <ctime>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <thread>
 #include "../TestBase.h"
+#include "core/logging/AsyncSink.h"
 #include "core/logging/LoggerConfiguration.h"
+#include "spdlog/sinks/null_sink.h"
+#include "spdlog/sinks/ostream_sink.h"
+#include "spdlog/spdlog.h"
 
 TEST_CASE("Test log Levels", "[ttl1]") {
   LogTestController::getInstance().setTrace<logging::Logger>();
@@ -107,3 +115,192 @@ TEST_CASE("Test ShortenNames", "[ttl6]") {
   LogTestController::getInstance(props)->reset();
   LogTestController::getInstance().reset();
 }
+
+namespace async {
+class TestClass {
+};
+class BenchmarkClass {
+};
+class AsyncBenchmarkClass {
+};
+}
+
+TEST_CASE("Test async logging", "[ttl7]") {
+  std::shared_ptr<logging::LoggerProperties> props = std::make_shared<logging::LoggerProperties>();
+
+  props->set("spdlog.async", "true");
+  props->set("spdlog.async.queue_size", "4");
+
+  std::shared_ptr<logging::Logger> logger = LogTestController::getInstance(props)->getLogger<async::TestClass>();
+  for (int i = 0; i < 20; i++) {
+    logger->log_error("hello %d", i);
+  }
+
+  REQUIRE(true == LogTestController::getInstance(props)->contains("[async::TestClass] [error] hello 19"));
+
+  LogTestController::getInstance(props)->reset();
+  LogTestController::getInstance().reset();
+  // the registry would keep the async sinks flushing into the controller's stream until after it is destroyed
+  spdlog::drop_all();
+}
+
+TEST_CASE("AsyncSink keeps the order of messages", "[ttl8]") {
+  std::ostringstream output;
+  {
+    auto sink = std::make_shared<logging::internal::AsyncSink>(std::make_shared<spdlog::sinks::ostream_sink_mt>(output), 4);
+    spdlog::logger logger("async", sink);
+    logger.set_pattern("%v");
+    for (int i = 0; i < 1000; i++) {
+      logger.info("{}", i);
+    }
+  }
+
+  std::istringstream lines(output.str());
+  int expected = 0;
+  int line;
+  while (lines >> line) {
+    REQUIRE(expected == line);
+    expected++;
+  }
+  REQUIRE(1000 == expected);
+}
+
+namespace {
+
+class BlockingSink : public spdlog::sinks::sink {
+ public:
+  BlockingSink()
+      : blocked(true),
+        count(0) {
+  }
+
+  void log(const spdlog::details::log_msg &msg) override {
+    while (blocked) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ++count;
+  }
+
+  void flush() override {
+  }
+
+  std::atomic<bool> blocked;
+  std::atomic<int> count;
+};
+
+}  // namespace
+
+TEST_CASE("AsyncSink discards messages when the queue is full", "[ttl9]") {
+  auto blocking_sink = std::make_shared<BlockingSink>();
+  uint64_t dropped;
+  {
+    auto sink = std::make_shared<logging::internal::AsyncSink>(blocking_sink, 4, spdlog::async_overflow_policy::discard_log_msg);
+    spdlog::logger logger("async", sink);
+    for (int i = 0; i < 100; i++) {
+      logger.info("{}", i);
+    }
+    dropped = sink->getDroppedCount();
+    blocking_sink->blocked = false;
+  }
+
+  // at most the queue and the message being written can be held back
+  REQUIRE(dropped >= 100 - 4 - 1);
+  REQUIRE(static_cast<uint64_t>(blocking_sink->count) + dropped == 100);
+}
+
+namespace {
+
+class ReconfigurableLogger : public logging::Logger {
+ public:
+  explicit ReconfigurableLogger(std::shared_ptr<spdlog::logger> delegate)
+      : Logger(delegate) {
+  }
+
+  using Logger::set_delegate;
+};
+
+}  // namespace
+
+TEST_CASE("Replaced spdlog loggers are released on the next reconfiguration", "[ttl10]") {
+  auto sink = std::make_shared<spdlog::sinks::null_sink_st>();
+  auto first = std::make_shared<spdlog::logger>("first", sink);
+  std::weak_ptr<spdlog::logger> first_delegate = first;
+  ReconfigurableLogger logger(first);
+  first.reset();
+
+  std::vector<std::weak_ptr<spdlog::logger>> delegates;
+  for (int i = 0; i < 5; i++) {
+    auto delegate = std::make_shared<spdlog::logger>("logger " + std::to_string(i), sink);
+    delegates.push_back(delegate);
+    logger.set_delegate(delegate);
+    logger.log_error("reconfigured %d times", i + 1);
+  }
+
+  REQUIRE(first_delegate.expired());
+  for (int i = 0; i < 3; i++) {
+    REQUIRE(delegates[i].expired());
+  }
+  // the one replaced last may still be in use by a log call
+  REQUIRE_FALSE(delegates[3].expired());
+  REQUIRE_FALSE(delegates[4].expired());
+}
+
+namespace {
+
+template<typename LogFunction>
+void benchmark(const std::string &name, LogFunction log) {
+  const int iterations = 1000000;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    log(i);
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+  std::cout << name << ": " << (elapsed / iterations) << " ns per call" << std::endl;
+}
+
+}  // namespace
+
+TEST_CASE("Per flow file logging overhead", "[.benchmark]") {
+  std::shared_ptr<logging::LoggerProperties> props = std::make_shared<logging::LoggerProperties>();
+  props->set("appender.null", "null");
+  props->set("logger.async::BenchmarkClass", "INFO,null");
+  auto sync_logger = LogTestController::getInstance(props)->getLogger<async::BenchmarkClass>();
+
+  benchmark("disabled debug", [&](int i) {
+    sync_logger->log_debug("Polled flow file %d from connection %s", i, "connection");
+  });
+  benchmark("enabled info, synchronous", [&](int i) {
+    sync_logger->log_info("Polled flow file %d from connection %s", i, "connection");
+  });
+
+  std::vector<std::thread> threads;
+  const auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < 250000; i++) {
+        sync_logger->log_debug("Polled flow file %d from connection %s", i, "connection");
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "disabled debug, 4 threads: " << (elapsed / 1000000) << " ns per call" << std::endl;
+
+  LogTestController::getInstance(props)->reset();
+
+  std::shared_ptr<logging::LoggerProperties> async_props = std::make_shared<logging::LoggerProperties>();
+  async_props->set("appender.null", "null");
+  async_props->set("logger.async::AsyncBenchmarkClass", "INFO,null");
+  async_props->set("spdlog.async", "true");
+  async_props->set("spdlog.async.overflow_policy", "discard");
+  auto async_logger = LogTestController::getInstance(async_props)->getLogger<async::AsyncBenchmarkClass>();
+
+  benchmark("enabled info, asynchronous", [&](int i) {
+    async_logger->log_info("Polled flow file %d from connection %s", i, "connection");
+  });
+
+  LogTestController::getInstance(async_props)->reset();
+  LogTestController::getInstance().reset();
+}
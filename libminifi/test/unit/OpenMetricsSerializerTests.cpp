@@ -0,0 +1,122 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <memory>
+#include <string>
+#include <vector>
+#include "../TestBase.h"
+#include "core/state/OpenMetricsSerializer.h"
+
+namespace state = org::apache::nifi::minifi::state;
+
+class TestQueueMetrics : public state::response::ResponseNode {
+ public:
+  TestQueueMetrics()
+      : state::response::ResponseNode("TestQueueMetrics") {
+  }
+
+  std::string getName() const override {
+    return "QueueMetrics";
+  }
+
+  std::vector<state::response::SerializedResponseNode> serialize() override {
+    std::vector<state::response::SerializedResponseNode> serialized;
+    for (const auto &connection : { std::make_pair("GetFile/success", "3"), std::make_pair("\"quoted\"", "12") }) {
+      state::response::SerializedResponseNode parent;
+      parent.name = connection.first;
+      state::response::SerializedResponseNode queued;
+      queued.name = "queued";
+      queued.value = std::string(connection.second);
+      state::response::SerializedResponseNode state;
+      state.name = "state";
+      state.value = std::string("RUNNING");
+      parent.children.push_back(queued);
+      parent.children.push_back(state);
+      serialized.push_back(parent);
+    }
+    state::response::SerializedResponseNode uptime;
+    uptime.name = "Up Time";
+    uptime.value = uint64_t(1234);
+    serialized.push_back(uptime);
+    return serialized;
+  }
+};
+
+class TestProcessorMetrics : public state::response::ResponseNode {
+ public:
+  TestProcessorMetrics()
+      : state::response::ResponseNode("TestProcessorMetrics") {
+  }
+
+  std::string getName() const override {
+    return "ProcessorMetrics";
+  }
+
+  std::vector<state::response::SerializedResponseNode> serialize() override {
+    state::response::SerializedResponseNode parent;
+    parent.name = "GetFile";
+    state::response::SerializedResponseNode invocations;
+    invocations.name = "invocations";
+    invocations.value = uint64_t(7);
+    invocations.monotonic = true;
+    state::response::SerializedResponseNode time;
+    time.name = "time";
+    state::response::SerializedResponseNode total;
+    total.name = "total";
+    total.value = uint64_t(900);
+    total.monotonic = true;
+    state::response::SerializedResponseNode max;
+    max.name = "max";
+    max.value = uint64_t(300);
+    time.children.push_back(total);
+    time.children.push_back(max);
+    parent.children.push_back(invocations);
+    parent.children.push_back(time);
+    return { parent };
+  }
+};
+
+TEST_CASE("Metric nodes are rendered in the OpenMetrics format", "[openmetrics]") {
+  std::vector<std::shared_ptr<state::response::ResponseNode>> nodes = { std::make_shared<TestQueueMetrics>() };
+  const std::string expected =
+      "# TYPE minifi_queuemetrics_queued gauge\n"
+      "minifi_queuemetrics_queued{component=\"GetFile/success\"} 3\n"
+      "minifi_queuemetrics_queued{component=\"\\\"quoted\\\"\"} 12\n"
+      "# TYPE minifi_queuemetrics_up_time gauge\n"
+      "minifi_queuemetrics_up_time 1234\n"
+      "# EOF\n";
+  REQUIRE(expected == state::OpenMetricsSerializer::serialize(nodes));
+}
+
+TEST_CASE("Monotonic values are rendered as counters", "[openmetrics]") {
+  std::vector<std::shared_ptr<state::response::ResponseNode>> nodes = { std::make_shared<TestProcessorMetrics>() };
+  const std::string expected =
+      "# TYPE minifi_processormetrics_invocations counter\n"
+      "minifi_processormetrics_invocations_total{component=\"GetFile\"} 7\n"
+      "# TYPE minifi_processormetrics_time counter\n"
+      "minifi_processormetrics_time_total{component=\"GetFile\"} 900\n"
+      "# TYPE minifi_processormetrics_time_max gauge\n"
+      "minifi_processormetrics_time_max{component=\"GetFile\"} 300\n"
+      "# EOF\n";
+  REQUIRE(expected == state::OpenMetricsSerializer::serialize(nodes));
+}
+
+TEST_CASE("Metric names are sanitized", "[openmetrics]") {
+  REQUIRE("repository_metrics_size" == state::OpenMetricsSerializer::sanitizeName("Repository Metrics.size_"));
+  REQUIRE("" == state::OpenMetricsSerializer::sanitizeName("--"));
+  REQUIRE("# EOF\n" == state::OpenMetricsSerializer::serialize({}));
+}
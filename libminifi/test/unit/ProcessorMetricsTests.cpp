@@ -0,0 +1,81 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "../TestBase.h"
+#include "core/ProcessorMetrics.h"
+
+using org::apache::nifi::minifi::core::LatencyHistogram;
+using org::apache::nifi::minifi::core::ProcessorMetrics;
+using org::apache::nifi::minifi::core::ShardedCounter;
+
+TEST_CASE("ShardedCounter sums the increments of every thread", "[metrics]") {
+  ShardedCounter counter;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 16; i++) {
+    threads.emplace_back([&counter]() {
+      for (int j = 0; j < 1000; j++) {
+        counter.add(2);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  REQUIRE(32000 == counter.load());
+}
+
+TEST_CASE("LatencyHistogram buckets bound the relative error", "[metrics]") {
+  for (uint64_t value : {uint64_t(0), uint64_t(7), uint64_t(8), uint64_t(1000), uint64_t(123456789), UINT64_MAX}) {
+    const size_t index = LatencyHistogram::bucketIndex(value);
+    REQUIRE(index < LatencyHistogram::BUCKETS);
+    const uint64_t upper = LatencyHistogram::bucketUpperBound(index);
+    REQUIRE(upper >= value);
+    REQUIRE(upper - value <= value / LatencyHistogram::SUB_BUCKETS);
+    if (index > 0) {
+      REQUIRE(LatencyHistogram::bucketUpperBound(index - 1) < value);
+    }
+  }
+}
+
+TEST_CASE("LatencyHistogram reports percentiles", "[metrics]") {
+  LatencyHistogram histogram;
+  REQUIRE(0 == histogram.getPercentile(50));
+  for (uint64_t i = 1; i <= 100; i++) {
+    histogram.record(i * 1000);
+  }
+  REQUIRE(100 == histogram.getCount());
+  REQUIRE(5050000 == histogram.getTotal());
+  REQUIRE(100000 == histogram.getMax());
+  const uint64_t median = histogram.getPercentile(50);
+  REQUIRE(median >= 50000);
+  REQUIRE(median <= 50000 + 50000 / LatencyHistogram::SUB_BUCKETS);
+  REQUIRE(100000 == histogram.getPercentile(100));
+}
+
+TEST_CASE("ProcessorMetrics accounts for backpressure periods", "[metrics]") {
+  ProcessorMetrics metrics;
+  metrics.backpressureReleased(100);
+  REQUIRE(0 == metrics.backpressure_nanos.load());
+  metrics.backpressureApplied(1000);
+  metrics.backpressureApplied(1500);
+  metrics.backpressureReleased(3000);
+  metrics.backpressureReleased(4000);
+  REQUIRE(2000 == metrics.backpressure_nanos.load());
+}
@@ -0,0 +1,104 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <map>
+#include <memory>
+#include <string>
+
+#include "../TestBase.h"
+#include "core/repository/VolatileContentRepository.h"
+#include "provenance/Provenance.h"
+#include "provenance/ProvenancePolicy.h"
+#include "ProvenanceTestHelper.h"
+
+TEST_CASE("No provenance policy is created by default", "[provenancePolicy]") {
+  minifi::Configure configure;
+  REQUIRE(provenance::ProvenancePolicy::create(configure, "uuid", "name") == nullptr);
+}
+
+TEST_CASE("Provenance event types can be excluded per processor", "[provenancePolicy]") {
+  minifi::Configure configure;
+  configure.set(minifi::Configure::nifi_provenance_excluded_event_types, "ROUTE, ATTRIBUTES_MODIFIED");
+  configure.set(std::string(minifi::Configure::nifi_provenance_excluded_event_types) + ".quiet", "CREATE,DROP");
+
+  auto policy = provenance::ProvenancePolicy::create(configure, "uuid", "name");
+  REQUIRE(policy != nullptr);
+  REQUIRE_FALSE(policy->isEnabled(provenance::ProvenanceEventRecord::ROUTE, "flowfile"));
+  REQUIRE_FALSE(policy->isEnabled(provenance::ProvenanceEventRecord::ATTRIBUTES_MODIFIED, "flowfile"));
+  REQUIRE(policy->isEnabled(provenance::ProvenanceEventRecord::CREATE, "flowfile"));
+
+  auto quiet = provenance::ProvenancePolicy::create(configure, "uuid", "quiet");
+  REQUIRE(quiet != nullptr);
+  REQUIRE_FALSE(quiet->isEnabled(provenance::ProvenanceEventRecord::CREATE, "flowfile"));
+  REQUIRE_FALSE(quiet->isEnabled(provenance::ProvenanceEventRecord::DROP, "flowfile"));
+  REQUIRE(quiet->isEnabled(provenance::ProvenanceEventRecord::ROUTE, "flowfile"));
+}
+
+TEST_CASE("Provenance sampling is decided by the FlowFile UUID", "[provenancePolicy]") {
+  minifi::Configure configure;
+  configure.set(minifi::Configure::nifi_provenance_sampling_percentage, "25");
+  auto policy = provenance::ProvenancePolicy::create(configure, "uuid", "name");
+  REQUIRE(policy != nullptr);
+
+  auto generator = utils::IdGenerator::getIdGenerator();
+  int sampled = 0;
+  for (int i = 0; i < 1000; i++) {
+    const std::string flow_file_uuid = generator->generate().to_string();
+    const bool enabled = policy->isEnabled(provenance::ProvenanceEventRecord::CREATE, flow_file_uuid);
+    // every event of a FlowFile gets the same decision
+    REQUIRE(policy->isEnabled(provenance::ProvenanceEventRecord::DROP, flow_file_uuid) == enabled);
+    if (enabled) {
+      sampled++;
+    }
+  }
+  REQUIRE(sampled > 150);
+  REQUIRE(sampled < 350);
+}
+
+TEST_CASE("Provenance events are rate limited", "[provenancePolicy]") {
+  minifi::Configure configure;
+  configure.set(minifi::Configure::nifi_provenance_rate_limit, "1000");
+  auto policy = provenance::ProvenancePolicy::create(configure, "uuid", "name");
+  REQUIRE(policy != nullptr);
+
+  int acquired = 0;
+  for (int i = 0; i < 5000; i++) {
+    if (policy->acquire()) {
+      acquired++;
+    }
+  }
+  // the loop may straddle a second boundary
+  REQUIRE(acquired >= 1000);
+  REQUIRE(acquired <= 2000);
+}
+
+TEST_CASE("ProvenanceReporter does not create excluded events", "[provenancePolicy]") {
+  minifi::Configure configure;
+  configure.set(minifi::Configure::nifi_provenance_excluded_event_types, "CREATE");
+  auto repo = std::make_shared<TestRepository>();
+  provenance::ProvenanceReporter reporter(repo, "component", "component", provenance::ProvenancePolicy::create(configure, "uuid", "component"));
+
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::VolatileContentRepository>();
+  std::shared_ptr<core::FlowFile> flow = std::make_shared<minifi::FlowFileRecord>(repo, content_repo, std::map<std::string, std::string>());
+
+  REQUIRE_FALSE(reporter.isEnabled(provenance::ProvenanceEventRecord::CREATE, flow));
+  reporter.create(flow, "created");
+  REQUIRE(reporter.getEvents().empty());
+
+  reporter.drop(flow, "dropped");
+  REQUIRE(reporter.getEvents().size() == 1);
+}
@@ -16,7 +16,9 @@
  * limitations under the License.
  */
 
+#include <chrono>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "Exception.h"
@@ -81,3 +83,75 @@ TEST_CASE("Regex::matchesFullInput works correctly", "[matchesFullInput]") {
   REQUIRE(Regex::matchesFullInput("(in|out)put", "input") == true);
   REQUIRE(Regex::matchesFullInput("inpu[aeiou]*", "input") == false);
 }
+
+TEST_CASE("Regex::search continues from an offset", "[regexSearch]") {
+  const std::string input = "Speed limit 130 | Speed limit 80";
+  const Regex rgx("Speed limit ([0-9]+)");
+  std::vector<std::string> results;
+  size_t match_end = 0;
+  REQUIRE(rgx.search(input, 0, results, match_end));
+  REQUIRE((results == std::vector<std::string>{"Speed limit 130", "130"}));
+  REQUIRE(15 == match_end);
+  REQUIRE(rgx.search(input, match_end, results, match_end));
+  REQUIRE((results == std::vector<std::string>{"Speed limit 80", "80"}));
+  REQUIRE(input.size() == match_end);
+  REQUIRE_FALSE(rgx.search(input, match_end, results, match_end));
+  REQUIRE(results.empty());
+  REQUIRE_FALSE(rgx.search(input, input.size() + 1, results, match_end));
+}
+
+TEST_CASE("Regex::search reports empty matches", "[regexSearch]") {
+  const Regex rgx("([0-9]*)");
+  std::vector<std::string> results;
+  size_t match_end = 0;
+  REQUIRE(rgx.search("a1", 0, results, match_end));
+  REQUIRE((results == std::vector<std::string>{"", ""}));
+  REQUIRE(0 == match_end);
+  REQUIRE(rgx.search("a1", 1, results, match_end));
+  REQUIRE((results == std::vector<std::string>{"1", "1"}));
+  REQUIRE(2 == match_end);
+  // the end of the input still matches the empty string
+  REQUIRE(rgx.search("a1", 2, results, match_end));
+  REQUIRE(2 == match_end);
+}
+
+TEST_CASE("Regex::search can be shared by threads", "[regexSearch]") {
+  const Regex rgx("limit ([0-9]+)", {Regex::Mode::ICASE});
+  std::vector<std::thread> threads;
+  std::vector<int> found(4, 0);
+  for (size_t t = 0; t < found.size(); t++) {
+    threads.emplace_back([&rgx, &found, t]() {
+      std::vector<std::string> results;
+      size_t match_end = 0;
+      for (int i = 0; i < 1000; i++) {
+        const std::string number = std::to_string(t * 1000 + i);
+        if (rgx.search("Speed LIMIT " + number, 0, results, match_end) && results.size() == 2 && results[1] == number) {
+          found[t]++;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  REQUIRE((found == std::vector<int>(4, 1000)));
+}
+
+#ifdef RE2_SUPPORT
+TEST_CASE("Regex matches in linear time with RE2", "[regexRE2]") {
+  // catastrophic backtracking for backtracking engines
+  const Regex rgx("^(a+)+$");
+  const std::string input = std::string(64, 'a') + "b";
+  std::vector<std::string> results;
+  size_t match_end = 0;
+  const auto start = std::chrono::steady_clock::now();
+  REQUIRE_FALSE(rgx.search(input, 0, results, match_end));
+  REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+
+  // unset optional groups are empty, as with std::regex
+  const Regex optional("a(b)?c");
+  REQUIRE(optional.search("xac", 0, results, match_end));
+  REQUIRE((results == std::vector<std::string>{"ac", ""}));
+  REQUIRE(3 == match_end);
+}
+#endif
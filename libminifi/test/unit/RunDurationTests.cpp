@@ -0,0 +1,224 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <stdexcept>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../TestBase.h"
+#include "Connection.h"
+#include "FlowFileRecord.h"
+#include "ProvenanceTestHelper.h"
+#include "TimerDrivenSchedulingAgent.h"
+#include "core/ProcessContext.h"
+#include "core/ProcessSessionFactory.h"
+#include "core/ProcessorNode.h"
+#include "core/repository/VolatileContentRepository.h"
+#include "properties/Configure.h"
+#include "utils/ThreadPool.h"
+
+namespace {
+
+// triggered until it has seen enough sessions, keeping every session it was given
+class CountingProcessor : public core::Processor {
+ public:
+  CountingProcessor(const std::string &name, bool batching, size_t triggers, std::chrono::milliseconds trigger_time = std::chrono::milliseconds(0))
+      : Processor(name),
+        batching_(batching),
+        triggers_(triggers),
+        trigger_time_(trigger_time) {
+  }
+
+  bool supportsBatching() const override {
+    return batching_;
+  }
+
+  void onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) override {
+    sessions.push_back(session);
+    std::this_thread::sleep_for(trigger_time_);
+    if (sessions.size() % triggers_ == 0) {
+      yield();
+    }
+  }
+
+  size_t distinctSessions() const {
+    std::vector<std::shared_ptr<core::ProcessSession>> distinct(sessions);
+    std::sort(distinct.begin(), distinct.end());
+    return std::unique(distinct.begin(), distinct.end()) - distinct.begin();
+  }
+
+  std::vector<std::shared_ptr<core::ProcessSession>> sessions;
+
+ private:
+  bool batching_;
+  size_t triggers_;
+  std::chrono::milliseconds trigger_time_;
+};
+
+const core::Relationship Success("success", "every flow file created");
+
+// passes on a flow file per trigger, failing on one of the triggers and yielding once its input is empty
+class TransferringProcessor : public core::Processor {
+ public:
+  TransferringProcessor(const std::string &name, size_t failing_trigger)
+      : Processor(name),
+        failing_trigger_(failing_trigger),
+        trigger_count_(0) {
+    setSupportedRelationships({ Success });
+  }
+
+  bool supportsBatching() const override {
+    return true;
+  }
+
+  void onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) override {
+    auto flow_file = session->get();
+    if (!flow_file) {
+      yield();
+      return;
+    }
+    session->transfer(flow_file, Success);
+    if (++trigger_count_ == failing_trigger_) {
+      throw std::runtime_error("failing trigger");
+    }
+  }
+
+ private:
+  size_t failing_trigger_;
+  size_t trigger_count_;
+};
+
+class Dispatcher {
+ public:
+  Dispatcher()
+      : thread_pool_(1),
+        agent_(nullptr, nullptr, nullptr, nullptr, std::make_shared<minifi::Configure>(), thread_pool_),
+        repo_(std::make_shared<TestRepository>()),
+        content_repo_(std::make_shared<core::repository::VolatileContentRepository>()) {
+    content_repo_->initialize(std::make_shared<minifi::Configure>());
+    agent_.start();
+  }
+
+  ~Dispatcher() {
+    thread_pool_.shutdown();
+  }
+
+  // runs a single dispatch of the processor
+  void dispatch(const std::shared_ptr<core::Processor> &processor, std::chrono::milliseconds run_duration) {
+    processor->setRunDurationNano(std::chrono::duration_cast<std::chrono::nanoseconds>(run_duration).count());
+    processor->setScheduledState(core::ScheduledState::RUNNING);
+    processor->incrementActiveTasks();
+    auto node = std::make_shared<core::ProcessorNode>(processor);
+    std::shared_ptr<core::controller::ControllerServiceProvider> controller_services_provider = nullptr;
+    auto context = std::make_shared<core::ProcessContext>(node, controller_services_provider, repo_, repo_, content_repo_);
+    agent_.run(processor, context, std::make_shared<core::ProcessSessionFactory>(context));
+  }
+
+  // the connection the successful flow files of the processor go to
+  std::shared_ptr<minifi::Connection> connectOutput(const std::shared_ptr<core::Processor> &processor) {
+    utils::Identifier uuid;
+    processor->getUUID(uuid);
+    auto connection = std::make_shared<minifi::Connection>(repo_, content_repo_, "output");
+    connection->addRelationship(Success);
+    connection->setSource(processor);
+    connection->setSourceUUID(uuid);
+    processor->addConnection(connection);
+    return connection;
+  }
+
+  // a connection holding flow_files flow files for the processor
+  std::shared_ptr<minifi::Connection> connectInput(const std::shared_ptr<core::Processor> &processor, size_t flow_files) {
+    utils::Identifier uuid;
+    processor->getUUID(uuid);
+    auto connection = std::make_shared<minifi::Connection>(repo_, content_repo_, "input");
+    connection->setDestination(processor);
+    connection->setDestinationUUID(uuid);
+    processor->addConnection(connection);
+    for (size_t i = 0; i < flow_files; i++) {
+      std::shared_ptr<core::FlowFile> flow_file = std::make_shared<minifi::FlowFileRecord>(repo_, content_repo_, std::map<std::string, std::string>());
+      connection->put(flow_file);
+    }
+    return connection;
+  }
+
+ private:
+  utils::ThreadPool<utils::TaskRescheduleInfo> thread_pool_;
+  minifi::TimerDrivenSchedulingAgent agent_;
+  std::shared_ptr<TestRepository> repo_;
+  std::shared_ptr<core::repository::VolatileContentRepository> content_repo_;
+};
+
+}  // namespace
+
+TEST_CASE("Processors are triggered once per dispatch without a run duration", "[runDuration]") {
+  Dispatcher dispatcher;
+  auto processor = std::make_shared<CountingProcessor>("counter", false, 5);
+  dispatcher.dispatch(processor, std::chrono::milliseconds(0));
+  REQUIRE(1 == processor->sessions.size());
+}
+
+TEST_CASE("Processors are triggered until they yield within the run duration", "[runDuration]") {
+  Dispatcher dispatcher;
+  auto processor = std::make_shared<CountingProcessor>("counter", false, 5);
+  dispatcher.dispatch(processor, std::chrono::seconds(10));
+  REQUIRE(5 == processor->sessions.size());
+  REQUIRE(5 == processor->distinctSessions());
+}
+
+TEST_CASE("Batching processors share a session within the run duration", "[runDuration]") {
+  Dispatcher dispatcher;
+  auto processor = std::make_shared<CountingProcessor>("counter", true, 5);
+  dispatcher.dispatch(processor, std::chrono::seconds(10));
+  REQUIRE(5 == processor->sessions.size());
+  REQUIRE(1 == processor->distinctSessions());
+}
+
+TEST_CASE("Processors are not triggered beyond the run duration", "[runDuration]") {
+  Dispatcher dispatcher;
+  auto processor = std::make_shared<CountingProcessor>("counter", false, 1000, std::chrono::milliseconds(10));
+  const auto start = std::chrono::steady_clock::now();
+  dispatcher.dispatch(processor, std::chrono::milliseconds(50));
+  REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(2));
+  REQUIRE(1 < processor->sessions.size());
+  REQUIRE(processor->sessions.size() < 1000);
+}
+
+TEST_CASE("Batches are committed once the run duration is over", "[runDuration]") {
+  Dispatcher dispatcher;
+  auto processor = std::make_shared<TransferringProcessor>("transferring", 0);
+  auto input = dispatcher.connectInput(processor, 5);
+  auto output = dispatcher.connectOutput(processor);
+  dispatcher.dispatch(processor, std::chrono::seconds(10));
+  REQUIRE(input->isEmpty());
+  REQUIRE(5 == output->getQueueSize());
+}
+
+TEST_CASE("Batches are rolled back as a whole when a trigger fails", "[runDuration]") {
+  Dispatcher dispatcher;
+  auto processor = std::make_shared<TransferringProcessor>("transferring", 3);
+  auto input = dispatcher.connectInput(processor, 5);
+  auto output = dispatcher.connectOutput(processor);
+  dispatcher.dispatch(processor, std::chrono::seconds(10));
+  // the flow files taken by the earlier triggers are put back as well
+  REQUIRE(output->isEmpty());
+  REQUIRE(5 == input->getQueueSize());
+}
@@ -0,0 +1,106 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+#include "../TestBase.h"
+#include "utils/ThreadAffinity.h"
+
+namespace {
+
+// two nodes of four cores each
+const utils::ThreadAffinity::Topology TOPOLOGY{{0, 1, 2, 3}, {4, 5, 6, 7}};
+
+std::vector<int> coresOf(const utils::ThreadAffinity &affinity, size_t workers) {
+  std::vector<int> cores;
+  for (size_t worker = 0; worker < workers; worker++) {
+    cores.push_back(affinity.getCore(worker));
+  }
+  return cores;
+}
+
+}  // namespace
+
+TEST_CASE("Parse thread affinity policies", "[threadAffinity]") {
+  utils::ThreadAffinity::Policy policy;
+  REQUIRE(utils::ThreadAffinity::parsePolicy("", policy));
+  REQUIRE(utils::ThreadAffinity::NONE == policy);
+  REQUIRE(utils::ThreadAffinity::parsePolicy(" Compact ", policy));
+  REQUIRE(utils::ThreadAffinity::COMPACT == policy);
+  REQUIRE(utils::ThreadAffinity::parsePolicy("scatter", policy));
+  REQUIRE(utils::ThreadAffinity::SCATTER == policy);
+  REQUIRE(utils::ThreadAffinity::parsePolicy("EXPLICIT", policy));
+  REQUIRE(utils::ThreadAffinity::EXPLICIT == policy);
+  REQUIRE_FALSE(utils::ThreadAffinity::parsePolicy("spread", policy));
+}
+
+TEST_CASE("Parse lists of cores", "[threadAffinity]") {
+  std::vector<int> cores;
+  REQUIRE(utils::ThreadAffinity::parseCoreList("0-3, 8,10-11", cores));
+  REQUIRE((cores == std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+  REQUIRE(utils::ThreadAffinity::parseCoreList("", cores));
+  REQUIRE(cores.empty());
+  REQUIRE_FALSE(utils::ThreadAffinity::parseCoreList("3-1", cores));
+  REQUIRE_FALSE(utils::ThreadAffinity::parseCoreList("a", cores));
+  REQUIRE_FALSE(utils::ThreadAffinity::parseCoreList("1-", cores));
+}
+
+TEST_CASE("Threads are not pinned without a policy", "[threadAffinity]") {
+  utils::ThreadAffinity affinity;
+  REQUIRE_FALSE(affinity.isEnabled());
+  REQUIRE(-1 == affinity.getCore(3));
+  REQUIRE(0 == affinity.getNode(3));
+  REQUIRE_FALSE(utils::ThreadAffinity(utils::ThreadAffinity::EXPLICIT, {}, TOPOLOGY).isEnabled());
+}
+
+TEST_CASE("Compact placement fills up a node first", "[threadAffinity]") {
+  utils::ThreadAffinity affinity(utils::ThreadAffinity::COMPACT, {}, TOPOLOGY);
+  REQUIRE((coresOf(affinity, 10) == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 0, 1}));
+  REQUIRE(0 == affinity.getNode(3));
+  REQUIRE(1 == affinity.getNode(4));
+
+  utils::ThreadAffinity restricted(utils::ThreadAffinity::COMPACT, {2, 3, 6}, TOPOLOGY);
+  REQUIRE((coresOf(restricted, 3) == std::vector<int>{2, 3, 6}));
+}
+
+TEST_CASE("Scatter placement takes turns between nodes", "[threadAffinity]") {
+  utils::ThreadAffinity affinity(utils::ThreadAffinity::SCATTER, {}, TOPOLOGY);
+  REQUIRE((coresOf(affinity, 9) == std::vector<int>{0, 4, 1, 5, 2, 6, 3, 7, 0}));
+  REQUIRE(0 == affinity.getNode(2));
+  REQUIRE(1 == affinity.getNode(3));
+}
+
+TEST_CASE("Explicit placement uses the cores in order", "[threadAffinity]") {
+  utils::ThreadAffinity affinity(utils::ThreadAffinity::EXPLICIT, {6, 1, 42}, TOPOLOGY);
+  REQUIRE((coresOf(affinity, 4) == std::vector<int>{6, 1, 42, 6}));
+  REQUIRE(1 == affinity.getNode(0));
+  REQUIRE(0 == affinity.getNode(1));
+  // cores the topology does not know about are put on the first node
+  REQUIRE(0 == affinity.getNode(2));
+}
+
+TEST_CASE("Detect the topology and pin a thread", "[threadAffinity]") {
+  const auto topology = utils::ThreadAffinity::detectTopology();
+  REQUIRE_FALSE(topology.empty());
+  for (const auto &node : topology) {
+    REQUIRE_FALSE(node.empty());
+  }
+#ifdef __linux__
+  REQUIRE(utils::ThreadAffinity::pinCurrentThread(topology.front().front()));
+  REQUIRE_FALSE(utils::ThreadAffinity::pinCurrentThread(-1));
+#endif
+}
@@ -19,8 +19,11 @@
 #include <utility>
 #include <future>
 #include <memory>
+#include <string>
+#include <vector>
 #include "../TestBase.h"
 #include "utils/ThreadPool.h"
+#include "utils/ThreadAffinity.h"
 
 bool function() {
   return true;
@@ -94,3 +97,49 @@ TEST_CASE("ThreadPoolTest2", "[TPT2]") {
   fut.wait();
   REQUIRE(20 == fut.get());
 }
+
+TEST_CASE("ThreadPoolTest3", "[TPT3]") {
+  counter = 0;
+  utils::ThreadPool<int> pool(5);
+  std::function<int()> f_ex = counterFunction;
+  std::unique_ptr<utils::AfterExecute<int>> after_execute = std::unique_ptr<utils::AfterExecute<int>>(new WorkerNumberExecutions(1000000));
+  utils::Worker<int> functor(f_ex, "id", std::move(after_execute));
+  pool.start();
+  std::future<int> fut;
+  REQUIRE(true == pool.execute(std::move(functor), fut));
+  std::this_thread::sleep_for(std::chrono::milliseconds(120));
+  REQUIRE(false == pool.waitForStoppedTasks("id", std::chrono::milliseconds(10)));
+
+  pool.stopTasks("id");
+  // the task waiting for its next execution is let go without waiting for it
+  REQUIRE(true == pool.waitForStoppedTasks("id", std::chrono::milliseconds(20)));
+  const int runs = counter;
+  std::this_thread::sleep_for(std::chrono::milliseconds(120));
+  REQUIRE(runs == counter);
+}
+
+TEST_CASE("ThreadPool runs tasks on the worker queues of several nodes", "[TPTAffinity]") {
+  const auto topology = utils::ThreadAffinity::detectTopology();
+  const int core = topology.front().front();
+  // two nodes sharing the same core, so the pool keeps a queue for each
+  utils::ThreadAffinity affinity(utils::ThreadAffinity::SCATTER, {}, {{core}, {core}});
+  REQUIRE(affinity.getNode(0) == 0);
+  REQUIRE(affinity.getNode(1) == 1);
+
+  utils::ThreadPool<bool> pool(2);
+  pool.setAffinity(affinity);
+  pool.start();
+  std::vector<std::future<bool>> futures;
+  for (int i = 0; i < 12; i++) {
+    std::function<bool()> f_ex = function;
+    utils::Worker<bool> functor(f_ex, "id" + std::to_string(i));
+    // tasks without a placement or placed on either node all run
+    functor.setPlacement(i % 3 - 1);
+    futures.emplace_back();
+    REQUIRE(true == pool.execute(std::move(functor), futures.back()));
+  }
+  for (auto &future : futures) {
+    REQUIRE(std::future_status::ready == future.wait_for(std::chrono::seconds(5)));
+    REQUIRE(true == future.get());
+  }
+}
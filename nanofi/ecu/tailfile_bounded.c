@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "api/ecu.h"
+#include "core/tail_ring.h"
+#include <unistd.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+/**
+ * Tails a file into a fixed ring of chunks and sends them straight over site to site,
+ * using no more memory than the given limit however fast the file grows. Data is read
+ * from the file only as fast as it can be sent.
+ */
+int main(int argc, char** argv) {
+
+    if (argc < 8) {
+        printf("Error: must run ./tailfile_bounded <file> <interval> <chunksize> <hostname> <tcp port number> <nifi port uuid> <memory limit> [delimiter]\n");
+        exit(1);
+    }
+
+    tailfile_input_params input_params = init_tailfile_chunk_input(argv);
+
+    uint64_t intrvl = 0;
+    uint64_t port_num = 0;
+    if (validate_input_params(&input_params, &intrvl, &port_num) < 0) {
+        return 1;
+    }
+
+    errno = 0;
+    uint64_t chunk_size = strtoull(input_params.chunk_size, NULL, 10);
+    uint64_t memory_limit = strtoull(argv[7], NULL, 10);
+    if (errno != 0) {
+        printf("Invalid chunk size or memory limit specified\n");
+        return 1;
+    }
+
+    tail_ring ring;
+    if (init_tail_ring(&ring, input_params.file, chunk_size, memory_limit) != 0) {
+        printf("A memory limit of %s bytes does not fit a chunk of %s bytes\n", argv[7], input_params.chunk_size);
+        return 1;
+    }
+    if (argc > 8 && strlen(argv[8]) > 0) {
+        set_tail_ring_delimiter(&ring, parse_delimiter(argv[8]));
+    }
+    printf("tailing %s into %zu chunks, using %" PRIu64 " bytes\n", input_params.file, ring.capacity, get_tail_ring_memory(&ring));
+
+    setup_signal_action();
+
+    struct CRawSiteToSiteClient * client = createClient(input_params.instance, port_num, input_params.nifi_port_uuid);
+
+    while (!stopped) {
+        int chunks_read = tail_file_to_ring(&ring);
+        if (ring.count > 0 && transmit_tail_ring(&ring, client) < 0) {
+            printf("Failed to send %zu chunks, they are sent again later\n", ring.count);
+        }
+        // more of the file is waiting when the ring filled up
+        if (chunks_read < (int)ring.capacity || ring.count > 0) {
+            sleep(intrvl);
+        }
+    }
+
+    printf("tailfile bounded stopped\n");
+    destroyClient(client);
+    free(client);
+    free_tail_ring(&ring);
+    return 0;
+}
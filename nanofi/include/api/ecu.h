@@ -79,6 +79,13 @@ void delete_completed_flow_files_from_proc(const char * uuid);
 void update_proc_params(const char * uuid, uint64_t value, flow_file_list * ff);
 processor_params * get_proc_params(const char * uuid);
 
+/**
+ * Parses a delimiter, which may be escaped, such as \n
+ * @param delimiter the delimiter string, which must not be empty
+ * @return the delimiter character
+ */
+char parse_delimiter(const char * delimiter);
+
 void init_common_input(tailfile_input_params * input_params, char ** args);
 tailfile_input_params init_logaggregate_input(char ** args);
 tailfile_input_params init_tailfile_chunk_input(char ** args);
@@ -313,6 +313,15 @@ flow_file_record* create_ff_object_na(const char *file, const size_t len, const
  */
 flow_file_record* create_ff_object_nc();
 
+/**
+ * Creates a flow file record whose content is a buffer of the caller. The buffer is not copied,
+ * so it has to stay valid until the flow file record is transmitted or freed.
+ * @param buffer content of the flow file
+ * @param size size of the buffer
+ * @return a flow file record or nullptr in case no flowfile was generated
+ */
+flow_file_record* create_ff_object_buffer(const uint8_t *buffer, const uint64_t size);
+
 /**
  * Adds content to the flow file record.
  * @param instance the nifi instance
@@ -364,6 +373,7 @@ void update_attribute(flow_file_record* ff, const char *key, void *value, size_t
 
 /**
  * Get the value of an attribute. Value and value size are written to parameter "caller_attribute"
+ * The value points into the flow file and is valid until its attributes are next modified.
  * @param ff flow file
  * @param caller_attribute attribute structure to provide name and get value, size
  * @return 0 in case of success, -1 otherwise (no such attribute)
@@ -409,6 +419,17 @@ int8_t remove_attribute(flow_file_record*, const char * key);
 
 int transmit_flowfile(flow_file_record *, nifi_instance *);
 
+/**
+ * Transmits the flow files in as few site-to-site transactions as possible. Content of files and
+ * buffers of the caller is streamed as it is sent, without being copied or read up front.
+ * @param ffs flow file records
+ * @param count number of flow file records
+ * @param instance nifi instance
+ * @return the number of flow files taken up for transmission, which is less than count when no
+ * peer could be reached, or -1 on invalid arguments
+ */
+int transmit_flowfiles(flow_file_record **ffs, size_t count, nifi_instance *instance);
+
 
 /****
  * ##################################################################
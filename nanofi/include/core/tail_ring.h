@@ -0,0 +1,127 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NANOFI_INCLUDE_CORE_TAIL_RING_H_
+#define NANOFI_INCLUDE_CORE_TAIL_RING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cstructs.h"
+#include "sitetosite/CRawSocketProtocol.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A chunk of the tailed file. Its flow file record refers to the chunk's buffer and is
+ * reused for every chunk read into it, the attributes are sent along with the content.
+ */
+typedef struct tail_chunk {
+    flow_file_record record;
+    uint64_t offset; /**< Offset in the file just past the chunk */
+    char offset_str[21];
+    attribute attributes[2];
+    attribute_set attribute_set;
+} tail_chunk;
+
+/**
+ * Fixed ring of chunks a file is tailed into. Everything is allocated when the ring is
+ * initialized, tailing and sending chunks allocates nothing.
+ */
+typedef struct tail_ring {
+    const char * file_path;
+    uint64_t chunk_size;
+    int delimited;
+    char delimiter;
+    uint64_t offset; /**< Offset in the file tailed up to */
+    uint8_t * buffers;
+    tail_chunk * chunks;
+    CDataPacket * packets;
+    size_t capacity;
+    size_t head; /**< Oldest chunk in the ring */
+    size_t count;
+} tail_ring;
+
+/**
+ * Initializes a ring with as many chunks as fit into the memory limit
+ * @param ring the ring to initialize
+ * @param file_path the file to tail, which has to outlive the ring
+ * @param chunk_size size of the chunks, the maximum size when the file is delimited
+ * @param memory_limit bytes the ring may use, including its buffers
+ * @return 0 on success, -1 if not even one chunk fits into the limit
+ */
+int init_tail_ring(tail_ring * ring, const char * file_path, uint64_t chunk_size, uint64_t memory_limit);
+
+/**
+ * Makes the ring read records ending with the delimiter rather than chunks of a fixed
+ * size. Records longer than the chunk size are split, empty ones are skipped.
+ * @param ring the ring
+ * @param delimiter the delimiter, which is not part of the records
+ */
+void set_tail_ring_delimiter(tail_ring * ring, char delimiter);
+
+/**
+ * @param ring the ring
+ * @return bytes used by the ring
+ */
+uint64_t get_tail_ring_memory(const tail_ring * ring);
+
+/**
+ * Reads chunks from the current offset into the free part of the ring. A chunk which is
+ * not complete yet, such as a record missing its delimiter, is read again next time.
+ * @param ring the ring
+ * @return the number of chunks read, -1 if the file cannot be read
+ */
+int tail_file_to_ring(tail_ring * ring);
+
+/**
+ * @param ring the ring
+ * @param index position of the chunk, the oldest one is at 0
+ * @return the chunk, NULL if there is none at that position
+ */
+tail_chunk * get_tail_chunk(tail_ring * ring, size_t index);
+
+/**
+ * Frees up the oldest chunks of the ring
+ * @param ring the ring
+ * @param count the number of chunks
+ */
+void release_tail_chunks(tail_ring * ring, size_t count);
+
+/**
+ * Sends every chunk of the ring in a single transaction, and frees them up once the peer
+ * confirmed it. They are kept to be sent again otherwise.
+ * @param ring the ring
+ * @param client the site to site client
+ * @return the number of chunks sent, -1 on failure
+ */
+int transmit_tail_ring(tail_ring * ring, struct CRawSiteToSiteClient * client);
+
+/**
+ * Frees the memory of the ring
+ * @param ring the ring
+ */
+void free_tail_ring(tail_ring * ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NANOFI_INCLUDE_CORE_TAIL_RING_H_ */
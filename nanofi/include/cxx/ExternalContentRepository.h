@@ -0,0 +1,150 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef NANOFI_INCLUDE_CXX_EXTERNALCONTENTREPOSITORY_H_
+#define NANOFI_INCLUDE_CXX_EXTERNALCONTENTREPOSITORY_H_
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ResourceClaim.h"
+#include "core/ContentRepository.h"
+#include "io/BaseStream.h"
+#include "properties/Configure.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+
+/**
+ * Read only stream over a buffer owned by someone else, which has to outlive the stream.
+ */
+class ExternalBufferStream : public io::BaseStream {
+ public:
+  ExternalBufferStream(const uint8_t *buffer, uint64_t size)
+      : buffer_(buffer),
+        size_(size),
+        offset_(0) {
+  }
+
+  void seek(uint64_t offset) override {
+    offset_ = offset < size_ ? offset : size_;
+  }
+
+  const uint64_t getSize() const override {
+    return size_;
+  }
+
+  int readData(std::vector<uint8_t> &buf, int buflen) override;
+
+  int readData(uint8_t *buf, int buflen) override;
+
+  int writeData(uint8_t *value, int size) override {
+    return -1;
+  }
+
+ private:
+  const uint8_t *buffer_;
+  uint64_t size_;
+  uint64_t offset_;
+};
+
+/**
+ * Purpose: Lets flow files refer to content owned by the caller of the C API, files and memory
+ * buffers, which is read in place when it is transmitted rather than copied into the content
+ * repository first. That content is never written or removed.
+ *
+ * Claims of any other content are passed on to the content repository of the instance.
+ */
+class ExternalContentRepository : public core::ContentRepository, public std::enable_shared_from_this<ExternalContentRepository> {
+ public:
+  explicit ExternalContentRepository(std::shared_ptr<core::ContentRepository> content_repo)
+      : content_repo_(std::move(content_repo)),
+        buffer_count_(0) {
+  }
+
+  /**
+   * @return a claim on the file at the given path
+   */
+  std::shared_ptr<ResourceClaim> createFileClaim(const std::string &path);
+
+  /**
+   * @return a claim on the given buffer, which has to stay valid as long as the claim is used
+   */
+  std::shared_ptr<ResourceClaim> createBufferClaim(const uint8_t *buffer, uint64_t size);
+
+  bool initialize(const std::shared_ptr<Configure> &configure) override {
+    return true;
+  }
+
+  void stop() override {
+  }
+
+  std::string getStoragePath() const override {
+    return content_repo_->getStoragePath();
+  }
+
+  std::shared_ptr<io::BaseStream> write(const std::shared_ptr<ResourceClaim> &claim, bool append = false) override;
+
+  std::shared_ptr<io::BaseStream> read(const std::shared_ptr<ResourceClaim> &claim) override;
+
+  bool close(const std::shared_ptr<ResourceClaim> &claim) override;
+
+  bool remove(const std::shared_ptr<ResourceClaim> &claim) override;
+
+  bool exists(const std::shared_ptr<ResourceClaim> &claim) override;
+
+  bool removeIfOrphaned(const std::shared_ptr<ResourceClaim> &claim) override;
+
+  uint32_t getStreamCount(const std::shared_ptr<ResourceClaim> &claim) override;
+
+  void incrementStreamCount(const std::shared_ptr<ResourceClaim> &claim) override;
+
+  void decrementStreamCount(const std::shared_ptr<ResourceClaim> &claim) override;
+
+ private:
+  // content of a claim created by this repository, a file when there is no buffer
+  struct ExternalContent {
+    const uint8_t *buffer;
+    uint64_t size;
+  };
+
+  std::shared_ptr<ResourceClaim> createClaim(const std::string &path, const uint8_t *buffer, uint64_t size);
+
+  bool findExternalContent(const std::shared_ptr<ResourceClaim> &claim, ExternalContent &content);
+
+  void forget(const ResourceClaim *claim);
+
+  std::shared_ptr<core::ContentRepository> content_repo_;
+  std::atomic<uint64_t> buffer_count_;
+
+  std::mutex external_content_mutex_;
+  std::map<const ResourceClaim*, ExternalContent> external_content_;
+};
+
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
+
+#endif  // NANOFI_INCLUDE_CXX_EXTERNALCONTENTREPOSITORY_H_
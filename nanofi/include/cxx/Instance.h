@@ -21,6 +21,7 @@
 #include <memory>
 #include <type_traits>
 #include <string>
+#include <vector>
 #include "core/Property.h"
 #include "properties/Configure.h"
 #include "io/StreamFactory.h"
@@ -39,6 +40,7 @@
 #include "core/controller/ControllerServiceProvider.h"
 #include "core/FlowConfiguration.h"
 #include "ReflexiveSession.h"
+#include "ExternalContentRepository.h"
 #include "utils/ThreadPool.h"
 #include "core/state/UpdateController.h"
 #include "core/file_utils.h"
@@ -89,6 +91,7 @@ class Instance {
     proc_node_ = std::make_shared<core::ProcessorNode>(rpg_);
     core::FlowConfiguration::initialize_static_functions();
     content_repo_->initialize(configure_);
+    external_content_repo_ = std::make_shared<ExternalContentRepository>(content_repo_);
   }
 
   ~Instance() {
@@ -132,13 +135,16 @@ class Instance {
     return content_repo_;
   }
 
-  void transfer(const std::shared_ptr<FlowFileRecord> &ff, const std::shared_ptr<minifi::io::DataStream> &stream = nullptr) {
-    std::shared_ptr<core::controller::ControllerServiceProvider> controller_service_provider = nullptr;
-    auto processContext = std::make_shared<core::ProcessContext>(proc_node_, controller_service_provider, no_op_repo_, no_op_repo_, configure_, content_repo_);
-    auto sessionFactory = std::make_shared<core::ProcessSessionFactory>(processContext);
-
-    rpg_->onSchedule(processContext, sessionFactory);
+  /**
+   * Content repository through which flow files can refer to files and buffers of the caller,
+   * which are then transmitted without being copied.
+   */
+  std::shared_ptr<ExternalContentRepository> getExternalContentRepository() const {
+    return external_content_repo_;
+  }
 
+  void transfer(const std::shared_ptr<FlowFileRecord> &ff, const std::shared_ptr<minifi::io::DataStream> &stream = nullptr) {
+    auto processContext = createProcessContext();
     auto session = std::make_shared<core::ReflexiveSession>(processContext);
 
     session->add(ff);
@@ -148,8 +154,40 @@ class Instance {
     rpg_->onTrigger(processContext, session);
   }
 
+  /**
+   * Transmits the flow files in as few site-to-site transactions as possible.
+   * @return the number of flow files which were taken up for transmission; the remaining ones
+   * could not be, e.g. as no peer was available
+   */
+  size_t transfer(const std::vector<std::shared_ptr<FlowFileRecord>> &ffs) {
+    auto processContext = createProcessContext();
+    auto session = std::make_shared<core::ReflexiveSession>(processContext);
+
+    for (const auto &ff : ffs) {
+      session->add(ff);
+    }
+    // a transaction ends once it has taken longer than the batch duration, leaving the rest for the next one
+    while (session->size() > 0) {
+      const size_t remaining = session->size();
+      rpg_->onTrigger(processContext, session);
+      if (session->size() == remaining) {
+        break;
+      }
+    }
+    return ffs.size() - session->size();
+  }
+
  protected:
 
+  std::shared_ptr<core::ProcessContext> createProcessContext() {
+    std::shared_ptr<core::controller::ControllerServiceProvider> controller_service_provider = nullptr;
+    auto processContext = std::make_shared<core::ProcessContext>(proc_node_, controller_service_provider, no_op_repo_, no_op_repo_, configure_, external_content_repo_);
+    auto sessionFactory = std::make_shared<core::ProcessSessionFactory>(processContext);
+
+    rpg_->onSchedule(processContext, sessionFactory);
+    return processContext;
+  }
+
   bool registerUpdateListener(const std::shared_ptr<state::UpdateController> &updateController, const int64_t &delay) {
     auto functions = updateController->getFunctions();
     // run all functions independently
@@ -173,6 +211,7 @@ class Instance {
 
   std::shared_ptr<minifi::core::Repository> no_op_repo_;
   std::shared_ptr<minifi::core::ContentRepository> content_repo_;
+  std::shared_ptr<ExternalContentRepository> external_content_repo_;
 
   std::shared_ptr<core::ProcessorNode> proc_node_;
   std::shared_ptr<minifi::RemoteProcessorGroupPort> rpg_;
@@ -54,7 +54,7 @@ using content_repo_sptr = std::shared_ptr<core::ContentRepository>;
 
 struct flowfile_input_params {
   std::shared_ptr<minifi::io::DataStream> content_stream;
-  std::map<std::string, std::string> attributes;
+  minifi::core::FlowFileAttributes attributes;
 };
 
 namespace {
@@ -19,6 +19,7 @@
 #define __REFLEXIVE_SESSION_H__
 
 #include <vector>
+#include <deque>
 #include <queue>
 #include <map>
 #include <mutex>
@@ -49,21 +50,29 @@ class ReflexiveSession : public ProcessSession{
   virtual ~ReflexiveSession() = default;
 
    virtual std::shared_ptr<core::FlowFile> get(){
-     auto prevff = ff;
-     ff = nullptr;
+     if (flow_files_.empty()) {
+       return nullptr;
+     }
+     auto prevff = flow_files_.front();
+     flow_files_.pop_front();
      return prevff;
    }
 
    virtual void add(const std::shared_ptr<core::FlowFile> &flow){
-     ff = flow;
+     flow_files_.push_back(flow);
    }
    virtual void transfer(const std::shared_ptr<core::FlowFile> &flow, Relationship relationship){
      // no op
    }
+
+   // number of flow files which were added but not taken yet
+   size_t size() const {
+     return flow_files_.size();
+   }
  protected:
   //
-  // Get the FlowFile from the highest priority queue
-  std::shared_ptr<core::FlowFile> ff;
+  // FlowFiles in the order they were added
+  std::deque<std::shared_ptr<core::FlowFile>> flow_files_;
 
 };
 
@@ -72,6 +72,13 @@ int confirm(struct CRawSiteToSiteClient * client, const char * transactionID);
 
 int transmitPayload(struct CRawSiteToSiteClient * client, const char * payload, const attribute_set * attributes);
 
+/**
+ * Sends the packets in a single transaction. Payloads are sent as they are, so they may
+ * contain binary data.
+ * @return 0 when the peer confirmed the transaction
+ */
+int transmitPackets(struct CRawSiteToSiteClient * client, CDataPacket * packets, size_t count);
+
 int16_t sendPacket(struct CRawSiteToSiteClient * client, const char * transactionID, CDataPacket *packet, flow_file_record * ff);
 
 CTransaction* createTransaction(struct CRawSiteToSiteClient * client, TransferDirection direction);
@@ -400,14 +400,20 @@ typedef struct {
   const attribute_set * _attributes;
   CTransaction* transaction_;
   const char * payload_;
+  uint64_t _payload_size;
 } CDataPacket;
 
-static void initPacket(CDataPacket * packet, CTransaction* transaction, const attribute_set * attributes, const char * payload) {
+static void initPacketWithSize(CDataPacket * packet, CTransaction* transaction, const attribute_set * attributes, const char * payload, uint64_t payload_size) {
   packet->payload_ = payload;
+  packet->_payload_size = payload_size;
   packet->transaction_ = transaction;
   packet->_attributes = attributes;
 }
 
+static void initPacket(CDataPacket * packet, CTransaction* transaction, const attribute_set * attributes, const char * payload) {
+  initPacketWithSize(packet, transaction, attributes, payload, payload ? strlen(payload) : 0);
+}
+
 
 #if defined(__GNUC__) || defined(__GNUG__)
 #pragma GCC diagnostic pop
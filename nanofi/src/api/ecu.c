@@ -350,6 +350,30 @@ flow_file_info log_aggregate(const char * file_path, char delim, processor_conte
     return ff_info;
 }
 
+char parse_delimiter(const char * delimiter) {
+    char delim = delimiter[0];
+
+    if (delim == '\\' && strlen(delimiter) > 1) {
+        switch (delimiter[1]) {
+          case 'r':
+            delim = '\r';
+            break;
+          case 't':
+            delim = '\t';
+            break;
+          case 'n':
+            delim = '\n';
+            break;
+          case '\\':
+            delim = '\\';
+            break;
+          default:
+            break;
+        }
+    }
+    return delim;
+}
+
 struct proc_properties * get_properties(const char * uuid, processor_context * ctx) {
     struct proc_properties * props = get_processor_properties(uuid);
     if (props) {
@@ -376,28 +400,7 @@ struct proc_properties * get_properties(const char * uuid, processor_context * c
     props = (struct proc_properties *)malloc(sizeof(struct proc_properties));
     memset(props, 0, sizeof(struct proc_properties));
 
-    char delim = delimiter[0];
-
-    if (delim == '\\') {
-          if (strlen(delimiter) > 1) {
-            switch (delimiter[1]) {
-              case 'r':
-                delim = '\r';
-                break;
-              case 't':
-                delim = '\t';
-                break;
-              case 'n':
-                delim = '\n';
-                break;
-              case '\\':
-                delim = '\\';
-                break;
-              default:
-                break;
-            }
-        }
-    }
+    char delim = parse_delimiter(delimiter);
 
     int len = strlen(file_path);
     props->file_path = (char *)malloc((len + 1) * sizeof(char));
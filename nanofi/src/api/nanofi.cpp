@@ -19,6 +19,7 @@
 #include <map>
 #include <memory>
 #include <utility>
+#include <vector>
 #include <exception>
 #include <stdio.h>
 
@@ -32,9 +33,10 @@
 #include "core/logging/LoggerConfiguration.h"
 #include "utils/StringUtils.h"
 #include "io/DataStream.h"
+#include "io/FileStream.h"
 #include "core/cxxstructs.h"
 
-using string_map = std::map<std::string, std::string>;
+using string_map = minifi::core::FlowFileAttributes;
 
 class API_INITIALIZER {
  public:
@@ -268,6 +270,7 @@ flow_file_record* create_ff_object_na(const char *file, const size_t len, const
   }
   new_ff->crp = static_cast<void*>(new std::shared_ptr<minifi::core::ContentRepository>);
   new_ff->ffp = nullptr;
+  new_ff->in = nullptr;
   new_ff->keepContent = 0;
   return new_ff;
 }
@@ -278,6 +281,14 @@ flow_file_record* create_ff_object_nc() {
   return new_ff;
 }
 
+flow_file_record* create_ff_object_buffer(const uint8_t *buffer, const uint64_t size) {
+  NULL_CHECK(nullptr, buffer);
+  flow_file_record* new_ff = create_ff_object_nc();
+  new_ff->in = const_cast<uint8_t*>(buffer);
+  new_ff->size = size;
+  return new_ff;
+}
+
 flow_file_record * generate_flow(processor_context * ctx) {
     flow_file_record * ffr = create_ff_object_nc();
 
@@ -370,8 +381,7 @@ int8_t add_attribute(flow_file_record *ff, const char *key, void *value, size_t
   NULL_CHECK(-1, ff, key, value);
   NULL_CHECK(-1, ff->attributes);
   auto attribute_map = static_cast<string_map*>(ff->attributes);
-  const auto& ret = attribute_map->insert(std::pair<std::string, std::string>(key, std::string(static_cast<char*>(value), size)));
-  return ret.second ? 0 : -1;
+  return attribute_map->insert(key, std::string(static_cast<char*>(value), size)) ? 0 : -1;
 }
 
 /**
@@ -385,7 +395,7 @@ void update_attribute(flow_file_record *ff, const char *key, void *value, size_t
   NULL_CHECK(, ff, key);
   NULL_CHECK(, ff->attributes);
   auto attribute_map = static_cast<string_map*>(ff->attributes);
-  (*attribute_map)[key] = std::string(static_cast<char*>(value), size);
+  attribute_map->set(key, std::string(static_cast<char*>(value), size));
 }
 
 /*
@@ -453,69 +463,88 @@ int get_content(const flow_file_record* ff, uint8_t* target, int size) {
                                                                                            *content_repo);
     auto stream = (*content_repo)->read(claim);
     return stream->read(target, size);
-  } else {
-    file_buffer fb = file_to_buffer(ff->contentLocation);
-    size_t copy_size = size < fb.file_len ? size : fb.file_len;
-    memcpy(target, fb.buffer, copy_size*sizeof(uint8_t));
-    free(fb.buffer);
+  } else if (ff->in) {
+    size_t copy_size = size < ff->size ? size : ff->size;
+    memcpy(target, ff->in, copy_size*sizeof(uint8_t));
     return copy_size;
+  } else {
+    minifi::io::FileStream stream(ff->contentLocation, 0, false);
+    return stream.read(target, size);
+  }
+}
+
+namespace {
+
+/**
+ * Creates the flow file which transmits a record. Content owned by the caller, a file or a
+ * buffer, is read in place when it is sent rather than copied.
+ */
+std::shared_ptr<minifi::FlowFileRecord> create_transmitted_flowfile(flow_file_record *ff, minifi::Instance *minifi_instance_ref) {
+  static const string_map empty_attribute_map;
+
+  const string_map& attribute_map = ff->attributes ? *static_cast<string_map *>(ff->attributes) : empty_attribute_map;
+
+  auto no_op = minifi_instance_ref->getNoOpRepository();
+
+  std::shared_ptr<minifi::core::ContentRepository> content_repo = minifi_instance_ref->getExternalContentRepository();
+
+  std::shared_ptr<minifi::ResourceClaim> claim = nullptr;
+
+  auto ff_content_repo_ptr = static_cast<std::shared_ptr<minifi::core::ContentRepository>*>(ff->crp);
+  if (ff->contentLocation && ff->crp && (*ff_content_repo_ptr)) {
+    content_repo = *ff_content_repo_ptr;
+    claim = std::make_shared<minifi::ResourceClaim>(ff->contentLocation, content_repo);
+    claim->increaseFlowFileRecordOwnedCount();
+    claim->increaseFlowFileRecordOwnedCount();
+  } else if (ff->contentLocation) {
+    claim = minifi_instance_ref->getExternalContentRepository()->createFileClaim(ff->contentLocation);
+  } else if (ff->in) {
+    claim = minifi_instance_ref->getExternalContentRepository()->createBufferClaim(static_cast<const uint8_t*>(ff->in), ff->size);
   }
+  // a flow file without a claim is sent without content
+
+  auto ffr = std::make_shared<minifi::FlowFileRecord>(no_op, content_repo, attribute_map.toMap(), claim);
+  ffr->addAttribute("nanofi.version", API_VERSION);
+  ffr->setSize(claim ? ff->size : 0);
+  return ffr;
 }
 
+}  // namespace
+
 /**
  * Transmits the flowfile
  * @param ff flow file record
  * @param instance nifi instance structure
  */
 int transmit_flowfile(flow_file_record *ff, nifi_instance *instance) {
-  static string_map empty_attribute_map;
-
   NULL_CHECK(-1, ff, instance);
+  return transmit_flowfiles(&ff, 1, instance) == 1 ? 0 : -1;
+}
+
+/**
+ * Transmits the flowfiles in as few site-to-site transactions as possible
+ * @param ffs flow file records
+ * @param count number of flow file records
+ * @param instance nifi instance structure
+ */
+int transmit_flowfiles(flow_file_record **ffs, size_t count, nifi_instance *instance) {
+  NULL_CHECK(-1, ffs, instance);
+  for (size_t i = 0; i < count; ++i) {
+    NULL_CHECK(-1, ffs[i]);
+  }
   auto minifi_instance_ref = static_cast<minifi::Instance*>(instance->instance_ptr);
   // in the unlikely event the user forgot to initialize the instance, we shall do it for them.
   if (UNLIKELY(minifi_instance_ref->isRPGConfigured() == false)) {
     minifi_instance_ref->setRemotePort(instance->port.port_id);
   }
 
-  string_map& attribute_map = empty_attribute_map;
-  if(ff->attributes) {
-    attribute_map = *(static_cast<string_map *>(ff->attributes));
+  std::vector<std::shared_ptr<minifi::FlowFileRecord>> flow_files;
+  flow_files.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    flow_files.push_back(create_transmitted_flowfile(ffs[i], minifi_instance_ref));
   }
 
-  auto no_op = minifi_instance_ref->getNoOpRepository();
-
-  auto content_repo = minifi_instance_ref->getContentRepository();
-
-  std::shared_ptr<minifi::ResourceClaim> claim = nullptr;
-  std::shared_ptr<minifi::io::DataStream> stream = nullptr; //Used when content is not in content repo
-
-  if(ff->contentLocation) {
-    auto ff_content_repo_ptr = (static_cast<std::shared_ptr<minifi::core::ContentRepository>*>(ff->crp));
-    if (ff->crp && (*ff_content_repo_ptr)) {
-      content_repo = *ff_content_repo_ptr;
-      claim = std::make_shared<minifi::ResourceClaim>(ff->contentLocation, content_repo);
-      claim->increaseFlowFileRecordOwnedCount();
-      claim->increaseFlowFileRecordOwnedCount();
-    } else {
-      file_buffer fb = file_to_buffer(ff->contentLocation);
-      stream = std::make_shared<minifi::io::DataStream>();
-      stream->writeData(fb.buffer, fb.file_len);
-      free(fb.buffer);
-    }
-  } else {
-    //The flowfile has no content - create an empty stream to create empty content
-    stream = std::make_shared<minifi::io::DataStream>();
-  }
-
-  auto ffr = std::make_shared<minifi::FlowFileRecord>(no_op, content_repo, attribute_map, claim);
-  ffr->addAttribute("nanofi.version", API_VERSION);
-  ffr->setSize(ff->size);
-
-  std::string port_uuid = instance->port.port_id;
-
-  minifi_instance_ref->transfer(ffr, stream);
-
-  return 0;
+  return minifi_instance_ref->transfer(flow_files);
 }
 
 flow * create_new_flow(nifi_instance * instance) {
@@ -700,14 +729,15 @@ flow_file_record *invoke_ff(standalone_processor* proc, const flow_file_record *
       std::shared_ptr<minifi::ResourceClaim> claim = std::make_shared<minifi::ResourceClaim>(input_ff->contentLocation,
                                                                                              *content_repo);
       ff_data->content_stream = (*content_repo)->read(claim);
+    } else if (input_ff->contentLocation) {
+      ff_data->content_stream = std::make_shared<minifi::io::FileStream>(input_ff->contentLocation, 0, false);
+    } else if (input_ff->in) {
+      ff_data->content_stream = std::make_shared<minifi::ExternalBufferStream>(static_cast<const uint8_t*>(input_ff->in), input_ff->size);
     } else {
       ff_data->content_stream = std::make_shared<minifi::io::DataStream>();
-      file_buffer fb = file_to_buffer(input_ff->contentLocation);
-      ff_data->content_stream->writeData(fb.buffer, fb.file_len);
-      free(fb.buffer);
     }
 
-    ff_data->attributes = *static_cast<std::map<std::string, std::string> *>(input_ff->attributes);
+    ff_data->attributes = *static_cast<string_map *>(input_ff->attributes);
     plan->runNextProcessor(nullptr, ff_data);
   }
   while (plan->runNextProcessor()) {
@@ -729,8 +759,7 @@ flow_file_record *invoke_chunk(standalone_processor* proc, uint8_t* buf, uint64_
   plan->reset();
 
   auto ff_data = std::make_shared<flowfile_input_params>();
-  ff_data->content_stream = std::make_shared<minifi::io::DataStream>();
-  ff_data->content_stream->writeData(buf, size);
+  ff_data->content_stream = std::make_shared<minifi::ExternalBufferStream>(buf, size);
 
   plan->runNextProcessor(nullptr, ff_data);
   while (plan->runNextProcessor()) {
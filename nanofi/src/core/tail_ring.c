@@ -0,0 +1,184 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <inttypes.h>
+
+#include "core/tail_ring.h"
+
+static const uint64_t CHUNK_OVERHEAD = sizeof(tail_chunk) + sizeof(CDataPacket);
+
+int init_tail_ring(tail_ring * ring, const char * file_path, uint64_t chunk_size, uint64_t memory_limit) {
+    memset(ring, 0, sizeof(tail_ring));
+    if (!file_path || chunk_size == 0 || chunk_size > memory_limit || memory_limit < sizeof(tail_ring)) {
+        return -1;
+    }
+
+    uint64_t capacity = (memory_limit - sizeof(tail_ring)) / (chunk_size + CHUNK_OVERHEAD);
+    if (capacity == 0 || capacity > SIZE_MAX / (chunk_size + CHUNK_OVERHEAD)) {
+        return -1;
+    }
+
+    ring->buffers = (uint8_t *)malloc(capacity * chunk_size);
+    ring->chunks = (tail_chunk *)malloc(capacity * sizeof(tail_chunk));
+    ring->packets = (CDataPacket *)malloc(capacity * sizeof(CDataPacket));
+    if (!ring->buffers || !ring->chunks || !ring->packets) {
+        free_tail_ring(ring);
+        return -1;
+    }
+    memset(ring->chunks, 0, capacity * sizeof(tail_chunk));
+
+    ring->file_path = file_path;
+    ring->chunk_size = chunk_size;
+    ring->capacity = capacity;
+
+    size_t i;
+    for (i = 0; i < capacity; ++i) {
+        tail_chunk * chunk = &ring->chunks[i];
+        chunk->record.in = ring->buffers + i * chunk_size;
+        chunk->attributes[0].key = "tailfile path";
+        chunk->attributes[0].value = (void *)file_path;
+        chunk->attributes[0].value_size = strlen(file_path);
+        chunk->attributes[1].key = "current offset";
+        chunk->attributes[1].value = chunk->offset_str;
+        chunk->attribute_set.attributes = chunk->attributes;
+        chunk->attribute_set.size = 2;
+    }
+    return 0;
+}
+
+void set_tail_ring_delimiter(tail_ring * ring, char delimiter) {
+    ring->delimited = 1;
+    ring->delimiter = delimiter;
+}
+
+uint64_t get_tail_ring_memory(const tail_ring * ring) {
+    return sizeof(tail_ring) + ring->capacity * (ring->chunk_size + CHUNK_OVERHEAD);
+}
+
+int tail_file_to_ring(tail_ring * ring) {
+    if (ring->count == ring->capacity) {
+        return 0;
+    }
+
+    int fd = open(ring->file_path, O_RDONLY);
+    if (fd < 0) {
+        printf("Unable to open file. {file: %s, reason: %s}\n", ring->file_path, strerror(errno));
+        return -1;
+    }
+
+    int chunks_read = 0;
+    while (ring->count < ring->capacity) {
+        tail_chunk * chunk = &ring->chunks[(ring->head + ring->count) % ring->capacity];
+        uint8_t * buffer = (uint8_t *)chunk->record.in;
+
+        ssize_t bytes_read = pread(fd, buffer, ring->chunk_size, ring->offset);
+        if (bytes_read < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            printf("Unable to read file. {file: %s, reason: %s}\n", ring->file_path, strerror(errno));
+            close(fd);
+            return chunks_read > 0 ? chunks_read : -1;
+        }
+
+        uint64_t chunk_bytes = bytes_read;
+        uint64_t consumed = bytes_read;
+        if (ring->delimited) {
+            const uint8_t * end = (const uint8_t *)memchr(buffer, ring->delimiter, bytes_read);
+            if (end) {
+                chunk_bytes = end - buffer;
+                consumed = chunk_bytes + 1;
+            } else if ((uint64_t)bytes_read < ring->chunk_size) {
+                break;
+            }
+        } else if ((uint64_t)bytes_read < ring->chunk_size) {
+            break;
+        }
+
+        ring->offset += consumed;
+        if (chunk_bytes == 0) {
+            continue;
+        }
+
+        chunk->record.size = chunk_bytes;
+        chunk->offset = ring->offset;
+        snprintf(chunk->offset_str, sizeof(chunk->offset_str), "%"PRIu64, chunk->offset);
+        chunk->attributes[1].value_size = strlen(chunk->offset_str);
+        ring->count++;
+        chunks_read++;
+    }
+    close(fd);
+    return chunks_read;
+}
+
+tail_chunk * get_tail_chunk(tail_ring * ring, size_t index) {
+    if (index >= ring->count) {
+        return NULL;
+    }
+    return &ring->chunks[(ring->head + index) % ring->capacity];
+}
+
+void release_tail_chunks(tail_ring * ring, size_t count) {
+    if (count > ring->count) {
+        count = ring->count;
+    }
+    if (count == 0) {
+        return;
+    }
+    ring->head = (ring->head + count) % ring->capacity;
+    ring->count -= count;
+}
+
+int transmit_tail_ring(tail_ring * ring, struct CRawSiteToSiteClient * client) {
+    if (!client) {
+        return -1;
+    }
+    if (ring->count == 0) {
+        return 0;
+    }
+
+    size_t count = ring->count;
+    size_t i;
+    for (i = 0; i < count; ++i) {
+        tail_chunk * chunk = get_tail_chunk(ring, i);
+        initPacketWithSize(&ring->packets[i], NULL, &chunk->attribute_set, (const char *)chunk->record.in, chunk->record.size);
+    }
+
+    if (transmitPackets(client, ring->packets, count) != 0) {
+        return -1;
+    }
+    release_tail_chunks(ring, count);
+    return count;
+}
+
+void free_tail_ring(tail_ring * ring) {
+    free(ring->buffers);
+    free(ring->chunks);
+    free(ring->packets);
+    ring->buffers = NULL;
+    ring->chunks = NULL;
+    ring->packets = NULL;
+    ring->capacity = 0;
+    ring->count = 0;
+}
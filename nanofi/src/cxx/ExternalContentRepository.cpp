@@ -0,0 +1,172 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "cxx/ExternalContentRepository.h"
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "io/FileStream.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+
+int ExternalBufferStream::readData(std::vector<uint8_t> &buf, int buflen) {
+  if (buflen < 0) {
+    return -1;
+  }
+  if (buf.size() < static_cast<size_t>(buflen)) {
+    buf.resize(buflen);
+  }
+  return readData(buf.data(), buflen);
+}
+
+int ExternalBufferStream::readData(uint8_t *buf, int buflen) {
+  if (buflen < 0) {
+    return -1;
+  }
+  const uint64_t remaining = size_ - offset_;
+  const int read_size = remaining < static_cast<uint64_t>(buflen) ? static_cast<int>(remaining) : buflen;
+  std::memcpy(buf, buffer_ + offset_, read_size);
+  offset_ += read_size;
+  return read_size;
+}
+
+std::shared_ptr<ResourceClaim> ExternalContentRepository::createFileClaim(const std::string &path) {
+  return createClaim(path, nullptr, 0);
+}
+
+std::shared_ptr<ResourceClaim> ExternalContentRepository::createBufferClaim(const uint8_t *buffer, uint64_t size) {
+  // the path only tells claims apart, e.g. to count their owners
+  return createClaim("nanofi-buffer-" + std::to_string(buffer_count_++), buffer, size);
+}
+
+std::shared_ptr<ResourceClaim> ExternalContentRepository::createClaim(const std::string &path, const uint8_t *buffer, uint64_t size) {
+  // claims are forgotten when they are removed, or once they are released if they never were
+  const std::weak_ptr<ExternalContentRepository> repository = shared_from_this();
+  std::shared_ptr<ResourceClaim> claim(new ResourceClaim(path, shared_from_this()), [repository](ResourceClaim *released) {
+    if (auto repo = repository.lock()) {
+      repo->forget(released);
+    }
+    delete released;
+  });
+  std::lock_guard<std::mutex> lock(external_content_mutex_);
+  external_content_[claim.get()] = ExternalContent{buffer, size};
+  return claim;
+}
+
+void ExternalContentRepository::forget(const ResourceClaim *claim) {
+  std::lock_guard<std::mutex> lock(external_content_mutex_);
+  external_content_.erase(claim);
+}
+
+bool ExternalContentRepository::findExternalContent(const std::shared_ptr<ResourceClaim> &claim, ExternalContent &content) {
+  std::lock_guard<std::mutex> lock(external_content_mutex_);
+  auto it = external_content_.find(claim.get());
+  // entries go before their claims are released, so no other claim can have taken the address
+  if (it == external_content_.end()) {
+    return false;
+  }
+  content = it->second;
+  return true;
+}
+
+std::shared_ptr<io::BaseStream> ExternalContentRepository::write(const std::shared_ptr<ResourceClaim> &claim, bool append) {
+  ExternalContent content;
+  if (findExternalContent(claim, content)) {
+    return nullptr;
+  }
+  return content_repo_->write(claim, append);
+}
+
+std::shared_ptr<io::BaseStream> ExternalContentRepository::read(const std::shared_ptr<ResourceClaim> &claim) {
+  ExternalContent content;
+  if (!findExternalContent(claim, content)) {
+    return content_repo_->read(claim);
+  }
+  if (content.buffer != nullptr) {
+    return std::make_shared<ExternalBufferStream>(content.buffer, content.size);
+  }
+  return std::make_shared<io::FileStream>(claim->getContentFullPath(), 0, false);
+}
+
+bool ExternalContentRepository::close(const std::shared_ptr<ResourceClaim> &claim) {
+  ExternalContent content;
+  return findExternalContent(claim, content) || content_repo_->close(claim);
+}
+
+bool ExternalContentRepository::remove(const std::shared_ptr<ResourceClaim> &claim) {
+  ExternalContent content;
+  if (!findExternalContent(claim, content)) {
+    return content_repo_->remove(claim);
+  }
+  // the content itself belongs to the caller
+  forget(claim.get());
+  return true;
+}
+
+bool ExternalContentRepository::exists(const std::shared_ptr<ResourceClaim> &claim) {
+  ExternalContent content;
+  if (!findExternalContent(claim, content)) {
+    return content_repo_->exists(claim);
+  }
+  return content.buffer != nullptr || std::ifstream(claim->getContentFullPath()).good();
+}
+
+bool ExternalContentRepository::removeIfOrphaned(const std::shared_ptr<ResourceClaim> &claim) {
+  ExternalContent content;
+  if (findExternalContent(claim, content)) {
+    return ContentRepository::removeIfOrphaned(claim);
+  }
+  return content_repo_->removeIfOrphaned(claim);
+}
+
+uint32_t ExternalContentRepository::getStreamCount(const std::shared_ptr<ResourceClaim> &claim) {
+  ExternalContent content;
+  if (findExternalContent(claim, content)) {
+    return ContentRepository::getStreamCount(claim);
+  }
+  return content_repo_->getStreamCount(claim);
+}
+
+void ExternalContentRepository::incrementStreamCount(const std::shared_ptr<ResourceClaim> &claim) {
+  ExternalContent content;
+  if (findExternalContent(claim, content)) {
+    ContentRepository::incrementStreamCount(claim);
+  } else {
+    content_repo_->incrementStreamCount(claim);
+  }
+}
+
+void ExternalContentRepository::decrementStreamCount(const std::shared_ptr<ResourceClaim> &claim) {
+  ExternalContent content;
+  if (findExternalContent(claim, content)) {
+    ContentRepository::decrementStreamCount(claim);
+  } else {
+    content_repo_->decrementStreamCount(claim);
+  }
+}
+
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
@@ -27,6 +27,12 @@ int openPeer(struct SiteToSiteCPeer * peer) {
     return -1;
   }
 
+  // a socket closed by an earlier tear down cannot be reused, so it is replaced by a new connection
+  if(peer->_stream != NULL && peer->_stream->socket_ == -1) {
+    free_socket(peer->_stream);
+    peer->_stream = NULL;
+  }
+
   //In case there was no socket injected, let's create it
   if(peer->_stream == NULL) {
     peer->_stream = create_socket(peer->_host, peer->_port);
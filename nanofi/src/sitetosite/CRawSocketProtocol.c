@@ -392,9 +392,21 @@ CTransaction* createTransaction(struct CRawSiteToSiteClient * client, TransferDi
 }
 
 int transmitPayload(struct CRawSiteToSiteClient * client, const char * payload, const attribute_set * attributes) {
+  if (payload == NULL && attributes == NULL) {
+    return -1;
+  }
+
+  CDataPacket packet;
+
+  initPacket(&packet, NULL, attributes, payload);
+
+  return transmitPackets(client, &packet, 1);
+}
+
+int transmitPackets(struct CRawSiteToSiteClient * client, CDataPacket * packets, size_t count) {
   CTransaction* transaction = NULL;
 
-  if (payload == NULL && attributes == NULL) {
+  if (packets == NULL || count == 0) {
     return -1;
   }
 
@@ -419,18 +431,17 @@ int transmitPayload(struct CRawSiteToSiteClient * client, const char * payload,
 
   transactionID = getUUIDStr(transaction);
 
-  CDataPacket packet;
-
-  initPacket(&packet, transaction, attributes, payload);
-
-  int16_t resp = sendPacket(client, transactionID, &packet, NULL);
-  if (resp != 0) {
-    deleteTransaction(client, transactionID);
-    tearDown(client);
-    return resp;
+  size_t i;
+  for (i = 0; i < count; ++i) {
+    packets[i].transaction_ = transaction;
+    int16_t resp = sendPacket(client, transactionID, &packets[i], NULL);
+    if (resp != 0) {
+      deleteTransaction(client, transactionID);
+      tearDown(client);
+      return resp;
+    }
   }
-  logc(info, "Site2Site transaction %s sent bytes length %zu", transactionID, strlen(payload));
-
+  logc(info, "Site2Site transaction %s sent %zu packets, bytes length %"PRIu64, transactionID, count, transaction->_bytes);
 
   int ret = confirm(client, transactionID);
 
@@ -726,20 +737,25 @@ int confirm(struct CRawSiteToSiteClient * client, const char * transactionID) {
 
       if(content_size > 0 && ff->crp != NULL) {
         content_buf = (uint8_t*)malloc(content_size*sizeof(uint8_t));
-        len = get_content(ff, content_buf, content_size);
-        if(len <= 0) {
+        // get_content reports failures as negative lengths, which must not wrap around in len
+        int content_len = get_content(ff, content_buf, content_size);
+        if(content_len <= 0) {
+          free(content_buf);
           return -2;
         }
+        len = content_len;
         ret = write_uint64t(transaction, len);
         if (ret != 8) {
           logc(debug, "ret != 8");
+          free(content_buf);
           return -1;
         }
         writeData(transaction, content_buf, len);
+        free(content_buf);
       }
 
-    } else if (packet->payload_ != NULL && strlen(packet->payload_) > 0) {
-      len = strlen(packet->payload_);
+    } else if (packet->payload_ != NULL && packet->_payload_size > 0) {
+      len = packet->_payload_size;
 
       ret = write_uint64t(transaction, len);
       if (ret != 8) {
@@ -18,9 +18,14 @@
 #include <utility>
 #include <string>
 #include <fstream>
+#include <memory>
+#include <vector>
 #include "utils/file/FileUtils.h"
 #include "TestBase.h"
 #include "api/nanofi.h"
+#include "core/repository/VolatileContentRepository.h"
+#include "cxx/ExternalContentRepository.h"
+#include "cxx/Instance.h"
 
 const std::string test_file_content = "C API raNdOMcaSe test d4t4 th1s is!";
 const std::string test_file_name = "tstFile.ext";
@@ -36,6 +41,60 @@ static int failure_count = 0;
 
 static int custom_onschedule_count = 0;
 
+/**
+ * Takes up to a number of flow files per transaction instead of sending them to a peer,
+ * reading their content through the session.
+ */
+class RecordingPort : public minifi::RemoteProcessorGroupPort {
+ public:
+  RecordingPort(const std::shared_ptr<minifi::Configure> &configure, size_t per_transaction)
+      : RemoteProcessorGroupPort(minifi::io::StreamFactory::getInstance(configure), "recording", "", configure),
+        per_transaction_(per_transaction) {
+  }
+
+  void onSchedule(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory) override {
+  }
+
+  void onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) override {
+    sessions.push_back(session);
+    for (size_t i = 0; i < per_transaction_; i++) {
+      auto flow_file = session->get();
+      if (flow_file == nullptr) {
+        break;
+      }
+      ContentCollector collector;
+      session->read(flow_file, &collector);
+      contents.push_back(collector.content);
+    }
+  }
+
+  std::vector<std::shared_ptr<core::ProcessSession>> sessions;
+  std::vector<std::string> contents;
+
+ private:
+  struct ContentCollector : public minifi::InputStreamCallback {
+    int64_t process(std::shared_ptr<minifi::io::BaseStream> stream) override {
+      std::vector<uint8_t> buffer;
+      const int read = stream->readData(buffer, static_cast<int>(stream->getSize()));
+      content.assign(buffer.begin(), buffer.begin() + (read > 0 ? read : 0));
+      return read;
+    }
+    std::string content;
+  };
+
+  size_t per_transaction_;
+};
+
+class RecordingInstance : public minifi::Instance {
+ public:
+  RecordingInstance(const std::string &port, const std::shared_ptr<RecordingPort> &recording_port)
+      : Instance("random_instance", port, "volatilerepository") {
+    rpg_ = recording_port;
+    proc_node_ = std::make_shared<core::ProcessorNode>(rpg_);
+    rpgInitialized_ = true;
+  }
+};
+
 void failure_counter(flow_file_record * fr) {
   failure_count++;
   REQUIRE(get_attribute_quantity(fr) > 0);
@@ -524,6 +583,16 @@ TEST_CASE("C API robustness test", "[TestRobustness]") {
 
   REQUIRE(transmit_flowfile(ffr, nullptr) == -1);
 
+  REQUIRE(transmit_flowfiles(nullptr, 1, instance) == -1);
+
+  flow_file_record *ffrs[] = { ffr, nullptr };
+
+  REQUIRE(transmit_flowfiles(ffrs, 2, instance) == -1);
+
+  REQUIRE(transmit_flowfiles(ffrs, 1, nullptr) == -1);
+
+  REQUIRE(create_ff_object_buffer(nullptr, 0) == nullptr);
+
   REQUIRE(create_new_flow(nullptr) == nullptr);
 
   flow *test_flow = create_new_flow(instance);
@@ -538,3 +607,101 @@ TEST_CASE("C API robustness test", "[TestRobustness]") {
 
   free_instance(instance);
 }
+
+TEST_CASE("Flow file content in a buffer", "[testBufferContent]") {
+  flow_file_record *ffr = create_ff_object_buffer(reinterpret_cast<const uint8_t *>(test_file_content.data()), test_file_content.size());
+  REQUIRE(ffr != nullptr);
+  REQUIRE(ffr->size == test_file_content.size());
+
+  std::vector<uint8_t> buffer(ffr->size);
+  REQUIRE(get_content(ffr, buffer.data(), buffer.size()) == test_file_content.size());
+  REQUIRE(std::string(buffer.begin(), buffer.end()) == test_file_content);
+
+  free_flowfile(ffr);
+}
+
+TEST_CASE("Flow files are transmitted through a single session", "[testTransmitFlowFiles]") {
+  char port_str[] = "12345";
+  const std::vector<std::string> contents = { "first", "second", "third", "fourth", "fifth" };
+  std::vector<flow_file_record *> ffrs;
+  for (const auto &content : contents) {
+    ffrs.push_back(create_ff_object_buffer(reinterpret_cast<const uint8_t *>(content.data()), content.size()));
+  }
+
+  // transactions taking fewer flow files than there are leave the rest to the next one on the same session
+  for (const size_t per_transaction : { 1, 2, 10 }) {
+    auto recording_port = std::make_shared<RecordingPort>(std::make_shared<minifi::Configure>(), per_transaction);
+    RecordingInstance minifi_instance(port_str, recording_port);
+    nifi_instance instance;
+    instance.instance_ptr = &minifi_instance;
+    instance.port.port_id = port_str;
+
+    REQUIRE(transmit_flowfiles(ffrs.data(), ffrs.size(), &instance) == contents.size());
+    REQUIRE(recording_port->contents == contents);
+    REQUIRE(recording_port->sessions.size() == (contents.size() + per_transaction - 1) / per_transaction);
+    for (const auto &session : recording_port->sessions) {
+      REQUIRE(session == recording_port->sessions.front());
+    }
+  }
+
+  for (auto ffr : ffrs) {
+    free_flowfile(ffr);
+  }
+}
+
+TEST_CASE("Transmitting a flow file fails when no peer takes it", "[testTransmitFlowFile]") {
+  char port_str[] = "12345";
+  auto recording_port = std::make_shared<RecordingPort>(std::make_shared<minifi::Configure>(), 0);
+  RecordingInstance minifi_instance(port_str, recording_port);
+  nifi_instance instance;
+  instance.instance_ptr = &minifi_instance;
+  instance.port.port_id = port_str;
+
+  flow_file_record *ffr = create_ff_object_buffer(reinterpret_cast<const uint8_t *>(test_file_content.data()), test_file_content.size());
+  REQUIRE(transmit_flowfile(ffr, &instance) == -1);
+  REQUIRE(transmit_flowfiles(&ffr, 1, &instance) == 0);
+  free_flowfile(ffr);
+}
+
+TEST_CASE("External content is read in place and left to its owner", "[testExternalContent]") {
+  auto external_repo = std::make_shared<minifi::ExternalContentRepository>(std::make_shared<core::repository::VolatileContentRepository>());
+
+  auto read_all = [&](const std::shared_ptr<minifi::ResourceClaim> &claim) {
+    auto stream = external_repo->read(claim);
+    REQUIRE(stream != nullptr);
+    std::vector<uint8_t> buffer;
+    const int read = stream->readData(buffer, static_cast<int>(stream->getSize()));
+    REQUIRE(read >= 0);
+    return std::string(buffer.begin(), buffer.begin() + read);
+  };
+
+  SECTION("Buffer claims") {
+    std::string content = test_file_content;
+    auto claim = external_repo->createBufferClaim(reinterpret_cast<const uint8_t *>(&content[0]), content.size());
+    REQUIRE(read_all(claim) == test_file_content);
+
+    // the stream reads the buffer of the caller rather than a copy of it
+    content[0] = 'c';
+    REQUIRE(read_all(claim) == content);
+    REQUIRE(external_repo->write(claim) == nullptr);
+
+    REQUIRE(external_repo->remove(claim));
+    REQUIRE(content[0] == 'c');
+    REQUIRE(content.substr(1) == test_file_content.substr(1));
+    REQUIRE_FALSE(external_repo->exists(claim));
+  }
+  SECTION("File claims") {
+    TestController test_controller;
+    char format[] = "/tmp/nanofi.XXXXXX";
+    const std::string path = create_testfile_for_getfile(test_controller.createTempDirectory(format).c_str());
+    auto claim = external_repo->createFileClaim(path);
+    REQUIRE(external_repo->exists(claim));
+    REQUIRE(read_all(claim) == test_file_content);
+
+    REQUIRE(external_repo->remove(claim));
+    std::ifstream file(path);
+    REQUIRE(file.good());
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    REQUIRE(content == test_file_content);
+  }
+}
@@ -20,11 +20,15 @@
 
 #include <algorithm>
 #include <chrono>
+#include <fstream>
 #include <string>
 #include <memory>
 #include <utility>
 #include <map>
 #include <thread>
+#include <vector>
+
+#include <zlib.h>
 
 #include "io/BaseStream.h"
 #include "TestBase.h"
@@ -34,6 +38,8 @@
 #include "sitetosite/CSiteToSite.h"
 #include "sitetosite/RawSocketProtocol.h"
 #include "core/cstructs.h"
+#include "core/tail_ring.h"
+#include "api/nanofi.h"
 #include "RandomServerSocket.h"
 #include "core/log.h"
 
@@ -229,3 +235,283 @@ TEST_CASE("TestSiteToBootStrap", "[S2S3]") {
     REQUIRE(std::string(reinterpret_cast<const char*>(received_data.payload.data()), received_data.payload.size()) == PAYLOAD);
   }
 }
+
+bool read_fully(minifi::io::BaseStream* stream, uint8_t* buf, uint64_t len) {
+  uint64_t read = 0;
+  while (read < len) {
+    int ret = stream->readData(buf + read, len - read);
+    if (ret <= 0) {
+      return false;
+    }
+    read += ret;
+  }
+  return true;
+}
+
+struct S2SPacket {
+  std::map<std::string, std::string> attributes;
+  std::string payload;
+};
+
+// reads the flow files of a transaction and checksums them the way the client does
+class TransactionReader {
+ public:
+  explicit TransactionReader(minifi::io::BaseStream* stream)
+      : stream_(stream),
+        crc_(crc32(0L, Z_NULL, 0)) {
+  }
+
+  bool readPacket(S2SPacket& packet) {
+    uint32_t attr_num;
+    if (!readInteger(attr_num)) {
+      return false;
+    }
+    for (uint32_t i = 0; i < attr_num; ++i) {
+      std::string key, value;
+      if (!readString(key) || !readString(value)) {
+        return false;
+      }
+      packet.attributes[key] = value;
+    }
+    uint64_t payload_size;
+    return readInteger(payload_size) && readBytes(packet.payload, payload_size);
+  }
+
+  uLong crc() const {
+    return crc_;
+  }
+
+ private:
+  template<typename T>
+  bool readInteger(T& value) {
+    std::string bytes;
+    if (!readBytes(bytes, sizeof(T))) {
+      return false;
+    }
+    value = 0;
+    for (char c : bytes) {
+      value = (value << 8) | static_cast<uint8_t>(c);
+    }
+    return true;
+  }
+
+  bool readString(std::string& str) {
+    uint32_t len;
+    return readInteger(len) && readBytes(str, len);
+  }
+
+  bool readBytes(std::string& bytes, uint64_t len) {
+    bytes.resize(len);
+    uint8_t* buf = reinterpret_cast<uint8_t*>(&bytes[0]);
+    if (!read_fully(stream_, buf, len)) {
+      return false;
+    }
+    crc_ = crc32(crc_, buf, len);
+    return true;
+  }
+
+  minifi::io::BaseStream* stream_;
+  uLong crc_;
+};
+
+uint8_t read_response_code(minifi::io::BaseStream* stream) {
+  std::array<uint8_t, 3> resp_codes = {0, 0, 0};
+  if (!read_fully(stream, resp_codes.data(), resp_codes.size()) || resp_codes[0] != 'R' || resp_codes[1] != 'C') {
+    return 0;
+  }
+  return resp_codes[2];
+}
+
+// keeps the connection open until the client closes it
+void drain(minifi::io::BaseStream* stream) {
+  uint8_t buf[64];
+  while (stream->readData(buf, sizeof(buf)) > 0) {
+  }
+}
+
+/**
+ * Receives the flow files of a transaction, confirms it with the checksum of what was read,
+ * or a wrong one when bad_crc is set, and returns whether the client confirmed it in turn.
+ */
+bool receive_transaction(minifi::io::BaseStream* stream, bool bad_crc, std::vector<S2SPacket>& packets) {
+  std::string requesttype;
+  stream->readUTF(requesttype);
+  if (requesttype != "SEND_FLOWFILES") {
+    return false;
+  }
+
+  TransactionReader reader(stream);
+  uint8_t code;
+  do {
+    S2SPacket packet;
+    if (!reader.readPacket(packet)) {
+      return false;
+    }
+    packets.push_back(packet);
+    code = read_response_code(stream);
+  } while (code == 10);  // continue transaction
+  if (code != 11) {  // finish transaction
+    return false;
+  }
+
+  send_response_code(stream, 12);  // confirm transaction
+  stream->writeUTF(std::to_string(bad_crc ? reader.crc() + 1 : reader.crc()));
+  if (read_response_code(stream) != 12) {
+    return false;
+  }
+  std::string description;
+  stream->readUTF(description);
+  send_response_code(stream, 13);  // transaction finished
+  return true;
+}
+
+TEST_CASE("TestSiteToSiteTransmitsPacketsInOneTransaction", "[S2S4]") {
+  TransferState transfer_state;
+  S2SReceivedData received_data;
+  std::vector<S2SPacket> packets;
+  bool server_confirmed = false;
+  std::unique_ptr<minifi::io::ServerSocket> sckt(new minifi::io::RandomServerSocket("localhost"));
+  uint16_t port = sckt->getPort();
+
+  sckt->registerCallback([]() -> bool { return true; }, [&transfer_state, &received_data, &packets, &server_confirmed](minifi::io::BaseStream* stream) {
+    sunny_path_bootstrap(stream, transfer_state, received_data);
+    server_confirmed = receive_transaction(stream, false, packets);
+    transfer_state.data_processed = true;
+    drain(stream);
+  });
+
+  SiteToSiteCPeer cpeer;
+  initPeer(&cpeer, "localhost", port, "");
+  CRawSiteToSiteClient cprotocol;
+  initRawClient(&cprotocol, &cpeer);
+
+  attribute attribute1;
+  attribute1.key = ATTR_NAME;
+  attribute1.value = (void *) ATTR_VALUE;
+  attribute1.value_size = strlen(ATTR_VALUE);
+  attribute_set as;
+  as.size = 1;
+  as.attributes = &attribute1;
+
+  // binary content is sent as far as its size says, not up to its first NUL
+  const char binary_payload[] = {'b', 'i', 'n', '\0', 'a', 'r', 'y', '\0'};
+  std::array<CDataPacket, 3> cpackets;
+  initPacket(&cpackets[0], NULL, &as, PAYLOAD);
+  initPacketWithSize(&cpackets[1], NULL, &as, binary_payload, sizeof(binary_payload));
+  initPacket(&cpackets[2], NULL, &as, "last");
+
+  REQUIRE(bootstrap(&cprotocol) == 0);
+  wait_until(transfer_state.handshake_data_processed);
+  REQUIRE(transmitPackets(&cprotocol, cpackets.data(), cpackets.size()) == 0);
+  wait_until(transfer_state.data_processed);
+  destroyClient(&cprotocol);
+  freePeer(&cpeer);
+
+  REQUIRE(server_confirmed);
+  REQUIRE(packets.size() == 3);
+  REQUIRE(packets[0].payload == PAYLOAD);
+  REQUIRE(packets[1].payload == std::string(binary_payload, sizeof(binary_payload)));
+  REQUIRE(packets[2].payload == "last");
+  for (const auto& packet : packets) {
+    REQUIRE(packet.attributes.at(ATTR_NAME) == ATTR_VALUE);
+  }
+}
+
+TEST_CASE("TestSiteToSiteReportsUnreadableContent", "[S2S5]") {
+  TransferState transfer_state;
+  S2SReceivedData received_data;
+  std::unique_ptr<minifi::io::ServerSocket> sckt(new minifi::io::RandomServerSocket("localhost"));
+  uint16_t port = sckt->getPort();
+
+  sckt->registerCallback([]() -> bool { return true; }, [&transfer_state, &received_data](minifi::io::BaseStream* stream) {
+    sunny_path_bootstrap(stream, transfer_state, received_data);
+    drain(stream);
+  });
+
+  SiteToSiteCPeer cpeer;
+  initPeer(&cpeer, "localhost", port, "");
+  CRawSiteToSiteClient cprotocol;
+  initRawClient(&cprotocol, &cpeer);
+  REQUIRE(bootstrap(&cprotocol) == 0);
+  wait_until(transfer_state.handshake_data_processed);
+
+  CTransaction* transaction = createTransaction(&cprotocol, SEND);
+  REQUIRE(transaction != nullptr);
+
+  // the content of a flow file which claims ten bytes of a file that does not exist cannot be read
+  const char * missing_file = "./a_file_which_does_not_exist";
+  flow_file_record * ff = create_ff_object_na(missing_file, strlen(missing_file), 10);
+  attribute_set as;
+  as.size = 0;
+  as.attributes = nullptr;
+  CDataPacket packet;
+  initPacket(&packet, transaction, &as, nullptr);
+
+  REQUIRE(sendPacket(&cprotocol, getUUIDStr(transaction), &packet, ff) == -2);
+  REQUIRE(transaction->_bytes == 0);
+
+  free_flowfile(ff);
+  destroyClient(&cprotocol);
+  freePeer(&cpeer);
+}
+
+TEST_CASE("TestTailRingKeepsChunksOfFailedTransactions", "[S2S6]") {
+  TestController test_controller;
+  char format[] = "/tmp/s2s.XXXXXX";
+  const std::string file = std::string(test_controller.createTempDirectory(format)) + "/e.txt";
+  {
+    std::ofstream out(file);
+    out << "aaaabbbb";
+  }
+
+  tail_ring ring;
+  REQUIRE(init_tail_ring(&ring, file.c_str(), 4, 4096) == 0);
+  REQUIRE(tail_file_to_ring(&ring) == 2);
+
+  TransferState transfer_state;
+  S2SReceivedData received_data;
+  std::vector<S2SPacket> packets;
+  std::atomic<int> transactions{0};
+  std::unique_ptr<minifi::io::ServerSocket> sckt(new minifi::io::RandomServerSocket("localhost"));
+  uint16_t port = sckt->getPort();
+
+  // the first transaction is confirmed with a wrong checksum, the next one is accepted
+  sckt->registerCallback([]() -> bool { return true; }, [&transfer_state, &received_data, &packets, &transactions](minifi::io::BaseStream* stream) {
+    sunny_path_bootstrap(stream, transfer_state, received_data);
+    std::vector<S2SPacket> received;
+    if (receive_transaction(stream, transactions == 0, received)) {
+      packets = received;
+    }
+    ++transactions;
+    drain(stream);
+  });
+
+  SiteToSiteCPeer cpeer;
+  initPeer(&cpeer, "localhost", port, "");
+  CRawSiteToSiteClient cprotocol;
+  initRawClient(&cprotocol, &cpeer);
+
+  REQUIRE(bootstrap(&cprotocol) == 0);
+  wait_until(transfer_state.handshake_data_processed);
+  REQUIRE(transmit_tail_ring(&ring, &cprotocol) == -1);
+  REQUIRE(ring.count == 2);
+  REQUIRE(packets.empty());
+
+  // the failed transaction tore the connection down, the chunks go out over a new one
+  transfer_state.handshake_data_processed = false;
+  REQUIRE(bootstrap(&cprotocol) == 0);
+  wait_until(transfer_state.handshake_data_processed);
+  REQUIRE(transmit_tail_ring(&ring, &cprotocol) == 2);
+  REQUIRE(ring.count == 0);
+  while (transactions < 2) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(0));
+  }
+  REQUIRE(packets.size() == 2);
+  REQUIRE(packets[0].payload == "aaaa");
+  REQUIRE(packets[1].payload == "bbbb");
+  REQUIRE(packets[1].attributes.at("current offset") == "8");
+
+  destroyClient(&cprotocol);
+  freePeer(&cpeer);
+  free_tail_ring(&ring);
+}
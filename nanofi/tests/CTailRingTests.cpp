@@ -0,0 +1,191 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _WIN32
+#include "catch.hpp"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "core/tail_ring.h"
+
+#include "CTestsBase.h"
+
+/****
+ * ##################################################################
+ *  CTAILFILE RING TESTS
+ * ##################################################################
+ */
+
+namespace {
+
+std::string chunk_content(tail_chunk * chunk) {
+    return std::string(static_cast<const char *>(chunk->record.in), chunk->record.size);
+}
+
+std::string attribute_value(tail_chunk * chunk, const std::string &key) {
+    for (size_t i = 0; i < chunk->attribute_set.size; ++i) {
+        if (key == chunk->attribute_set.attributes[i].key) {
+            return std::string(static_cast<const char *>(chunk->attribute_set.attributes[i].value), chunk->attribute_set.attributes[i].value_size);
+        }
+    }
+    return "";
+}
+
+long max_rss_kb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+}  // namespace
+
+TEST_CASE("Test tail ring fits into its memory limit", "[tailRingMemoryLimit]") {
+    tail_ring ring;
+    REQUIRE(init_tail_ring(&ring, "./e.txt", 4096, 4096) == -1);
+    REQUIRE(init_tail_ring(&ring, "./e.txt", 0, 65536) == -1);
+
+    REQUIRE(init_tail_ring(&ring, "./e.txt", 4096, 65536) == 0);
+    REQUIRE(ring.capacity > 0);
+    REQUIRE(get_tail_ring_memory(&ring) <= 65536);
+    REQUIRE(get_tail_ring_memory(&ring) + 4096 > 65536);
+    free_tail_ring(&ring);
+}
+
+TEST_CASE("Test tail ring reads complete chunks", "[tailRingChunks]") {
+    TestControllerWithTemporaryWorkingDirectory test_controller;
+    const char * file = "./e.txt";
+
+    FileManager fm(file);
+    fm.WriteNChars(4, 'a');
+    fm.WriteNChars(4, 'b');
+    fm.WriteNChars(2, 'c');
+    fm.CloseStream();
+
+    tail_ring ring;
+    REQUIRE(init_tail_ring(&ring, file, 4, 4096) == 0);
+
+    REQUIRE(tail_file_to_ring(&ring) == 2);
+    REQUIRE(ring.count == 2);
+    REQUIRE(ring.offset == 8);
+    REQUIRE(chunk_content(get_tail_chunk(&ring, 0)) == "aaaa");
+    REQUIRE(chunk_content(get_tail_chunk(&ring, 1)) == "bbbb");
+    REQUIRE(attribute_value(get_tail_chunk(&ring, 1), "current offset") == "8");
+    REQUIRE(attribute_value(get_tail_chunk(&ring, 1), "tailfile path") == file);
+
+    fm.OpenStream();
+    fm.WriteNChars(2, 'c');
+    fm.CloseStream();
+
+    REQUIRE(tail_file_to_ring(&ring) == 1);
+    REQUIRE(chunk_content(get_tail_chunk(&ring, 2)) == "cccc");
+    REQUIRE(get_tail_chunk(&ring, 3) == nullptr);
+    free_tail_ring(&ring);
+}
+
+TEST_CASE("Test tail ring reads delimited records", "[tailRingDelimited]") {
+    TestControllerWithTemporaryWorkingDirectory test_controller;
+    const char * file = "./e.txt";
+
+    FileManager fm(file);
+    fm.Write("first;;second;a record longer than a chunk;last");
+    fm.CloseStream();
+
+    tail_ring ring;
+    REQUIRE(init_tail_ring(&ring, file, 16, 4096) == 0);
+    set_tail_ring_delimiter(&ring, ';');
+
+    REQUIRE(tail_file_to_ring(&ring) == 4);
+    REQUIRE(chunk_content(get_tail_chunk(&ring, 0)) == "first");
+    REQUIRE(chunk_content(get_tail_chunk(&ring, 1)) == "second");
+    REQUIRE(chunk_content(get_tail_chunk(&ring, 2)) == "a record longer ");
+    REQUIRE(chunk_content(get_tail_chunk(&ring, 3)) == "than a chunk");
+    REQUIRE(get_tail_chunk(&ring, 4) == nullptr);
+    REQUIRE(ring.offset == 43);
+
+    fm.OpenStream();
+    fm.Write(";");
+    fm.CloseStream();
+
+    REQUIRE(tail_file_to_ring(&ring) == 1);
+    REQUIRE(chunk_content(get_tail_chunk(&ring, 4)) == "last");
+    REQUIRE(ring.offset == 48);
+    free_tail_ring(&ring);
+}
+
+TEST_CASE("Test tail ring stops reading when it is full", "[tailRingFull]") {
+    TestControllerWithTemporaryWorkingDirectory test_controller;
+    const char * file = "./e.txt";
+
+    FileManager fm(file);
+    fm.WriteNChars(4096 * 8, 'a');
+    fm.CloseStream();
+
+    tail_ring ring;
+    REQUIRE(init_tail_ring(&ring, file, 4096, 4 * 4096 + 4096) == 0);
+    const size_t capacity = ring.capacity;
+    REQUIRE(capacity < 8);
+
+    REQUIRE(tail_file_to_ring(&ring) == capacity);
+    REQUIRE(tail_file_to_ring(&ring) == 0);
+    REQUIRE(ring.offset == capacity * 4096);
+
+    release_tail_chunks(&ring, 1);
+    REQUIRE(ring.count == capacity - 1);
+    REQUIRE(tail_file_to_ring(&ring) == 1);
+    REQUIRE(ring.offset == (capacity + 1) * 4096);
+
+    release_tail_chunks(&ring, capacity);
+    REQUIRE(ring.count == 0);
+    free_tail_ring(&ring);
+}
+
+TEST_CASE("Test tail ring throughput and memory", "[.benchmark][tailRingBenchmark]") {
+    TestControllerWithTemporaryWorkingDirectory test_controller;
+    const char * file = "./e.txt";
+    const uint64_t file_size = 64 * 1024 * 1024;
+    const uint64_t memory_limit = 1024 * 1024;
+
+    FileManager fm(file);
+    for (int i = 0; i < 64; ++i) {
+        fm.WriteNChars(1024 * 1024, 'a' + i % 26);
+    }
+    fm.CloseStream();
+
+    tail_ring ring;
+    REQUIRE(init_tail_ring(&ring, file, 64 * 1024, memory_limit) == 0);
+    const long rss_before = max_rss_kb();
+
+    const auto start = std::chrono::steady_clock::now();
+    while (ring.offset < file_size) {
+        REQUIRE(tail_file_to_ring(&ring) > 0);
+        release_tail_chunks(&ring, ring.count);
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    const long rss_growth = max_rss_kb() - rss_before;
+
+    std::cout << "tailed " << file_size / (1024 * 1024) << " MB through " << ring.capacity << " chunks: "
+              << (file_size * 1.0 / std::max<int64_t>(elapsed, 1)) << " MB/s, peak RSS grew by " << rss_growth << " KB" << std::endl;
+    REQUIRE(rss_growth * 1024 <= static_cast<long>(memory_limit));
+    free_tail_ring(&ring);
+}
+
+#endif